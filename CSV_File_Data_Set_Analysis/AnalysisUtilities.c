@@ -10,48 +10,1342 @@
 #include "FileUtilities.h"
 #include "DebuggingUtilities.h"
 #include <ctype.h>
+#include <limits.h>
 
 
 
 
 
 
+/**
+ * analyze_data_set_properties
+ *
+ * Ingests a data set, in a single pass over its file, into a typed columnar table along with its header, delimiter, and schema.
+ *
+ * The file is mapped and its header and format line are captured exactly as in 'stream_data_set': the format line is preprocessed and
+ * formatted, and the schema inferred from it establishes the expected type of every field. Each data entry(beginning with the format line)
+ * is then split in place, directly in the mapping, with 'split_line_into_delimited_field_spans', and each of its values is trimmed,
+ * converted, and appended to the column of its field with 'append_data_column_value'. No data entry is copied or rewritten: an empty
+ * field keeps its position and becomes a null, as do hyphens and values of the wrong type, rather than being replaced by "0.0" in the
+ * entry. No line index or array of lines is built. Every column grows geometrically, all of them at once.
+ *
+ * @param filePathName Path of the data set file.
+ * @return The properties and columns of the data set, to be released with 'free_data_set_properties'. A data set without data entries
+ *         has no columns.
+ */
 DataSetProperties analyze_data_set_properties(const char *filePathName)
 {
-	int lineCount = count_file_lines(filePathName, MAX_NUM_FILE_LINES);
-	char **fileContents = read_file_contents(filePathName, lineCount);
-	const char *delimiter = identify_delimiter(fileContents, lineCount);
+	DataSetProperties dataSetProperties;
+	set_memory_block(&dataSetProperties, 0, sizeof(DataSetProperties));
+	dataSetProperties.filePathName = filePathName;
+	
+	MappedFile dataSetFile = map_file_bytes(filePathName);
+	if (dataSetFile.size == 0)
+	{
+		perror("\n\nError: The data set file is empty in 'analyze_data_set_properties'.\n");
+		return dataSetProperties;
+	}
+	const char *delimiter = identify_mapped_file_delimiter(&dataSetFile, 64);
+	
+	
+	
+	/*-----------   Capture the Header Line and the Format Line   -----------*/
+	size_t offset = 0;
+	size_t lineLength = 0;
+	const char *line = next_mapped_file_line(&dataSetFile, &offset, &lineLength);
+	char *headerLine = copy_line_contents(line, lineLength);
+	char *headerCopy = strdup(headerLine); // 'count_data_fields' modifies the string it counts
+	int fieldCount = count_data_fields(headerCopy);
+	free(headerCopy);
+	
+	
+	size_t dataOffset = offset; // The data entries begin with the format line
+	line = next_mapped_file_line(&dataSetFile, &offset, &lineLength);
+	char *formatEntry = (line != NULL) ? copy_line_contents(line, lineLength) : NULL;
+	char *prunedFormatEntry = (formatEntry != NULL) ? prune_and_trim_problematic_characters_from_string(formatEntry, delimiter, fieldCount) : NULL;
+	char *formatLine = (prunedFormatEntry != NULL) ? format_data_entry_for_plotting(prunedFormatEntry, prunedFormatEntry, fieldCount, delimiter) : NULL;
+	if (prunedFormatEntry != formatEntry)
+	{
+		free(prunedFormatEntry);
+	}
+	free(formatEntry);
+	if (formatLine == NULL || fieldCount <= 0)
+	{
+		perror("\n\nError: The data set has no data entries in 'analyze_data_set_properties'.\n");
+		free(formatLine);
+		free(headerLine);
+		unmap_file_contents(&dataSetFile);
+		return dataSetProperties;
+	}
+	
+	
+	
+	/*-----------   Determine the Expected Data Type, Name, and Storage of Each Field   -----------*/
+	char *typeSource[2] = {headerLine, formatLine}; // 'capture_data_set_header_for_plotting' determines the types from the line following the header
+	dataSetProperties.fieldCount = fieldCount;
+	dataSetProperties.delimiter = delimiter;
+	dataSetProperties.header = headerLine;
+	dataSetProperties.fieldNameTypePairs = capture_data_set_header_for_plotting(headerLine, typeSource, delimiter);
+	dataSetProperties.schema = infer_data_set_schema(formatLine, fieldCount, delimiter);
+	dataSetProperties.columns = (DataColumn*)calloc(fieldCount, sizeof(DataColumn));
+	if (dataSetProperties.columns == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'analyze_data_set_properties'.\n");
+		exit(1);
+	}
+	
+	FieldSpan *rowFields = (FieldSpan*)malloc(fieldCount * sizeof(FieldSpan)); // Reused for the format line and then every data entry
+	RowView formatRow = create_delimited_row_view(formatLine, delimiter, rowFields, fieldCount);
+	for (int i = 0; i < fieldCount; i++)
+	{
+		DataColumn *column = &dataSetProperties.columns[i];
+		const char *typeDelimiterPosition = strchr(dataSetProperties.fieldNameTypePairs[i], ':');
+		size_t nameLength = (typeDelimiterPosition != NULL) ? (size_t)(typeDelimiterPosition - dataSetProperties.fieldNameTypePairs[i]) : strlen(dataSetProperties.fieldNameTypePairs[i]);
+		column->name = strndup(dataSetProperties.fieldNameTypePairs[i], nameLength);
+		column->fieldType = dataSetProperties.schema.fieldTypes[i];
+		
+		int64_t integerValue;
+		if (column->fieldType != FIELD_TYPE_NUMERIC)
+		{
+			column->storage = COLUMN_STORAGE_STRING;
+		}
+		else if (i < formatRow.fieldCount && parse_integer_string(formatRow.fields[i].start, formatRow.fields[i].length, &integerValue))
+		{
+			column->storage = COLUMN_STORAGE_INT64;
+		}
+		else
+		{
+			column->storage = COLUMN_STORAGE_DOUBLE;
+		}
+	}
+	free(formatLine);
+	grow_data_set_columns(&dataSetProperties, 1024);
+	
+	
+	
+	/*-----------   Ingest Every Data Entry into the Columns   -----------*/
+	DateTimeFormat columnFormats[fieldCount]; // Each column's date/time format, detected from its first date/time
+	for (int i = 0; i < fieldCount; i++)
+	{
+		columnFormats[i] = compile_date_time_format(-1);
+	}
+	
+	size_t entryCount = 0;
+	offset = dataOffset;
+	while ((line = next_mapped_file_line(&dataSetFile, &offset, &lineLength)) != NULL)
+	{
+		// Blank lines are not data entries and are skipped
+		size_t leadingWhitespace = 0;
+		while (leadingWhitespace < lineLength && isspace((unsigned char)line[leadingWhitespace]))
+		{
+			leadingWhitespace++;
+		}
+		if (leadingWhitespace == lineLength)
+		{
+			continue;
+		}
+		
+		
+		if (entryCount == dataSetProperties.rowCapacity)
+		{
+			grow_data_set_columns(&dataSetProperties, dataSetProperties.rowCapacity * 2);
+		}
+		int spanCount = split_line_into_delimited_field_spans(line, lineLength, delimiter, rowFields, fieldCount);
+		for (int i = 0; i < fieldCount; i++)
+		{
+			FieldSpan field = (i < spanCount) ? rowFields[i] : (FieldSpan){"", 0}; // Fields missing from the end of the entry are empty
+			while (field.length > 0 && isspace((unsigned char)field.start[0])) // Trim the whitespace surrounding the value
+			{
+				field.start++;
+				field.length--;
+			}
+			while (field.length > 0 && isspace((unsigned char)field.start[field.length - 1]))
+			{
+				field.length--;
+			}
+			append_data_column_value(&dataSetProperties.columns[i], field, entryCount, dataSetProperties.rowCapacity, &columnFormats[i]);
+		}
+		entryCount++;
+	}
+	dataSetProperties.entryCount = (int)entryCount;
+	free(rowFields);
+	unmap_file_contents(&dataSetFile);
+	
+	
+	printf("\n\n\n\ndataSetProperties: ");
+	printf("\n\ndataSetHeader: %s", dataSetProperties.header);
+	printf("\ndelimiter: %s", dataSetProperties.delimiter);
+	printf("\nentryCount: %d        fieldCount: %d      ", dataSetProperties.entryCount, dataSetProperties.fieldCount);
+	
+	print_string_array(dataSetProperties.fieldNameTypePairs, dataSetProperties.fieldCount, "fieldNameTypePairs");
+	
+	return dataSetProperties;
+}
+
+
+
+
+/**
+ * free_data_set_properties
+ *
+ * Releases the memory held by the properties of a data set created by 'analyze_data_set_properties', including every column.
+ *
+ * @param properties The properties to be released, they are reset to an empty state.
+ */
+void free_data_set_properties(DataSetProperties *properties)
+{
+	if (properties == NULL)
+	{
+		return;
+	}
+	
+	for (int i = 0; properties->columns != NULL && i < properties->fieldCount; i++)
+	{
+		DataColumn *column = &properties->columns[i];
+		free(column->name);
+		free(column->integerValues);
+		free(column->doubleValues);
+		free(column->stringOffsets);
+		free(column->stringBytes);
+		free(column->validity);
+		free_column_statistics_cache(column->statistics);
+	}
+	free(properties->columns);
+	if (properties->fieldNameTypePairs != NULL)
+	{
+		deallocate_memory_char_ptr_ptr(properties->fieldNameTypePairs, properties->fieldCount);
+	}
+	free_data_set_schema(&properties->schema);
+	free(properties->header);
+	
+	const char *filePathName = properties->filePathName;
+	set_memory_block(properties, 0, sizeof(DataSetProperties));
+	properties->filePathName = filePathName;
+}
+
+
+
+
+/**
+ * grow_data_set_columns
+ *
+ * Grows the value array and validity bitmap of every column of a data set to hold 'rowCapacity' values, the values already stored are
+ * kept and the values added are null. String columns grow their offsets, their bytes grow separately as values are appended.
+ *
+ * @param properties The data set whose columns are grown, its 'rowCapacity' is updated.
+ * @param rowCapacity The number of values each column must be able to hold.
+ */
+void grow_data_set_columns(DataSetProperties *properties, size_t rowCapacity)
+{
+	for (int i = 0; i < properties->fieldCount; i++)
+	{
+		DataColumn *column = &properties->columns[i];
+		void *grown = NULL;
+		switch (column->storage)
+		{
+			case COLUMN_STORAGE_INT64:
+				grown = column->integerValues = realloc(column->integerValues, rowCapacity * sizeof(int64_t));
+				break;
+			case COLUMN_STORAGE_DOUBLE:
+				grown = column->doubleValues = realloc(column->doubleValues, rowCapacity * sizeof(double));
+				break;
+			case COLUMN_STORAGE_STRING:
+				grown = realloc(column->stringOffsets, (rowCapacity + 1) * sizeof(size_t));
+				if (grown != NULL && column->stringOffsets == NULL)
+				{
+					((size_t*)grown)[0] = 0; // The first value begins at the start of the heap
+				}
+				column->stringOffsets = grown;
+				break;
+		}
+		if (grown == NULL)
+		{
+			perror("\n\nError: Unable to allocate memory in 'grow_data_set_columns'.\n");
+			exit(1);
+		}
+		column->validity = grow_validity_bitmap(column->validity, properties->rowCapacity, rowCapacity);
+	}
+	properties->rowCapacity = rowCapacity;
+}
+
+
+
+
+/**
+ * promote_data_column_to_double
+ *
+ * Converts a COLUMN_STORAGE_INT64 column to COLUMN_STORAGE_DOUBLE, for when a value that is not an integer is appended to it.
+ * This happens at most once per column.
+ *
+ * @param column The column to be converted.
+ * @param rowCount The number of values already stored in the column.
+ * @param rowCapacity The number of values the column must be able to hold.
+ */
+void promote_data_column_to_double(DataColumn *column, size_t rowCount, size_t rowCapacity)
+{
+	if (column->storage != COLUMN_STORAGE_INT64)
+	{
+		return;
+	}
+	
+	column->doubleValues = allocate_memory_double_ptr(rowCapacity);
+	for (size_t i = 0; i < rowCount; i++)
+	{
+		column->doubleValues[i] = (double)column->integerValues[i];
+	}
+	free(column->integerValues);
+	column->integerValues = NULL;
+	column->storage = COLUMN_STORAGE_DOUBLE;
+}
+
+
+
+
+/**
+ * append_data_column_value
+ *
+ * Converts a single value and stores it as the 'rowIndex'th value of its column, which must have room for it. Numeric values are
+ * parsed once, as an integer when the column still holds integers and otherwise as a double, and a date/time in a numeric column is
+ * converted to Unix time with the column's date/time format. A value that is missing, or is not of the field's expected type(with the
+ * same rules as 'is_missing_field_value'), is a null: its validity bit is left clear, 0(or an empty string) is stored in its place so
+ * that the values remain contiguous, and it is counted in the column's 'missingCount'. Either way the column's 'version' is incremented.
+ *
+ * @param column The column the value belongs to.
+ * @param field The value, with the surrounding whitespace already trimmed.
+ * @param rowIndex The index of the data entry the value belongs to, values must be appended in order.
+ * @param rowCapacity The number of values the column can hold.
+ * @param columnFormat The date/time format of the column, updated as 'column_value_to_unix_time' detects it.
+ */
+void append_data_column_value(DataColumn *column, FieldSpan field, size_t rowIndex, size_t rowCapacity, DateTimeFormat *columnFormat)
+{
+	column->version++; // Any data derived from the column before this value is stale
+	
+	
+	if (column->storage == COLUMN_STORAGE_STRING)
+	{
+		size_t heapLength = column->stringOffsets[rowIndex];
+		if (field.length == 0 || is_missing_field_value(field, column->fieldType))
+		{
+			column->missingCount++;
+			field.length = 0;
+		}
+		else
+		{
+			set_validity_bit(column->validity, rowIndex);
+			if (heapLength + field.length > column->stringBytesCapacity)
+			{
+				size_t grownCapacity = (column->stringBytesCapacity > 0) ? column->stringBytesCapacity * 2 : 4096;
+				while (grownCapacity < heapLength + field.length)
+				{
+					grownCapacity *= 2;
+				}
+				column->stringBytes = realloc(column->stringBytes, grownCapacity);
+				if (column->stringBytes == NULL)
+				{
+					perror("\n\nError: Unable to allocate memory in 'append_data_column_value'.\n");
+					exit(1);
+				}
+				column->stringBytesCapacity = grownCapacity;
+			}
+			copy_memory_block(column->stringBytes + heapLength, field.start, field.length);
+		}
+		column->stringOffsets[rowIndex + 1] = heapLength + field.length;
+		return;
+	}
+	
+	
+	/// Integers are kept exactly for as long as the column holds only integers
+	int64_t integerValue;
+	if (column->storage == COLUMN_STORAGE_INT64 && parse_integer_string(field.start, field.length, &integerValue))
+	{
+		column->integerValues[rowIndex] = integerValue;
+		set_validity_bit(column->validity, rowIndex);
+		return;
+	}
+	
+	double value;
+	bool isPresent = (field.length > 0 && parse_numeric_string(field.start, field.length, &value));
+	if (!isPresent && field.length > 0 && field.length < 64) // Not a number, it may be a date/time, which needs a null-terminated copy
+	{
+		char dateTimeString[64];
+		copy_memory_block(dateTimeString, field.start, field.length);
+		dateTimeString[field.length] = '\0';
+		time_t unixTime;
+		if (column_value_to_unix_time(dateTimeString, columnFormat, &unixTime))
+		{
+			isPresent = true;
+			if (column->storage == COLUMN_STORAGE_INT64)
+			{
+				column->integerValues[rowIndex] = (int64_t)unixTime;
+				set_validity_bit(column->validity, rowIndex);
+				return;
+			}
+			value = (double)unixTime;
+		}
+	}
+	
+	
+	if (!isPresent)
+	{
+		column->missingCount++;
+		if (column->storage == COLUMN_STORAGE_INT64)
+		{
+			column->integerValues[rowIndex] = 0;
+		}
+		else
+		{
+			column->doubleValues[rowIndex] = 0.0;
+		}
+		return;
+	}
+	promote_data_column_to_double(column, rowIndex, rowCapacity); // Only converts a column that still holds integers
+	column->doubleValues[rowIndex] = value;
+	set_validity_bit(column->validity, rowIndex);
+}
+
+
+
+
+/**
+ * data_column_string
+ *
+ * Views a value of a string column in place, the span points into the column's heap and is not null-terminated.
+ *
+ * @param column The string column.
+ * @param rowIndex The index of the value.
+ * @return The span of the value, empty for a missing value or a column that does not hold strings.
+ */
+FieldSpan data_column_string(const DataColumn *column, size_t rowIndex)
+{
+	FieldSpan value = {"", 0};
+	if (column->storage == COLUMN_STORAGE_STRING && column->stringBytes != NULL)
+	{
+		value.start = column->stringBytes + column->stringOffsets[rowIndex];
+		value.length = column->stringOffsets[rowIndex + 1] - column->stringOffsets[rowIndex];
+	}
+	return value;
+}
+
+
+
+
+/**
+ * data_column_to_doubles
+ *
+ * Copies the values of a numeric column into a new array of doubles, in the form the statistical methods take. A COLUMN_STORAGE_DOUBLE
+ * column can also be read directly through its 'doubleValues'. The nulls of the column are copied as 0, so the array should be read
+ * along with the column's 'validity' bitmap, e.g., by 'compute_mean_of_valid_values'.
+ *
+ * @param column The numeric column.
+ * @param rowCount The number of values in the column.
+ * @return A new array of 'rowCount' doubles, or NULL if the column holds strings.
+ */
+double *data_column_to_doubles(const DataColumn *column, size_t rowCount)
+{
+	if (column->storage == COLUMN_STORAGE_STRING)
+	{
+		return NULL;
+	}
+	
+	double *values = allocate_memory_double_ptr(rowCount > 0 ? rowCount : 1);
+	if (column->storage == COLUMN_STORAGE_DOUBLE)
+	{
+		copy_memory_block(values, column->doubleValues, rowCount * sizeof(double));
+	}
+	else
+	{
+		for (size_t i = 0; i < rowCount; i++)
+		{
+			values[i] = (double)column->integerValues[i];
+		}
+	}
+	return values;
+}
+
+
+
+
+
+/**
+ * data_column_statistics
+ *
+ * Returns the cache of the data derived from a numeric column that the statistical methods share(its sorted values, sort permutation,
+ * extremes, and moments, see 'create_column_statistics_cache'), creating it the first time it is needed. The cache is kept with the
+ * column and reused by every later call, unless values have been stored in the column since it was created, in which case it is
+ * released and created again from the column's current values.
+ *
+ * @param properties The ingested data set.
+ * @param fieldIndex The index of the numeric column.
+ * @return The cache of the column, owned by the column, or NULL if the column holds strings.
+ */
+ColumnStatisticsCache *data_column_statistics(DataSetProperties *properties, int fieldIndex)
+{
+	DataColumn *column = &properties->columns[fieldIndex];
+	if (column->storage == COLUMN_STORAGE_STRING)
+	{
+		return NULL;
+	}
+	if (column->statistics != NULL && column->statistics->sourceVersion == column->version)
+	{
+		return column->statistics;
+	}
+	
+	
+	free_column_statistics_cache(column->statistics);
+	if (column->storage == COLUMN_STORAGE_DOUBLE)
+	{
+		column->statistics = create_column_statistics_cache(column->doubleValues, column->validity, properties->entryCount, column->version);
+	}
+	else
+	{
+		double *values = data_column_to_doubles(column, properties->entryCount);
+		column->statistics = create_column_statistics_cache(values, column->validity, properties->entryCount, column->version);
+		free(values);
+	}
+	
+	return column->statistics;
+}
+
+
+
+
+/**
+ * write_data_set_properties_plottable_fields
+ *
+ * Writes every numeric column of an ingested data set to the plottable fields directory, with the same layout as 'stream_data_set':
+ * a file per field, named by its index among the plottable fields and its name, holding the field name followed by one value per line
+ * and a blank line, plus a single file combining all of them. The values are written straight from each column's contiguous array, and
+ * a null is written as "nan", so that it keeps its row without being mistaken for a zero.
+ *
+ * @param properties The ingested data set.
+ * @return The path of the plottable fields directory.
+ */
+char *write_data_set_properties_plottable_fields(const DataSetProperties *properties)
+{
+	char *plottableFieldsDirectory = create_directory(properties->filePathName, "_Plottable_Fields");
+	char *fileName = find_name_from_path(properties->filePathName);
+	char *plottableFieldFileName = combine_strings("/", fileName);
+	char *plottableFieldsPathName = combine_strings(plottableFieldsDirectory, plottableFieldFileName);
+	free(plottableFieldFileName);
+	plottableFieldFileName = plottableFieldsPathName;
+	plottableFieldsPathName = combine_strings(plottableFieldFileName, "_Plottable_Field"); // Full path for plottable data fields, followed by the index and name of each field
+	free(plottableFieldFileName);
+	
+	char *plottingDataFilePathName = combine_strings(plottableFieldsPathName, ".txt");
+	FILE *plottingDataFile = fopen(plottingDataFilePathName, "w");
+	if (plottingDataFile == NULL)
+	{
+		perror("\n\nError opening file for writing in 'write_data_set_properties_plottable_fields'.");
+		exit(1);
+	}
+	
+	
+	int plottableIndex = 0;
+	for (int i = 0; i < properties->fieldCount; i++)
+	{
+		const DataColumn *column = &properties->columns[i];
+		if (column->storage == COLUMN_STORAGE_STRING)
+		{
+			continue;
+		}
+		
+		size_t pathLength = strlen(plottableFieldsPathName) + strlen(column->name) + 32;
+		char *plottableFieldFilePathName = allocate_memory_char_ptr(pathLength);
+		snprintf(plottableFieldFilePathName, pathLength, "%s_%d-%s.txt", plottableFieldsPathName, plottableIndex++, column->name);
+		FILE *plottableFieldFile = fopen(plottableFieldFilePathName, "w");
+		if (plottableFieldFile == NULL)
+		{
+			perror("\n\nError opening file for writing in 'write_data_set_properties_plottable_fields'.");
+			exit(1);
+		}
+		
+		
+		// Write the field to its own file and to the combined file in the same pass over its values
+		FILE *outputFiles[2] = {plottableFieldFile, plottingDataFile};
+		for (int f = 0; f < 2; f++)
+		{
+			fprintf(outputFiles[f], "%s\n", column->name);
+			for (int r = 0; r < properties->entryCount; r++)
+			{
+				int written;
+				if (!validity_bit_is_set(column->validity, (size_t)r))
+				{
+					written = fprintf(outputFiles[f], "nan\n");
+				}
+				else
+				{
+					written = (column->storage == COLUMN_STORAGE_DOUBLE) ? fprintf(outputFiles[f], "%.17g\n", column->doubleValues[r])
+					                                                     : fprintf(outputFiles[f], "%lld\n", (long long)column->integerValues[r]);
+				}
+				if (written < 0)
+				{
+					perror("\n\nError writing to file in 'write_data_set_properties_plottable_fields'.");
+					exit(1);
+				}
+			}
+			if (properties->entryCount > 0)
+			{
+				fputc('\n', outputFiles[f]); // Each field ends with a blank line, as written by 'write_file_numeric_data'
+			}
+		}
+		fclose(plottableFieldFile);
+		free(plottableFieldFilePathName);
+	}
+	fclose(plottingDataFile);
+	
+	
+	free(plottingDataFilePathName);
+	free(plottableFieldsPathName);
+	free(fileName);
+	
+	return plottableFieldsDirectory;
+}
+
+
+
+
+
+/**
+ * write_data_set_properties_correlation_matrix
+ *
+ * Computes the covariance or correlation matrix of every numeric column of an ingested data set with 'compute_correlation_matrix',
+ * excluding nulls pair by pair, and writes it to a file next to the plottable fields directory, named after the data set and the
+ * measure(e.g., "<data set>_Pearson_Correlation_Matrix.txt"). The first line holds the names of the columns and each following line a
+ * column's name and its row of the matrix, separated by the data set's delimiter, with an undefined entry written as "nan". Double
+ * columns are read in place with their validity bitmaps, only integer columns are converted.
+ *
+ * @param properties The ingested data set.
+ * @param method The measure to compute.
+ * @return The path of the matrix file.
+ */
+char *write_data_set_properties_correlation_matrix(const DataSetProperties *properties, CorrelationMethod method)
+{
+	/// Gather the numeric columns as doubles
+	const double *columns[properties->fieldCount];
+	const uint64_t *validity[properties->fieldCount];
+	double *convertedColumns[properties->fieldCount];
+	const char *columnNames[properties->fieldCount];
+	int columnCount = 0;
+	for (int i = 0; i < properties->fieldCount; i++)
+	{
+		const DataColumn *column = &properties->columns[i];
+		if (column->storage == COLUMN_STORAGE_STRING)
+		{
+			continue;
+		}
+		
+		convertedColumns[columnCount] = (column->storage == COLUMN_STORAGE_DOUBLE) ? NULL : data_column_to_doubles(column, properties->entryCount);
+		columns[columnCount] = (column->storage == COLUMN_STORAGE_DOUBLE) ? column->doubleValues : convertedColumns[columnCount];
+		validity[columnCount] = column->validity;
+		columnNames[columnCount] = column->name;
+		columnCount++;
+	}
+	double *matrix = compute_correlation_matrix(columns, validity, columnCount, properties->entryCount, method, 0);
+	
+	
+	/// Write the matrix next to the plottable fields directory
+	const char *matrixNames[] = { "_Covariance_Matrix.txt", "_Pearson_Correlation_Matrix.txt", "_Spearman_Correlation_Matrix.txt" };
+	char *directoryPathName = find_file_directory_path(properties->filePathName);
+	char *dataSetFileName = find_name_from_path(properties->filePathName);
+	char *matrixFileName = combine_strings(dataSetFileName, matrixNames[method]);
+	char *matrixFilePathName = combine_strings(directoryPathName, matrixFileName);
+	FILE *matrixFile = fopen(matrixFilePathName, "w");
+	if (matrixFile == NULL)
+	{
+		perror("\n\nError opening file for writing in 'write_data_set_properties_correlation_matrix'.");
+		exit(1);
+	}
+	
+	fprintf(matrixFile, "field");
+	for (int j = 0; j < columnCount; j++)
+	{
+		fprintf(matrixFile, "%s%s", properties->delimiter, columnNames[j]);
+	}
+	for (int i = 0; i < columnCount; i++)
+	{
+		fprintf(matrixFile, "\n%s", columnNames[i]);
+		for (int j = 0; j < columnCount; j++)
+		{
+			if (fprintf(matrixFile, "%s%.17g", properties->delimiter, matrix[(size_t)i * columnCount + j]) < 0)
+			{
+				perror("\n\nError writing to file in 'write_data_set_properties_correlation_matrix'.");
+				exit(1);
+			}
+		}
+	}
+	fputc('\n', matrixFile);
+	fclose(matrixFile);
+	
+	
+	for (int c = 0; c < columnCount; c++)
+	{
+		free(convertedColumns[c]);
+	}
+	free(matrix);
+	free(directoryPathName);
+	free(dataSetFileName);
+	free(matrixFileName);
+	return matrixFilePathName;
+}
+
+
+
+
+
+/**
+ * print_data_set_properties_statistics
+ *
+ * Prints the statistics of every numeric column of an ingested data set: its number of nulls, mean, standard deviation, skewness,
+ * excess kurtosis, minimum, maximum, IQR, Freedman-Diaconis bin width, the number of its histogram's bins, and its Anderson-Darling
+ * statistic. Every one of them but the histogram is computed from the column's statistics cache(see 'data_column_statistics'), which
+ * holds only its present values, so nulls are skipped rather than counted as zeros, and the column is sorted once and its moments
+ * accumulated once however many statistics are printed. String columns only have their number of nulls printed.
+ *
+ * The quartiles behind the IQR and binning are found in the mode resolved by 'resolve_quantile_mode' for the column's number of
+ * present values. When it is QUANTILE_MODE_SKETCH the column is not sorted: a single quantile sketch, seeded with the index of the
+ * column, is built in one pass over the cached values, the IQR and bin width are both taken from it, and the Anderson-Darling
+ * statistic, which needs the sorted values, is not computed.
+ *
+ * The histograms of every numeric column are then counted together, with their IQRs found above, in a single pass over the table
+ * ('compute_data_columns_binning'), reading the columns in place with their nulls skipped through their validity bitmaps.
+ *
+ * @param properties The ingested data set, each numeric column keeps its statistics cache.
+ * @param quantileMode How the quartiles are found, QUANTILE_MODE_AUTOMATIC to find them exactly within EXACT_QUANTILE_MEMORY_BUDGET.
+ */
+void print_data_set_properties_statistics(DataSetProperties *properties, QuantileMode quantileMode)
+{
+	int fieldCount = properties->fieldCount;
+	int binnedColumnIndices[fieldCount > 0 ? fieldCount : 1]; // The index of each field's column among the binned columns, -1 if it is not binned
+	const double *binnedColumns[fieldCount > 0 ? fieldCount : 1];
+	const uint64_t *binnedValidity[fieldCount > 0 ? fieldCount : 1];
+	double *convertedValues[fieldCount > 0 ? fieldCount : 1];
+	double iqrs[fieldCount > 0 ? fieldCount : 1];
+	double binWidths[fieldCount > 0 ? fieldCount : 1];
+	double andersonDarlings[fieldCount > 0 ? fieldCount : 1];
+	int binnedColumnCount = 0;
+	
+	
+	/// Find the quartiles of each numeric column in its own mode
+	for (int i = 0; i < fieldCount; i++)
+	{
+		const DataColumn *column = &properties->columns[i];
+		ColumnStatisticsCache *statistics = data_column_statistics(properties, i);
+		binnedColumnIndices[i] = -1;
+		if (statistics == NULL || statistics->count < 2) // String columns, and columns with too few values to spread over a histogram
+		{
+			continue;
+		}
+		
+		
+		int b = binnedColumnCount++;
+		binnedColumnIndices[i] = b;
+		if (resolve_quantile_mode(quantileMode, statistics->count) == QUANTILE_MODE_EXACT)
+		{
+			iqrs[b] = compute_IQR_of_cached_column(statistics);
+			binWidths[b] = (iqrs[b] > 0.0) ? compute_bin_width_of_cached_column(statistics) : NAN; // The bin width is undefined for a zero IQR
+			andersonDarlings[b] = anderson_darling_normality_test_of_cached_column(statistics);
+		}
+		else
+		{
+			QuantileSketch *sketch = create_quantile_sketch(0, (uint64_t)i);
+			add_values_to_quantile_sketch(sketch, statistics->values, statistics->count);
+			double probabilities[2] = { 0.25, 0.75 };
+			double quartiles[2];
+			quantile_sketch_quantiles(sketch, probabilities, 2, quartiles);
+			iqrs[b] = quartiles[1] - quartiles[0];
+			binWidths[b] = (iqrs[b] > 0.0) ? compute_bin_width_from_quartiles(quartiles[0], quartiles[1], statistics->count) : NAN;
+			andersonDarlings[b] = NAN;
+			free_quantile_sketch(sketch);
+		}
+		
+		convertedValues[b] = (column->storage == COLUMN_STORAGE_DOUBLE) ? NULL : data_column_to_doubles(column, properties->entryCount);
+		binnedColumns[b] = (column->storage == COLUMN_STORAGE_DOUBLE) ? column->doubleValues : convertedValues[b];
+		binnedValidity[b] = column->validity;
+	}
+	
+	
+	/// Bin every numeric column in one pass over the table
+	Histogram *histograms = compute_data_columns_binning(binnedColumns, binnedValidity, iqrs, binnedColumnCount, properties->entryCount, 0);
+	
+	
+	printf("\n\n\n\nField Statistics: %s", properties->filePathName);
+	for (int i = 0; i < fieldCount; i++)
+	{
+		const DataColumn *column = &properties->columns[i];
+		int b = binnedColumnIndices[i];
+		if (b < 0)
+		{
+			printf("\n    Field %d: %-20s missing: %zu", i, column->name, column->missingCount);
+			continue;
+		}
+		
+		const MomentsAccumulator *moments = cached_moments(data_column_statistics(properties, i));
+		printf("\n    Field %d: %-20s missing: %-8zu mean: %-14g std dev: %-14g skewness: %-14g kurtosis: %-14g min: %-14g max: %-14g IQR: %-14g bin width: %-14g bins: %-6d A^2: %g",
+		       i, column->name, column->missingCount, moments->mean, moments_standard_deviation(moments), moments_skewness(moments), moments_excess_kurtosis(moments),
+		       moments->min, moments->max, iqrs[b], binWidths[b], histograms[b].num_bins, andersonDarlings[b]);
+	}
+	printf("\n");
+	
+	
+	for (int b = 0; b < binnedColumnCount; b++)
+	{
+		free_histogram(&histograms[b]);
+		free(convertedValues[b]);
+	}
+	free(histograms);
+}
+
+
+
+
+
+/**
+ * create_group_aggregate
+ *
+ * Creates the aggregate of a numeric column over a group holding no values.
+ *
+ * @return The empty aggregate.
+ */
+GroupAggregate create_group_aggregate(void)
+{
+	GroupAggregate aggregate = { 0, 0, 0.0, 0.0, 0.0, INFINITY, -INFINITY };
+	return aggregate;
+}
+
+
+
+
+/**
+ * add_to_group_aggregate
+ *
+ * Adds a value to the aggregate of a group, updating its mean and sum of squared deviations with Welford's method.
+ *
+ * @param aggregate The aggregate.
+ * @param value The value.
+ */
+void add_to_group_aggregate(GroupAggregate *aggregate, double value)
+{
+	aggregate->count++;
+	aggregate->sum += value;
+	double delta = value - aggregate->mean;
+	aggregate->mean += delta / (double)aggregate->count;
+	aggregate->M2 += delta * (value - aggregate->mean);
+	aggregate->min = (value < aggregate->min) ? value : aggregate->min;
+	aggregate->max = (value > aggregate->max) ? value : aggregate->max;
+}
+
+
+
+
+/**
+ * merge_group_aggregates
+ *
+ * Merges the aggregate of other values of a group into an aggregate, as 'merge_moments_accumulators' merges moments, so that the
+ * aggregates of different threads combine into the aggregate of all of their rows.
+ *
+ * @param aggregate The aggregate to merge into.
+ * @param otherAggregate The aggregate of the other values.
+ */
+void merge_group_aggregates(GroupAggregate *aggregate, const GroupAggregate *otherAggregate)
+{
+	if (otherAggregate->count > 0)
+	{
+		double count = (double)(aggregate->count + otherAggregate->count);
+		double delta = otherAggregate->mean - aggregate->mean;
+		aggregate->M2 += otherAggregate->M2 + delta * delta * (double)aggregate->count * (double)otherAggregate->count / count;
+		aggregate->mean += delta * (double)otherAggregate->count / count;
+		aggregate->count += otherAggregate->count;
+		aggregate->sum += otherAggregate->sum;
+		aggregate->min = (otherAggregate->min < aggregate->min) ? otherAggregate->min : aggregate->min;
+		aggregate->max = (otherAggregate->max > aggregate->max) ? otherAggregate->max : aggregate->max;
+	}
+	aggregate->nullCount += otherAggregate->nullCount;
+}
+
+
+
+
+/**
+ * group_aggregate_variance
+ *
+ * The sample variance of the values of a group.
+ *
+ * @param aggregate The aggregate.
+ * @return The variance, NAN with fewer than 2 values.
+ */
+double group_aggregate_variance(const GroupAggregate *aggregate)
+{
+	return (aggregate->count > 1) ? aggregate->M2 / (double)(aggregate->count - 1) : NAN;
+}
+
+
+
+
+/**
+ * create_group_by_table
+ *
+ * Creates an empty group-by table, an open-addressing hash table whose keys are the interned identifiers of a group's values in
+ * each key column, and whose entries are the group's aggregate of each value column.
+ *
+ * @param keyColumnCount The number of key columns.
+ * @param valueColumnCount The number of value columns.
+ * @return The table, to be released with 'free_group_by_table'.
+ */
+GroupByTable create_group_by_table(int keyColumnCount, int valueColumnCount)
+{
+	GroupByTable table;
+	table.keyColumnCount = keyColumnCount;
+	table.valueColumnCount = valueColumnCount;
+	table.groupCount = 0;
+	table.groupCapacity = 16;
+	table.slotCount = 32;
+	table.groupKeys = allocate_memory_int_ptr(table.groupCapacity * keyColumnCount);
+	table.groupHashes = (uint64_t *)malloc(table.groupCapacity * sizeof(uint64_t));
+	table.aggregates = (GroupAggregate *)malloc(table.groupCapacity * valueColumnCount * sizeof(GroupAggregate));
+	table.slots = allocate_memory_int_ptr(table.slotCount);
+	if (table.groupHashes == NULL || (valueColumnCount > 0 && table.aggregates == NULL))
+	{
+		perror("\n\nError: Unable to allocate memory in 'create_group_by_table'.\n");
+		exit(1);
+	}
+	memset(table.slots, 0xFF, table.slotCount * sizeof(int)); // Every slot starts empty(-1)
+	
+	return table;
+}
+
+
+
+
+/**
+ * free_group_by_table
+ *
+ * Releases the memory held by a group-by table.
+ *
+ * @param table The table.
+ */
+void free_group_by_table(GroupByTable *table)
+{
+	free(table->groupKeys);
+	free(table->groupHashes);
+	free(table->aggregates);
+	free(table->slots);
+	table->groupKeys = NULL;
+	table->groupHashes = NULL;
+	table->aggregates = NULL;
+	table->slots = NULL;
+	table->groupCount = 0;
+}
+
+
+
+
+/**
+ * hash_group_key
+ *
+ * Hashes the interned identifiers of a group's key values, mixing each into the hash with a multiply and shift.
+ *
+ * @param keyIds The identifier of the group's value in each key column.
+ * @param keyColumnCount The number of key columns.
+ * @return The hash.
+ */
+uint64_t hash_group_key(const int *keyIds, int keyColumnCount)
+{
+	uint64_t hash = 0x9E3779B97F4A7C15ull;
+	for (int k = 0; k < keyColumnCount; k++)
+	{
+		hash ^= (uint64_t)(uint32_t)keyIds[k];
+		hash *= 0xff51afd7ed558ccdull;
+		hash ^= hash >> 32;
+	}
+	return hash;
+}
+
+
+
+
+/**
+ * find_or_insert_group
+ *
+ * Finds the group with the given key in a group-by table, adding it with empty aggregates if it is not there yet. The slots are
+ * probed linearly, and doubled and rebuilt from the stored hashes whenever they become more than half full.
+ *
+ * @param table The table.
+ * @param keyIds The identifier of the group's value in each key column.
+ * @param hash The hash of the key(see 'hash_group_key').
+ * @return The index of the group.
+ */
+int find_or_insert_group(GroupByTable *table, const int *keyIds, uint64_t hash)
+{
+	int keyColumnCount = table->keyColumnCount;
+	size_t mask = (size_t)table->slotCount - 1;
+	size_t slot = hash & mask;
+	for (; table->slots[slot] >= 0; slot = (slot + 1) & mask)
+	{
+		int group = table->slots[slot];
+		if (table->groupHashes[group] == hash && memcmp(&table->groupKeys[group * keyColumnCount], keyIds, keyColumnCount * sizeof(int)) == 0)
+		{
+			return group;
+		}
+	}
+	
+	
+	/// Add the group
+	if (table->groupCount == table->groupCapacity)
+	{
+		table->groupCapacity *= 2;
+		table->groupKeys = (int *)realloc(table->groupKeys, table->groupCapacity * keyColumnCount * sizeof(int));
+		table->groupHashes = (uint64_t *)realloc(table->groupHashes, table->groupCapacity * sizeof(uint64_t));
+		table->aggregates = (GroupAggregate *)realloc(table->aggregates, table->groupCapacity * table->valueColumnCount * sizeof(GroupAggregate));
+		if (table->groupKeys == NULL || table->groupHashes == NULL || (table->valueColumnCount > 0 && table->aggregates == NULL))
+		{
+			perror("\n\nError: Unable to allocate memory in 'find_or_insert_group'.\n");
+			exit(1);
+		}
+	}
+	
+	int group = table->groupCount++;
+	memcpy(&table->groupKeys[group * keyColumnCount], keyIds, keyColumnCount * sizeof(int));
+	table->groupHashes[group] = hash;
+	for (int v = 0; v < table->valueColumnCount; v++)
+	{
+		table->aggregates[group * table->valueColumnCount + v] = create_group_aggregate();
+	}
+	table->slots[slot] = group;
+	
+	
+	/// Keep the slots at most half full
+	if (2 * table->groupCount > table->slotCount)
+	{
+		table->slotCount *= 2;
+		table->slots = (int *)realloc(table->slots, table->slotCount * sizeof(int));
+		if (table->slots == NULL)
+		{
+			perror("\n\nError: Unable to allocate memory in 'find_or_insert_group'.\n");
+			exit(1);
+		}
+		memset(table->slots, 0xFF, table->slotCount * sizeof(int));
+		mask = (size_t)table->slotCount - 1;
+		for (int g = 0; g < table->groupCount; g++)
+		{
+			size_t newSlot = table->groupHashes[g] & mask;
+			while (table->slots[newSlot] >= 0)
+			{
+				newSlot = (newSlot + 1) & mask;
+			}
+			table->slots[newSlot] = g;
+		}
+	}
+	
+	return group;
+}
+
+
+
+
+/**
+ * aggregate_group_by_rows
+ *
+ * Thread routine aggregating a range of rows into the task's own group-by table: each row's group is found from its interned key
+ * identifiers, and each present value of the row is added to the group's aggregate of its column, while each null is counted.
+ *
+ * @param task The GroupByTask to run.
+ * @return NULL.
+ */
+void *aggregate_group_by_rows(void *task)
+{
+	GroupByTask *groupByTask = (GroupByTask *)task;
+	GroupByTable *table = &groupByTask->table;
+	int keyColumnCount = table->keyColumnCount;
+	int valueColumnCount = table->valueColumnCount;
+	int keyIds[keyColumnCount];
+	for (int r = groupByTask->start; r < groupByTask->end; r++)
+	{
+		for (int k = 0; k < keyColumnCount; k++)
+		{
+			keyIds[k] = groupByTask->keyIds[k][r];
+		}
+		int group = find_or_insert_group(table, keyIds, hash_group_key(keyIds, keyColumnCount));
+		
+		GroupAggregate *aggregates = &table->aggregates[group * valueColumnCount];
+		for (int v = 0; v < valueColumnCount; v++)
+		{
+			double value = groupByTask->values[v][r];
+			if (!validity_bit_is_set(groupByTask->validity[v], (size_t)r) || isnan(value))
+			{
+				aggregates[v].nullCount++;
+				continue;
+			}
+			add_to_group_aggregate(&aggregates[v], value);
+		}
+	}
+	
+	return NULL;
+}
+
+
+
+
+/**
+ * group_data_set_by
+ *
+ * Groups the rows of an ingested data set by their values in one or more string(categorical) columns, and aggregates every numeric
+ * column over each group: its count, sum, mean, minimum, maximum, and variance, with nulls counted apart.
+ *
+ * The values of each key column are first interned('intern_string'), so the rest of the work hashes and compares small integers
+ * rather than strings. A null key value is given GROUP_BY_NULL_KEY_ID instead, so rows missing a key form groups of their own rather
+ * than joining the rows whose key is an empty string. The rows are then divided between several threads, each aggregating its rows into a group-by table of its own
+ * ('aggregate_group_by_rows'), and the tables are merged into the first at the end, in thread order, so the groups are in the order
+ * their first rows appear in the data set.
+ *
+ * @param properties The ingested data set.
+ * @param keyFieldIndices The indices of the key columns, each a string column.
+ * @param keyColumnCount The number of key columns.
+ * @param threadCount The number of threads, or 0 or less for every hardware thread.
+ * @return The groups and their aggregates, to be released with 'free_group_by_result'.
+ */
+GroupByResult group_data_set_by(const DataSetProperties *properties, const int *keyFieldIndices, int keyColumnCount, int threadCount)
+{
+	GroupByResult result;
+	int rowCount = properties->entryCount;
+	result.keyColumnCount = keyColumnCount;
+	result.keyFieldIndices = allocate_memory_int_ptr(keyColumnCount);
+	result.keyDictionaries = (StringInternTable *)malloc(keyColumnCount * sizeof(StringInternTable));
+	if (result.keyDictionaries == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'group_data_set_by'.\n");
+		exit(1);
+	}
 	
 	
-	int fieldCount = count_data_fields(fileContents[0]);
+	/// Intern the values of each key column, a null being given GROUP_BY_NULL_KEY_ID so it is not grouped with an empty string
+	int *keyIds[keyColumnCount];
+	for (int k = 0; k < keyColumnCount; k++)
+	{
+		const DataColumn *column = &properties->columns[keyFieldIndices[k]];
+		if (column->storage != COLUMN_STORAGE_STRING)
+		{
+			perror("\n\nError: A key column is not a string column in 'group_data_set_by'.\n");
+			exit(1);
+		}
+		
+		result.keyFieldIndices[k] = keyFieldIndices[k];
+		result.keyDictionaries[k] = create_string_intern_table(64);
+		keyIds[k] = allocate_memory_int_ptr(rowCount);
+		for (int r = 0; r < rowCount; r++)
+		{
+			keyIds[k][r] = validity_bit_is_set(column->validity, (size_t)r) ? intern_string(&result.keyDictionaries[k], data_column_string(column, (size_t)r)) : GROUP_BY_NULL_KEY_ID;
+		}
+	}
 	
 	
+	/// Every numeric column is a value column, read in place or, for an integer column, converted
+	result.valueFieldIndices = allocate_memory_int_ptr(properties->fieldCount);
+	result.valueColumnCount = 0;
+	const double *values[properties->fieldCount];
+	const uint64_t *validity[properties->fieldCount];
+	double *convertedValues[properties->fieldCount];
+	for (int i = 0; i < properties->fieldCount; i++)
+	{
+		const DataColumn *column = &properties->columns[i];
+		if (column->storage == COLUMN_STORAGE_STRING)
+		{
+			continue;
+		}
+		
+		int v = result.valueColumnCount++;
+		result.valueFieldIndices[v] = i;
+		convertedValues[v] = (column->storage == COLUMN_STORAGE_DOUBLE) ? NULL : data_column_to_doubles(column, rowCount);
+		values[v] = (column->storage == COLUMN_STORAGE_DOUBLE) ? column->doubleValues : convertedValues[v];
+		validity[v] = column->validity;
+	}
 	
 	
-	DataSetProperties dataSetProperties;
-	dataSetProperties.entryCount = lineCount;
-	dataSetProperties.fieldCount = fieldCount;
-	dataSetProperties.delimiter = delimiter;
-	dataSetProperties.header = fileContents[0];
-	dataSetProperties.fieldNameTypePairs =  capture_data_set_header_for_plotting(fileContents[0], fileContents, delimiter);
-	dataSetProperties.filePathName = filePathName;
+	/// Aggregate a range of rows per thread into thread-local tables
+	if (threadCount <= 0)
+	{
+		threadCount = determine_hardware_thread_count();
+	}
+	if (threadCount > rowCount / PARALLEL_GROUP_BY_MIN_ROWS)
+	{
+		threadCount = rowCount / PARALLEL_GROUP_BY_MIN_ROWS;
+	}
+	threadCount = (threadCount > 0) ? threadCount : 1;
 	
+	GroupByTask tasks[threadCount];
+	pthread_t threads[threadCount];
+	for (int t = 0; t < threadCount; t++)
+	{
+		tasks[t].keyIds = (const int *const *)keyIds;
+		tasks[t].values = values;
+		tasks[t].validity = validity;
+		tasks[t].start = (int)((int64_t)rowCount * t / threadCount);
+		tasks[t].end = (int)((int64_t)rowCount * (t + 1) / threadCount);
+		tasks[t].table = create_group_by_table(keyColumnCount, result.valueColumnCount);
+		if (t > 0 && pthread_create(&threads[t], NULL, aggregate_group_by_rows, &tasks[t]) != 0)
+		{
+			perror("\n\nError: Unable to create a thread in 'group_data_set_by'.\n");
+			exit(1);
+		}
+	}
+	aggregate_group_by_rows(&tasks[0]); // The calling thread takes the first range
 	
-	printf("\n\n\n\ndataSetProperties: ");
-	printf("\n\ndataSetHeader: %s", dataSetProperties.header);
-	printf("\ndelimiter: %s", dataSetProperties.delimiter);
-	printf("\nentryCount: %d        fieldCount: %d      ", dataSetProperties.entryCount, dataSetProperties.fieldCount);
 	
-	print_string_array(dataSetProperties.fieldNameTypePairs, dataSetProperties.fieldCount, "fieldNameTypePairs");
+	/// Merge the tables of the other threads into the first, in order
+	for (int t = 1; t < threadCount; t++)
+	{
+		pthread_join(threads[t], NULL);
+		GroupByTable *threadTable = &tasks[t].table;
+		for (int g = 0; g < threadTable->groupCount; g++)
+		{
+			int group = find_or_insert_group(&tasks[0].table, &threadTable->groupKeys[g * keyColumnCount], threadTable->groupHashes[g]);
+			for (int v = 0; v < result.valueColumnCount; v++)
+			{
+				merge_group_aggregates(&tasks[0].table.aggregates[group * result.valueColumnCount + v], &threadTable->aggregates[g * result.valueColumnCount + v]);
+			}
+		}
+		free_group_by_table(threadTable);
+	}
+	result.groups = tasks[0].table;
+	
+	
+	for (int k = 0; k < keyColumnCount; k++)
+	{
+		free(keyIds[k]);
+	}
+	for (int v = 0; v < result.valueColumnCount; v++)
+	{
+		free(convertedValues[v]);
+	}
+	return result;
+}
+
+
+
+
+/**
+ * print_group_by_result
+ *
+ * Prints each group of a group-by, by its key values(a null as <null>), followed by the aggregates of every value column over it.
+ *
+ * @param result The group-by result.
+ * @param properties The data set it was computed from, for the names of the columns.
+ */
+void print_group_by_result(const GroupByResult *result, const DataSetProperties *properties)
+{
+	printf("\n\n\n\nGroups by");
+	for (int k = 0; k < result->keyColumnCount; k++)
+	{
+		printf(" %s", properties->columns[result->keyFieldIndices[k]].name);
+	}
+	printf(": %d", result->groups.groupCount);
 	
-	for (int i = 0; i < dataSetProperties.entryCount; i++)
+	for (int g = 0; g < result->groups.groupCount; g++)
+	{
+		printf("\n\n  Group");
+		for (int k = 0; k < result->keyColumnCount; k++)
+		{
+			int keyId = result->groups.groupKeys[g * result->keyColumnCount + k];
+			if (keyId == GROUP_BY_NULL_KEY_ID)
+			{
+				printf(" <null>");
+				continue;
+			}
+			FieldSpan keyValue = interned_string(&result->keyDictionaries[k], keyId);
+			printf(" '%.*s'", (int)keyValue.length, keyValue.start);
+		}
+		for (int v = 0; v < result->valueColumnCount; v++)
+		{
+			const GroupAggregate *aggregate = &result->groups.aggregates[g * result->valueColumnCount + v];
+			printf("\n    %-20s count: %-10lld nulls: %-8lld sum: %-14g mean: %-14g min: %-14g max: %-14g variance: %g", properties->columns[result->valueFieldIndices[v]].name,
+			       (long long)aggregate->count, (long long)aggregate->nullCount, aggregate->sum, (aggregate->count > 0) ? aggregate->mean : NAN,
+			       aggregate->min, aggregate->max, group_aggregate_variance(aggregate));
+		}
+	}
+	printf("\n");
+}
+
+
+
+
+/**
+ * print_data_set_properties_groups
+ *
+ * Aggregates the numeric columns of an ingested data set over groups of its rows with 'group_data_set_by', and prints the groups.
+ * The columns the string values of which 'capture_data_set_for_plotting' leaves out are what the groups are keyed by: either the
+ * caller's key columns together, or, if none are given, each string column found by 'analyze_data_set_properties' on its own. A
+ * string column grouped by on its own is only printed if it has at most GROUP_BY_MAX_CATEGORY_GROUPS groups, as a column with more
+ * (e.g., names or identifiers) is not a category, only its number of groups is printed.
+ *
+ * @param properties The ingested data set.
+ * @param keyFieldIndices The indices of the key columns, each a string column, or NULL to group by each string column in turn.
+ * @param keyColumnCount The number of key columns, 0 to group by each string column in turn.
+ */
+void print_data_set_properties_groups(const DataSetProperties *properties, const int *keyFieldIndices, int keyColumnCount)
+{
+	if (keyFieldIndices != NULL && keyColumnCount > 0)
 	{
-		//printf("\n%s", dataSetProperties.fieldNameTypePairs[i]);
-		//printf("\n%s", dataSetProperties.fieldNameTypePairs[i]);
+		for (int k = 0; k < keyColumnCount; k++)
+		{
+			if (keyFieldIndices[k] < 0 || keyFieldIndices[k] >= properties->fieldCount || properties->columns[keyFieldIndices[k]].storage != COLUMN_STORAGE_STRING)
+			{
+				perror("\n\nError: A key field is not a string field of the data set in 'print_data_set_properties_groups'.\n");
+				return;
+			}
+		}
 		
+		GroupByResult groups = group_data_set_by(properties, keyFieldIndices, keyColumnCount, 0);
+		print_group_by_result(&groups, properties);
+		free_group_by_result(&groups);
+		return;
 	}
 	
-	return dataSetProperties;
+	
+	/// Group by each string column on its own
+	for (int i = 0; i < properties->fieldCount; i++)
+	{
+		if (properties->columns[i].storage != COLUMN_STORAGE_STRING)
+		{
+			continue;
+		}
+		
+		GroupByResult groups = group_data_set_by(properties, &i, 1, 0);
+		if (groups.groups.groupCount <= GROUP_BY_MAX_CATEGORY_GROUPS)
+		{
+			print_group_by_result(&groups, properties);
+		}
+		else
+		{
+			printf("\n\n\n\nGroups by %s: %d, too many for a category, not printed\n", properties->columns[i].name, groups.groups.groupCount);
+		}
+		free_group_by_result(&groups);
+	}
+}
+
+
+
+
+/**
+ * free_group_by_result
+ *
+ * Releases the memory held by the result of 'group_data_set_by'.
+ *
+ * @param result The group-by result.
+ */
+void free_group_by_result(GroupByResult *result)
+{
+	for (int k = 0; k < result->keyColumnCount; k++)
+	{
+		free_string_intern_table(&result->keyDictionaries[k]);
+	}
+	free(result->keyDictionaries);
+	free(result->keyFieldIndices);
+	free(result->valueFieldIndices);
+	free_group_by_table(&result->groups);
+	result->keyDictionaries = NULL;
+	result->keyFieldIndices = NULL;
+	result->valueFieldIndices = NULL;
+	result->keyColumnCount = 0;
+	result->valueColumnCount = 0;
 }
 
 
@@ -67,6 +1361,10 @@ DataSetProperties analyze_data_set_properties(const char *filePathName)
  * The function takes in the file contents, line count, field count, and delimiter as parameters. It returns an array of arrays of strings,
  * where each of the ith subarrays of the highest level array is a representation of the ith data set fields and all the entries within it.
  *
+ * Every line is viewed as field spans, twice: the first pass totals the lengths of the fields, so that all of them can be copied into a
+ * single block by the second, rather than duplicating every line and then every field of every line. The strings of the result all point
+ * into that block, which is owned by 'separatedData[0][0]' and is released along with the arrays by 'free_parsed_file_contents'.
+ *
  * @param fileContents Constant character pointer to the string containing the data.
  * @param lineCount Constant character pointer to the string containing the  data.
  * @param fieldCount Pointer to the integer value representing the number of paramaters a data set has.
@@ -77,27 +1375,47 @@ char*** parse_entire_file(char **fileContents, int lineCount, int* fieldCount, c
 	// Capture the header of the data set for plotting
 	char **fileHeader = capture_data_set_header_for_plotting(fileContents[0], fileContents, delimiter);
 	int fieldCountCopy = count_data_fields(fileContents[0]);
+	const char *typeDelimiter = identify_delimiter(fileHeader, fieldCountCopy);
 	
 	
 	
-	/// Capture the Data Field Names in a Single String Without the typeDelimiters
-	const char *fieldNames[fieldCountCopy]; //The string of field names as they appear in the first element of the fileContents array of strings
+	/// Capture the Data Field Names as the first span of each header field split by the typeDelimiter, and total the lengths of every string to be stored
+	FieldSpan *rowFields = malloc(fieldCountCopy * sizeof(FieldSpan)); // Reused for every line
+	FieldSpan *fieldNames = malloc(fieldCountCopy * sizeof(FieldSpan));
+	size_t contentsSize = 1; // The empty string shared by the entries missing from a line
 	for (int i = 0; i < fieldCountCopy; i++)
 	{
-		const char *typeDelimiter = identify_delimiter(fileHeader, fieldCountCopy);
-		
-		// Split the token by the type delimiter to get the name
-		char* typeDelimiterToken = strtok(fileHeader[i], typeDelimiter);
-		if (typeDelimiterToken)
+		if (split_string_into_field_spans(fileHeader[i], typeDelimiter, &fieldNames[i], 1) == 0)
+		{
+			fieldNames[i].start = "";
+			fieldNames[i].length = 0;
+		}
+		contentsSize += fieldNames[i].length + 1;
+	}
+	for (int line = 1; line < lineCount; line++)
+	{
+		RowView rowView = create_row_view(fileContents[line], delimiter, rowFields, fieldCountCopy);
+		for (int i = 0; i < rowView.fieldCount; i++)
 		{
-			// Duplicate the token to the field names
-			fieldNames[i] = strdup(typeDelimiterToken);
+			contentsSize += rowView.fields[i].length + 1;
 		}
 	}
 	
 	
-	// Allocate array of string arrays for each member
+	// Allocate array of string arrays for each member, and the single block holding all of their strings
 	char*** separatedData = malloc(fieldCountCopy * sizeof(char**));
+	char *parsedContents = malloc(contentsSize);
+	if (!separatedData || !parsedContents)
+	{
+		free(separatedData);
+		free(parsedContents);
+		free(rowFields);
+		free(fieldNames);
+		*fieldCount = 0;
+		return NULL;
+	}
+	char *nextString = parsedContents; // The key names come first, so the first of them owns the block
+	
 	
 	// Initialize arrays for each member
 	for (int i = 0; i < fieldCountCopy; i++)
@@ -112,37 +1430,46 @@ char*** parse_entire_file(char **fileContents, int lineCount, int* fieldCount, c
 				free(separatedData[i]);
 			}
 			free(separatedData);
+			free(parsedContents);
+			free(rowFields);
+			free(fieldNames);
 			*fieldCount = 0;
 			return NULL;
 		}
 		
 		
 		// Copy the key name
-		separatedData[i][0] = strdup(fieldNames[i]);
-		// Free fieldNames elements
-		free((void*)fieldNames[i]);
+		copy_memory_block(nextString, fieldNames[i].start, fieldNames[i].length);
+		nextString[fieldNames[i].length] = '\0';
+		separatedData[i][0] = nextString;
+		nextString += fieldNames[i].length + 1;
 	}
+	char *emptyEntry = nextString; // The empty string shared by the entries missing from a line
+	*nextString++ = '\0';
 	
 	
 	// Parse the data
 	for (int line = 1; line < lineCount; line++) // Start from line 1 to skip header
 	{
-		// Duplicate the data
-		char* dataCopy = strdup(fileContents[line]);
-		
-		// Tokenize the data
-		char* token = strtok(dataCopy, delimiter);
-		for (int i = 0; i < fieldCountCopy && token; i++)
+		RowView rowView = create_row_view(fileContents[line], delimiter, rowFields, fieldCountCopy);
+		for (int i = 0; i < fieldCountCopy; i++)
 		{
-			// Store the token in the separated data
-			separatedData[i][line] = strdup(token);
+			if (i >= rowView.fieldCount)
+			{
+				separatedData[i][line] = emptyEntry;
+				continue;
+			}
+			
 			
-			// Get the next token
-			token = strtok(NULL, delimiter);
+			// Store the field in the separated data
+			copy_memory_block(nextString, rowView.fields[i].start, rowView.fields[i].length);
+			nextString[rowView.fields[i].length] = '\0';
+			separatedData[i][line] = nextString;
+			nextString += rowView.fields[i].length + 1;
 		}
-		// Free the duplicated data
-		free(dataCopy);
 	}
+	free(rowFields);
+	free(fieldNames);
 	
 	// Update the field count
 	*fieldCount = fieldCountCopy;
@@ -152,6 +1479,36 @@ char*** parse_entire_file(char **fileContents, int lineCount, int* fieldCount, c
 
 
 
+/**
+ * free_parsed_file_contents
+ *
+ * Releases the arrays returned by 'parse_entire_file' along with the single block that holds all of their strings.
+ *
+ * @param separatedData The arrays returned by 'parse_entire_file'.
+ * @param fieldCount The number of fields, as returned by 'parse_entire_file'.
+ */
+void free_parsed_file_contents(char ***separatedData, int fieldCount)
+{
+	if (separatedData == NULL)
+	{
+		return;
+	}
+	
+	
+	if (fieldCount > 0)
+	{
+		free(separatedData[0][0]); // Owns the block holding every string
+	}
+	for (int i = 0; i < fieldCount; i++)
+	{
+		free(separatedData[i]);
+	}
+	free(separatedData);
+}
+
+
+
+
 /**
  * count_missing_values
  *
@@ -184,52 +1541,64 @@ int* count_missing_values(char** fileContents, int lineCount, int fieldCount, co
 		return NULL;
 	}
 	
-	// Analyze the data types based on the header line (assuming first line is the header)
-	char **dataTypes = determine_data_entry_types(fileContents[1], fieldCount, delimiter);
+	// Analyze the data types based on the first data entry, once, for every line
+	DataSetSchema schema = infer_data_set_schema(fileContents[1], fieldCount, delimiter);
+	FieldSpan fields[(fieldCount > 0) ? fieldCount : 1];
 	
-	/// Iterate over each line in the dataset, tokenizing the line based on the delimiter, and checking each token.
+	/// Iterate over each line in the dataset, viewing the line's fields in place, and checking each field.
 	for (int i = 1; i < lineCount; i++) // Start from 1 to skip the header
 	{
-		char *dataCopy = strdup(fileContents[i]);
-		char *token = strtok(dataCopy, delimiter);
-		int fieldIndex = 0;
-		
-		
-		/// Check each token
-		while (token && fieldIndex < fieldCount)
+		RowView rowView = create_row_view(fileContents[i], delimiter, fields, fieldCount);
+		for (int fieldIndex = 0; fieldIndex < rowView.fieldCount; fieldIndex++)
 		{
-			while (isspace((unsigned char)*token)) token++; // Trim leading spaces from the token
-			
-			const char *typeDataEntry = determine_string_representation_type(token);
-			
-			
-			
-			/// Here the delimited value is nothing but a hyphen "-". This field is assumed to be a missing value(either N/A or not available)
-			/// Furthermore, to ensure the value is not being used as a minus sign, a check is made to ensure the token is nonnumeric
-			if (strcmp(token, "-") == 0 && strcmp(dataTypes[fieldIndex], "nonnumeric") == 0 )
+			FieldSpan field = rowView.fields[fieldIndex];
+			while (field.length > 0 && isspace((unsigned char)*field.start)) // Trim leading spaces from the field
 			{
-				missingDataCount[fieldIndex]++;  // This field is assumed to be a missing value(either N/A or not available)
+				field.start++;
+				field.length--;
 			}
-			else if (strcmp(typeDataEntry, dataTypes[fieldIndex]) != 0) //The determined data type does not match the expected data type
+			
+			if (is_missing_field_value(field, schema.fieldTypes[fieldIndex]))
 			{
 				missingDataCount[fieldIndex]++;
 			}
-			
-			
-			token = strtok(NULL, delimiter);
-			fieldIndex++;
 		}
-		
-		free(dataCopy);
 	}
 	
-	for (int i = 0; i < fieldCount; i++)
+	free_data_set_schema(&schema);
+	
+	return missingDataCount; // Return the count of missing or incorrectly formatted values for each field
+}
+
+
+
+
+/**
+ * is_missing_data_entry_field
+ *
+ * Determines if the value of a single field of a data entry is missing or incorrectly formatted.
+ * An empty value is always missing. A value consisting of nothing but a hyphen "-" in a field expected to be nonnumeric is assumed to be a missing value(either N/A or not available),
+ * the check on the expected type ensuring that the hyphen is not being used as a minus sign. Any value whose determined data type does not match the
+ * expected data type of its field is considered incorrectly formatted.
+ *
+ * @param token The value of the field, with leading spaces already trimmed.
+ * @param expectedType The expected data type of the field("numeric" or "nonnumeric").
+ * @return 1 if the value is missing or incorrectly formatted, 0 otherwise.
+ */
+int is_missing_data_entry_field(const char *token, const char *expectedType)
+{
+	FieldType expectedFieldType = FIELD_TYPE_UNDETERMINED; // Any other type name matches no value
+	if (strcmp(expectedType, "numeric") == 0)
+	{
+		expectedFieldType = FIELD_TYPE_NUMERIC;
+	}
+	else if (strcmp(expectedType, "nonnumeric") == 0)
 	{
-		free(dataTypes[i]);
+		expectedFieldType = FIELD_TYPE_NONNUMERIC;
 	}
-	free(dataTypes);
 	
-	return missingDataCount; // Return the count of missing or incorrectly formatted values for each field
+	FieldSpan field = { token, strlen(token) };
+	return is_missing_field_value(field, expectedFieldType);
 }
 
 
@@ -280,7 +1649,8 @@ char** capture_data_set_header_for_plotting(char* headerContents, char** fileCon
 	//printf("\n\ntypeDelimiter: %s\n", typeDelimiter);
 	
 	// Tokenize the header and pair each field with its data type.
-	char* token = strtok(headerCopy, delimiter);
+	StringTokenizer tokenizer = create_string_tokenizer(headerCopy, delimiter);
+	char* token = next_string_token(&tokenizer);
 	int formatIndex = 0;
 	while(token && formatIndex < fieldCount)
 	{
@@ -291,7 +1661,7 @@ char** capture_data_set_header_for_plotting(char* headerContents, char** fileCon
 		
 		// Get the next token
 		formatIndex++;
-		token = strtok(NULL, delimiter);
+		token = next_string_token(&tokenizer);
 	}
 	free(headerCopy);
 	
@@ -305,56 +1675,161 @@ char** capture_data_set_header_for_plotting(char* headerContents, char** fileCon
 
 
 
-
-
+
+
+/**
+ * determine_data_entry_types
+ *
+ * Determines the data types of fields in a data entry.
+ * Analyzes a line from the dataset to infer the data type of each field.
+ * It helps in understanding the kind of data each field in the dataset holds.
+ *
+ * @param dataEntry A string containing a line from the dataset.
+ * @param fieldCount The number of fields in the data entry.
+ * @param delimiter The character used as a delimiter in the dataset.
+ * @return An array of strings where each string represents the inferred data type of a field.
+ */
+char** determine_data_entry_types(const char *dataEntry, int fieldCount, const char *delimiter)
+{
+	DataSetSchema schema = infer_data_set_schema(dataEntry, fieldCount, delimiter);
+	
+	
+	// Allocate memory for storing data types of each field, fields the data entry does not have are left as empty strings.
+	char** dataFields = (char**)malloc(fieldCount * sizeof(char*));
+	for(int i = 0; i < fieldCount; i++)
+	{
+		dataFields[i] = strdup(field_type_name(schema.fieldTypes[i]));
+	}
+	
+	
+	free_data_set_schema(&schema);
+	return dataFields;
+}
+
+
+
+
+/**
+ * determine_field_type
+ *
+ * Determines the data type of a single value, with the same rules as 'determine_string_representation_type': a value that parses as a
+ * number in its entirety is numeric, anything else(including a lone hyphen) is nonnumeric. The value is classified in place.
+ *
+ * @param field The value to be classified.
+ * @return FIELD_TYPE_NUMERIC or FIELD_TYPE_NONNUMERIC.
+ */
+FieldType determine_field_type(FieldSpan field)
+{
+	double value;
+	return parse_numeric_string(field.start, field.length, &value) ? FIELD_TYPE_NUMERIC : FIELD_TYPE_NONNUMERIC;
+}
+
+
+
+
+/**
+ * field_type_name
+ *
+ * Returns the string representation of a data type used throughout the program's string based type arrays.
+ *
+ * @param fieldType The data type.
+ * @return "numeric", "nonnumeric", or "" for an undetermined type.
+ */
+const char *field_type_name(FieldType fieldType)
+{
+	switch (fieldType)
+	{
+		case FIELD_TYPE_NUMERIC:
+			return "numeric";
+		case FIELD_TYPE_NONNUMERIC:
+			return "nonnumeric";
+		default:
+			return "";
+	}
+}
+
+
+
+
+/**
+ * infer_data_set_schema
+ *
+ * Infers the expected data type of each field of a data set from its format line(the first data entry). This is the only point at which
+ * the format line is examined, the resulting schema is then passed to the functions formatting each data entry.
+ * Fields beyond the last value of the format line are FIELD_TYPE_UNDETERMINED. An empty value, or a lone hyphen, is a missing value and
+ * carries no type of its own, its field is expected to be numeric so that a numeric field missing its first value is not taken for text.
+ *
+ * @param formatLine The line whose values establish the expected types, it is not modified.
+ * @param fieldCount The number of fields per data entry.
+ * @param delimiter The delimiter of the data set, the schema refers to it rather than copying it.
+ * @return The schema, to be released with 'free_data_set_schema'.
+ */
+DataSetSchema infer_data_set_schema(const char *formatLine, int fieldCount, const char *delimiter)
+{
+	DataSetSchema schema;
+	schema.fieldCount = (fieldCount > 0) ? fieldCount : 0;
+	schema.delimiter = delimiter;
+	schema.fieldTypes = (FieldType*)calloc((schema.fieldCount > 0) ? schema.fieldCount : 1, sizeof(FieldType)); // FIELD_TYPE_UNDETERMINED is 0
+	if (schema.fieldTypes == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'infer_data_set_schema'.\n");
+		exit(1);
+	}
+	
+	
+	FieldSpan fields[(schema.fieldCount > 0) ? schema.fieldCount : 1];
+	RowView formatRow = create_delimited_row_view(formatLine, delimiter, fields, schema.fieldCount);
+	for (int i = 0; i < formatRow.fieldCount; i++)
+	{
+		FieldSpan field = formatRow.fields[i];
+		bool isMissing = (field.length == 0 || (field.length == 1 && field.start[0] == '-'));
+		schema.fieldTypes[i] = isMissing ? FIELD_TYPE_NUMERIC : determine_field_type(field);
+	}
+	
+	return schema;
+}
+
+
+
+
+/**
+ * free_data_set_schema
+ *
+ * Releases the memory held by a schema created by 'infer_data_set_schema'.
+ *
+ * @param schema The schema to be released.
+ */
+void free_data_set_schema(DataSetSchema *schema)
+{
+	free(schema->fieldTypes);
+	schema->fieldTypes = NULL;
+	schema->fieldCount = 0;
+}
+
+
+
+
 /**
- * determine_data_entry_types
+ * is_missing_field_value
  *
- * Determines the data types of fields in a data entry.
- * Analyzes a line from the dataset to infer the data type of each field.
- * It helps in understanding the kind of data each field in the dataset holds.
+ * Determines if a value is missing or does not match the expected type of its field, with the same rules as 'is_missing_data_entry_field'.
  *
- * @param dataEntry A string containing a line from the dataset.
- * @param fieldCount The number of fields in the data entry.
- * @param delimiter The character used as a delimiter in the dataset.
- * @return An array of strings where each string represents the inferred data type of a field.
+ * @param field The value to be checked.
+ * @param expectedType The expected type of the value's field.
+ * @return 1 if the value is missing or of the wrong type, 0 otherwise.
  */
-char** determine_data_entry_types(const char *dataEntry, int fieldCount, const char *delimiter)
+int is_missing_field_value(FieldSpan field, FieldType expectedType)
 {
-	// Increase the buffer size to accommodate additional characters
-	size_t characterCount = (strlen(dataEntry) + 1) * 3;
-	
-	// Allocate memory for storing data types of each field.
-	char** dataFields = allocate_memory_char_ptr_ptr(characterCount, fieldCount);
-	
-	// Initialize the dataFields array with empty strings.
-	for(int i = 0; i < fieldCount; i++)
+	if (field.length == 0)
 	{
-		strcpy(dataFields[i], "\0");
+		return 1; // An empty field is a missing value whatever its expected type
 	}
-	
-	
-	int fieldIndex = 0;
-	char* dataCopy = strdup(dataEntry); // Create a copy of dataEntry to use with strtok (as it modifies the string)
-	char* token = strtok(dataCopy, delimiter); // Tokenize and analyze each field
-	while(token && fieldIndex < fieldCount)
+	if (field.length == 1 && field.start[0] == '-' && expectedType == FIELD_TYPE_NONNUMERIC)
 	{
-		// Check if the token is a double to determine the type of the field
-		const char* type = determine_string_representation_type(token);
-		strncat(dataFields[fieldIndex], type, characterCount - strlen(dataFields[fieldIndex]) - 1);
-		
-		// Get the next token
-		fieldIndex++;
-		token = strtok(NULL, delimiter);
-		
+		return 1; // This field is assumed to be a missing value(either N/A or not available)
 	}
 	
-	
-	free(dataCopy);
-	
-	//print_string_array(dataFields, fieldCount, "determine_data_entry_types");
-	
-	return dataFields;
+	return determine_field_type(field) != expectedType; //The determined data type does not match the expected data type
 }
 
 
@@ -399,8 +1874,9 @@ char** determine_common_data_entry_types(const char **dataEntries, int entryCoun
 	// Loop through each data entry.
 	for(int i = 0; i < entryCount; i++)
 	{
-		char* dataCopy = strdup(dataEntries[i]); // Create a copy to use with strtok (as it modifies the string)
-		char* token = strtok(dataCopy, delimiter);
+		char* dataCopy = strdup(dataEntries[i]); // Create a copy to tokenize (as tokenizing modifies the string)
+		StringTokenizer tokenizer = create_string_tokenizer(dataCopy, delimiter);
+		char* token = next_string_token(&tokenizer);
 		int fieldIndex = 0;
 		
 		// Tokenize and analyze each field in the current data entry.
@@ -410,7 +1886,7 @@ char** determine_common_data_entry_types(const char **dataEntries, int entryCoun
 			dataTypesPerField[fieldIndex] = (char**)realloc(dataTypesPerField[fieldIndex], (i+1) * sizeof(char*));
 			dataTypesPerField[fieldIndex][i] = strdup(type);
 			fieldIndex++;
-			token = strtok(NULL, delimiter);
+			token = next_string_token(&tokenizer);
 		}
 		
 		free(dataCopy);
@@ -457,8 +1933,10 @@ char** determine_common_data_entry_types(const char **dataEntries, int entryCoun
  *
  * Formats a data entry for plotting by ensuring each field is of the correct data type.
  * Primarily used for preparing data lines for plotting where data types need to be consistent.
- * The function processes a line from the dataset, converting fields to a default value if they don't match
- * the expected data type (i.e., replacing non-numeric values with '0.0' in numeric fields).
+ * The function processes a line from the dataset, marking fields that don't match the expected data type as missing
+ * (i.e., writing non-numeric values in numeric fields as "nan", and dropping the value of any other field, leaving it empty).
+ * The expected types are inferred from 'headerLine' on every call, when formatting many entries infer them once with
+ * 'infer_data_set_schema' and use 'format_data_entry_with_schema'.
  *
  * @param headerLine The header line of the dataset.
  * @param dataEntry A line from the dataset.
@@ -467,103 +1945,119 @@ char** determine_common_data_entry_types(const char **dataEntries, int entryCoun
  * @return A new string with the formatted data entry.
  */
 char *format_data_entry_for_plotting(char *headerLine, char* dataEntry, int fieldCount, const char *delimiter)
+{
+	DataSetSchema schema = infer_data_set_schema(headerLine, fieldCount, delimiter);
+	char *formattedDataEntry = format_data_entry_with_schema(&schema, dataEntry);
+	free_data_set_schema(&schema);
+	
+	return formattedDataEntry;
+}
+
+
+
+
+/**
+ * format_data_entry_with_schema
+ *
+ * Formats a data entry for plotting by ensuring each field is of the data type its schema expects, exactly as 'format_data_entry_for_plotting'
+ * does, but with the expected types already inferred, so the only per-field work is classifying the field's own value. The fields are
+ * viewed in place and written directly into a single output buffer.
+ *
+ * @param schema The expected type of each field and the delimiter, from 'infer_data_set_schema'.
+ * @param dataEntry A line from the dataset, it is not modified.
+ * @return A new string with the formatted data entry, or NULL if 'dataEntry' is NULL.
+ */
+char *format_data_entry_with_schema(const DataSetSchema *schema, const char *dataEntry)
+{
+	return format_data_entry_with_schema_in_arena(NULL, schema, dataEntry);
+}
+
+
+
+
+/**
+ * format_data_entry_with_schema_in_arena
+ *
+ * Formats a data entry exactly as 'format_data_entry_with_schema' does, with the formatted entry allocated from an arena instead of with
+ * malloc. Memory from an arena is not shrunk to fit, since it is released with the rest of the batch.
+ *
+ * @param arena The arena to allocate the formatted entry from, or NULL to allocate it with malloc.
+ * @param schema The expected type of each field and the delimiter, from 'infer_data_set_schema'.
+ * @param dataEntry A line from the dataset, it is not modified.
+ * @return A new string with the formatted data entry, or NULL if 'dataEntry' is NULL.
+ */
+char *format_data_entry_with_schema_in_arena(MemoryArena *arena, const DataSetSchema *schema, const char *dataEntry)
 {
 	if (!dataEntry)
 	{
-		perror("\n\nError: NULL argument provided for dataEntry in 'format_data_entry_for_plotting'.");
+		perror("\n\nError: NULL argument provided for dataEntry in 'format_data_entry_with_schema_in_arena'.");
 		return NULL;
 	}
 	
 	
 	
-	// Create a buffer for the formatted data entry, making it larger to accommodate potential changes
-	size_t bufferSize = strlen(dataEntry) + fieldCount * 4; // Extra space for "0.0" and commas
-	char* formattedDataEntry = allocate_memory_char_ptr(bufferSize);
+	// Create a buffer for the formatted data entry, large enough for a "nan" and a delimiter per field on top of the entry itself
+	int fieldCount = schema->fieldCount;
+	const char *delimiter = schema->delimiter;
+	size_t delimiterLength = strlen(delimiter);
+	size_t bufferSize = strlen(dataEntry) + fieldCount * (3 + delimiterLength) + 1;
+	char* formattedDataEntry = allocate_memory_char_ptr_in_arena(arena, bufferSize);
+	char *writePtr = formattedDataEntry;
 	
-	strcpy(&formattedDataEntry[0], "\0"); // Initialize the string empty
-	char* dataCopy = strdup(dataEntry);
-	char* token;
-	char* saveptr = dataCopy;
-	token = strtok_r(dataCopy, delimiter, &saveptr);
-	int formatIndex = 0;
-	
-	
-	// Determine the data types for each field in the header.
-	char** dataTypes = determine_data_entry_types(headerLine, fieldCount, delimiter);
-	if (!dataTypes)
-	{
-		perror("\n\nError: NULL dataTypes in 'format_data_entry_for_plotting'.");
-		free(formattedDataEntry);
-		return NULL;
-	}
+	FieldSpan fields[(fieldCount > 0) ? fieldCount : 1];
+	RowView rowView = create_delimited_row_view(dataEntry, delimiter, fields, fieldCount);
 	
 	
 	// Process each field based on its data type.
-	while(token && formatIndex < fieldCount)
+	for (int formatIndex = 0; formatIndex < rowView.fieldCount; formatIndex++)
 	{
-		// Trim leading spaces from the token
-		while (isspace((unsigned char)*token)) token++;
-		
-		// Determine the type of data in the token.
-		const char* typeDataEntry = determine_string_representation_type(token);
-		
-		
-		/// Handling incorrectly formatted fields.
-		if (strcmp(token, "-") == 0) // Incorrectly formatted field, effectively a missing/blank value.
+		// Trim leading spaces from the field
+		FieldSpan field = rowView.fields[formatIndex];
+		while (field.length > 0 && isspace((unsigned char)*field.start))
 		{
-			// If the field/token is comprised of only a single character(between delimiters within a data entry) which is found to be a hyphen, "-", then it is treated as a blank or missing space
-			// As a result of the missing value for the field being represented as a nonnumeric character, the hyphen, then only the expected data type is relevant.
-			if (strcmp(dataTypes[formatIndex], "numeric") == 0) // If the missing field was expected to be a numeric value, append a default value in place of the missing field.
-			{
-				strcat(formattedDataEntry, "0.0"); // Replace with default numeric value.
-			}
-			else if(strcmp(dataTypes[formatIndex], "numeric") != 0 ) // This "missing" field should be a nonnumeric value, append the hyphen as is or append some sort of arbitrary substitute(such as 0.0), so long as the functions for extracting numeric plottable data are not affected.
-			{
-				strcat(formattedDataEntry, "0.0"); // Replace with default numeric value... temporary, ideally the entire data set should adjust itself to ensure data is consistent.
-			}
+			field.start++;
+			field.length--;
 		}
-		else if (strcmp(typeDataEntry, dataTypes[formatIndex]) != 0) //The determined data type does not match the expected data type
+		FieldType expectedType = schema->fieldTypes[formatIndex];
+		
+		
+		/// Handling missing and incorrectly formatted fields, a lone hyphen is effectively a missing/blank value.
+		/// No value is substituted for them, a numeric field is written as "nan" so it keeps its position without being mistaken for a zero.
+		if ((field.length == 1 && field.start[0] == '-') || determine_field_type(field) != expectedType) //The determined data type does not match the expected data type
 		{
-			if (strcmp(dataTypes[formatIndex], "numeric") == 0) // Will be true when the field should have a numeric value but instead has a non-numeric value
+			if (expectedType == FIELD_TYPE_NUMERIC) // Will be true when the field should have a numeric value but instead has a non-numeric value
 			{
-				strcat(formattedDataEntry, "0.0"); // Replace non-numeric values in numeric fields.
+				copy_memory_block(writePtr, "nan", 3);
+				writePtr += 3;
 			}
-			// If it is expected to be a string but is not, we remove it (by doing nothing here)
+			// If it is expected to be a string but is not, we remove it, leaving the field empty (by doing nothing here)
 		}
-		else // The determined data types do match and the type is numeric
+		else // The determined data types do match
 		{
-			strcat(formattedDataEntry, token); // Append correct token.
+			copy_memory_block(writePtr, field.start, field.length); // Append correct field.
+			writePtr += field.length;
 		}
 		
 		
-		
-		// Append delimiter except for the last token
+		// Append delimiter except for the last field
 		if (formatIndex < fieldCount - 1)
 		{
-			strncat(formattedDataEntry, delimiter, bufferSize - strlen(formattedDataEntry) - 1);
+			copy_memory_block(writePtr, delimiter, delimiterLength);
+			writePtr += delimiterLength;
 		}
-		
-		// Increment the index for the current field on this dataEntry and move to the next token(the next delimiter separated field in the dataEntry)
-		formatIndex++;
-		token = strtok_r(saveptr, delimiter, &saveptr);
-	}
-	
-	
-	
-	free(dataCopy);
-	for (int i = 0; i < fieldCount; i++)
-	{
-		free(dataTypes[i]);
 	}
-	free(dataTypes);
+	*writePtr = '\0';
 	
 	
 	
-	// Reallocate formattedDataEntry to fit the actual length.
-	char *fitOutput = realloc(formattedDataEntry, strlen(formattedDataEntry) + 1);
-	if (fitOutput)
+	// Reallocate formattedDataEntry to fit the actual length, unless it belongs to an arena.
+	if (arena == NULL)
 	{
-		formattedDataEntry = fitOutput;
+		char *fitOutput = realloc(formattedDataEntry, (size_t)(writePtr - formattedDataEntry) + 1);
+		if (fitOutput)
+		{
+			formattedDataEntry = fitOutput;
+		}
 	}
 	
 	return formattedDataEntry;
@@ -629,32 +2123,50 @@ int* identify_plottable_fields(char** fieldNameTypePairs, int fieldCount, const
  */
 char** capture_plottable_fields(char *headerLine, char* dataEntry, int fieldCount, const char *delimiter)
 {
+	DataSetSchema schema = infer_data_set_schema(headerLine, fieldCount, delimiter);
+	char **plottableFields = capture_plottable_fields_with_schema(&schema, dataEntry);
+	free_data_set_schema(&schema);
+	
+	return plottableFields;
+}
+
+
+
+
+/**
+ * capture_plottable_fields_with_schema
+ *
+ * Captures the numeric fields of a data entry, as 'capture_plottable_fields' does, but formats the entry against an already inferred schema.
+ *
+ * @param schema The expected type of each field and the delimiter, from 'infer_data_set_schema'.
+ * @param dataEntry A line from the dataset.
+ * @return An array of strings containing only the numeric fields from the data entry.
+ */
+char **capture_plottable_fields_with_schema(const DataSetSchema *schema, const char *dataEntry)
+{
+	int fieldCount = schema->fieldCount;
+	
 	// Format the data entry for plotting.
-	char *formattedData = format_data_entry_for_plotting(headerLine, dataEntry, fieldCount, delimiter);
+	char *formattedData = format_data_entry_with_schema(schema, dataEntry);
 	
 	
 	// Allocate memory for plottable fields.
 	char** plottableFields = allocate_memory_char_ptr_ptr(0, fieldCount);
 	
-	// Duplicate formatted data for processing.
-	char* dataCopy = strdup(formattedData);
-	
-	char* token = strtok(dataCopy, delimiter);
+	// View the fields of the formatted data in place, without duplicating it.
+	FieldSpan fields[(fieldCount > 0) ? fieldCount : 1];
+	RowView rowView = create_row_view(formattedData, schema->delimiter, fields, fieldCount);
 	int plottableIndex = 0;
 	
-	// Extract numeric fields for plotting.
-	while (token)
+	// Extract numeric fields for plotting, only they are copied out of the formatted data.
+	for (int i = 0; i < rowView.fieldCount; i++)
 	{
-		if (string_is_numeric(token))  // Check if the field is numeric.
+		if (determine_field_type(rowView.fields[i]) == FIELD_TYPE_NUMERIC)  // Check if the field is numeric.
 		{
-			plottableFields[plottableIndex] = allocate_memory_char_ptr(strlen(token) + 1);      // Allocate memory for the plottable field
-			strcpy(plottableFields[plottableIndex], token); // Copy the token to the plottable field
+			plottableFields[plottableIndex] = materialize_field_span(rowView.fields[i]); // Copy the field to the plottable field
 			plottableIndex++;
 		}
-		// Get the next token
-		token = strtok(NULL, delimiter);
 	}
-	free(dataCopy);
 	free(formattedData); // Free the formatted data, which is no longer needed
 	
 	
@@ -673,29 +2185,103 @@ char** capture_plottable_fields(char *headerLine, char* dataEntry, int fieldCoun
  * @param fileContents Array of strings representing the dataset.
  * @param lineCount The number of lines in the dataset.
  * @param delimiter The delimiter used in the dataset.
- * @return An array of strings, each representing a line in the dataset with only plottable fields.
+ * @return A line store holding the names of the plottable fields followed by each line of the dataset with only its plottable fields,
+ *         to be released with 'free_line_store'.
  */
-char** capture_data_set_for_plotting(char** fileContents, int lineCount, const char *delimiter)
+LineStore capture_data_set_for_plotting(char** fileContents, int lineCount, const char *delimiter)
 {
 	// Assume the first line is the header to determine the format
 	char *headerLine = fileContents[0]; // The header line is the first line of the file that is assumed to contain the names of each data field seperated by the delimiter.
 	char *formatLine = fileContents[1]; // The format line is the line with the first data entries and whose contents will be analyzed to serve as the basis for formatting.
 	int fieldCount = count_data_fields(formatLine);
 	
-	// Allocate memory for the new dataset
-	char** processedDataSet = allocate_memory_char_ptr_ptr(MAX_STRING_SIZE, lineCount + 1); // Assuming max length of processed line
+	
+	/// Capture the
+	char **fileHeader = capture_data_set_header_for_plotting(headerLine, fileContents, delimiter);
+	
+	
+	/// Identify plottable fields and store the plottability status in an integer array as 1 for plottable and 0 for unplottable
+	int *plottabilityStatus = identify_plottable_fields(fileHeader, fieldCount, ":");
+	
+	
+	
+	
+	/// Loop through all fields and count the number of plottable fields
+	int plottableFieldCount = 0;
+	for (int i = 0; i < fieldCount; i++)
+	{
+		if(plottabilityStatus[i] == 1)
+		{
+			plottableFieldCount++;
+		}
+	}
+	printf("\n\n plottableFieldCount: %d\n\n\n\n", plottableFieldCount);
+	
+	
+	int unplottableFieldCount = 0; // Start as 0 then as unplottable fields are encountered, increment by 1. Use this variable to offset the index of the fieldNames array when assigning the field names
+	
+	
+	
+	// Capture the Data Field Names in a Single String Without the typeDelimiters
+	const char *fieldNames[fieldCount]; //The string of field names as they appear in the first element of the fileContents array of strings
+	for (int i = 0; i < fieldCount; i++)
+	{
+		// Identify the delimiting character seperating each field name from it's data type, for example,  'mass:numeric'  --->  typeDelimiter = ':'  &&  typeDelimiterToken = 'mass'
+		const char *typeDelimiter = identify_delimiter(fileHeader, fieldCount);
+		StringTokenizer tokenizer = create_string_tokenizer(fileHeader[i], typeDelimiter);
+		char* typeDelimiterToken = next_string_token(&tokenizer); // Split the token by the type delimiter to get the name
+																		 //printf("\n\n\n field: %d \n typeDelimiter: %s \n typeDelimiterToken: %s", i, typeDelimiter, typeDelimiterToken);
+		
+		
+		if (typeDelimiterToken)
+		{
+			if(plottabilityStatus[i] == 1) /// If the token field name is not NULL and the field is plottable, duplicate the token to the field names
+			{
+				// Offset the index of the fieldNames array by the current number of unplottable fields which preceded this iteration of the loop when assigning the field names
+				// so that the ordering of the plottable field names will correspond to the ordering of the plottable fields in the processed dataset
+				fieldNames[i - unplottableFieldCount] = strdup(typeDelimiterToken);  // Duplicate the token to the field names while omitting unplottable fieldsa
+			}
+			else if(plottabilityStatus[i] == 0) /// the token field name is not NULL and the field is NOT plottable
+			{
+				unplottableFieldCount++; // Increment the count of unplottable fields
+				
+				
+				// Remove the invalid field name from the field names array, decreasing the dimension of the array by 1 and pushing the remaining elements to the left
+				//for (int j = i - unplottableFieldCount; j < fieldCount; j++)
+				//{
+				//    fieldNames[j] = fieldNames[j + 1];
+				//}
+				
+			}
+			
+		}
+	}
+	
+	
+	
+	// Concatenate field names into a single string and set as the first line of the processed dataset, the lines are stored contiguously
+	// so the memory of the processed dataset is proportional to its size
+	char* headerString = concatenate_string_array(fieldNames, plottableFieldCount, delimiter);
+	LineStore processedDataSet = create_line_store(strlen(headerString) + 1, (lineCount > 0) ? (size_t)lineCount : 1);
+	append_line_store_line(&processedDataSet, headerString, strlen(headerString));
+	free(headerString);
+	
+	
+	// Infer the expected data type of each field once, from the format line
+	DataSetSchema schema = infer_data_set_schema(formatLine, fieldCount, delimiter);
 	
 	// Extracting solely the numeric values from all of the plottable fields
-	for (int i = 0; i < lineCount; i++)
+	for (int i = 1; i < lineCount; i++)
 	{
 		// Extract plottable fields from each line of the dataset.
-		char** plottableFields = capture_plottable_fields(formatLine, fileContents[i], fieldCount, delimiter);
+		char** plottableFields = capture_plottable_fields_with_schema(&schema, fileContents[i]);
 		
 		// Concatenate plottable fields into a single string for each line.
 		char* concatenatedFields = concatenate_string_array(plottableFields, fieldCount, delimiter);
 		
 		// Store the concatenated string in the processed dataset.
-		processedDataSet[i] = concatenatedFields; // Shift index by 1 to leave space for the header
+		append_line_store_line(&processedDataSet, concatenatedFields, strlen(concatenatedFields));
+		free(concatenatedFields);
 		
 		// Free the array of plottable fields
 		for (int j = 0; j < fieldCount && plottableFields[j] != NULL; j++)
@@ -704,74 +2290,251 @@ char** capture_data_set_for_plotting(char** fileContents, int lineCount, const c
 		}
 		free(plottableFields);
 	}
+	free_data_set_schema(&schema);
+	
+	return processedDataSet;
+}
+
+
+
+
+
+
+
+
+
+
+
+
+/**
+ * count_data_set_chunk_quotes
+ *
+ * Thread routine counting the double quotes in the byte range of a DataSetChunk, storing the result in 'quoteCount'.
+ *
+ * @param chunkArgument Pointer to the DataSetChunk to scan.
+ * @return NULL.
+ */
+void *count_data_set_chunk_quotes(void *chunkArgument)
+{
+	DataSetChunk *chunk = (DataSetChunk *)chunkArgument;
+	chunk->quoteCount = count_quotes_in_mapped_file_range(chunk->mappedFile, chunk->startOffset, chunk->endOffset);
+	return NULL;
+}
+
+
+
+
+/**
+ * preprocess_data_set_chunk
+ *
+ * Thread routine preprocessing and formatting every record beginning within the byte range of a DataSetChunk.
+ * Each record is copied out of the mapping, preprocessed with 'prune_and_trim_problematic_characters_with_date_formats'(detecting
+ * each column's date/time format once per chunk, in formats private to the thread), and formatted
+ * with 'format_data_entry_with_schema' against the chunk's schema, exactly as 'run_data_set' processes each line. The formatted
+ * entries are appended, in file order, to the chunk's 'formattedEntries' line store. Blank records are not data entries and are skipped.
+ *
+ * @param chunkArgument Pointer to the DataSetChunk to process, its range must begin at the start of a record.
+ * @return NULL.
+ */
+void *preprocess_data_set_chunk(void *chunkArgument)
+{
+	DataSetChunk *chunk = (DataSetChunk *)chunkArgument;
+	DateTimeFormat columnFormats[chunk->fieldCount > 0 ? chunk->fieldCount : 1];
+	for (int i = 0; i < chunk->fieldCount; i++)
+	{
+		columnFormats[i] = compile_date_time_format(-1);
+	}
+	MemoryArena *recordArena = create_memory_arena(0); // Holds the strings of the record being processed, released once it has been captured
+	chunk->formattedEntries = create_line_store(chunk->endOffset - chunk->startOffset + 1, 1024); // Formatting rarely lengthens the entries of a range by much
 	
 	
-	/// Capture the
-	char **fileHeader = capture_data_set_header_for_plotting(headerLine, fileContents, delimiter);
+	size_t offset = chunk->startOffset;
+	size_t recordLength = 0;
+	const char *record;
+	while (offset < chunk->endOffset && (record = next_mapped_file_record(chunk->mappedFile, &offset, &recordLength)) != NULL)
+	{
+		/// Examine the data entry and filter out problematic characters, then format it to ensure each one of its fields is of the correct data type
+		char *dataEntry = copy_line_contents_in_arena(recordArena, record, recordLength);
+		char *prunedDataEntry = prune_and_trim_problematic_characters_in_arena(recordArena, dataEntry, chunk->delimiter, chunk->fieldCount, columnFormats);
+		char *formattedDataEntry = (prunedDataEntry != NULL) ? format_data_entry_with_schema_in_arena(recordArena, chunk->schema, prunedDataEntry) : NULL;
+		
+		
+		/// Capture the formatted data entry at the end of the chunk's line store
+		if (formattedDataEntry != NULL)
+		{
+			append_line_store_line(&chunk->formattedEntries, formattedDataEntry, strlen(formattedDataEntry));
+		}
+		reset_memory_arena(recordArena);
+	}
+	destroy_memory_arena(recordArena);
 	
 	
-	/// Identify plottable fields and store the plottability status in an integer array as 1 for plottable and 0 for unplottable
-	int *plottabilityStatus = identify_plottable_fields(fileHeader, fieldCount, ":");
+	return NULL;
+}
+
+
+
+
+/**
+ * preprocess_data_set_in_parallel
+ *
+ * Preprocesses and formats the data entries of a mapped data set, dividing the work between 'threadCount' threads.
+ *
+ * The bytes following the header are split into equally sized ranges, one per thread(fewer for small files), in three phases:
+ *   1. Each thread counts the double quotes in its range.
+ *   2. A prefix sum of those counts gives the parity of the quotes preceding each range boundary, i.e., whether the boundary lies inside
+ *      a quoted field. Each boundary is then moved forward to the start of the next record with 'align_to_record_start', so that a record
+ *      (including one whose quoted fields contain newlines) is never divided between two ranges.
+ *   3. Each thread preprocesses and formats the records of its range with 'preprocess_data_set_chunk'.
+ * The entries of the ranges are then gathered in file order, so the result is the same as processing the records one after another.
+ *
+ * As in 'run_data_set', the first record is the header and is captured as is, and the preprocessed first data entry is the format line
+ * establishing the expected data type of each field.
+ *
+ * @param mappedFile The mapped data set file.
+ * @param delimiter The delimiter of the data set.
+ * @param threadCount The number of threads to divide the work between(see 'determine_hardware_thread_count').
+ * @return A line store holding the header followed by each formatted data entry('lineCount' includes the header), empty if the file is
+ *         empty, to be released with 'free_line_store'.
+ */
+LineStore preprocess_data_set_in_parallel(const MappedFile *mappedFile, const char *delimiter, int threadCount)
+{
+	if (mappedFile == NULL || mappedFile->size == 0)
+	{
+		perror("\n\nError: The data set file is empty in 'preprocess_data_set_in_parallel'.\n");
+		LineStore emptyLineStore = {NULL, 0, 0, NULL, 0, 0, NULL};
+		return emptyLineStore;
+	}
 	
 	
 	
+	/*-----------   Capture the Header and the Format Line   -----------*/
+	size_t dataOffset = 0;
+	size_t recordLength = 0;
+	const char *record = next_mapped_file_record(mappedFile, &dataOffset, &recordLength);
+	char *headerLine = copy_line_contents(record, recordLength);
+	char *headerCopy = strdup(headerLine); // 'count_data_fields' modifies the string it counts
+	int fieldCount = count_data_fields(headerCopy);
+	free(headerCopy);
 	
-	/// Loop through all fields and count the number of plottable fields
-	int plottableFieldCount = 0;
-	for (int i = 0; i < fieldCount; i++)
+	
+	size_t formatOffset = dataOffset;
+	char *formatLine = NULL;
+	record = next_mapped_file_record(mappedFile, &formatOffset, &recordLength);
+	if (record != NULL)
 	{
-		if(plottabilityStatus[i] == 1)
+		char *formatEntry = copy_line_contents(record, recordLength);
+		formatLine = prune_and_trim_problematic_characters_from_string(formatEntry, delimiter, fieldCount);
+		if (formatLine != formatEntry)
 		{
-			plottableFieldCount++;
+			free(formatEntry);
 		}
 	}
-	printf("\n\n plottableFieldCount: %d\n\n\n\n", plottableFieldCount);
 	
 	
-	int unplottableFieldCount = 0; // Start as 0 then as unplottable fields are encountered, increment by 1. Use this variable to offset the index of the fieldNames array when assigning the field names
+	
+	/*-----------   Divide the Data Entries Into Equally Sized Byte Ranges   -----------*/
+	const size_t minimumChunkSize = 1 << 16; // Ranges smaller than this are not worth a thread of their own
+	size_t dataSize = mappedFile->size - dataOffset;
+	int chunkCount = (threadCount > 0) ? threadCount : 1;
+	if (formatLine == NULL)
+	{
+		chunkCount = 0; // There are no data entries to process
+	}
+	else if (dataSize / minimumChunkSize + 1 < (size_t)chunkCount)
+	{
+		chunkCount = (int)(dataSize / minimumChunkSize) + 1;
+	}
+	
+	
+	DataSetSchema schema = infer_data_set_schema((formatLine != NULL) ? formatLine : "", fieldCount, delimiter); // Shared, read only, by every thread
+	DataSetChunk *chunks = (DataSetChunk*)calloc((chunkCount > 0) ? chunkCount : 1, sizeof(DataSetChunk));
+	pthread_t *threads = (pthread_t*)malloc(((chunkCount > 0) ? chunkCount : 1) * sizeof(pthread_t));
+	if (chunks == NULL || threads == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'preprocess_data_set_in_parallel'.\n");
+		exit(1);
+	}
+	for (int i = 0; i < chunkCount; i++)
+	{
+		chunks[i].mappedFile = mappedFile;
+		chunks[i].startOffset = dataOffset + (size_t)((uint64_t)dataSize * i / chunkCount);
+		chunks[i].endOffset = dataOffset + (size_t)((uint64_t)dataSize * (i + 1) / chunkCount);
+		chunks[i].delimiter = delimiter;
+		chunks[i].schema = &schema;
+		chunks[i].fieldCount = fieldCount;
+	}
+	
+	
+	
+	/*-----------   Phase 1: Count the Quotes in Each Range   -----------*/
+	for (int i = 0; i < chunkCount; i++)
+	{
+		if (pthread_create(&threads[i], NULL, count_data_set_chunk_quotes, &chunks[i]) != 0)
+		{
+			perror("\n\nError: Unable to create thread in 'preprocess_data_set_in_parallel'.\n");
+			exit(1);
+		}
+	}
+	for (int i = 0; i < chunkCount; i++)
+	{
+		pthread_join(threads[i], NULL);
+	}
+	
+	
+	
+	/*-----------   Phase 2: Align Each Boundary to the Start of a Record   -----------*/
+	size_t quotesBeforeBoundary = 0; // The header ends outside of any quoted field, so the count begins at the first data entry
+	for (int i = 1; i < chunkCount; i++)
+	{
+		quotesBeforeBoundary += chunks[i - 1].quoteCount;
+		size_t recordStart = align_to_record_start(mappedFile, chunks[i].startOffset, quotesBeforeBoundary % 2 == 1);
+		chunks[i].startOffset = recordStart;
+		chunks[i - 1].endOffset = recordStart;
+	}
+	
+	
+	
+	/*-----------   Phase 3: Preprocess and Format Each Range on Its Own Thread   -----------*/
+	for (int i = 0; i < chunkCount; i++)
+	{
+		if (pthread_create(&threads[i], NULL, preprocess_data_set_chunk, &chunks[i]) != 0)
+		{
+			perror("\n\nError: Unable to create thread in 'preprocess_data_set_in_parallel'.\n");
+			exit(1);
+		}
+	}
+	for (int i = 0; i < chunkCount; i++)
+	{
+		pthread_join(threads[i], NULL);
+	}
+	
 	
 	
+	/*-----------   Gather the Header and the Formatted Entries of Each Range, in File Order   -----------*/
+	size_t totalByteCount = strlen(headerLine) + 1, totalEntryCount = 1;
+	for (int i = 0; i < chunkCount; i++)
+	{
+		totalByteCount += chunks[i].formattedEntries.byteCount;
+		totalEntryCount += chunks[i].formattedEntries.lineCount;
+	}
 	
-	// Capture the Data Field Names in a Single String Without the typeDelimiters
-	const char *fieldNames[fieldCount]; //The string of field names as they appear in the first element of the fileContents array of strings
-	for (int i = 0; i < fieldCount; i++)
+	LineStore formattedFileContents = create_line_store(totalByteCount, totalEntryCount);
+	append_line_store_line(&formattedFileContents, headerLine, strlen(headerLine));
+	for (int i = 0; i < chunkCount; i++)
 	{
-		// Identify the delimiting character seperating each field name from it's data type, for example,  'mass:numeric'  --->  typeDelimiter = ':'  &&  typeDelimiterToken = 'mass'
-		const char *typeDelimiter = identify_delimiter(fileHeader, fieldCount);
-		char* typeDelimiterToken = strtok(fileHeader[i], typeDelimiter); // Split the token by the type delimiter to get the name
-																		 //printf("\n\n\n field: %d \n typeDelimiter: %s \n typeDelimiterToken: %s", i, typeDelimiter, typeDelimiterToken);
-		
-		
-		if (typeDelimiterToken)
-		{
-			if(plottabilityStatus[i] == 1) /// If the token field name is not NULL and the field is plottable, duplicate the token to the field names
-			{
-				// Offset the index of the fieldNames array by the current number of unplottable fields which preceded this iteration of the loop when assigning the field names
-				// so that the ordering of the plottable field names will correspond to the ordering of the plottable fields in the processed dataset
-				fieldNames[i - unplottableFieldCount] = strdup(typeDelimiterToken);  // Duplicate the token to the field names while omitting unplottable fieldsa
-			}
-			else if(plottabilityStatus[i] == 0) /// the token field name is not NULL and the field is NOT plottable
-			{
-				unplottableFieldCount++; // Increment the count of unplottable fields
-				
-				
-				// Remove the invalid field name from the field names array, decreasing the dimension of the array by 1 and pushing the remaining elements to the left
-				//for (int j = i - unplottableFieldCount; j < fieldCount; j++)
-				//{
-				//    fieldNames[j] = fieldNames[j + 1];
-				//}
-				
-			}
-			
-		}
+		append_line_store(&formattedFileContents, &chunks[i].formattedEntries);
+		free_line_store(&chunks[i].formattedEntries);
 	}
 	
 	
+	free_data_set_schema(&schema);
+	free(headerLine);
+	free(formatLine);
+	free(threads);
+	free(chunks);
 	
-	// Concatenate field names into a single string and set as the first line of the processed dataset
-	char* headerString = concatenate_string_array(fieldNames, plottableFieldCount, delimiter);
-	processedDataSet[0] = headerString;
-	return processedDataSet;
+	return formattedFileContents;
 }
 
 
@@ -781,15 +2544,12 @@ char** capture_data_set_for_plotting(char** fileContents, int lineCount, const c
 
 
 
-
-
-
-
 /**
  * extract_plottable_data_field
  *
  * Extracts a specific plottable data field from the dataset for plotting purposes.
  * It allocates memory for storing the extracted numeric data and processes each line to capture the specified field.
+ * Each line is viewed as field spans, so the field is converted directly from the line without the line or the field being copied.
  *
  * @param dataSetContents Array of strings representing the dataset.
  * @param fieldIndex Index of the field to be extracted.
@@ -802,42 +2562,21 @@ double *extract_plottable_data_field(char** dataSetContents, int fieldIndex, int
 	// Count the number of lines in the dataset and allocate memory for plot data.
 	int lineCount = count_array_strings(dataSetContents);
 	double *plotData = allocate_memory_double_ptr(lineCount);
+	int spanCount = (fieldIndex < fieldCount) ? fieldIndex + 1 : fieldCount; // Fields past the specified one are never examined
+	FieldSpan *fieldSpans = malloc((spanCount > 0 ? spanCount : 1) * sizeof(FieldSpan)); // Reused for every line
 	
 	// Process each line to extract the specified field.
 	for (int i = 0; i < lineCount; i++)
 	{
-		char* dataEntry = dataSetContents[i]; // The current line of the data set.
-		char* dataCopy = strdup(dataEntry);
-		char* saveptr;
-		char* token = strtok_r(dataCopy, delimiter, &saveptr);
-		int currentIndex = 0;
-		double fieldValue = 0.0;
-		
-		
-		// Extract the field value at the specified index.
-		while (token && currentIndex < fieldCount)
-		{
-			if (currentIndex == fieldIndex) // The field index is passed in to capture the specified data set field only.
-			{
-				fieldValue = atof(token); // Convert the nonnumeric token to a numeric representation as a double.
-				plotData[i] = fieldValue;
-				break;
-			}
-			
-			// Not yet at the fieldIndex, iterate the currentIndex and get the next field with token.
-			currentIndex++;
-			token = strtok_r(NULL, delimiter, &saveptr);
-		}
+		RowView rowView = create_row_view(dataSetContents[i], delimiter, fieldSpans, spanCount); // The current line of the data set.
 		
 		
-		// If after iterating through all field indexes, the specified fieldIndex of the data entry has not been found, set it to NULL 0.0.
-		if (!token)
-		{
-			fieldValue = 0.0;
-			plotData[i] = fieldValue;
-		}
-		free(dataCopy);
+		// The field index is passed in to capture the specified data set field only, convert it to a numeric representation as a double.
+		// If the specified fieldIndex of the data entry is not found, or is not a number(e.g., empty), it is missing and set to NAN.
+		double value;
+		plotData[i] = (fieldIndex < rowView.fieldCount && parse_numeric_string(rowView.fields[fieldIndex].start, rowView.fields[fieldIndex].length, &value)) ? value : NAN;
 	}
+	free(fieldSpans);
 	
 	
 	return plotData;
@@ -1033,7 +2772,7 @@ const char *write_plottable_data(char** dataSetContents, char *headerLine, const
  * The function structures the dataset, creating separate files for plottable fields to aid in analysis
  * and plotting.
  *
- * @param fileContents Array of strings representing the dataset.
+ * @param fileContents NULL-terminated array of strings representing the dataset.
  * @param filePathName Path of the original dataset file.
  * @param delimiter The delimiter used in the dataset.
  * @return The directory where the processed dataset files are stored.
@@ -1053,8 +2792,9 @@ char *write_data_set(char** fileContents, const char *filePathName, const char *
 	
 	// Process the dataset for plotting
 	/*-----------   Write the NON-Plottable Data to Files   -----------*/
-	int lineCount = count_file_lines(filePathName, MAX_NUM_FILE_LINES);
-	char **plottingData = capture_data_set_for_plotting(fileContents, lineCount, delimiter);  // Capture data suitable for plotting.
+	int lineCount = count_array_strings(fileContents);
+	LineStore plottingDataStore = capture_data_set_for_plotting(fileContents, lineCount, delimiter);  // Capture data suitable for plotting.
+	char **plottingData = line_store_pointers(&plottingDataStore);
 	
 	printf("\n\n\n\n fileContents[0]: %s\n plottingData[0]: %s\n\n", fileContents[0], plottingData[0]);
 	print_file_contents(plottingData, lineCount);
@@ -1090,7 +2830,554 @@ char *write_data_set(char** fileContents, const char *filePathName, const char *
 	// Write plottable fields to files, Populate the Contents of the Plotting File with the Contents of the Array of Strings(i.e., the data entries)
 	// Write plottable fields to the directory at 'directoryPathName' with pathnames 'plottableFieldsPathName'(to be followed by the index of the field and the .txt extension)
 	write_plottable_data(plottingData, fileContents[0], directoryPathName, plottableFieldsPathName, delimiter);
+	free_line_store(&plottingDataStore);
 	
 	
 	return dataDirectory;
 }
+
+
+
+
+
+
+
+
+/**
+ * default_data_set_run_options
+ *
+ * Returns the default configuration for running a data set with 'run_data_set', which ingests it once into a typed columnar
+ * table rather than running the legacy string pipeline, finds the quartiles of each field exactly unless a copy of the field
+ * would exceed EXACT_QUANTILE_MEMORY_BUDGET, writes the Pearson correlation matrix of the numeric fields, and groups the numeric
+ * fields by each string field in turn.
+ *
+ * @return A DataSetRunOptions structure holding the default configuration.
+ */
+DataSetRunOptions default_data_set_run_options(void)
+{
+	DataSetRunOptions options;
+	options.legacyStringPipeline = false;
+	options.quantileMode = QUANTILE_MODE_AUTOMATIC;
+	options.correlationMethod = CORRELATION_METHOD_PEARSON;
+	options.groupByFieldIndices = NULL;
+	options.groupByFieldCount = 0;
+	return options;
+}
+
+
+
+
+/**
+ * default_streaming_options
+ *
+ * Returns the default configuration for streaming a data set, processing 'STREAMING_WINDOW_ROW_COUNT' rows per window
+ * while keeping the window buffers within 'STREAMING_MEMORY_BUDGET' bytes, and finding the quartiles of each field in
+ * QUANTILE_MODE_AUTOMATIC.
+ *
+ * @return A StreamingOptions structure holding the default window size, memory budget, and quantile mode.
+ */
+StreamingOptions default_streaming_options(void)
+{
+	StreamingOptions options;
+	options.windowRowCount = STREAMING_WINDOW_ROW_COUNT;
+	options.memoryBudgetBytes = STREAMING_MEMORY_BUDGET;
+	options.quantileMode = QUANTILE_MODE_AUTOMATIC;
+	return options;
+}
+
+
+
+
+/**
+ * stream_data_set
+ *
+ * Processes a data set in fixed-size windows of rows without ever holding the whole of it in memory, producing the same
+ * plottable fields directory as 'write_data_set' along with a running summary(count, missing values, sum, min, max) of every field.
+ *
+ * The file is mapped with 'map_file_bytes' and walked front to back one line at a time, no line index is built and no array
+ * of the file's lines is created. Each data entry is copied, preprocessed with 'prune_and_trim_problematic_characters_from_string',
+ * checked for missing values, and formatted with 'format_data_entry_for_plotting', after which its plottable values are placed
+ * into the current window and the strings are released together by resetting the arena they were allocated from. Once a window is full, its values are folded into the column accumulators
+ * and appended to the plottable field files, and the pages of the mapping that held the window's rows are handed back to the kernel.
+ * Each plottable field's window is also binned into a streaming histogram of its own, which is merged into the field's, so the field
+ * is binned without ever being held in memory: once it has been streamed, its histogram is converted to the number of bins found
+ * by 'summarize_streamed_column'.
+ * Peak memory is therefore bounded by the window buffers(at most 'options.memoryBudgetBytes') plus a single row, regardless of the
+ * size of the file.
+ *
+ * As with the rest of the program, the first line is the header and the second line is the format line whose contents establish
+ * the expected data type of each field.
+ *
+ * @param filePathName Path of the data set file.
+ * @param options The window size and memory budget to stream the data set with.
+ * @return A StreamingDataSetSummary structure describing the data set, which should be released with 'free_streaming_data_set_summary'.
+ */
+StreamingDataSetSummary stream_data_set(const char *filePathName, StreamingOptions options)
+{
+	StreamingDataSetSummary summary = {0, 0, 0, NULL, NULL, NULL, NULL, NULL};
+	
+	MappedFile dataSetFile = map_file_bytes(filePathName);
+	if (dataSetFile.size == 0)
+	{
+		perror("\n\nError: The data set file is empty in 'stream_data_set'.\n");
+		return summary;
+	}
+	
+	
+	
+	/*-----------   Identify the Delimiter From a Sample of the First Lines of the File   -----------*/
+	const char *delimiter = identify_mapped_file_delimiter(&dataSetFile, 64);
+	
+	
+	
+	/*-----------   Capture the Header Line and the Format Line   -----------*/
+	size_t offset = 0;
+	size_t lineLength = 0;
+	const char *line = next_mapped_file_line(&dataSetFile, &offset, &lineLength);
+	char *headerLine = copy_line_contents(line, lineLength);
+	char *headerCopy = strdup(headerLine); // 'count_data_fields' modifies the string it counts
+	int fieldCount = count_data_fields(headerCopy);
+	free(headerCopy);
+	
+	
+	size_t dataOffset = offset; // The data entries begin with the format line
+	line = next_mapped_file_line(&dataSetFile, &offset, &lineLength);
+	if (line == NULL || fieldCount <= 0)
+	{
+		perror("\n\nError: The data set has no data entries in 'stream_data_set'.\n");
+		free(headerLine);
+		unmap_file_contents(&dataSetFile);
+		return summary;
+	}
+	char *formatEntry = copy_line_contents(line, lineLength);
+	char *prunedFormatEntry = prune_and_trim_problematic_characters_from_string(formatEntry, delimiter, fieldCount);
+	char *formatLine = (prunedFormatEntry != NULL) ? format_data_entry_for_plotting(prunedFormatEntry, prunedFormatEntry, fieldCount, delimiter) : NULL; // Formatted the same way as every other data entry
+	if (formatLine == NULL)
+	{
+		perror("\n\nError: The format line of the data set could not be formatted in 'stream_data_set'.\n");
+		if (prunedFormatEntry != formatEntry)
+		{
+			free(prunedFormatEntry);
+		}
+		free(formatEntry);
+		free(headerLine);
+		unmap_file_contents(&dataSetFile);
+		return summary;
+	}
+	
+	
+	
+	/*-----------   Determine the Expected Data Type, Name, and Plottability of Each Field   -----------*/
+	char *typeSource[2] = {headerLine, formatLine}; // 'capture_data_set_header_for_plotting' determines the types from the line following the header
+	char **fieldNameTypePairs = capture_data_set_header_for_plotting(headerLine, typeSource, delimiter);
+	DataSetSchema entrySchema = infer_data_set_schema(prunedFormatEntry, fieldCount, delimiter); // The types every preprocessed data entry is formatted against
+	DataSetSchema plottableSchema = infer_data_set_schema(formatLine, fieldCount, delimiter); // The expected types, which the formatted entries are formatted against again
+	FieldSpan *entryFields = (FieldSpan*)malloc(fieldCount * sizeof(FieldSpan)); // Reused for every data entry
+	
+	summary.fieldCount = fieldCount;
+	summary.delimiter = delimiter;
+	summary.plottabilityStatus = identify_plottable_fields(fieldNameTypePairs, fieldCount, ":");
+	summary.fieldNames = (char**)malloc(fieldCount * sizeof(char*));
+	summary.columnAccumulators = (ColumnAccumulator*)malloc(fieldCount * sizeof(ColumnAccumulator));
+	int *plottableFieldIndices = allocate_memory_int_ptr(fieldCount); // Maps the ith plottable field to its index among all fields
+	if (summary.fieldNames == NULL || summary.columnAccumulators == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'stream_data_set'.\n");
+		exit(1);
+	}
+	
+	for (int i = 0; i < fieldCount; i++)
+	{
+		const char *typeDelimiterPosition = strchr(fieldNameTypePairs[i], ':');
+		size_t nameLength = (typeDelimiterPosition != NULL) ? (size_t)(typeDelimiterPosition - fieldNameTypePairs[i]) : strlen(fieldNameTypePairs[i]);
+		summary.fieldNames[i] = strndup(fieldNameTypePairs[i], nameLength);
+		
+		ColumnAccumulator emptyAccumulator = {0, 0, 0.0, INFINITY, -INFINITY, NULL, NULL, QUANTILE_MODE_AUTOMATIC, NAN, NAN, NAN, 0, {NULL, 0, 0.0, 0.0, 0.0, 0.0, NULL}};
+		summary.columnAccumulators[i] = emptyAccumulator;
+		
+		if (summary.plottabilityStatus[i] == 1)
+		{
+			plottableFieldIndices[summary.plottableFieldCount++] = i;
+			summary.columnAccumulators[i].sketch = create_quantile_sketch(0, (uint64_t)i);
+			summary.columnAccumulators[i].histogram = create_streaming_histogram(0);
+		}
+	}
+	deallocate_memory_char_ptr_ptr(fieldNameTypePairs, fieldCount);
+	int plottableFieldCount = summary.plottableFieldCount;
+	
+	
+	
+	/*-----------   Create the Plottable Fields Directory and Open a Writer for Each Plottable Field   -----------*/
+	summary.plottableFieldsDirectory = create_directory(filePathName, "_Plottable_Fields");
+	char *fileName = find_name_from_path(filePathName);
+	char *plottableFieldFileName = combine_strings("/", fileName);
+	char *plottableFieldsPathName = combine_strings(summary.plottableFieldsDirectory, plottableFieldFileName);
+	free(plottableFieldFileName);
+	plottableFieldFileName = plottableFieldsPathName;
+	plottableFieldsPathName = combine_strings(plottableFieldFileName, "_Plottable_Field"); // Full path for plottable data fields, followed by the index and name of each field
+	free(plottableFieldFileName);
+	
+	
+	FILE **plottableFieldFiles = (FILE**)malloc((plottableFieldCount > 0 ? plottableFieldCount : 1) * sizeof(FILE*));
+	char **plottableFieldFilePathNames = (char**)malloc((plottableFieldCount > 0 ? plottableFieldCount : 1) * sizeof(char*));
+	if (plottableFieldFiles == NULL || plottableFieldFilePathNames == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'stream_data_set'.\n");
+		exit(1);
+	}
+	for (int p = 0; p < plottableFieldCount; p++)
+	{
+		const char *fieldName = summary.fieldNames[plottableFieldIndices[p]];
+		size_t pathLength = strlen(plottableFieldsPathName) + strlen(fieldName) + 32;
+		plottableFieldFilePathNames[p] = allocate_memory_char_ptr(pathLength);
+		snprintf(plottableFieldFilePathNames[p], pathLength, "%s_%d-%s.txt", plottableFieldsPathName, p, fieldName);
+		
+		plottableFieldFiles[p] = fopen(plottableFieldFilePathNames[p], "w");
+		if (plottableFieldFiles[p] == NULL)
+		{
+			perror("\n\nError opening file for writing in 'stream_data_set'.");
+			exit(1);
+		}
+		fprintf(plottableFieldFiles[p], "%s\n", fieldName);
+	}
+	
+	
+	
+	/*-----------   Size the Window to Fit the Memory Budget   -----------*/
+	size_t rowSize = (size_t)(plottableFieldCount > 0 ? plottableFieldCount : 1) * sizeof(double); // Bytes of window buffer per row
+	size_t windowRowCount = (options.windowRowCount > 0) ? options.windowRowCount : STREAMING_WINDOW_ROW_COUNT;
+	if (options.memoryBudgetBytes / rowSize < windowRowCount)
+	{
+		windowRowCount = (options.memoryBudgetBytes / rowSize > 0) ? options.memoryBudgetBytes / rowSize : 1;
+	}
+	double *windowValues = allocate_memory_double_ptr(windowRowCount * (plottableFieldCount > 0 ? plottableFieldCount : 1)); // Column-major, the values of the pth plottable field start at p * windowRowCount
+	
+	
+	
+	/*-----------   Stream the Data Entries Window by Window   -----------*/
+	DateTimeFormat columnFormats[fieldCount > 0 ? fieldCount : 1]; // Each column's date/time format, detected from its first date/time
+	for (int i = 0; i < fieldCount; i++)
+	{
+		columnFormats[i] = compile_date_time_format(-1);
+	}
+	MemoryArena *entryArena = create_memory_arena(0); // Holds every string of the data entry being processed, released at once when it is done
+	offset = dataOffset;
+	size_t releasedOffset = 0; // Everything in the mapping before this offset has already been handed back to the kernel
+	int endOfFile = 0;
+	while (!endOfFile)
+	{
+		/// Fill the window with the plottable values of up to 'windowRowCount' data entries
+		size_t windowRows = 0;
+		while (windowRows < windowRowCount)
+		{
+			line = next_mapped_file_line(&dataSetFile, &offset, &lineLength);
+			if (line == NULL)
+			{
+				endOfFile = 1;
+				break;
+			}
+			
+			
+			// Preprocess the data entry the same way 'run_data_set' does, blank lines are not data entries and are skipped
+			char *dataEntry = copy_line_contents_in_arena(entryArena, line, lineLength);
+			char *prunedDataEntry = prune_and_trim_problematic_characters_in_arena(entryArena, dataEntry, delimiter, fieldCount, columnFormats);
+			if (prunedDataEntry == NULL)
+			{
+				reset_memory_arena(entryArena);
+				continue;
+			}
+			
+			
+			// Count the missing or incorrectly formatted values of the data entry before formatting replaces them
+			RowView entryView = create_delimited_row_view(prunedDataEntry, delimiter, entryFields, fieldCount);
+			for (int fieldIndex = 0; fieldIndex < entryView.fieldCount; fieldIndex++)
+			{
+				FieldSpan field = entryView.fields[fieldIndex];
+				while (field.length > 0 && isspace((unsigned char)*field.start)) // Trim leading spaces from the field
+				{
+					field.start++;
+					field.length--;
+				}
+				if (is_missing_field_value(field, plottableSchema.fieldTypes[fieldIndex]))
+				{
+					summary.columnAccumulators[fieldIndex].missingCount++;
+				}
+			}
+			
+			
+			// Format the data entry as 'run_data_set' does, then format it against the format line and capture its numeric fields, in order,
+			// as the values of the plottable fields, as 'capture_plottable_fields' does. The second pass drops any numeric value left in a
+			// nonnumeric field, so that it is not mistaken for the value of the following plottable field. A missing value is formatted as
+			// "nan" and captured as NAN.
+			char *formattedDataEntry = format_data_entry_with_schema_in_arena(entryArena, &entrySchema, prunedDataEntry);
+			if (formattedDataEntry != NULL)
+			{
+				formattedDataEntry = format_data_entry_with_schema_in_arena(entryArena, &plottableSchema, formattedDataEntry);
+			}
+			int plottableIndex = 0;
+			StringTokenizer tokenizer = create_string_tokenizer(formattedDataEntry, delimiter); // A NULL entry yields no tokens
+			char *token = next_string_token(&tokenizer);
+			while (token && plottableIndex < plottableFieldCount)
+			{
+				double tokenValue;
+				if (parse_numeric_string(token, string_length(token), &tokenValue)) // Classified and converted in one pass
+				{
+					windowValues[plottableIndex * windowRowCount + windowRows] = tokenValue;
+					plottableIndex++;
+				}
+				token = next_string_token(&tokenizer);
+			}
+			for (; plottableIndex < plottableFieldCount; plottableIndex++)
+			{
+				windowValues[plottableIndex * windowRowCount + windowRows] = NAN; // The field was not found, as in 'extract_plottable_data_field'
+			}
+			reset_memory_arena(entryArena);
+			
+			
+			summary.entryCount++;
+			windowRows++;
+		}
+		
+		
+		
+		/// Fold the window into the column accumulators and append it to the plottable field files, one field at a time
+		for (int p = 0; p < plottableFieldCount; p++)
+		{
+			const double *fieldValues = &windowValues[p * windowRowCount];
+			ColumnAccumulator *accumulator = &summary.columnAccumulators[plottableFieldIndices[p]];
+			for (size_t r = 0; r < windowRows; r++)
+			{
+				if (fprintf(plottableFieldFiles[p], "%.17g\n", fieldValues[r]) < 0) // A missing value is written as "nan", keeping its row
+				{
+					perror("\n\nError writing to file in 'stream_data_set'.");
+					exit(1);
+				}
+				if (isnan(fieldValues[r]))
+				{
+					continue;
+				}
+				
+				accumulator->count++;
+				accumulator->sum += fieldValues[r];
+				accumulator->min = (fieldValues[r] < accumulator->min) ? fieldValues[r] : accumulator->min;
+				accumulator->max = (fieldValues[r] > accumulator->max) ? fieldValues[r] : accumulator->max;
+			}
+			add_values_to_quantile_sketch(accumulator->sketch, fieldValues, (int)windowRows); // NAN values are skipped
+			
+			StreamingHistogram *windowHistogram = create_streaming_histogram(accumulator->histogram->maxBins);
+			add_values_to_streaming_histogram(windowHistogram, fieldValues, (int)windowRows);
+			merge_streaming_histograms(accumulator->histogram, windowHistogram);
+			free_streaming_histogram(windowHistogram);
+		}
+		
+		
+		/// The rows of this window will not be read again, let the kernel reclaim the pages that held them
+		release_mapped_file_range(&dataSetFile, releasedOffset, offset);
+		releasedOffset = offset;
+	}
+	destroy_memory_arena(entryArena);
+	
+	
+	
+	/*-----------   Close the Plottable Field Files and Combine Them into a Single File   -----------*/
+	const char *plottingDataFilePathName = combine_strings(plottableFieldsPathName, ".txt");
+	FILE *plottingDataFile = fopen(plottingDataFilePathName, "w");
+	if (plottingDataFile == NULL)
+	{
+		perror("\n\nError opening file for writing in 'stream_data_set'.");
+		exit(1);
+	}
+	
+	char *copyBuffer = allocate_memory_char_ptr(MAX_STRING_SIZE * 64);
+	for (int p = 0; p < plottableFieldCount; p++)
+	{
+		if (summary.entryCount > 0)
+		{
+			fputc('\n', plottableFieldFiles[p]); // Each field ends with a blank line, as written by 'write_file_numeric_data'
+		}
+		fclose(plottableFieldFiles[p]);
+		
+		
+		// Append the field to the combined file in fixed-size chunks, so that no field is ever held in memory in its entirety
+		FILE *plottableFieldFile = fopen(plottableFieldFilePathNames[p], "r");
+		if (plottableFieldFile == NULL)
+		{
+			perror("\n\nError opening file for reading in 'stream_data_set'.");
+			exit(1);
+		}
+		size_t bytesRead;
+		while ((bytesRead = fread(copyBuffer, 1, MAX_STRING_SIZE * 64, plottableFieldFile)) > 0)
+		{
+			fwrite(copyBuffer, 1, bytesRead, plottingDataFile);
+		}
+		fclose(plottableFieldFile);
+		
+		
+		// Find the field's median, IQR, and binning now that every value has been written, and bin its streaming histogram accordingly
+		ColumnAccumulator *accumulator = &summary.columnAccumulators[plottableFieldIndices[p]];
+		summarize_streamed_column(accumulator, plottableFieldFilePathNames[p], options.quantileMode);
+		accumulator->binning = streaming_histogram_to_histogram(accumulator->histogram, accumulator->binCount);
+		free(plottableFieldFilePathNames[p]);
+	}
+	fclose(plottingDataFile);
+	
+	
+	
+	free(copyBuffer);
+	free((void*)plottingDataFilePathName);
+	free(plottableFieldFilePathNames);
+	free(plottableFieldFiles);
+	free(plottableFieldsPathName);
+	free(fileName);
+	free(windowValues);
+	free(plottableFieldIndices);
+	free(entryFields);
+	free_data_set_schema(&plottableSchema);
+	free_data_set_schema(&entrySchema);
+	free(formatLine);
+	if (prunedFormatEntry != formatEntry)
+	{
+		free(prunedFormatEntry);
+	}
+	free(formatEntry);
+	free(headerLine);
+	unmap_file_contents(&dataSetFile);
+	
+	return summary;
+}
+
+
+
+
+/**
+ * read_plottable_field_values
+ *
+ * Reads the values of a plottable field file, as written by 'stream_data_set', back into memory: the first line holds the name of
+ * the field and each following line a value. The file is mapped and its lines walked in place, and the values written as "nan"
+ * (the field's missing values) are skipped.
+ *
+ * @param plottableFieldFilePathName Path of the plottable field file.
+ * @param valueCount The number of present values the file holds, at most this many are read.
+ * @param readCount Set to the number of values read.
+ * @return A new array holding the present values of the field, in the order they were written.
+ */
+double *read_plottable_field_values(const char *plottableFieldFilePathName, size_t valueCount, size_t *readCount)
+{
+	double *values = allocate_memory_double_ptr(valueCount > 0 ? valueCount : 1);
+	*readCount = 0;
+	
+	MappedFile plottableFieldFile = map_file_bytes(plottableFieldFilePathName);
+	size_t offset = 0;
+	size_t lineLength = 0;
+	const char *line = next_mapped_file_line(&plottableFieldFile, &offset, &lineLength); // The name of the field
+	while (line != NULL && *readCount < valueCount && (line = next_mapped_file_line(&plottableFieldFile, &offset, &lineLength)) != NULL)
+	{
+		double value;
+		if (parse_numeric_string(line, lineLength, &value) && !isnan(value))
+		{
+			values[(*readCount)++] = value;
+		}
+	}
+	unmap_file_contents(&plottableFieldFile);
+	
+	return values;
+}
+
+
+
+
+/**
+ * summarize_streamed_column
+ *
+ * Finds the median, IQR, and Freedman-Diaconis binning of a plottable field once it has been streamed, in the mode resolved by
+ * 'resolve_quantile_mode' for the number of values accumulated. When a copy of the values fits EXACT_QUANTILE_MEMORY_BUDGET, they
+ * are read back from the field's plottable field file(one field at a time, so the window's memory bound is only exceeded by the
+ * budget) and found exactly from a single sort(see 'create_column_statistics_cache'). Otherwise they are estimated from the
+ * quantile sketch accumulated while streaming, without reading the field again.
+ *
+ * @param accumulator The accumulator of the field, its quantile mode, median, IQR, bin width, and bin count are set.
+ * @param plottableFieldFilePathName Path of the field's plottable field file, already closed.
+ * @param mode The requested quantile mode.
+ */
+void summarize_streamed_column(ColumnAccumulator *accumulator, const char *plottableFieldFilePathName, QuantileMode mode)
+{
+	int count = (accumulator->count < (size_t)INT_MAX) ? (int)accumulator->count : INT_MAX;
+	accumulator->quantileMode = resolve_quantile_mode(mode, count);
+	accumulator->median = NAN;
+	accumulator->iqr = NAN;
+	accumulator->binWidth = NAN;
+	accumulator->binCount = 0;
+	if (accumulator->count < 2 || (accumulator->quantileMode == QUANTILE_MODE_SKETCH && accumulator->sketch == NULL))
+	{
+		return;
+	}
+	
+	
+	if (accumulator->quantileMode == QUANTILE_MODE_EXACT)
+	{
+		size_t readCount = 0;
+		double *values = read_plottable_field_values(plottableFieldFilePathName, accumulator->count, &readCount);
+		ColumnStatisticsCache *statistics = create_column_statistics_cache(values, NULL, (int)readCount, 0);
+		free(values);
+		if (statistics->count >= 2)
+		{
+			const double *sortedValues = cached_sorted_values(statistics);
+			int middle = statistics->count / 2;
+			accumulator->median = (statistics->count % 2 == 1) ? sortedValues[middle] : (sortedValues[middle - 1] + sortedValues[middle]) / 2.0;
+			accumulator->iqr = compute_IQR_of_cached_column(statistics);
+			accumulator->binWidth = (accumulator->iqr > 0.0) ? compute_bin_width_of_cached_column(statistics) : NAN; // The bin width is undefined for a zero IQR
+		}
+		free_column_statistics_cache(statistics);
+	}
+	else
+	{
+		accumulator->median = quantile_sketch_quantile(accumulator->sketch, 0.5);
+		accumulator->iqr = compute_IQR_of_sketch(accumulator->sketch);
+		accumulator->binWidth = (accumulator->iqr > 0.0) ? compute_bin_width_of_sketch(accumulator->sketch) : NAN;
+	}
+	
+	if (!isnan(accumulator->iqr))
+	{
+		accumulator->binCount = freedman_diaconis_num_bins(accumulator->iqr, count, accumulator->min, accumulator->max);
+	}
+}
+
+
+
+
+/**
+ * free_streaming_data_set_summary
+ *
+ * Releases the memory held by a StreamingDataSetSummary and resets it to an empty state.
+ *
+ * @param summary The summary to release.
+ */
+void free_streaming_data_set_summary(StreamingDataSetSummary *summary)
+{
+	if (summary == NULL)
+	{
+		return;
+	}
+	
+	deallocate_memory_char_ptr_ptr(summary->fieldNames, summary->fieldCount);
+	free(summary->plottabilityStatus);
+	if (summary->columnAccumulators != NULL)
+	{
+		for (int i = 0; i < summary->fieldCount; i++)
+		{
+			free_quantile_sketch(summary->columnAccumulators[i].sketch);
+			free_streaming_histogram(summary->columnAccumulators[i].histogram);
+			free_histogram(&summary->columnAccumulators[i].binning);
+		}
+	}
+	free(summary->columnAccumulators);
+	free(summary->plottableFieldsDirectory);
+	
+	summary->fieldNames = NULL;
+	summary->plottabilityStatus = NULL;
+	summary->columnAccumulators = NULL;
+	summary->plottableFieldsDirectory = NULL;
+	summary->entryCount = 0;
+	summary->fieldCount = 0;
+	summary->plottableFieldCount = 0;
+}
@@ -35,6 +35,60 @@
 #include <string.h>
 #include <time.h>
 #include <math.h>
+#include "FileUtilities.h"
+#include "StringUtilities.h"
+#include "StatisticalMethods.h"
+
+
+
+
+// -------------- Data Set Schema Structure Definitions --------------
+/**
+ * FieldType Enumeration: The data type of a field, or of a single value of a field.
+ *
+ * - FIELD_TYPE_UNDETERMINED: The line the schema was inferred from has no such field, so no value is of the expected type.
+ * - FIELD_TYPE_NUMERIC: The value parses, in its entirety, as a number.
+ * - FIELD_TYPE_NONNUMERIC: Any other value, including a lone hyphen.
+ */
+typedef enum
+{
+	FIELD_TYPE_UNDETERMINED,
+	FIELD_TYPE_NUMERIC,
+	FIELD_TYPE_NONNUMERIC
+} FieldType;
+
+
+/**
+ * DataSetSchema Structure: The expected data type of each field of a data set, inferred once from its format line.
+ *
+ * Formatting a data entry only requires the type of each of its values to be compared with the expected type of its field, so the
+ * schema is inferred once and passed to every per-row function, rather than each row tokenizing and classifying the format line again.
+ *
+ * - fieldCount: The number of fields per data entry.
+ * - fieldTypes: The expected type of each field.
+ * - delimiter: The delimiter of the data set.
+ */
+typedef struct
+{
+	int fieldCount;
+	FieldType *fieldTypes;
+	const char *delimiter;
+} DataSetSchema;
+
+
+
+
+// ------------- Helper Functions for Inferring and Applying a Data Set Schema -------------
+/// \{
+FieldType determine_field_type(FieldSpan field); // Determines the type of a single value. (~= determine_string_representation_type)
+const char *field_type_name(FieldType fieldType); // Returns "numeric", "nonnumeric", or "" for an undetermined type.
+DataSetSchema infer_data_set_schema(const char *formatLine, int fieldCount, const char *delimiter); // Infers the expected type of each field from a format line.
+void free_data_set_schema(DataSetSchema *schema); // Releases the memory held by a schema.
+int is_missing_field_value(FieldSpan field, FieldType expectedType); // Determines if a value is missing or does not match its field's expected type.
+char *format_data_entry_with_schema(const DataSetSchema *schema, const char *dataEntry); // Formats a data entry against a schema, ensuring correct data type for each field.
+char *format_data_entry_with_schema_in_arena(MemoryArena *arena, const DataSetSchema *schema, const char *dataEntry); // Formats a data entry against a schema into a string allocated from an arena.
+char **capture_plottable_fields_with_schema(const DataSetSchema *schema, const char *dataEntry); // Captures the numeric fields of a data entry formatted against a schema.
+/// \}
 
 
 
@@ -42,7 +96,9 @@
 // ------------- Helper Functions for Capturing and Formatting Data from an Existing File/Data Set -------------
 /// \{
 char*** parse_entire_file(char **fileContents, int lineCount, int* fieldCount, const char *delimiter);
+void free_parsed_file_contents(char ***separatedData, int fieldCount); // Releases the arrays returned by 'parse_entire_file' along with the block holding their strings.
 int* count_missing_values(char** fileContents, int lineCount, int fieldCount, const char *delimiter, const char *headerLine);
+int is_missing_data_entry_field(const char *token, const char *expectedType); // Determines if a field's value is missing or does not match the field's expected data type.
 char** capture_data_set_header_for_plotting(char* headerContents, char** fileContents, const char *delimiter); // Captures and formats header information for plotting purposes.
 char** determine_data_entry_types(const char *dataEntry, int fieldCount, const char *delimiter); // Determines the data types of fields in a data entry.
 char** determine_common_data_entry_types(const char **dataEntries, int entryCount, int fieldCount, const char *delimiter); // Determines the data types of entries in a dataset.
@@ -51,7 +107,50 @@ char** determine_common_data_entry_types(const char **dataEntries, int entryCoun
 int* identify_plottable_fields(char** fieldNameTypePairs, int fieldCount, const char *typeDelimiter); // Identifies the plottable fields in the dataset and captures their indexes with a value of 0 if the field is not plottable, and a value of 1 if the field is plottable.
 char** capture_plottable_fields(char *headerLine, char* dataEntry, int fieldCount, const char *delimiter); // Captures fields from a data entry suitable for plotting.
 char *format_data_entry_for_plotting(char *headerLine, char* dataEntry, int fieldCount, const char *delimiter); // Formats a data entry for plotting, ensuring correct data type for each field.
-char** capture_data_set_for_plotting(char** fileContents, int lineCount, const char *delimiter); // Processes a dataset for plotting by extracting and formatting numeric fields.
+LineStore capture_data_set_for_plotting(char** fileContents, int lineCount, const char *delimiter); // Processes a dataset for plotting by extracting and formatting numeric fields.
+/// \}
+
+
+
+
+
+
+// -------------- Data Set Chunk Structure Definition --------------
+/**
+ * DataSetChunk Structure: Describes one byte range of a mapped data set and the results of preprocessing it on its own thread.
+ *
+ * - mappedFile: The mapped data set file the range belongs to.
+ * - startOffset: The byte offset at which the range begins, once aligned this is always the start of a record.
+ * - endOffset: The byte offset at which the range ends(exclusive), records beginning before it belong to this range.
+ * - quoteCount: The number of double quotes found in the range before alignment, used to determine the quote state at each boundary.
+ * - delimiter: The delimiter of the data set.
+ * - schema: The expected data type of each field, inferred from the preprocessed format line.
+ * - fieldCount: The number of fields per data entry.
+ * - formattedEntries: The preprocessed and formatted data entries of the range, in file order.
+ */
+typedef struct
+{
+	const MappedFile *mappedFile;
+	size_t startOffset;
+	size_t endOffset;
+	size_t quoteCount;
+	
+	
+	const char *delimiter;
+	const DataSetSchema *schema;
+	int fieldCount;
+	
+	
+	LineStore formattedEntries;
+} DataSetChunk;
+
+
+
+// ------------- Helper Functions for Preprocessing a Data Set in Parallel -------------
+/// \{
+void *count_data_set_chunk_quotes(void *chunkArgument); // Thread routine counting the double quotes in a chunk's byte range
+void *preprocess_data_set_chunk(void *chunkArgument); // Thread routine preprocessing and formatting every record of a chunk
+LineStore preprocess_data_set_in_parallel(const MappedFile *mappedFile, const char *delimiter, int threadCount); // Preprocesses and formats a mapped data set, dividing its records between threads
 /// \}
 
 
@@ -94,22 +193,84 @@ char *write_data_set(char** fileContents, const char *filePathName, const char *
 
 
 
-/// NOTE: THE 'DataSetProperties Structure' BELOW IS STRICTLY IN TESTING PHASE, NOT RELEVANT FOR CURRENT VERSION
+// -------------- Data Set Properties Structure Definitions --------------
+/**
+ * ColumnStorage Enumeration: How the values of a column are laid out in memory.
+ *
+ * - COLUMN_STORAGE_INT64: One contiguous array of int64_t, for numeric columns whose every value so far has been an integer.
+ * - COLUMN_STORAGE_DOUBLE: One contiguous array of double, for numeric columns holding any other number.
+ * - COLUMN_STORAGE_STRING: The bytes of every value back to back in a single heap, each value located by its offset into it.
+ */
+typedef enum
+{
+	COLUMN_STORAGE_INT64,
+	COLUMN_STORAGE_DOUBLE,
+	COLUMN_STORAGE_STRING
+} ColumnStorage;
+
+
+/**
+ * DataColumn Structure: The values of a single field of a data set, stored contiguously by type.
+ *
+ * A numeric column begins as COLUMN_STORAGE_INT64 if the value of its field in the format line is an integer, and is converted to
+ * COLUMN_STORAGE_DOUBLE once(the first time a value is not an integer), so integer columns such as identifiers and Unix times are
+ * kept exactly. Missing values, and values not of the field's expected type, are nulls: their bit in the column's validity bitmap
+ * is clear, and the value stored in their place(0, or an empty string) is not data and must not be read as such.
+ *
+ * - name: The name of the field, as it appears in the header line.
+ * - fieldType: The expected type of the field, from the data set's schema.
+ * - storage: Which of the value arrays holds the column's values.
+ * - integerValues: The values of a COLUMN_STORAGE_INT64 column, NULL otherwise.
+ * - doubleValues: The values of a COLUMN_STORAGE_DOUBLE column, NULL otherwise.
+ * - stringOffsets: For a COLUMN_STORAGE_STRING column, value 'i' occupies the bytes from 'stringOffsets[i]' up to 'stringOffsets[i + 1]'.
+ * - stringBytes: The heap holding the bytes of every value of a COLUMN_STORAGE_STRING column, without null characters.
+ * - stringBytesCapacity: The number of bytes that fit in 'stringBytes' before it must grow.
+ * - validity: The packed validity bitmap of the column, bit 'i' is set if value 'i' is present and clear if it is null.
+ * - missingCount: The number of null values, i.e., values that were missing or not of the field's expected type.
+ * - version: Incremented whenever a value of the column is stored, so derived data can tell whether the column has changed since.
+ * - statistics: The derived data shared by the statistical methods(see 'data_column_statistics'), NULL until first needed.
+ */
+typedef struct
+{
+	char *name;
+	FieldType fieldType;
+	ColumnStorage storage;
+	
+	
+	int64_t *integerValues;
+	double *doubleValues;
+	size_t *stringOffsets;
+	char *stringBytes;
+	size_t stringBytesCapacity;
+	
+	
+	uint64_t *validity;
+	size_t missingCount;
+	
+	
+	uint64_t version;
+	ColumnStatisticsCache *statistics;
+} DataColumn;
 
 
 /**
- * DataSetProperties Structure: Encapsulates the key static properties of a data set for analysis and processing.
+ * DataSetProperties Structure: Encapsulates the key static properties of a data set, along with all of its values as a typed columnar table.
  *
- * The DataSetProperties structure provides a convenient way to store and pass around the key properties of a data set
- * once they have already been rigorously determined and compatibility with plotting tools has been ensured.
+ * The data set is ingested once by 'analyze_data_set_properties': each value of every data entry is converted straight from the file and
+ * appended to the column of its field, with missing values recorded as nulls in the column's validity bitmap rather than written into the
+ * entry as placeholder zeros. Statistics, binning, and plottable field export can then read each field as contiguous memory(skipping nulls
+ * with the '_of_valid_values' kernels) rather than tokenizing and converting the strings of the data entries again.
  *
  * Struct for data set properties members:
- *      - int entryCount: The number of data entries in the data set.
+ *      - int entryCount: The number of data entries in the data set(excluding the header line).
  *      - int fieldCount: The number of fields per data entry.
  *      - const char *delimiter: The delimiter character used to separate fields in the data set.
- *      - char *dataSetHeader: Header line of the data set.
+ *      - char *header: Header line of the data set.
  *      - char **fieldNameTypePairs: Array of strings storing pairs of field names and their corresponding types.
- *      - const char* dataSetFilePathName: Path to the data set file.
+ *      - const char* filePathName: Path to the data set file.
+ *      - DataSetSchema schema: The expected data type of each field, inferred from the format line.
+ *      - DataColumn *columns: The values of each field, 'fieldCount' columns of 'entryCount' values.
+ *      - size_t rowCapacity: The number of values each column can hold before the columns must grow.
  */
 typedef struct
 {
@@ -121,7 +282,291 @@ typedef struct
 	char *header;
 	char **fieldNameTypePairs;
 	const char* filePathName;
+	
+	
+	DataSetSchema schema;
+	DataColumn *columns;
+	size_t rowCapacity;
 } DataSetProperties;
-DataSetProperties analyze_data_set_properties(const char *filePathName);
+
+
+
+
+// ------------- Helper Functions for Building and Reading a Columnar Data Set -------------
+/// \{
+DataSetProperties analyze_data_set_properties(const char *filePathName); // Ingests a data set once into a typed columnar table, along with its header, delimiter, and schema.
+void free_data_set_properties(DataSetProperties *properties); // Releases the memory held by a data set's properties and columns.
+void grow_data_set_columns(DataSetProperties *properties, size_t rowCapacity); // Grows every column to hold 'rowCapacity' values.
+void promote_data_column_to_double(DataColumn *column, size_t rowCount, size_t rowCapacity); // Converts the integer values of a column to doubles.
+void append_data_column_value(DataColumn *column, FieldSpan field, size_t rowIndex, size_t rowCapacity, DateTimeFormat *columnFormat); // Converts a value and stores it as the 'rowIndex'th value of its column, or marks it null.
+FieldSpan data_column_string(const DataColumn *column, size_t rowIndex); // Views a value of a string column in place.
+double *data_column_to_doubles(const DataColumn *column, size_t rowCount); // Copies the values of a numeric column into a new array of doubles, read them with the column's validity bitmap.
+ColumnStatisticsCache *data_column_statistics(DataSetProperties *properties, int fieldIndex); // Returns the derived data shared by the statistical methods for a numeric column, rebuilt only if the column has changed.
+char *write_data_set_properties_plottable_fields(const DataSetProperties *properties); // Writes every numeric column to the plottable fields directory, straight from its contiguous values.
+char *write_data_set_properties_correlation_matrix(const DataSetProperties *properties, CorrelationMethod method); // Writes the covariance or correlation matrix of every numeric column next to the plottable fields directory.
+void print_data_set_properties_statistics(DataSetProperties *properties, QuantileMode quantileMode); // Prints the statistics of every numeric column, computed once per column from its statistics cache without its nulls.
+/// \}
+
+
+
+
+
+
+
+
+
+
+
+// -------------- Group-By Structure Definitions --------------
+/**
+ * GroupAggregate Structure: The aggregate of a numeric column over the rows of one group.
+ *
+ * - count: The number of values aggregated.
+ * - nullCount: The number of rows of the group whose value was null.
+ * - sum: The sum of the values.
+ * - mean: The mean of the values.
+ * - M2: The sum of the squared deviations of the values from their mean.
+ * - min: The smallest value, INFINITY if there are none.
+ * - max: The largest value, -INFINITY if there are none.
+ */
+typedef struct
+{
+	int64_t count;
+	int64_t nullCount;
+	double sum;
+	double mean;
+	double M2;
+	double min;
+	double max;
+} GroupAggregate;
+
+
+/**
+ * GroupByTable Structure: The groups found in a set of rows, and their aggregates(see 'create_group_by_table').
+ *
+ * - keyColumnCount: The number of key columns.
+ * - valueColumnCount: The number of value columns.
+ * - groupCount: The number of groups.
+ * - groupCapacity: The number of groups the arrays can hold before they must grow.
+ * - groupKeys: The interned identifier of each group's value in each key column, 'keyColumnCount' per group, GROUP_BY_NULL_KEY_ID for a null.
+ * - groupHashes: The hash of each group's key.
+ * - aggregates: Each group's aggregate of each value column, 'valueColumnCount' per group.
+ * - slots: The open-addressing hash table, each slot holding the index of a group or -1 if empty.
+ * - slotCount: The number of slots, a power of two at least twice the number of groups.
+ */
+typedef struct
+{
+	int keyColumnCount;
+	int valueColumnCount;
+	int groupCount;
+	int groupCapacity;
+	
+	
+	int *groupKeys;
+	uint64_t *groupHashes;
+	GroupAggregate *aggregates;
+	
+	
+	int *slots;
+	int slotCount;
+} GroupByTable;
+
+
+/**
+ * GroupByTask Structure: The rows aggregated by one thread of 'group_data_set_by', and the thread's own table.
+ *
+ * - keyIds: The interned identifiers of the values of each key column, one per row.
+ * - values: The values of each value column.
+ * - validity: The validity bitmap of each value column.
+ * - start: The first row of the range.
+ * - end: One past the last row of the range.
+ * - table: The groups of the thread's rows.
+ */
+typedef struct
+{
+	const int *const *keyIds;
+	const double *const *values;
+	const uint64_t *const *validity;
+	int start;
+	int end;
+	GroupByTable table;
+} GroupByTask;
+
+
+/**
+ * GroupByResult Structure: The groups of a data set by one or more string columns, and the aggregates of every numeric column over them.
+ *
+ * - keyColumnCount: The number of key columns.
+ * - keyFieldIndices: The index of each key column among the data set's fields.
+ * - keyDictionaries: The strings of each key column, by the identifiers in the groups' keys.
+ * - valueColumnCount: The number of value columns.
+ * - valueFieldIndices: The index of each value column among the data set's fields.
+ * - groups: The groups, in the order their first rows appear, and their aggregates.
+ */
+typedef struct
+{
+	int keyColumnCount;
+	int *keyFieldIndices;
+	StringInternTable *keyDictionaries;
+	
+	
+	int valueColumnCount;
+	int *valueFieldIndices;
+	GroupByTable groups;
+} GroupByResult;
+
+
+
+
+// ------------- Helper Functions for Grouping and Aggregating a Columnar Data Set -------------
+/// \{
+GroupAggregate create_group_aggregate(void); // Creates the aggregate of a group holding no values.
+void add_to_group_aggregate(GroupAggregate *aggregate, double value); // Adds a value to the aggregate of a group.
+void merge_group_aggregates(GroupAggregate *aggregate, const GroupAggregate *otherAggregate); // Merges the aggregate of other values of a group into an aggregate.
+double group_aggregate_variance(const GroupAggregate *aggregate); // The sample variance of the values of a group.
+GroupByTable create_group_by_table(int keyColumnCount, int valueColumnCount); // Creates an empty group-by hash table.
+void free_group_by_table(GroupByTable *table); // Releases the memory held by a group-by table.
+uint64_t hash_group_key(const int *keyIds, int keyColumnCount); // Hashes the interned identifiers of a group's key values.
+int find_or_insert_group(GroupByTable *table, const int *keyIds, uint64_t hash); // Finds a group by its key, adding it if it is new.
+void *aggregate_group_by_rows(void *task); // Thread routine aggregating a range of rows into a thread-local table.
+GroupByResult group_data_set_by(const DataSetProperties *properties, const int *keyFieldIndices, int keyColumnCount, int threadCount); // Groups the rows by string columns and aggregates every numeric column per group.
+void print_group_by_result(const GroupByResult *result, const DataSetProperties *properties); // Prints each group and its aggregates.
+void print_data_set_properties_groups(const DataSetProperties *properties, const int *keyFieldIndices, int keyColumnCount); // Groups by the given string columns, or by each string column in turn, and prints the groups.
+void free_group_by_result(GroupByResult *result); // Releases the memory held by a group-by result.
+/// \}
+
+
+
+
+
+
+
+
+
+
+
+// -------------- Data Set Run Options Structure Definition --------------
+/**
+ * DataSetRunOptions Structure: Configures how a data set is processed by 'run_data_set'.
+ *
+ * - legacyStringPipeline: Whether to run the original pipeline, which preprocesses every data entry into a formatted string, writes the
+ *   formatted data set with 'write_data_set', and parses it again with 'parse_entire_file', instead of ingesting the data set once into
+ *   a typed columnar table with 'analyze_data_set_properties'.
+ * - quantileMode: How the quartiles used to bin each field are found, QUANTILE_MODE_AUTOMATIC finds them exactly unless a copy of the
+ *   field would exceed EXACT_QUANTILE_MEMORY_BUDGET.
+ * - correlationMethod: The measure written as the matrix of every pair of numeric fields, next to the plottable fields directory.
+ * - groupByFieldIndices: The indices of the string fields whose values together key the groups the numeric fields are aggregated
+ *   over, or NULL to group by each string field in turn.
+ * - groupByFieldCount: The number of indices in 'groupByFieldIndices', 0 to group by each string field in turn.
+ */
+typedef struct
+{
+	bool legacyStringPipeline;
+	QuantileMode quantileMode;
+	CorrelationMethod correlationMethod;
+	const int *groupByFieldIndices;
+	int groupByFieldCount;
+} DataSetRunOptions;
+
+DataSetRunOptions default_data_set_run_options(void); // Returns the default configuration for running a data set, through its columnar table
+
+
+
+
+
+
+
+
+
+
+// -------------- Streaming Data Set Structure Definitions --------------
+/**
+ * StreamingOptions Structure: Configures how a data set is streamed by 'stream_data_set'.
+ *
+ * - windowRowCount: The maximum number of rows processed together before their values are written out and their memory is reused.
+ * - memoryBudgetBytes: The maximum number of bytes the window buffers may occupy, the window is shrunk(to no fewer than one row) when
+ *   the configured number of rows would not fit, so wide data sets are still processed within the budget.
+ * - quantileMode: How the median and quartiles of each field are found once it has been streamed, QUANTILE_MODE_AUTOMATIC finds them
+ *   exactly(reading the field back from its plottable field file) unless its values would exceed EXACT_QUANTILE_MEMORY_BUDGET.
+ */
+typedef struct
+{
+	size_t windowRowCount;
+	size_t memoryBudgetBytes;
+	QuantileMode quantileMode;
+} StreamingOptions;
+
+
+
+/**
+ * ColumnAccumulator Structure: The running summary of a single field, updated window by window as a data set is streamed.
+ *
+ * - count: The number of values accumulated(only plottable fields accumulate values, missing values are not accumulated).
+ * - missingCount: The number of entries whose value was missing or did not match the field's expected data type.
+ * - sum: The sum of the accumulated values.
+ * - min: The smallest accumulated value.
+ * - max: The largest accumulated value.
+ * - sketch: The quantile sketch of the accumulated values, from which their median and IQR are estimated(NULL for unplottable fields).
+ * - histogram: The streaming histogram of the accumulated values, each window's own merged into it(NULL for unplottable fields).
+ * - quantileMode: How the median, IQR, and binning below were found, QUANTILE_MODE_EXACT or QUANTILE_MODE_SKETCH.
+ * - median: The median of the accumulated values, NAN if there are fewer than 2.
+ * - iqr: The Interquartile Range of the accumulated values, NAN if there are fewer than 2.
+ * - binWidth: The Freedman-Diaconis bin width of the accumulated values, NAN if their IQR is zero or there are fewer than 2.
+ * - binCount: The number of bins of the Freedman-Diaconis rule, 0 if there are fewer than 2 values.
+ * - binning: The streaming histogram converted to 'binCount' equal-width bins once the field has been streamed(as many bins as it
+ *   holds if there are fewer than 2 values, a single empty bin if there are none).
+ */
+typedef struct
+{
+	size_t count;
+	size_t missingCount;
+	double sum;
+	double min;
+	double max;
+	QuantileSketch *sketch;
+	StreamingHistogram *histogram;
+	
+	
+	QuantileMode quantileMode;
+	double median;
+	double iqr;
+	double binWidth;
+	int binCount;
+	Histogram binning;
+} ColumnAccumulator;
+
+
+
+/**
+ * StreamingDataSetSummary Structure: The result of streaming a data set with 'stream_data_set'.
+ *
+ * - entryCount: The number of data entries processed(excluding the header line).
+ * - fieldCount: The number of fields per data entry.
+ * - plottableFieldCount: The number of fields whose values were written to the plottable fields directory.
+ * - delimiter: The delimiter identified for the data set.
+ * - fieldNames: Array of the names of every field, as they appear in the header line.
+ * - plottabilityStatus: Array holding 1 for each plottable field and 0 for each unplottable field.
+ * - columnAccumulators: Array holding the running summary of each field.
+ * - plottableFieldsDirectory: Path of the directory the plottable fields were written to.
+ */
+typedef struct
+{
+	size_t entryCount;
+	int fieldCount;
+	int plottableFieldCount;
+	
+	
+	const char *delimiter;
+	char **fieldNames;
+	int *plottabilityStatus;
+	ColumnAccumulator *columnAccumulators;
+	char *plottableFieldsDirectory;
+} StreamingDataSetSummary;
+
+StreamingOptions default_streaming_options(void); // Returns the default window size and memory budget for streaming a data set
+StreamingDataSetSummary stream_data_set(const char *filePathName, StreamingOptions options); // Processes a data set window by window without holding the whole of it in memory
+double *read_plottable_field_values(const char *plottableFieldFilePathName, size_t valueCount, size_t *readCount); // Reads the present values of a plottable field file back into memory
+void summarize_streamed_column(ColumnAccumulator *accumulator, const char *plottableFieldFilePathName, QuantileMode mode); // Finds the median, IQR, and binning of a streamed field, exactly or from its sketch
+void free_streaming_data_set_summary(StreamingDataSetSummary *summary); // Releases the memory held by a streaming data set summary
 
 #endif /* AnalysisUtilities_h */
@@ -26,6 +26,7 @@
 
 #include <stdio.h>
 #include <pthread.h> // For POSIX Threads
+#include <stdint.h>
 
 
 
@@ -36,7 +37,24 @@
 
 
 static const size_t MAX_STRING_SIZE = 1000; // Maximum string size.
-static const size_t MAX_NUM_FILE_LINES = 100000; // Maximum number of lines in a file.
+static const size_t STREAMING_WINDOW_ROW_COUNT = 65536; // Default number of rows processed per window when a data set is streamed.
+static const size_t STREAMING_MEMORY_BUDGET = 64 * 1024 * 1024; // Default number of bytes the window buffers of a streamed data set may occupy.
+static const size_t MEMORY_ARENA_BLOCK_SIZE = 1024 * 1024; // Default number of bytes of each block a memory arena allocates from.
+static const int MOMENTS_BLOCK_LENGTH = 256; // Number of values whose moments are computed at once, in cache, before being merged into a running accumulator.
+static const int SELECTION_INSERTION_SORT_LENGTH = 16; // Length at or below which a range being searched for order statistics is sorted by insertion rather than partitioned further.
+static const int MERGE_SORT_INSERTION_LENGTH = 32; // Length of the runs sorted by insertion before a merge sort starts merging.
+static const int PARALLEL_MERGE_SORT_MIN_RUN_LENGTH = 32768; // Minimum number of values each thread of a parallel merge sort is given, shorter arrays use fewer threads.
+static const int PARALLEL_RADIX_SORT_MIN_CHUNK_LENGTH = 65536; // Minimum number of keys each thread of a parallel radix sort is given, shorter arrays use fewer threads.
+static const int QUANTILE_SKETCH_DEFAULT_K = 200; // Default accuracy parameter of a quantile sketch, giving a rank error of about 1.33%.
+static const int QUANTILE_SKETCH_MIN_LEVEL_CAPACITY = 8; // Smallest capacity of any level of a quantile sketch.
+static const size_t EXACT_QUANTILE_MEMORY_BUDGET = 256 * 1024 * 1024; // Maximum number of bytes of a column's copy for its quantiles to be found exactly rather than sketched.
+static const int PARALLEL_HISTOGRAM_MIN_CHUNK_LENGTH = 65536; // Minimum number of rows each thread bins, fewer are binned by a single thread.
+static const int STREAMING_HISTOGRAM_DEFAULT_BINS = 64; // Default number of bins a streaming histogram keeps.
+static const int CORRELATION_TILE_COLUMNS = 32; // Number of columns in each block of a correlation matrix tile.
+static const int CORRELATION_TILE_ROWS = 256; // Number of rows packed into a correlation panel at a time.
+static const int PARALLEL_GROUP_BY_MIN_ROWS = 65536; // Minimum number of rows each thread of a group-by aggregates.
+static const int GROUP_BY_NULL_KEY_ID = -1; // Key identifier of a null in a key column of a group-by, kept apart from every interned string, the empty one included.
+static const int GROUP_BY_MAX_CATEGORY_GROUPS = 64; // Maximum number of groups printed for a string column grouped by on its own, a column with more is not treated as a category.
 
 /// \}
 
@@ -150,6 +168,23 @@ extern const char *commonUnitFormats[45]; // An array of string literals represe
 
 
 
+/**@{
+------------------ CONSTANTS FACILITATING NUMBER PARSING ------------------
+ * These constants are used for converting the decimal representations of numbers in data set fields into doubles without
+ * going through the C library, see 'parse_numeric_string'.
+ **/
+#define POWERS_OF_FIVE_SMALLEST_EXPONENT (-325) // The exponent of the first entry of 'powersOfFiveTable'
+#define POWERS_OF_FIVE_LARGEST_EXPONENT 308 // The exponent of the last entry of 'powersOfFiveTable'
+extern const uint64_t powersOfFiveTable[634][2]; // The 128 most significant bits of each power of five from 5^-325 to 5^308.
+/** @}*/
+
+
+
+
+
+
+
+
 /**@{
 ------------------ CONSTANTS FACILITATING NEW FILE NAMING ------------------
  * These constants are used for defining standard formats and identifiers for new text files.
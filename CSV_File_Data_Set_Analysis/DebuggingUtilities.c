@@ -3,6 +3,8 @@
 //  DavidRichardson02
 
 
+#include <time.h>
+
 #include "DebuggingUtilities.h"
 #include "CommonDefinitions.h"
 #include "GeneralUtilities.h"
@@ -219,9 +221,11 @@ void print_file(const char* filePathName)
 	char *fileExtension = identify_file_extension(filePathName);
 	char *directoryPathName = find_file_directory_path(filePathName);
 	char *fileName = find_name_from_path(filePathName);
-	int countFileLines = count_file_lines(filePathName, MAX_NUM_FILE_LINES);
+	MappedFile mappedFile = map_file_contents(filePathName);
+	int countFileLines = (int)mappedFile.lineIndex.count;
 	
-	char **fileContents = read_file_contents(filePathName, countFileLines);
+	LineStore fileContents = read_mapped_file_contents(&mappedFile, countFileLines);
+	unmap_file_contents(&mappedFile);
 	
 	
 	
@@ -237,10 +241,11 @@ void print_file(const char* filePathName)
 	printf("\n\n\n\n\n\nFile Contents: \n");
 	for(int i = 0; i < countFileLines; i++)
 	{
-		printf("\n    Line %d:       %-5s", i, fileContents[i]);
+		printf("\n    Line %d:       %-5s", i, line_store_line(&fileContents, i));
 	}
 	
 	printf("\n\n\n=========================================================================================");
+	free_line_store(&fileContents);
 }
 
 
@@ -277,3 +282,172 @@ void print_file_contents(char** fileContents, int countFileLines)
 
 
 
+
+
+/**
+ * benchmark_string_tokenizers
+ * Times the three ways of tokenizing a string available to the program, 'tokenize_string', the C library's strtok_r, and the
+ * reentrant 'StringTokenizer', by tokenizing every string of the array to its end 'repetitions' times with each, and prints the
+ * average time per string and the total number of tokens found(which must be the same for all three).
+ *
+ * Each string is copied into a scratch buffer before being tokenized, because tokenizing modifies the string, the copy costs the
+ * same for each method, so the differences between the timings are due to the tokenizers alone.
+ *
+ * @param stringArray The strings to be tokenized, for example the lines of a data set. They are not modified.
+ * @param stringCount The number of strings in the array.
+ * @param delimiter The delimiter character(s) used to tokenize the strings.
+ * @param repetitions The number of times each string is tokenized by each method.
+ */
+void benchmark_string_tokenizers(char **stringArray, int stringCount, const char *delimiter, int repetitions)
+{
+	if(stringArray == NULL || stringCount <= 0 || repetitions <= 0){ perror("\n\nError: invalid input in 'benchmark_string_tokenizers'.");      return; }
+	
+	
+	/// Measure each string once so that the copies made while timing don't have to
+	size_t *stringLengths = (size_t *)malloc(stringCount * sizeof(size_t));
+	size_t maxStringLength = 0;
+	for(int i = 0; i < stringCount; i++)
+	{
+		stringLengths[i] = strlen(stringArray[i]);
+		if(stringLengths[i] > maxStringLength)
+		{
+			maxStringLength = stringLengths[i];
+		}
+	}
+	char *scratch = (char *)malloc(maxStringLength + 1);
+	
+	
+	const char *methodNames[3] = { "tokenize_string", "strtok_r", "StringTokenizer" };
+	double methodSeconds[3];
+	size_t methodTokenCounts[3];
+	for(int method = 0; method < 3; method++)
+	{
+		size_t tokenCount = 0;
+		struct timespec start, end;
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		for(int repetition = 0; repetition < repetitions; repetition++)
+		{
+			for(int i = 0; i < stringCount; i++)
+			{
+				memcpy(scratch, stringArray[i], stringLengths[i] + 1);
+				if(method == 0)
+				{
+					for(char *token = tokenize_string(scratch, delimiter); token != NULL; token = tokenize_string(NULL, delimiter))
+					{
+						tokenCount++;
+					}
+				}
+				else if(method == 1)
+				{
+					char *saveptr;
+					for(char *token = strtok_r(scratch, delimiter, &saveptr); token != NULL; token = strtok_r(NULL, delimiter, &saveptr))
+					{
+						tokenCount++;
+					}
+				}
+				else
+				{
+					StringTokenizer tokenizer = create_string_tokenizer(scratch, delimiter);
+					for(char *token = next_string_token(&tokenizer); token != NULL; token = next_string_token(&tokenizer))
+					{
+						tokenCount++;
+					}
+				}
+			}
+		}
+		clock_gettime(CLOCK_MONOTONIC, &end);
+		methodSeconds[method] = (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) * 1e-9;
+		methodTokenCounts[method] = tokenCount;
+	}
+	
+	
+	printf("\n\nbenchmark_string_tokenizers: %d strings x %d repetitions, delimiter '%s', structural character scan: %s", stringCount, repetitions, delimiter, structural_character_scanner_name(select_structural_character_scanner()));
+	for(int method = 0; method < 3; method++)
+	{
+		printf("\n    %-18s %10.2f ns/string      %8.3f s      tokens: %zu", methodNames[method], methodSeconds[method] * 1e9 / ((double)stringCount * repetitions), methodSeconds[method], methodTokenCounts[method]);
+	}
+	printf("\n    StringTokenizer speedup over tokenize_string: %.2fx\n", methodSeconds[0] / methodSeconds[2]);
+	
+	
+	free(scratch);
+	free(stringLengths);
+}
+
+
+
+
+/**
+ * benchmark_sorts
+ * Times the ways of sorting an array of doubles available to the program, 'merge_sort', 'parallel_merge_sort' on every hardware
+ * thread, 'radix_sort_doubles', and 'parallel_radix_sort_doubles' on every hardware thread, by sorting the same pseudo-random values(uniform over [-1e6, 1e6), from a fixed seed) with each
+ * 'repetitions' times, and prints the average time per sort. Each sort is checked against the result of the first, so a sort that
+ * disagrees is reported rather than merely timed.
+ *
+ * @param numElements The number of values to sort.
+ * @param repetitions The number of times the values are sorted by each method.
+ */
+void benchmark_sorts(int numElements, int repetitions)
+{
+	if(numElements <= 0 || repetitions <= 0){ perror("\n\nError: invalid input in 'benchmark_sorts'.");      return; }
+	
+	
+	double *values = allocate_memory_double_ptr(numElements);
+	double *scratch = allocate_memory_double_ptr(numElements);
+	double *reference = allocate_memory_double_ptr(numElements);
+	srand(1);
+	for(int i = 0; i < numElements; i++)
+	{
+		values[i] = ((double)rand() / RAND_MAX - 0.5) * 2e6;
+	}
+	
+	
+	const char *methodNames[4] = { "merge_sort", "parallel_merge_sort", "radix_sort_doubles", "parallel_radix_sort_doubles" };
+	double methodSeconds[4] = { 0.0, 0.0, 0.0, 0.0 };
+	bool methodMatches[4] = { true, true, true, true };
+	for(int method = 0; method < 4; method++)
+	{
+		for(int repetition = 0; repetition < repetitions; repetition++)
+		{
+			memcpy(scratch, values, numElements * sizeof(double)); // The copy is not timed
+			struct timespec start, end;
+			clock_gettime(CLOCK_MONOTONIC, &start);
+			if(method == 0)
+			{
+				merge_sort(scratch, numElements);
+			}
+			else if(method == 1)
+			{
+				parallel_merge_sort(scratch, numElements, 0);
+			}
+			else if(method == 2)
+			{
+				radix_sort_doubles(scratch, numElements);
+			}
+			else
+			{
+				parallel_radix_sort_doubles(scratch, numElements, 0);
+			}
+			clock_gettime(CLOCK_MONOTONIC, &end);
+			methodSeconds[method] += (double)(end.tv_sec - start.tv_sec) + (double)(end.tv_nsec - start.tv_nsec) * 1e-9;
+		}
+		
+		if(method == 0)
+		{
+			memcpy(reference, scratch, numElements * sizeof(double));
+		}
+		methodMatches[method] = memcmp(reference, scratch, numElements * sizeof(double)) == 0;
+	}
+	
+	
+	printf("\n\nbenchmark_sorts: %d values x %d repetitions, %d hardware threads", numElements, repetitions, determine_hardware_thread_count());
+	for(int method = 0; method < 4; method++)
+	{
+		printf("\n    %-28s %10.3f ms/sort      %s", methodNames[method], methodSeconds[method] * 1e3 / repetitions, methodMatches[method] ? "matches" : "DIFFERS from merge_sort");
+	}
+	printf("\n    parallel_merge_sort speedup over merge_sort: %.2fx, parallel_radix_sort_doubles speedup over radix_sort_doubles: %.2fx\n", methodSeconds[0] / methodSeconds[1], methodSeconds[2] / methodSeconds[3]);
+	
+	
+	free(values);
+	free(scratch);
+	free(reference);
+}
@@ -42,4 +42,15 @@ void print_file_contents(char** fileContents, int countFileLines); // Prints fil
 
 
 
+// ------------- Helper Functions for Benchmarking -------------
+/// \{
+void benchmark_string_tokenizers(char **stringArray, int stringCount, const char *delimiter, int repetitions); // Times 'tokenize_string', strtok_r, and the 'StringTokenizer' over the same strings and prints the results.
+void benchmark_sorts(int numElements, int repetitions); // Times the serial and parallel merge and radix sorts over the same random values and prints the results.
+/// \}
+
+
+
+
+
+
 #endif /* DebuggingUtilities_h */
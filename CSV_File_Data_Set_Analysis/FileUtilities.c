@@ -11,6 +11,8 @@
 #include <sys/stat.h>
 #include <unistd.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
 
 
 
@@ -108,11 +110,12 @@ char* find_file_directory_path(const char* filePathName)
 	}
 	
 	char* directoryPathName;
-	directoryPathName = allocate_memory_char_ptr(directoryPathNameCharacterCount);
+	directoryPathName = allocate_memory_char_ptr(directoryPathNameCharacterCount + 1);
 	for(int i = 0; i < directoryPathNameCharacterCount; i++)
 	{
 		directoryPathName[i] = filePathName[i];
 	}
+	directoryPathName[directoryPathNameCharacterCount] = '\0';
 	
 	return directoryPathName;
 }
@@ -143,12 +146,14 @@ char* find_name_from_path(const char* filePathName)
 	
 	
 	char *fileName;
-	fileName = allocate_memory_char_ptr(fileNameLength);
+	fileName = allocate_memory_char_ptr(fileNameLength + 1);
 	
 	for(int i = 0; i < fileNameLength; i++)
 	{
 		fileName[i] = filePathName[i+directoryPathLength];
 	}
+	fileName[fileNameLength] = '\0';
+	free(directoryPathName);
 	
 	
 	return fileName;
@@ -166,39 +171,40 @@ char* find_name_from_path(const char* filePathName)
  *
  * Counts the number of data fields in a CSV-style line.
  * This function processes a line from a CSV file and counts the number of fields based on commas.
- * It also handles empty fields (i.e., two consecutive commas) by temporarily replacing them with spaces.
- * The function assumes that the input string is null-terminated and that the fields are
- * separated by commas. It modifies the input string temporarily but restores its original state.
+ * It also handles empty fields (i.e., two consecutive commas) by replacing the first comma of each pair with a space.
+ * The line is examined 64 bytes at a time with the structural character scan: the commas of a block are counted with a
+ * population count, and a comma whose preceding character is also a comma is found by shifting the block's comma mask by one.
+ * The function assumes that the input string is null-terminated and that the fields are separated by commas.
  *
  * @param lineContents A string representing a line from a CSV file.
  * @return The number of data fields in the line.
  */
 int count_data_fields(char* lineContents)
 {
-	for(int i = 0; i < strlen(lineContents)+1;i++)
+	size_t length = strlen(lineContents);
+	if (length == 0)
 	{
-		if(lineContents[i] == ',' && lineContents[i+1] == ',')
-		{
-			lineContents[i] = ' ';
-		}
+		return 0;
 	}
 	
 	
-	int count = 0;
-	// If the header is not empty, start with count 1 (the first field before any comma).
-	if (lineContents && strlen(lineContents) > 0)
-	{
-		count = 1;
-	}
-	
-	// Iterate over each character in the string.
-	for (int i = 0; lineContents[i] != '\0'; i++)
+	StructuralCharacterScanner scanner = select_structural_character_scanner();
+	int count = 1; // The first field before any comma
+	uint64_t previousBlockEndsWithComma = 0;
+	for (size_t blockStart = 0; blockStart < length; blockStart += 64)
 	{
-		// Increment count at each comma, which indicates a new field.
-		if (lineContents[i] == ',')
+		size_t blockLength = (length - blockStart < 64) ? length - blockStart : 64;
+		uint64_t commaMask = scanner(lineContents + blockStart, blockLength, ',').delimiterMask;
+		uint64_t repeatedCommaMask = commaMask & ((commaMask << 1) | previousBlockEndsWithComma); // Commas preceded by a comma
+		
+		
+		// Increment count at each comma, which indicates a new field, except where the comma repeats the one before it
+		count += __builtin_popcountll(commaMask) - __builtin_popcountll(repeatedCommaMask);
+		for (; repeatedCommaMask != 0; repeatedCommaMask &= repeatedCommaMask - 1)
 		{
-			count++;
+			lineContents[blockStart + __builtin_ctzll(repeatedCommaMask) - 1] = ' ';
 		}
+		previousBlockEndsWithComma = commaMask >> 63;
 	}
 	return count;
 }
@@ -223,11 +229,12 @@ int count_plot_data_fields(char* lineContents, const char *delimiter)
 	// Counts the number of fields in a data entry.
 	int count = 0;
 	char* dataCopy = strdup(lineContents);
-	char* token = strtok(dataCopy, delimiter);
+	StringTokenizer tokenizer = create_string_tokenizer(dataCopy, delimiter);
+	char* token = next_string_token(&tokenizer);
 	while (token)
 	{
 		count++;
-		token = strtok(NULL, delimiter);
+		token = next_string_token(&tokenizer);
 	}
 	free(dataCopy);
 	
@@ -242,43 +249,35 @@ int count_plot_data_fields(char* lineContents, const char *delimiter)
  * count_file_lines
  *
  * Counts the number of lines in a file.
- * This function opens a file specified by its path (filePathName) and counts
- * the number of lines it contains, up to a maximum specified by maxLines.
- * It uses fgets to read each line into a buffer and increments a counter
- * for each line read.
+ * This function maps the file specified by its path (filePathName) into memory and counts the newline characters
+ * it contains with 'memchr', a final line without a trailing newline is still counted as a line. No line buffer is
+ * used, so neither the length nor the number of lines is bounded by anything other than the size of the file.
  *
  * @param filePathName A string representing the path to the file.
- * @param maxLines An integer specifying the maximum line length buffer.
  * @return The total number of lines in the file.
  */
-int count_file_lines(const char* filePathName, int maxLines)
+size_t count_file_lines(const char* filePathName)
 {
 	printf("\nEntering: 'count_file_lines' function.\n");
-	//Open the file at the specified path and ensure file is opened properly.
-	FILE *tempFile = fopen(filePathName, "r");
-	if (!tempFile)
+	MappedFile mappedFile = map_file_bytes(filePathName);
+	if (mappedFile.size == 0)
 	{
-		perror("\n\nError: Unable to open file for 'count_file_lines'.\n");
-		exit(1);
+		return 0;
 	}
 	
 	
-	char line[maxLines]; // Buffer to hold each line from the file.
-						 // Count the number of lines in the file from a starting point numLinesToSkip away from the first line.
-	int count = 0;
-	while((fgets(line, sizeof(line), tempFile)))
+	const char *end = mappedFile.contents + mappedFile.size;
+	size_t count = 0;
+	for (const char *newline = mappedFile.contents; (newline = memchr(newline, '\n', (size_t)(end - newline))) != NULL; newline++)
 	{
 		count++;
 	}
-	
-	
-	if (count >= maxLines)
+	if (mappedFile.contents[mappedFile.size - 1] != '\n') // The last line is not terminated by a newline, but is still a line
 	{
-		printf("\n\nError: The number of lines in the file '%s' exceeded the expected number of maximum lines, %zu 'count_file_lines'.\n", filePathName, MAX_NUM_FILE_LINES);
-		perror("\n\nError: File  'count_file_lines'.\n");
-		exit(1);
+		count++;
 	}
-	fclose(tempFile);
+	
+	unmap_file_contents(&mappedFile);
 	return count;
 }
 
@@ -421,111 +420,760 @@ int* count_characters_in_file_lines_range(const char* filePathName, int lineCoun
 
 
 /**
- * read_file_contents
+ * create_line_index
  *
- * Reads the contents of a file into an array of strings.
- * This function opens a file and reads its contents line by line, counting the characters in each line,
- * and then reading each line into a dynamically allocated array of strings (char pointers).
- * Each line is stored in the array up to the specified lineCount.
+ * Creates an empty line index with room for 'initialCapacity' offsets.
  *
- * @param filePathName A string representing the path of the file to be read.
- * @param lineCount An integer specifying the number of lines to read from the file.
- * @return A pointer to an array of strings, each string holding the content of a line.
+ * @param initialCapacity The number of offsets to allocate room for up front(at least one is always allocated).
+ * @return An empty LineIndex structure.
  */
-char** read_file_contents(const char* filePathName, int lineCount)
+LineIndex create_line_index(size_t initialCapacity)
 {
-	// Checking if the filePathName is NULL or if lineCount is less than or equal to 0.
-	// If so, return NULL as it's not possible to read the file contents under these conditions.
-	if (filePathName == NULL || lineCount <= 0)
+	LineIndex lineIndex = {NULL, 0, (initialCapacity > 0) ? initialCapacity : 1};
+	
+	lineIndex.offsets = (uint64_t *)malloc(lineIndex.capacity * sizeof(uint64_t));
+	if (lineIndex.offsets == NULL)
 	{
-		perror("\n\nError:filePathName is NULL or if lineCount is less than or equal to 0 in 'read_file_contents'.");
-		return NULL;
+		perror("\n\nError: Unable to allocate memory for the line index in 'create_line_index'.\n");
+		exit(1);
 	}
 	
+	return lineIndex;
+}
+
+
+
+
+/**
+ * append_line_offset
+ *
+ * Appends the offset at which a line begins to a line index. When the index is full its capacity is doubled, so appending
+ * 'n' offsets costs amortized O(1) each and only O(log n) reallocations occur in total.
+ *
+ * @param lineIndex The line index to append to.
+ * @param offset The byte offset at which the line begins.
+ */
+void append_line_offset(LineIndex *lineIndex, uint64_t offset)
+{
+	if (lineIndex->count == lineIndex->capacity) // Grow the line index geometrically
+	{
+		if (lineIndex->capacity > SIZE_MAX / (2 * sizeof(uint64_t)))
+		{
+			perror("\n\nError: The line index exceeded the addressable memory in 'append_line_offset'.\n");
+			exit(1);
+		}
+		size_t grownCapacity = lineIndex->capacity * 2;
+		uint64_t *grownOffsets = (uint64_t *)realloc(lineIndex->offsets, grownCapacity * sizeof(uint64_t));
+		if (grownOffsets == NULL)
+		{
+			perror("\n\nError: Unable to grow the line index in 'append_line_offset'.\n");
+			exit(1);
+		}
+		lineIndex->offsets = grownOffsets;
+		lineIndex->capacity = grownCapacity;
+	}
 	
-	//Open the file at the specified path and ensure file is opened properly.
-	FILE *tempFile = fopen(filePathName, "r");
-	if (!tempFile)
+	lineIndex->offsets[lineIndex->count++] = offset;
+}
+
+
+
+
+/**
+ * free_line_index
+ *
+ * Releases the memory held by a line index and resets it to an empty state.
+ *
+ * @param lineIndex The line index to release.
+ */
+void free_line_index(LineIndex *lineIndex)
+{
+	if (lineIndex == NULL)
 	{
-		perror("\n\nError: Unable to open file for 'read_file_contents'.");
+		return;
+	}
+	
+	free(lineIndex->offsets);
+	lineIndex->offsets = NULL;
+	lineIndex->count = 0;
+	lineIndex->capacity = 0;
+}
+
+
+
+
+
+/**
+ * create_line_store
+ *
+ * Creates an empty line store. The lines appended to it are stored back to back(each followed by its null terminator) in a single
+ * byte buffer, and the offset at which each begins is recorded, so a store of 'n' lines takes two allocations instead of 'n + 1' and
+ * its memory is proportional to the size of its lines. Both arrays grow geometrically, the capacities are only initial estimates.
+ *
+ * @param byteCapacity The number of bytes of lines(including their null terminators) to make room for.
+ * @param lineCapacity The number of lines to make room for.
+ * @return The empty line store, to be released with 'free_line_store'.
+ */
+LineStore create_line_store(size_t byteCapacity, size_t lineCapacity)
+{
+	LineStore lineStore = {NULL, 0, (byteCapacity > 0) ? byteCapacity : 1, NULL, 0, (lineCapacity > 0) ? lineCapacity : 1, NULL};
+	
+	lineStore.bytes = (char *)malloc(lineStore.byteCapacity);
+	lineStore.offsets = (size_t *)malloc((lineStore.lineCapacity + 1) * sizeof(size_t)); // +1 for the offset one past the last line
+	if (lineStore.bytes == NULL || lineStore.offsets == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory for the line store in 'create_line_store'.\n");
 		exit(1);
 	}
+	lineStore.offsets[0] = 0;
+	
+	return lineStore;
+}
+
+
+
+
+/**
+ * reserve_line_store_line
+ *
+ * Makes room at the end of a line store for a line of up to 'maxLineLength' characters, to be written directly into the store and then
+ * recorded with 'commit_line_store_line'. The byte buffer and the offsets are grown geometrically when full. Since the buffer may move,
+ * any pointer previously returned by 'line_store_line' or 'line_store_pointers' is no longer valid.
+ *
+ * @param lineStore The line store to append to.
+ * @param maxLineLength The largest number of characters the line may have, excluding its null terminator.
+ * @return The position at which to write the line, it has room for 'maxLineLength + 1' characters.
+ */
+char *reserve_line_store_line(LineStore *lineStore, size_t maxLineLength)
+{
+	if (lineStore->lineCount == lineStore->lineCapacity) // Grow the offsets geometrically
+	{
+		size_t grownCapacity = lineStore->lineCapacity * 2;
+		size_t *grownOffsets = (size_t *)realloc(lineStore->offsets, (grownCapacity + 1) * sizeof(size_t));
+		if (grownOffsets == NULL)
+		{
+			perror("\n\nError: Unable to grow the line store in 'reserve_line_store_line'.\n");
+			exit(1);
+		}
+		lineStore->offsets = grownOffsets;
+		lineStore->lineCapacity = grownCapacity;
+	}
 	
 	
-	// First, count the characters in each line.
-	int *charCounts = count_file_lines_characters(filePathName, lineCount);
+	if (lineStore->byteCapacity - lineStore->byteCount < maxLineLength + 1) // Grow the bytes geometrically
+	{
+		size_t grownCapacity = lineStore->byteCapacity * 2;
+		if (grownCapacity < lineStore->byteCount + maxLineLength + 1)
+		{
+			grownCapacity = lineStore->byteCount + maxLineLength + 1;
+		}
+		char *grownBytes = (char *)realloc(lineStore->bytes, grownCapacity);
+		if (grownBytes == NULL)
+		{
+			perror("\n\nError: Unable to grow the line store in 'reserve_line_store_line'.\n");
+			exit(1);
+		}
+		lineStore->bytes = grownBytes;
+		lineStore->byteCapacity = grownCapacity;
+	}
 	
 	
-	// Allocate memory for the array of strings.
-	char **fileContents = allocate_memory_char_ptr_ptr(MAX_STRING_SIZE, lineCount);
+	free(lineStore->linePointers); // Points into the buffer, rebuilt when next requested
+	lineStore->linePointers = NULL;
 	
-	size_t len = 0;
-	size_t read;
-	char *line = NULL;
-	int currentLine = 0;
+	return lineStore->bytes + lineStore->byteCount;
+}
+
+
+
+
+/**
+ * commit_line_store_line
+ *
+ * Records the line written at the position returned by the last call to 'reserve_line_store_line' as the next line of the store,
+ * null-terminating it.
+ *
+ * @param lineStore The line store to append to.
+ * @param lineLength The number of characters written, at most the 'maxLineLength' that was reserved.
+ */
+void commit_line_store_line(LineStore *lineStore, size_t lineLength)
+{
+	lineStore->bytes[lineStore->byteCount + lineLength] = '\0';
+	lineStore->byteCount += lineLength + 1;
+	lineStore->offsets[++lineStore->lineCount] = lineStore->byteCount;
+}
+
+
+
+
+/**
+ * append_line_store_line
+ *
+ * Appends a copy of a line to a line store.
+ *
+ * @param lineStore The line store to append to.
+ * @param line Pointer to the first character of the line, it does not need to be null-terminated.
+ * @param lineLength The number of characters in the line.
+ */
+void append_line_store_line(LineStore *lineStore, const char *line, size_t lineLength)
+{
+	char *destination = reserve_line_store_line(lineStore, lineLength);
+	memcpy(destination, line, lineLength);
+	commit_line_store_line(lineStore, lineLength);
+}
+
+
+
+
+/**
+ * append_line_store
+ *
+ * Appends every line of one line store to another, copying the bytes of all of them at once.
+ *
+ * @param destination The line store to append to.
+ * @param source The line store whose lines are appended, it is not modified.
+ */
+void append_line_store(LineStore *destination, const LineStore *source)
+{
+	size_t requiredLineCapacity = destination->lineCount + source->lineCount;
+	if (requiredLineCapacity > destination->lineCapacity) // Make room for the offsets, the bytes are reserved below
+	{
+		size_t grownCapacity = (destination->lineCapacity * 2 > requiredLineCapacity) ? destination->lineCapacity * 2 : requiredLineCapacity;
+		size_t *grownOffsets = (size_t *)realloc(destination->offsets, (grownCapacity + 1) * sizeof(size_t));
+		if (grownOffsets == NULL)
+		{
+			perror("\n\nError: Unable to grow the line store in 'append_line_store'.\n");
+			exit(1);
+		}
+		destination->offsets = grownOffsets;
+		destination->lineCapacity = grownCapacity;
+	}
+	if (source->byteCount == 0)
+	{
+		return;
+	}
 	
 	
+	char *bytes = reserve_line_store_line(destination, source->byteCount - 1); // The source's bytes include the last null terminator
+	memcpy(bytes, source->bytes, source->byteCount);
+	for (size_t i = 1; i <= source->lineCount; i++)
+	{
+		destination->offsets[destination->lineCount + i] = destination->byteCount + source->offsets[i];
+	}
+	destination->byteCount += source->byteCount;
+	destination->lineCount += source->lineCount;
+}
+
+
+
+
+/**
+ * line_store_line
+ *
+ * Returns a line of a line store as a null-terminated string within the store. The line may be modified in place(without growing it),
+ * but must not be freed, and it is only valid until the next line is appended.
+ *
+ * @param lineStore The line store.
+ * @param lineNumber The index of the line, less than 'lineStore->lineCount'.
+ * @return Pointer to the first character of the line.
+ */
+char *line_store_line(const LineStore *lineStore, size_t lineNumber)
+{
+	return lineStore->bytes + lineStore->offsets[lineNumber];
+}
+
+
+
+
+/**
+ * line_store_line_length
+ *
+ * Returns the number of characters a line of a line store had when it was appended, excluding its null terminator.
+ *
+ * @param lineStore The line store.
+ * @param lineNumber The index of the line, less than 'lineStore->lineCount'.
+ * @return The length of the line.
+ */
+size_t line_store_line_length(const LineStore *lineStore, size_t lineNumber)
+{
+	return lineStore->offsets[lineNumber + 1] - lineStore->offsets[lineNumber] - 1;
+}
+
+
+
+
+/**
+ * line_store_pointers
+ *
+ * Returns the lines of a line store as a NULL-terminated array of strings, for functions taking the contents of a file as an
+ * array of strings. The strings are the lines within the store, they must not be freed individually. The array is built on first
+ * use and owned by the store: it is released by 'free_line_store', and invalidated when a line is appended.
+ *
+ * @param lineStore The line store.
+ * @return A NULL-terminated array holding a pointer to each line of the store.
+ */
+char **line_store_pointers(LineStore *lineStore)
+{
+	if (lineStore->linePointers == NULL)
+	{
+		lineStore->linePointers = (char **)malloc((lineStore->lineCount + 1) * sizeof(char *));
+		if (lineStore->linePointers == NULL)
+		{
+			perror("\n\nError: Unable to allocate memory in 'line_store_pointers'.\n");
+			exit(1);
+		}
+		for (size_t i = 0; i < lineStore->lineCount; i++)
+		{
+			lineStore->linePointers[i] = line_store_line(lineStore, i);
+		}
+		lineStore->linePointers[lineStore->lineCount] = NULL; // Null-terminate the array
+	}
 	
-	// Read the file line by line and store each line in the corresponding string.
-	while ((read = getline(&line, &len, tempFile)) != -1 && currentLine < lineCount)
+	return lineStore->linePointers;
+}
+
+
+
+
+/**
+ * free_line_store
+ *
+ * Releases the memory held by a line store, including the array of pointers to its lines, and resets it to an empty state.
+ *
+ * @param lineStore The line store to release.
+ */
+void free_line_store(LineStore *lineStore)
+{
+	if (lineStore == NULL)
 	{
-		// Allocate memory for the current line in the array.
-		fileContents[currentLine] = allocate_memory_char_ptr((charCounts[currentLine] + 1));
-		
-		
-		
-		// Copy the contents of the line into the allocated memory
-		strncpy(fileContents[currentLine], line, charCounts[currentLine]);
-		fileContents[currentLine][charCounts[currentLine]] = '\0'; // Null-terminate the string
-		
-		currentLine++;
+		return;
 	}
-	free(line);
-	free(charCounts);
-	fclose(tempFile);
+	
+	free(lineStore->bytes);
+	free(lineStore->offsets);
+	free(lineStore->linePointers);
+	LineStore emptyLineStore = {NULL, 0, 0, NULL, 0, 0, NULL};
+	*lineStore = emptyLineStore;
+}
+
+
+
+
+/**
+ * map_file_bytes
+ *
+ * Maps the contents of a file into memory without indexing its lines.
+ * The file is opened, mapped read-only, and closed again(the mapping remains valid after the descriptor is closed).
+ * This is the basis of 'map_file_contents', and is used on its own wherever the file only needs to be walked front to back
+ * (see 'next_mapped_file_line'), so that no per-line memory is spent on an index.
+ *
+ * @param filePathName A string representing the path of the file to be mapped.
+ * @return A MappedFile structure describing the mapping with an empty line index. An empty file yields a MappedFile with no contents.
+ */
+MappedFile map_file_bytes(const char *filePathName)
+{
+	MappedFile mappedFile = {NULL, 0, {NULL, 0, 0}};
 	
 	
+	//Open the file at the specified path and ensure file is opened properly.
+	int fileDescriptor = open(filePathName, O_RDONLY);
+	if (fileDescriptor < 0)
+	{
+		perror("\n\nError: Unable to open file for 'map_file_bytes'.\n");
+		exit(1);
+	}
 	
-	// Replace double commas with a space to handle missing values.
-	// This is meant to ensure that empty fields are accounted for.
-	for (int i = 0; i < lineCount; i++)
+	struct stat fileStatus;
+	if (fstat(fileDescriptor, &fileStatus) != 0)
+	{
+		perror("\n\nError: Unable to determine the size of the file in 'map_file_bytes'.\n");
+		close(fileDescriptor);
+		exit(1);
+	}
+	mappedFile.size = (size_t)fileStatus.st_size;
+	
+	
+	if (mappedFile.size == 0) // A zero-length mapping is not permitted, an empty file simply has no lines.
+	{
+		close(fileDescriptor);
+		return mappedFile;
+	}
+	
+	
+	void *mapping = mmap(NULL, mappedFile.size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+	close(fileDescriptor); // The mapping holds its own reference to the file.
+	if (mapping == MAP_FAILED)
+	{
+		perror("\n\nError: Unable to map file into memory in 'map_file_bytes'.\n");
+		exit(1);
+	}
+	madvise(mapping, mappedFile.size, MADV_SEQUENTIAL); // The file is read front to back, hint the kernel to read ahead aggressively.
+	mappedFile.contents = (const char *)mapping;
+	
+	return mappedFile;
+}
+
+
+
+
+/**
+ * map_file_contents
+ *
+ * Maps the contents of a file into memory and builds an index of the byte offsets at which each line begins.
+ * The file is mapped with 'map_file_bytes', then its bytes are scanned exactly once, 64 at a time with the structural character scan,
+ * to locate every newline: each set bit of a block's newline mask is the end of a line.
+ * This replaces the sequence of counting the lines, counting the characters of each line, and then reading each line,
+ * which required three full passes over the file.
+ * The line index grows geometrically as lines are found, so the number of lines does not need to be known in advance.
+ *
+ * @param filePathName A string representing the path of the file to be mapped.
+ * @return A MappedFile structure describing the mapping and its line index. An empty file yields a MappedFile with no contents and no lines.
+ */
+MappedFile map_file_contents(const char *filePathName)
+{
+	MappedFile mappedFile = map_file_bytes(filePathName);
+	if (mappedFile.size == 0)
 	{
-		char *tempData = fileContents[i];
-		int extraSpaceNeeded = 0;
+		return mappedFile;
+	}
+	
+	
+	
+	/// Single pass over the mapped bytes, recording the offset at which each line begins.
+	mappedFile.lineIndex = create_line_index(1024);
+	append_line_offset(&mappedFile.lineIndex, 0);
+	StructuralCharacterScanner scanner = select_structural_character_scanner();
+	for (size_t blockStart = 0; blockStart < mappedFile.size; blockStart += 64)
+	{
+		size_t blockLength = (mappedFile.size - blockStart < 64) ? mappedFile.size - blockStart : 64;
+		uint64_t newlineMask = scanner(mappedFile.contents + blockStart, blockLength, '\n').newlineMask;
+		
 		
-		// For each line, scan through the string and count how many times two commas appear consecutively. This will determine the additional space needed.
-		for (int j = 0; tempData[j] != '\0'; j++)
+		// Each newline begins a line at the following character, unless it is the final character of the file
+		for (; newlineMask != 0; newlineMask &= newlineMask - 1)
 		{
-			if (tempData[j] == ',' && tempData[j + 1] == ',')
+			size_t lineStart = blockStart + __builtin_ctzll(newlineMask) + 1;
+			if (lineStart < mappedFile.size)
 			{
-				extraSpaceNeeded += strlen(",0.0,") - 1; // Subtract 1 because we replace two commas.
+				append_line_offset(&mappedFile.lineIndex, (uint64_t)lineStart);
 			}
 		}
+	}
+	
+	
+	return mappedFile;
+}
+
+
+
+
+/**
+ * mapped_file_line
+ *
+ * Returns a view of a single line of a mapped file. No memory is allocated and nothing is copied, the returned pointer
+ * points directly into the mapping and is therefore NOT null-terminated, the length of the line is returned through 'lineLength'.
+ * The trailing newline character is excluded from the view, consistent with how 'read_file_contents' captures lines.
+ *
+ * @param mappedFile The mapped file to retrieve the line from.
+ * @param lineNumber The index of the line to retrieve.
+ * @param lineLength Pointer to a variable in which to store the number of characters in the line.
+ * @return A pointer to the first character of the line within the mapping, or NULL if the index is out of range.
+ */
+const char *mapped_file_line(const MappedFile *mappedFile, size_t lineNumber, size_t *lineLength)
+{
+	if (mappedFile == NULL || lineNumber >= mappedFile->lineIndex.count)
+	{
+		*lineLength = 0;
+		return NULL;
+	}
+	
+	
+	size_t lineStart = (size_t)mappedFile->lineIndex.offsets[lineNumber];
+	size_t lineEnd = (lineNumber + 1 < mappedFile->lineIndex.count) ? (size_t)mappedFile->lineIndex.offsets[lineNumber + 1] : mappedFile->size;
+	
+	// Exclude the newline character terminating the line, if there is one.
+	if (lineEnd > lineStart && mappedFile->contents[lineEnd - 1] == '\n')
+	{
+		lineEnd--;
+	}
+	
+	*lineLength = lineEnd - lineStart;
+	return mappedFile->contents + lineStart;
+}
+
+
+
+
+/**
+ * next_mapped_file_line
+ *
+ * Returns a view of the line beginning at '*offset' in a mapped file and advances '*offset' to the beginning of the following line.
+ * This walks the file front to back without requiring its line index, so arbitrarily large files can be processed using no memory
+ * beyond the mapping itself. As with 'mapped_file_line', the view is NOT null-terminated and excludes the trailing newline.
+ *
+ * @param mappedFile The mapped file to walk.
+ * @param offset Pointer to the byte offset of the line to retrieve, updated to the offset of the next line.
+ * @param lineLength Pointer to a variable in which to store the number of characters in the line.
+ * @return A pointer to the first character of the line within the mapping, or NULL once the end of the file has been reached.
+ */
+const char *next_mapped_file_line(const MappedFile *mappedFile, size_t *offset, size_t *lineLength)
+{
+	if (mappedFile == NULL || *offset >= mappedFile->size)
+	{
+		*lineLength = 0;
+		return NULL;
+	}
+	
+	
+	const char *line = mappedFile->contents + *offset;
+	const char *newline = memchr(line, '\n', mappedFile->size - *offset);
+	if (newline != NULL)
+	{
+		*lineLength = (size_t)(newline - line);
+		*offset += *lineLength + 1;
+	}
+	else // The last line of the file is not terminated by a newline
+	{
+		*lineLength = mappedFile->size - *offset;
+		*offset = mappedFile->size;
+	}
+	
+	return line;
+}
+
+
+
+
+/**
+ * next_mapped_file_record
+ *
+ * Returns a view of the record beginning at '*offset' in a mapped file and advances '*offset' to the beginning of the following record.
+ * A record ends at the first newline that is not inside a quoted field, so unlike 'next_mapped_file_line', a quoted field containing
+ * newlines does not split its record. Quotes are tracked by parity, an escaped quote("") toggles the state twice and so has no effect.
+ * The view is NOT null-terminated and excludes the newline terminating the record. '*offset' must be the start of a record.
+ *
+ * @param mappedFile The mapped file to walk.
+ * @param offset Pointer to the byte offset of the record to retrieve, updated to the offset of the next record.
+ * @param recordLength Pointer to a variable in which to store the number of characters in the record.
+ * @return A pointer to the first character of the record within the mapping, or NULL once the end of the file has been reached.
+ */
+const char *next_mapped_file_record(const MappedFile *mappedFile, size_t *offset, size_t *recordLength)
+{
+	if (mappedFile == NULL || *offset >= mappedFile->size)
+	{
+		*recordLength = 0;
+		return NULL;
+	}
+	
+	
+	const char *record = mappedFile->contents + *offset;
+	size_t recordEnd = align_to_record_start(mappedFile, *offset, 0); // The offset following the newline ending this record
+	
+	*recordLength = recordEnd - *offset;
+	if (*recordLength > 0 && record[*recordLength - 1] == '\n')
+	{
+		(*recordLength)--; // Exclude the newline terminating the record
+	}
+	*offset = recordEnd;
+	
+	return record;
+}
+
+
+
+
+/**
+ * count_quotes_in_mapped_file_range
+ *
+ * Counts the double quote characters within the byte range [startOffset, endOffset) of a mapped file. The parity of the count of
+ * all quotes preceding an offset determines whether that offset lies inside a quoted field, which is how independent byte ranges
+ * of a file can learn their starting quote state without scanning the file from its beginning.
+ *
+ * @param mappedFile The mapped file to scan.
+ * @param startOffset The byte offset at which the range begins.
+ * @param endOffset The byte offset at which the range ends(exclusive).
+ * @return The number of double quote characters in the range.
+ */
+size_t count_quotes_in_mapped_file_range(const MappedFile *mappedFile, size_t startOffset, size_t endOffset)
+{
+	size_t quoteCount = 0;
+	StructuralCharacterScanner scanner = select_structural_character_scanner();
+	for (size_t blockStart = startOffset; blockStart < endOffset; blockStart += 64)
+	{
+		size_t blockLength = (endOffset - blockStart < 64) ? endOffset - blockStart : 64;
+		quoteCount += (size_t)__builtin_popcountll(scanner(mappedFile->contents + blockStart, blockLength, '\n').quoteMask);
+	}
+	
+	return quoteCount;
+}
+
+
+
+
+/**
+ * align_to_record_start
+ *
+ * Finds the start of the first record beginning after 'offset', i.e., the character following the first newline at or after 'offset'
+ * that is not inside a quoted field. Used to move an arbitrary byte offset(such as the boundary between two equally sized chunks of a
+ * file) onto a real record boundary so that no record is split between two chunks.
+ *
+ * @param mappedFile The mapped file to scan.
+ * @param offset The byte offset to begin scanning from.
+ * @param insideQuotes Nonzero if 'offset' lies inside a quoted field(an odd number of quotes precede it).
+ * @return The byte offset at which the next record begins, or the size of the file if there is no further record.
+ */
+size_t align_to_record_start(const MappedFile *mappedFile, size_t offset, int insideQuotes)
+{
+	StructuralCharacterScanner scanner = select_structural_character_scanner();
+	for (size_t blockStart = offset; blockStart < mappedFile->size; blockStart += 64)
+	{
+		size_t blockLength = (mappedFile->size - blockStart < 64) ? mappedFile->size - blockStart : 64;
+		StructuralCharacterMasks masks = scanner(mappedFile->contents + blockStart, blockLength, '\n');
 		
 		
-		// Allocate new memory for the modified string
-		char *modifiedData = allocate_memory_char_ptr(strlen(tempData) + extraSpaceNeeded + 1);
-		
-		
-		// Copy characters from the original string to the new string. When two consecutive commas are encountered, insert ", 0.0" and adjust the index accordingly.
-		for (int j = 0, k = 0; tempData[j] != '\0'; j++, k++)
+		// Each quote toggles whether the bytes following it are inside a quoted field, the first newline outside of one ends the record
+		uint64_t recordEndMask = masks.newlineMask & ~compute_quoted_region_mask(masks.quoteMask, &insideQuotes);
+		if (recordEndMask != 0)
 		{
-			if (tempData[j] == ',' && tempData[j + 1] == ',')
-			{
-				strcpy(&modifiedData[k], ",0.0,");
-				k += strlen(",0.0,") - 1; // Adjust index.
-				j++; // Skip the next comma in the original string.
-			}
-			else
-			{
-				modifiedData[k] = tempData[j];
-			}
+			return blockStart + __builtin_ctzll(recordEndMask) + 1;
 		}
-		modifiedData[strlen(tempData) + extraSpaceNeeded] = '\0'; // Null-terminate the new string.
-		
-		// Replace the original string with the modified string.
-		free(fileContents[i]); // Free the memory allocated for the original string.
-		fileContents[i] = modifiedData;
+	}
+	
+	return mappedFile->size;
+}
+
+
+
+
+/**
+ * release_mapped_file_range
+ *
+ * Tells the kernel that the pages of a mapped file within the byte range [startOffset, endOffset) are no longer needed, so that
+ * their memory can be reclaimed immediately rather than remaining resident until the whole file is unmapped. Only whole pages
+ * lying inside the range are released. The mapping stays valid, a released page is simply read from the file again if it is touched.
+ *
+ * @param mappedFile The mapped file whose pages are to be released.
+ * @param startOffset The byte offset at which the released range begins.
+ * @param endOffset The byte offset at which the released range ends(exclusive).
+ */
+void release_mapped_file_range(const MappedFile *mappedFile, size_t startOffset, size_t endOffset)
+{
+	if (mappedFile == NULL || mappedFile->contents == NULL || endOffset > mappedFile->size)
+	{
+		return;
+	}
+	
+	
+	// The mapping itself is page aligned, so only the offsets need to be rounded inwards to page boundaries.
+	size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+	size_t alignedStart = ((startOffset + pageSize - 1) / pageSize) * pageSize;
+	size_t alignedEnd = (endOffset / pageSize) * pageSize;
+	if (alignedEnd > alignedStart)
+	{
+		madvise((void *)(mappedFile->contents + alignedStart), alignedEnd - alignedStart, MADV_DONTNEED);
+	}
+}
+
+
+
+
+/**
+ * unmap_file_contents
+ *
+ * Releases the memory mapping and the line index held by a MappedFile and resets it to an empty state.
+ * Any line views previously obtained from 'mapped_file_line' are invalid after this call.
+ *
+ * @param mappedFile The mapped file to release.
+ */
+void unmap_file_contents(MappedFile *mappedFile)
+{
+	if (mappedFile == NULL)
+	{
+		return;
+	}
+	
+	if (mappedFile->contents != NULL)
+	{
+		munmap((void *)mappedFile->contents, mappedFile->size);
+	}
+	free_line_index(&mappedFile->lineIndex);
+	
+	mappedFile->contents = NULL;
+	mappedFile->size = 0;
+}
+
+
+
+
+
+
+
+
+/**
+ * read_file_contents
+ *
+ * Reads the contents of a file into a line store.
+ * This function is a wrapper around 'read_mapped_file_contents', the file is mapped into memory once, its lines are
+ * copied into a line store(a single buffer holding every line), and the mapping is then released.
+ * Each line is stored up to the specified lineCount.
+ *
+ * @param filePathName A string representing the path of the file to be read.
+ * @param lineCount An integer specifying the number of lines to read from the file.
+ * @return The line store holding the content of each line, empty if the file could not be read, to be released with 'free_line_store'.
+ */
+LineStore read_file_contents(const char* filePathName, int lineCount)
+{
+	// Checking if the filePathName is NULL or if lineCount is less than or equal to 0.
+	// If so, return an empty line store as it's not possible to read the file contents under these conditions.
+	if (filePathName == NULL || lineCount <= 0)
+	{
+		perror("\n\nError:filePathName is NULL or if lineCount is less than or equal to 0 in 'read_file_contents'.");
+		LineStore emptyLineStore = {NULL, 0, 0, NULL, 0, 0, NULL};
+		return emptyLineStore;
+	}
+	
+	
+	MappedFile mappedFile = map_file_contents(filePathName);
+	LineStore fileContents = read_mapped_file_contents(&mappedFile, lineCount);
+	unmap_file_contents(&mappedFile);
+	
+	return fileContents;
+}
+
+
+
+
+/**
+ * read_mapped_file_contents
+ *
+ * Copies the lines of an already mapped file into a line store.
+ * The line views are taken directly from the mapping's line index, so the file is not read again, and each line is
+ * written exactly once, directly into the store, by 'write_line_contents'. Empty fields are kept empty, they are nulls, not zeros.
+ * The store is sized from the size of the file, so its memory is proportional to the file rather than to the number of lines.
+ * If lineCount exceeds the number of lines in the file, the remaining lines are empty.
+ *
+ * @param mappedFile The mapped file whose lines are to be copied.
+ * @param lineCount An integer specifying the number of lines to read from the file.
+ * @return The line store holding the content of each line, empty if the file could not be read, to be released with 'free_line_store'.
+ */
+LineStore read_mapped_file_contents(const MappedFile *mappedFile, int lineCount)
+{
+	if (mappedFile == NULL || lineCount <= 0)
+	{
+		perror("\n\nError: mappedFile is NULL or lineCount is less than or equal to 0 in 'read_mapped_file_contents'.");
+		LineStore emptyLineStore = {NULL, 0, 0, NULL, 0, 0, NULL};
+		return emptyLineStore;
+	}
+	
+	
+	// Room for every byte of the file plus a null terminator per line.
+	LineStore fileContents = create_line_store(mappedFile->size + (size_t)lineCount, (size_t)lineCount);
+	for (int i = 0; i < lineCount; i++)
+	{
+		size_t lineLength = 0;
+		const char *line = mapped_file_line(mappedFile, i, &lineLength);
+		char *lineContents = reserve_line_store_line(&fileContents, lineLength);
+		commit_line_store_line(&fileContents, write_line_contents(lineContents, line, lineLength));
 	}
 	
 	
@@ -535,6 +1183,107 @@ char** read_file_contents(const char* filePathName, int lineCount)
 
 
 
+/**
+ * identify_mapped_file_delimiter
+ *
+ * Identifies the delimiter of a mapped file from a sample of its first lines, so that the delimiter of a data set can be determined
+ * without copying the whole file into an array of strings.
+ *
+ * @param mappedFile The mapped file whose delimiter is to be identified.
+ * @param sampleLineCount The maximum number of lines to sample from the beginning of the file.
+ * @return The most common delimiter found in the sampled lines(see 'identify_delimiter').
+ */
+char* identify_mapped_file_delimiter(const MappedFile *mappedFile, int sampleLineCount)
+{
+	char **sampleLines = (char**)malloc((sampleLineCount > 0 ? sampleLineCount : 1) * sizeof(char*));
+	if (sampleLines == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'identify_mapped_file_delimiter'.\n");
+		exit(1);
+	}
+	
+	
+	int sampledLineCount = 0;
+	size_t offset = 0;
+	size_t lineLength = 0;
+	const char *line;
+	while (sampledLineCount < sampleLineCount && (line = next_mapped_file_line(mappedFile, &offset, &lineLength)) != NULL)
+	{
+		sampleLines[sampledLineCount++] = copy_line_contents(line, lineLength);
+	}
+	
+	char *delimiter = identify_delimiter(sampleLines, sampledLineCount);
+	
+	deallocate_memory_char_ptr_ptr(sampleLines, sampledLineCount);
+	return delimiter;
+}
+
+
+
+
+/**
+ * copy_line_contents
+ *
+ * Copies a line view(pointer + length, such as one returned by 'mapped_file_line') into a new null-terminated string.
+ * The line is copied unchanged: an empty field(consecutive delimiters) is kept empty, so that it is read as a missing value rather
+ * than as a zero.
+ *
+ * @param line Pointer to the first character of the line, it does not need to be null-terminated.
+ * @param lineLength The number of characters in the line.
+ * @return A newly allocated string holding the contents of the line.
+ */
+char* copy_line_contents(const char *line, size_t lineLength)
+{
+	return copy_line_contents_in_arena(NULL, line, lineLength);
+}
+
+
+
+
+/**
+ * copy_line_contents_in_arena
+ *
+ * Copies a line view into a new null-terminated string exactly as 'copy_line_contents' does, with the string allocated from an arena
+ * instead of with malloc.
+ *
+ * @param arena The arena to allocate the string from, or NULL to allocate it with malloc.
+ * @param line Pointer to the first character of the line, it does not need to be null-terminated.
+ * @param lineLength The number of characters in the line.
+ * @return A newly allocated string holding the contents of the line.
+ */
+char* copy_line_contents_in_arena(MemoryArena *arena, const char *line, size_t lineLength)
+{
+	char *lineContents = allocate_memory_char_ptr_in_arena(arena, lineLength + 1);
+	write_line_contents(lineContents, line, lineLength);
+	
+	return lineContents;
+}
+
+
+
+
+/**
+ * write_line_contents
+ *
+ * Writes the contents of a line view into a buffer as a null-terminated string. Empty fields are written as they are, no value is
+ * substituted for them, so a missing value stays missing instead of becoming a zero.
+ *
+ * @param lineContents The buffer to write to, it must hold at least 'lineLength + 1' characters.
+ * @param line Pointer to the first character of the line, it does not need to be null-terminated.
+ * @param lineLength The number of characters in the line.
+ * @return The number of characters written, excluding the null terminator.
+ */
+size_t write_line_contents(char *lineContents, const char *line, size_t lineLength)
+{
+	memcpy(lineContents, line, lineLength);
+	lineContents[lineLength] = '\0'; // Null-terminate the new string.
+	
+	return lineLength;
+}
+
+
+
+
 /**
  * write_file_contents
  *
@@ -716,44 +1465,33 @@ char* generate_merged_filename(const char* filePath1, const char* filePath2)
  */
 char* merge_two_files(const char* filePath1, const char* filePath2)
 {
-	// Count lines in each file
-	int lineCount1 = count_file_lines(filePath1, MAX_NUM_FILE_LINES);
-	int lineCount2 = count_file_lines(filePath2, MAX_NUM_FILE_LINES);
+	// Map each file once, the line counts are taken from the line index built while mapping
+	MappedFile mappedFile1 = map_file_contents(filePath1);
+	MappedFile mappedFile2 = map_file_contents(filePath2);
+	size_t lineCount1 = mappedFile1.lineIndex.count;
+	size_t lineCount2 = mappedFile2.lineIndex.count;
 	
-	char** contents1 = read_file_contents(filePath1, lineCount1);
-	char** contents2 = read_file_contents(filePath2, lineCount2);
+	LineStore mergedContents = (lineCount1 > 0) ? read_mapped_file_contents(&mappedFile1, (int)lineCount1) : create_line_store(0, 0);
+	LineStore contents2 = (lineCount2 > 0) ? read_mapped_file_contents(&mappedFile2, (int)lineCount2) : create_line_store(0, 0);
+	unmap_file_contents(&mappedFile1);
+	unmap_file_contents(&mappedFile2);
 	
 	
 	// Create filename based on input filenames, "merged" string literal, and enclosing directory of the files
 	char* mergedFilename = generate_merged_filename(filePath1, filePath2);  // Combines the base names of the files(extracted from full path) then appends this to the path to the enclosing directory of the files
 	
 	
-	// Allocate memory for the merged contents array of strings
-	char** mergedContents = allocate_memory_char_ptr_ptr(MAX_STRING_SIZE, lineCount1 + lineCount2 + 1);  // +1 for safety/null termination
-	
-	
-	
-	// Copy contents from both files into the merged array
-	int i, j;
-	for (i = 0; i < lineCount1; i++)
-	{
-		mergedContents[i] = duplicate_string(contents1[i]); // Copy contents from the first file
-	}
-	for (j = 0; j < lineCount2; j++, i++)
-	{
-		mergedContents[i] = duplicate_string(contents2[j]); // Copy contents from the second file
-	}
-	mergedContents[i] = NULL;  // Null-terminate the array
+	// Append the lines of the second file to those of the first, the bytes of all of them are copied at once
+	append_line_store(&mergedContents, &contents2);
+	free_line_store(&contents2);
 	
 	
 	
 	// Write the merged contents to the new file
-	write_file_contents(mergedFilename, mergedContents);
+	write_file_contents(mergedFilename, line_store_pointers(&mergedContents));
 	
-	// Clean up memory
-	deallocate_memory_char_ptr_ptr(contents1, lineCount1);
-	deallocate_memory_char_ptr_ptr(contents2, lineCount2);
-	deallocate_memory_char_ptr_ptr(mergedContents, lineCount1 + lineCount2);
+	// Clean up memory, the merged store owns every line
+	free_line_store(&mergedContents);
 	
 	return mergedFilename; // Return the path to the merged file
 }
@@ -27,6 +27,8 @@
 #include <string.h>
 #include <time.h>
 #include <math.h>
+#include <stdint.h>
+#include "GeneralUtilities.h"
 
 
 
@@ -41,7 +43,7 @@ char* find_name_from_path(const char* filePathName); // Extracts the file name f
 
 int count_data_fields(char* headerLine); // Counts the number of data fields in a header line
 int count_plot_data_fields(char* lineContents, const char *delimiter); // Counts the number of fields in a plot data line
-int count_file_lines(const char* filePathName, int maxLines); // Counts the lines in a file up to a specified maximum
+size_t count_file_lines(const char* filePathName); // Counts the lines in a file, limited only by the size of the file
 int* count_file_lines_characters(const char* filePathName, int lineCount); // Counts characters in each line of a file
 int* count_characters_in_file_lines_range(const char* filePathName, int lineCount, int startLine); // Counts characters in each line in a specified range of lines of a file
 /// \}
@@ -56,9 +58,125 @@ int* count_characters_in_file_lines_range(const char* filePathName, int lineCoun
 
 
 
+// -------------- Line Index Structure Definition --------------
+/**
+ * LineIndex Structure: A growable array of the byte offsets at which each line of a file begins.
+ *
+ * Offsets are stored as 64-bit values so that files larger than 4 GiB can be indexed on any platform, and the array grows
+ * geometrically(doubling its capacity whenever it is full) so that the number of lines never needs to be known in advance.
+ *
+ * - offsets: Pointer to an array holding the byte offset at which each line begins.
+ * - count: The number of offsets currently stored.
+ * - capacity: The number of offsets that fit in the array before it must grow.
+ */
+typedef struct
+{
+	uint64_t *offsets;
+	size_t count;
+	size_t capacity;
+} LineIndex;
+
+LineIndex create_line_index(size_t initialCapacity); // Creates an empty line index with room for 'initialCapacity' offsets
+void append_line_offset(LineIndex *lineIndex, uint64_t offset); // Appends an offset to a line index, growing it geometrically when full
+void free_line_index(LineIndex *lineIndex); // Releases the memory held by a line index
+
+
+
+
+
+
+
+
+
+// -------------- Line Store Structure Definition --------------
+/**
+ * LineStore Structure: The lines of a file(or any array of strings), stored contiguously in a single growable byte buffer.
+ *
+ * Each line is followed by its null terminator, so a line can be used as a string in place, and the offset at which each begins is
+ * recorded. Storing 'n' lines takes two allocations rather than 'n + 1', and memory is proportional to the size of the lines.
+ *
+ * - bytes: Pointer to the lines, back to back, each followed by a null terminator.
+ * - byteCount: The number of bytes of 'bytes' in use.
+ * - byteCapacity: The number of bytes that fit in 'bytes' before it must grow.
+ * - offsets: The offset at which each line begins, followed by the offset one past the end of the last line('lineCount + 1' entries).
+ * - lineCount: The number of lines stored.
+ * - lineCapacity: The number of lines that fit in 'offsets' before it must grow.
+ * - linePointers: The NULL-terminated array of pointers to each line built by 'line_store_pointers', or NULL until it is requested.
+ */
+typedef struct
+{
+	char *bytes;
+	size_t byteCount;
+	size_t byteCapacity;
+	
+	
+	size_t *offsets;
+	size_t lineCount;
+	size_t lineCapacity;
+	
+	
+	char **linePointers;
+} LineStore;
+
+LineStore create_line_store(size_t byteCapacity, size_t lineCapacity); // Creates an empty line store with room for 'byteCapacity' bytes and 'lineCapacity' lines
+char *reserve_line_store_line(LineStore *lineStore, size_t maxLineLength); // Makes room for a line of up to 'maxLineLength' characters and returns where to write it
+void commit_line_store_line(LineStore *lineStore, size_t lineLength); // Records the line written at the reserved position as the next line
+void append_line_store_line(LineStore *lineStore, const char *line, size_t lineLength); // Appends a copy of a line to a line store
+void append_line_store(LineStore *destination, const LineStore *source); // Appends every line of one line store to another
+char *line_store_line(const LineStore *lineStore, size_t lineNumber); // Returns a line of a line store as a string within the store
+size_t line_store_line_length(const LineStore *lineStore, size_t lineNumber); // Returns the length of a line of a line store
+char **line_store_pointers(LineStore *lineStore); // Returns the lines of a line store as a NULL-terminated array of strings owned by the store
+void free_line_store(LineStore *lineStore); // Releases the memory held by a line store
+
+
+
+
+
+
+
+
+// -------------- Memory-Mapped File Structure Definition --------------
+/**
+ * MappedFile Structure: Represents a read-only memory mapping of a file along with an index of where each of its lines begins.
+ *
+ * The file is mapped exactly once and its bytes are scanned a single time to build the line index, after which any line can be
+ * handed out as a view(pointer + length) directly into the mapping without copying it or reading the file again.
+ *
+ * - contents: Pointer to the first byte of the mapping. NOTE: the mapping is NOT null-terminated.
+ * - size: The number of bytes in the file.
+ * - lineIndex: The offsets at which each line begins, 'lineIndex.count' is the number of lines in the file, counted the same
+ *   way as 'count_file_lines'(a final line without a trailing newline is still a line).
+ */
+typedef struct
+{
+	const char *contents;
+	size_t size;
+	LineIndex lineIndex;
+} MappedFile;
+
+MappedFile map_file_bytes(const char *filePathName); // Maps a file into memory without indexing its lines
+MappedFile map_file_contents(const char *filePathName); // Maps a file into memory and indexes its lines in a single pass
+const char *mapped_file_line(const MappedFile *mappedFile, size_t lineNumber, size_t *lineLength); // Returns a view of a line of the mapped file(excluding the newline)
+const char *next_mapped_file_line(const MappedFile *mappedFile, size_t *offset, size_t *lineLength); // Returns a view of the line at '*offset' and advances '*offset' to the next line
+const char *next_mapped_file_record(const MappedFile *mappedFile, size_t *offset, size_t *recordLength); // Returns a view of the record at '*offset'(quoted newlines do not end a record) and advances '*offset'
+size_t count_quotes_in_mapped_file_range(const MappedFile *mappedFile, size_t startOffset, size_t endOffset); // Counts the double quotes in a byte range of the mapping
+size_t align_to_record_start(const MappedFile *mappedFile, size_t offset, int insideQuotes); // Finds the start of the first record after 'offset', skipping newlines inside quoted fields
+void release_mapped_file_range(const MappedFile *mappedFile, size_t startOffset, size_t endOffset); // Lets the kernel reclaim the pages of an already processed range of the mapping
+void unmap_file_contents(MappedFile *mappedFile); // Releases the mapping and the line index of a mapped file
+
+
+
+
+
+
 // ------------- Helper Functions for File I/O Operations -------------
 /// \{
-char** read_file_contents(const char* filePathName, int lineCount); // Reads the contents of a file into a string array
+LineStore read_file_contents(const char* filePathName, int lineCount); // Reads the contents of a file into a line store
+LineStore read_mapped_file_contents(const MappedFile *mappedFile, int lineCount); // Copies the lines of an already mapped file into a line store
+char* identify_mapped_file_delimiter(const MappedFile *mappedFile, int sampleLineCount); // Identifies the delimiter of a mapped file from a sample of its first lines
+char* copy_line_contents(const char *line, size_t lineLength); // Copies a line view into a new string, keeping empty fields empty
+char* copy_line_contents_in_arena(MemoryArena *arena, const char *line, size_t lineLength); // Copies a line view into a new string allocated from an arena.
+size_t write_line_contents(char *lineContents, const char *line, size_t lineLength); // Writes the contents of a line view into a buffer
 void write_file_contents(const char *filename, char **fileContents); // Writes content to a file from a char array
 void write_file_numeric_data(const char *filename, double *data, int countDataEntries, const char *dataFieldName); // Writes data to a file from a double array
 char* generate_merged_filename(const char* filePath1, const char* filePath2);
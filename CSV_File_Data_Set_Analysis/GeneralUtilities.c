@@ -5,6 +5,7 @@
 
 #include "GeneralUtilities.h"
 #include "CommonDefinitions.h"
+#include <unistd.h>
 
 
 
@@ -135,10 +136,10 @@ char **allocate_memory_char_ptr_ptr(size_t strSize, size_t numStrings) // Alloca
 	}
 	
 	
-	//For each pointer, allocate memory for a char pointer
+	//For each pointer, allocate memory for a char pointer, unless the caller assigns the strings itself(a 'strSize' of 0), in which case the pointers start out NULL
 	for(size_t i = 0; i < numStrings; i++)
 	{
-		charPtrPtr[i] = allocate_memory_char_ptr(strSize);
+		charPtrPtr[i] = (strSize > 0) ? allocate_memory_char_ptr(strSize) : NULL;
 	}
 	
 	return charPtrPtr;
@@ -210,6 +211,184 @@ void deallocate_memory_char_ptr_ptr(char **charPtrPtr, size_t numStrings)
 
 
 
+/**
+ * create_memory_arena
+ *
+ * Creates an empty memory arena. Its first block is allocated up front, further blocks are allocated as they are needed.
+ *
+ * @param blockSize The number of bytes of each block, or 0 for 'MEMORY_ARENA_BLOCK_SIZE'.
+ * @return The arena, to be released with 'destroy_memory_arena'.
+ */
+MemoryArena *create_memory_arena(size_t blockSize)
+{
+	MemoryArena *arena = (MemoryArena *)malloc(sizeof(MemoryArena));
+	if (arena == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'create_memory_arena'.\n");
+		exit(1);
+	}
+	arena->blockSize = (blockSize > 0) ? blockSize : MEMORY_ARENA_BLOCK_SIZE;
+	
+	
+	arena->firstBlock = (ArenaBlock *)malloc(sizeof(ArenaBlock) + arena->blockSize);
+	if (arena->firstBlock == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'create_memory_arena'.\n");
+		exit(1);
+	}
+	arena->firstBlock->next = NULL;
+	arena->firstBlock->capacity = arena->blockSize;
+	arena->firstBlock->used = 0;
+	arena->currentBlock = arena->firstBlock;
+	
+	return arena;
+}
+
+
+
+
+/**
+ * arena_allocate
+ *
+ * Allocates memory from an arena by advancing past it in the current block, the memory is aligned to 16 bytes. When the current block
+ * is full, allocation moves on to the next block left over from before the last reset, or to a new block inserted after the current one
+ * (as large as the allocation, if it does not fit in 'blockSize' bytes). The memory must not be freed, it is released with the arena.
+ *
+ * Functions taking an arena also accept NULL, in which case the memory is allocated with malloc and the caller frees it as before.
+ *
+ * @param arena The arena to allocate from, or NULL to allocate with malloc.
+ * @param size The number of bytes to allocate.
+ * @return A pointer to the allocated memory(from malloc, NULL if the allocation failed).
+ */
+void *arena_allocate(MemoryArena *arena, size_t size)
+{
+	if (arena == NULL)
+	{
+		return malloc(size > 0 ? size : 1);
+	}
+	
+	
+	size_t alignedSize = (size + 15) & ~(size_t)15;
+	ArenaBlock *block = arena->currentBlock;
+	if (block->capacity - block->used < alignedSize)
+	{
+		if (block->next != NULL && block->next->capacity >= alignedSize) // Blocks after the current one are empty since the last reset
+		{
+			block = block->next;
+		}
+		else
+		{
+			size_t capacity = (alignedSize > arena->blockSize) ? alignedSize : arena->blockSize;
+			ArenaBlock *newBlock = (ArenaBlock *)malloc(sizeof(ArenaBlock) + capacity);
+			if (newBlock == NULL)
+			{
+				perror("\n\nError: Unable to allocate memory in 'arena_allocate'.\n");
+				exit(1);
+			}
+			newBlock->next = block->next;
+			newBlock->capacity = capacity;
+			newBlock->used = 0;
+			block->next = newBlock;
+			block = newBlock;
+		}
+		arena->currentBlock = block;
+	}
+	
+	
+	void *allocation = block->data + block->used;
+	block->used += alignedSize;
+	return allocation;
+}
+
+
+
+
+/**
+ * reset_memory_arena
+ *
+ * Releases everything allocated from an arena in one call, e.g., once a batch of data entries has been processed. The blocks are kept,
+ * so the next batch is allocated from the same memory without calling malloc again.
+ *
+ * @param arena The arena to reset, NULL is ignored.
+ */
+void reset_memory_arena(MemoryArena *arena)
+{
+	if (arena == NULL)
+	{
+		return;
+	}
+	
+	for (ArenaBlock *block = arena->firstBlock; block != NULL; block = block->next)
+	{
+		block->used = 0;
+	}
+	arena->currentBlock = arena->firstBlock;
+}
+
+
+
+
+/**
+ * destroy_memory_arena
+ *
+ * Frees every block of an arena and the arena itself, along with everything allocated from it.
+ *
+ * @param arena The arena to destroy, NULL is ignored.
+ */
+void destroy_memory_arena(MemoryArena *arena)
+{
+	if (arena == NULL)
+	{
+		return;
+	}
+	
+	ArenaBlock *block = arena->firstBlock;
+	while (block != NULL)
+	{
+		ArenaBlock *nextBlock = block->next;
+		free(block);
+		block = nextBlock;
+	}
+	free(arena);
+}
+
+
+
+
+char *allocate_memory_char_ptr_in_arena(MemoryArena *arena, size_t sizeC)
+{
+	if (arena == NULL)
+	{
+		return allocate_memory_char_ptr(sizeC);
+	}
+	
+	return (char*)arena_allocate(arena, sizeC * sizeof(char));
+}
+
+
+char **allocate_memory_char_ptr_ptr_in_arena(MemoryArena *arena, size_t strSize, size_t numStrings) // Allocate the array of char* pointers and the strings from the arena
+{
+	if (arena == NULL)
+	{
+		return allocate_memory_char_ptr_ptr(strSize, numStrings);
+	}
+	
+	char **charPtrPtr = (char**)arena_allocate(arena, numStrings * sizeof(char*));
+	
+	
+	//For each pointer, allocate memory for a char pointer
+	for(size_t i = 0; i < numStrings; i++)
+	{
+		charPtrPtr[i] = (strSize > 0) ? allocate_memory_char_ptr_in_arena(arena, strSize) : NULL;
+	}
+	
+	return charPtrPtr;
+}
+
+
+
+
+
 
 
 /**
@@ -377,6 +556,33 @@ time_t convert_to_unix_time(const char *dateTimeString)
 }
 
 
+
+
+/**
+ * days_since_unix_epoch
+ *
+ * Counts the days from January 1, 1970 to a date of the proleptic Gregorian calendar with pure integer arithmetic, which is what
+ * 'mktime' spends most of its time on, without taking its timezone lock. The year is shifted to begin in March so that the leap
+ * day falls at the end of it, then whole 400 year eras, years, and days are counted. A day past the end of the month rolls over
+ * into the following month, as it does with 'mktime'.
+ *
+ * @param year The year, e.g., 2024.
+ * @param month The month, from 1(January) to 12(December).
+ * @param day The day of the month, counting from 1.
+ * @return The number of days since the epoch, negative for dates before it.
+ */
+int64_t days_since_unix_epoch(int64_t year, int month, int day)
+{
+	year -= (month <= 2);
+	int64_t era = (year >= 0 ? year : year - 399) / 400;
+	int64_t yearOfEra = year - era * 400;                                        // [0, 399]
+	int64_t dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1; // [0, 365] for days within the month
+	int64_t dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+	
+	return era * 146097 + dayOfEra - 719468;
+}
+
+
 /**
  * thread_safe_localtime
  *
@@ -404,9 +610,7 @@ struct tm *thread_safe_localtime(const time_t *tim, struct tm *result)
 	{
 		*result = *t;  // Copy the statically allocated struct
 	}
-	pthread_mutex_unlock(&localtime_mutex);
-	
-	pthread_mutex_destroy(&localtime_mutex);
+	pthread_mutex_unlock(&localtime_mutex); // The mutex is statically initialized and shared by every call, so it is never destroyed
 	
 	
 	return t ? result : NULL; // Return result if localtime didn't return NULL
@@ -419,6 +623,153 @@ struct tm *thread_safe_localtime(const time_t *tim, struct tm *result)
 
 
 
+
+/**
+ * allocate_validity_bitmap
+ *
+ * Allocates a validity bitmap: a packed array of 64-bit words in which bit 'i % 64' of word 'i / 64' is set if value 'i' of a column
+ * is present and clear if it is missing(null). Missing values therefore need no placeholder in the values themselves, and whole words
+ * of 64 values can be tested, skipped, or counted at once.
+ *
+ * @param valueCount The number of values the bitmap describes.
+ * @return The bitmap, with every value marked missing.
+ */
+uint64_t *allocate_validity_bitmap(size_t valueCount)
+{
+	size_t wordCount = (valueCount + 63) / 64;
+	uint64_t *validity = (uint64_t *)calloc(wordCount > 0 ? wordCount : 1, sizeof(uint64_t));
+	if (validity == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'allocate_validity_bitmap'.\n");
+		exit(1);
+	}
+	return validity;
+}
+
+
+
+
+/**
+ * grow_validity_bitmap
+ *
+ * Grows a validity bitmap to describe more values, keeping the bits of the values it already describes.
+ *
+ * @param validity The bitmap to be grown, or NULL to allocate a new one.
+ * @param oldValueCount The number of values the bitmap currently describes.
+ * @param newValueCount The number of values the grown bitmap must describe.
+ * @return The grown bitmap, the values added are marked missing.
+ */
+uint64_t *grow_validity_bitmap(uint64_t *validity, size_t oldValueCount, size_t newValueCount)
+{
+	size_t oldWordCount = (validity != NULL) ? (oldValueCount + 63) / 64 : 0;
+	size_t newWordCount = (newValueCount + 63) / 64;
+	if (newWordCount <= oldWordCount)
+	{
+		return validity;
+	}
+	
+	uint64_t *grownValidity = (uint64_t *)realloc(validity, newWordCount * sizeof(uint64_t));
+	if (grownValidity == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'grow_validity_bitmap'.\n");
+		exit(1);
+	}
+	set_memory_block(grownValidity + oldWordCount, 0, (newWordCount - oldWordCount) * sizeof(uint64_t));
+	return grownValidity;
+}
+
+
+
+
+/**
+ * set_validity_bit
+ *
+ * Marks a value of a validity bitmap as present.
+ *
+ * @param validity The bitmap.
+ * @param index The index of the value.
+ */
+void set_validity_bit(uint64_t *validity, size_t index)
+{
+	validity[index / 64] |= (uint64_t)1 << (index % 64);
+}
+
+
+
+
+/**
+ * validity_bit_is_set
+ *
+ * Checks whether a value of a validity bitmap is present.
+ *
+ * @param validity The bitmap.
+ * @param index The index of the value.
+ * @return true if the value is present, false if it is missing.
+ */
+bool validity_bit_is_set(const uint64_t *validity, size_t index)
+{
+	return (validity[index / 64] >> (index % 64)) & 1;
+}
+
+
+
+
+/**
+ * count_valid_values
+ *
+ * Counts the values of a validity bitmap that are present, a whole word of 64 values at a time with a population count.
+ * Bits beyond 'valueCount' in the last word are ignored.
+ *
+ * @param validity The bitmap.
+ * @param valueCount The number of values the bitmap describes.
+ * @return The number of present values.
+ */
+size_t count_valid_values(const uint64_t *validity, size_t valueCount)
+{
+	size_t validCount = 0;
+	size_t fullWordCount = valueCount / 64;
+	for (size_t w = 0; w < fullWordCount; w++)
+	{
+		validCount += (size_t)__builtin_popcountll(validity[w]);
+	}
+	if (valueCount % 64 != 0)
+	{
+		validCount += (size_t)__builtin_popcountll(validity[fullWordCount] & (((uint64_t)1 << (valueCount % 64)) - 1));
+	}
+	return validCount;
+}
+
+
+
+
+
+
+/**
+ * determine_hardware_thread_count
+ *
+ * Determines the number of hardware threads(online logical processors) available to the program, which is
+ * the natural number of worker threads to divide CPU-bound work between.
+ *
+ * @return The number of online logical processors, or 1 if it cannot be determined.
+ */
+int determine_hardware_thread_count(void)
+{
+	long processorCount = sysconf(_SC_NPROCESSORS_ONLN);
+	if (processorCount < 1)
+	{
+		return 1;
+	}
+	
+	return (int)processorCount;
+}
+
+
+
+
+
+
+
+
 /**
  * flip_sign_bit
  *
@@ -483,6 +834,38 @@ double uint64_to_double(uint64_t value)
 }
 
 
+/**
+ * double_to_radix_key
+ *
+ * Maps a double to a 64-bit unsigned integer that orders the same way as the double, so that doubles can be radix sorted as integers.
+ * The bit pattern of a positive double already orders as an integer, so only its sign bit is flipped, which places it above every
+ * negative double. A negative double orders backwards as an integer(a larger magnitude has a larger pattern), so all of its bits are
+ * flipped, reversing that order and clearing its sign bit.
+ *
+ * @param value The double to be mapped.
+ * @return The order-preserving key of the double.
+ */
+uint64_t double_to_radix_key(double value)
+{
+	uint64_t bits = double_to_uint64(value);
+	return (bits >> 63) ? ~bits : flip_sign_bit(bits);
+}
+
+
+/**
+ * radix_key_to_double
+ *
+ * The inverse of 'double_to_radix_key', which restores the double a key was made from.
+ *
+ * @param key The key to be mapped back.
+ * @return The double the key was made from.
+ */
+double radix_key_to_double(uint64_t key)
+{
+	return uint64_to_double((key >> 63) ? flip_sign_bit(key) : ~key);
+}
+
+
 
 
 
@@ -495,14 +878,47 @@ double uint64_to_double(uint64_t value)
 
 
 
+/**
+ * merge_sorted_runs
+ *
+ * Merges two sorted runs into a destination that overlaps neither of them. Each step compares the heads of the two runs and
+ * advances one of them by the result of the comparison rather than by branching on it, so the merge runs at the same speed however
+ * unpredictable the order of the data is. Equal values are taken from the first run first, keeping the merge stable.
+ *
+ * @param first The first sorted run.
+ * @param firstLength The number of values of the first run.
+ * @param second The second sorted run.
+ * @param secondLength The number of values of the second run.
+ * @param destination Receives the firstLength + secondLength merged values.
+ */
+void merge_sorted_runs(const double *first, int firstLength, const double *second, int secondLength, double *destination)
+{
+	int i = 0, j = 0, k = 0;
+	while (i < firstLength && j < secondLength)
+	{
+		double a = first[i];
+		double b = second[j];
+		int takeSecond = b < a;
+		destination[k++] = takeSecond ? b : a;
+		j += takeSecond;
+		i += !takeSecond;
+	}
+	
+	// Copy whichever run has values left
+	memcpy(destination + k, first + i, (firstLength - i) * sizeof(double));
+	k += firstLength - i;
+	memcpy(destination + k, second + j, (secondLength - j) * sizeof(double));
+}
+
+
 /**
  * merge_data
  *
  * Merges two subarrays of unsortedData[].
  * This function is a part of the merge sort algorithm. It merges two sorted subarrays
  * defined by the indices [left, middle] and [middle+1, right] into a single sorted array.
- * It uses two temporary arrays to hold the subarrays and then merges them back into the
- * original array in a sorted manner.
+ * It merges them into one temporary array with 'merge_sorted_runs' and copies the result back into the
+ * original array.
  *
  * @param unsortedData Pointer to the array of doubles to be sorted.
  * @param left The starting index of the first subarray,  unsortedData[left..middle]
@@ -511,73 +927,63 @@ double uint64_to_double(uint64_t value)
  */
 void merge_data(double *unsortedData, int left, int middle, int right)
 {
-	// Calculate the sizes of the two subarrays to be merged
-	int i, j, k;
-	int size1 = middle - left + 1;  // Size of the first subarray
-	int size2 = right - middle;   // Size of the second subarray
-	
-	
-	
-	// Dynamically allocate memory for temporary arrays holding subarray elements
-	double *leftTempData = allocate_memory_double_ptr(size1);
-	double *rightTempData = allocate_memory_double_ptr(size2);
-	
-	
-	// Copying data to the temporary arrays to isolate the subarrays
-	for (i = 0; i < size1; i++)
-	{
-		leftTempData[i] = (unsortedData)[left + i];
-	}
-	for (j = 0; j < size2; j++)
+	int mergedLength = right - left + 1;
+	double *mergedData = allocate_memory_double_ptr(mergedLength);
+	merge_sorted_runs(unsortedData + left, middle - left + 1, unsortedData + middle + 1, right - middle, mergedData);
+	memcpy(unsortedData + left, mergedData, mergedLength * sizeof(double));
+	free(mergedData);
+}
+
+
+/**
+ * merge_sort_with_buffer
+ *
+ * Sorts an array bottom-up using a scratch buffer of the same length, without allocating. Runs of MERGE_SORT_INSERTION_LENGTH values
+ * are first sorted by insertion, then each pass merges pairs of adjacent runs into runs twice as long, alternating between the
+ * array and the buffer as the source and destination of the pass, so no values are copied back between passes. If the last pass
+ * leaves the result in the buffer it is copied into the array once.
+ *
+ * @param data Pointer to the array of doubles to be sorted.
+ * @param scratch A buffer of at least numElements doubles, its contents are overwritten.
+ * @param numElements The number of elements in the array.
+ */
+void merge_sort_with_buffer(double *data, double *scratch, int numElements)
+{
+	for (int runStart = 0; runStart < numElements; runStart += MERGE_SORT_INSERTION_LENGTH)
 	{
-		rightTempData[j] = (unsortedData)[middle + 1 + j];
+		int runEnd = (runStart + MERGE_SORT_INSERTION_LENGTH < numElements) ? runStart + MERGE_SORT_INSERTION_LENGTH : numElements;
+		insertion_sort_data(data, runStart, runEnd - 1);
 	}
 	
 	
-	
-	// Merging the temporary arrays back into the original array[left..right]
-	i = 0; // Initial index of the first subarray
-	j = 0; // Initial index of the second subarray
-	k = left; // Initial index of the merged subarray
-	while (i < size1 && j < size2)
+	double *source = data;
+	double *destination = scratch;
+	for (int runLength = MERGE_SORT_INSERTION_LENGTH; runLength < numElements; runLength *= 2)
 	{
-		if (leftTempData[i] <= rightTempData[j])
+		for (int runStart = 0; runStart < numElements; runStart += 2 * runLength)
 		{
-			(unsortedData)[k] = leftTempData[i];
-			i++;
+			int firstLength = (runStart + runLength < numElements) ? runLength : numElements - runStart;
+			int secondLength = (runStart + 2 * runLength < numElements) ? runLength : numElements - runStart - firstLength;
+			merge_sorted_runs(source + runStart, firstLength, source + runStart + firstLength, secondLength, destination + runStart);
 		}
-		else
-		{
-			(unsortedData)[k] = rightTempData[j];
-			j++;
-		}
-		k++;
-	}
-	while (i < size1)  // Copy the remaining elements from leftTempData to unsortedData
-	{
-		(unsortedData)[k] = leftTempData[i];
-		i++;
-		k++;
+		
+		double *swap = source;
+		source = destination;
+		destination = swap;
 	}
-	while (j < size2)  // Copy the remaining elements from rightTempData to unsortedData
+	
+	if (source != data)
 	{
-		(unsortedData)[k] = rightTempData[j];
-		j++;
-		k++;
+		memcpy(data, source, numElements * sizeof(double));
 	}
-	
-	
-	free(leftTempData);
-	free(rightTempData);
 }
 
 
 /**
  * merge_sort_data
  *
- * This function implements the recursive part of the merge sort algorithm. It recursively divides
- * the array into two halves, calls itself for the two halves, and then merges the two sorted halves
- * using the merge_data function..
+ * This function sorts the portion of an array between two indices, inclusive, with the bottom-up merge sort of
+ * 'merge_sort_with_buffer', allocating the one scratch buffer it needs.
  *
  * @param unsortedData Pointer to the array of doubles to be sorted.
  * @param left The starting index of the array portion to be sorted.
@@ -587,17 +993,10 @@ void merge_sort_data(double *unsortedData, int left, int right)
 {
 	if(left < right)  // Check to ensure valid indexing bounds
 	{
-		// Find the middle point to divide the array into two halves
-		int middle = left + (right - left) / 2; // Same as (left+right)/2, but avoids overflow for large left and right
-		
-		// Recursive call to sort the first half of the array until the sub-arrays are small enough to be solved directly
-		merge_sort_data(unsortedData, left, middle);
-		
-		// Recursive call to sort the second half of the array until the sub-arrays are small enough to be solved directly
-		merge_sort_data(unsortedData, middle + 1, right);
-		
-		// Merge the sorted halves
-		merge_data(unsortedData, left, middle, right);
+		int numElements = right - left + 1;
+		double *scratch = allocate_memory_double_ptr(numElements);
+		merge_sort_with_buffer(unsortedData + left, scratch, numElements);
+		free(scratch);
 	}
 }
 
@@ -621,106 +1020,738 @@ void merge_sort(double *unsortedData, const int numElements)
 	}
 	
 	
-	// Initial call to the recursive merge sort function on the entire array
+	// Sort the entire array
 	merge_sort_data(unsortedData, 0, numElements - 1);
 }
 
 
-
-
 /**
- * radix_sort_doubles
+ * sort_merge_sort_run
  *
- * Sorts an array of double precision floating-point numbers using Radix Sort algorithm. This implementation
- * specifically deals with the floating-point nature of the data by converting doubles to their 64-bit integer
- * representations. The sorting is performed on these integer representations, enabling the Radix Sort algorithm
- * to be applied to floating-point numbers.
+ * Thread routine of 'parallel_merge_sort' that sorts one run of the array with 'merge_sort_with_buffer', using the matching portion
+ * of the shared scratch buffer.
  *
+ * @param arg Pointer to the MergeSortRun to sort.
+ * @return NULL.
+ */
+void *sort_merge_sort_run(void *arg)
+{
+	MergeSortRun *run = (MergeSortRun *)arg;
+	merge_sort_with_buffer(run->data, run->scratch, run->length);
+	return NULL;
+}
+
+
+/**
+ * merge_merge_sort_segment
  *
- * Perform a radix sort on an array of double values. This function sorts an array of doubles
- * using a radix sort algorithm, which is a non-comparative integer sorting algorithm. It achieves this by
- * interpreting the bit representation of double values as unsigned 64-bit integers (uint64_t).
+ * Thread routine of 'parallel_merge_sort' that merges one segment of a pair of runs with 'merge_sorted_runs'.
  *
- * The radix sort is done on the binary representation of these integers. Special handling is done for negative
- * numbers by flipping the sign bit, to ensure they are sorted correctly. Post sorting, the binary representations
- * are converted back to double values.
+ * @param arg Pointer to the MergeSegment to merge.
+ * @return NULL.
+ */
+void *merge_merge_sort_segment(void *arg)
+{
+	MergeSegment *segment = (MergeSegment *)arg;
+	merge_sorted_runs(segment->first, segment->firstLength, segment->second, segment->secondLength, segment->destination);
+	return NULL;
+}
+
+
+/**
+ * find_merge_path_split
  *
- * This function is particularly useful in scenarios where a fast, stable sorting of a large number of floating-point numbers( > 60) is required.
+ * Finds where a diagonal of the merge path of two sorted runs crosses it, that is, how many of the first 'diagonal' values of their
+ * merge come from the first run, by binary search. Merging the runs up to that split and after it separately yields the same result,
+ * in the same stable order, as merging them whole, so a merge can be divided into independent segments of equal output length.
  *
- * @param unsortedData A pointer to the array of double values to be sorted.
+ * @param first The first sorted run.
+ * @param firstLength The number of values of the first run.
+ * @param second The second sorted run.
+ * @param secondLength The number of values of the second run.
+ * @param diagonal The number of merged values before the split, in [0, firstLength + secondLength].
+ * @return The number of those values taken from the first run.
+ */
+int find_merge_path_split(const double *first, int firstLength, const double *second, int secondLength, int diagonal)
+{
+	int low = (diagonal > secondLength) ? diagonal - secondLength : 0;
+	int high = (diagonal < firstLength) ? diagonal : firstLength;
+	while (low < high)
+	{
+		int middle = low + (high - low) / 2;
+		if (first[middle] <= second[diagonal - middle - 1])
+		{
+			low = middle + 1;
+		}
+		else
+		{
+			high = middle;
+		}
+	}
+	
+	return low;
+}
+
+
+/**
+ * parallel_merge_sort
+ *
+ * Sorts an array with several threads and one scratch buffer. The array is divided into one run per thread, which are sorted
+ * concurrently with 'merge_sort_with_buffer', then adjacent runs are merged pairwise level by level, alternating between the array
+ * and the buffer as in the serial sort. Every level is merged by all of the threads, even the last with its single pair of runs: each
+ * merge is divided along its merge path(see 'find_merge_path_split') into segments of equal output length, one per thread available
+ * to it, which are merged independently. Arrays too short to be worth dividing are sorted serially.
+ *
+ * @param unsortedData Pointer to the array of doubles to be sorted.
  * @param numElements The number of elements in the array.
+ * @param threadCount The number of threads to use, or 0 for one per hardware thread.
  */
-void radix_sort_doubles(double *unsortedData, const int numElements)
+void parallel_merge_sort(double *unsortedData, const int numElements, int threadCount)
 {
-	// Allocate memory for temporary arrays used in sorting
-	uint64_t* temp = (uint64_t*)malloc(numElements * sizeof(uint64_t));
-	uint64_t* intValues = (uint64_t*)malloc(numElements * sizeof(uint64_t));
+	// Check for null pointers to ensure data integrity
+	if(unsortedData == NULL)
+	{
+		perror("\n\nError: Data to be sorted was NULL in 'parallel_merge_sort'.\n");
+		exit(1);
+	}
+	
+	if (threadCount <= 0)
+	{
+		threadCount = determine_hardware_thread_count();
+	}
+	if (threadCount > numElements / PARALLEL_MERGE_SORT_MIN_RUN_LENGTH)
+	{
+		threadCount = numElements / PARALLEL_MERGE_SORT_MIN_RUN_LENGTH;
+	}
+	if (threadCount <= 1)
+	{
+		merge_sort(unsortedData, numElements);
+		return;
+	}
+	
+	
+	double *scratch = allocate_memory_double_ptr(numElements);
+	pthread_t threads[threadCount];
+	
+	
+	/// Step 1: Sort one run per thread
+	int runCount = threadCount;
+	int runStarts[runCount + 1];
+	MergeSortRun runs[runCount];
+	for (int i = 0; i <= runCount; i++)
+	{
+		runStarts[i] = (int)((int64_t)numElements * i / runCount);
+	}
+	for (int i = 0; i < runCount; i++)
+	{
+		runs[i] = (MergeSortRun){ unsortedData + runStarts[i], scratch + runStarts[i], runStarts[i + 1] - runStarts[i] };
+		if (pthread_create(&threads[i], NULL, sort_merge_sort_run, &runs[i]) != 0)
+		{
+			perror("\n\nError: Unable to create a thread in 'parallel_merge_sort'.\n");
+			exit(1);
+		}
+	}
+	for (int i = 0; i < runCount; i++)
+	{
+		pthread_join(threads[i], NULL);
+	}
 	
-	/// Step 1: Convert doubles to uint64_t for sorting, reinterpreting each double as a 64-bit integer.
-	for (size_t i = 0; i < numElements; i++)
+	
+	/// Step 2: Merge pairs of adjacent runs until one is left, dividing each level's merges between all of the threads
+	double *source = unsortedData;
+	double *destination = scratch;
+	MergeSegment segments[threadCount];
+	while (runCount > 1)
 	{
-		uint64_t intValue = double_to_uint64(unsortedData[i]);
+		int pairCount = runCount / 2;
+		int segmentCount = 0;
+		for (int pair = 0; pair < pairCount; pair++)
+		{
+			int start = runStarts[2 * pair], middle = runStarts[2 * pair + 1], end = runStarts[2 * pair + 2];
+			const double *first = source + start, *second = source + middle;
+			int firstLength = middle - start, secondLength = end - middle, mergedLength = end - start;
+			int pairThreadCount = threadCount / pairCount + (pair < threadCount % pairCount);
+			
+			int previousDiagonal = 0, previousSplit = 0;
+			for (int t = 1; t <= pairThreadCount; t++)
+			{
+				int diagonal = (int)((int64_t)mergedLength * t / pairThreadCount);
+				int split = (t == pairThreadCount) ? firstLength : find_merge_path_split(first, firstLength, second, secondLength, diagonal);
+				segments[segmentCount++] = (MergeSegment){ first + previousSplit, split - previousSplit, second + (previousDiagonal - previousSplit),
+				                                           (diagonal - split) - (previousDiagonal - previousSplit), destination + start + previousDiagonal };
+				previousDiagonal = diagonal;
+				previousSplit = split;
+			}
+		}
+		if (runCount % 2 == 1) // The last run has no partner at this level, it is carried over as is
+		{
+			int start = runStarts[runCount - 1], end = runStarts[runCount];
+			memcpy(destination + start, source + start, (end - start) * sizeof(double));
+		}
+		
+		
+		for (int i = 0; i < segmentCount; i++)
+		{
+			if (pthread_create(&threads[i], NULL, merge_merge_sort_segment, &segments[i]) != 0)
+			{
+				perror("\n\nError: Unable to create a thread in 'parallel_merge_sort'.\n");
+				exit(1);
+			}
+		}
+		for (int i = 0; i < segmentCount; i++)
+		{
+			pthread_join(threads[i], NULL);
+		}
 		
 		
-		// Check if the number is negative (indicated by the sign bit).
-		// If so, flip the sign bit to ensure correct sorting order
-		if (intValue >> 63)
+		// The merged runs start where every other run did
+		for (int i = 0; i <= (runCount + 1) / 2; i++)
+		{
+			runStarts[i] = runStarts[(2 * i < runCount) ? 2 * i : runCount];
+		}
+		runCount = (runCount + 1) / 2;
+		
+		double *swap = source;
+		source = destination;
+		destination = swap;
+	}
+	
+	if (source != unsortedData)
+	{
+		memcpy(unsortedData, source, numElements * sizeof(double));
+	}
+	free(scratch);
+}
+
+
+
+
+
+/**
+ * insertion_sort_data
+ *
+ * Sorts the portion of an array between two indices, inclusive, by insertion. Used by 'select_order_statistics' to finish the
+ * short ranges that partitioning leaves behind, where it is faster than partitioning further.
+ *
+ * @param data Pointer to the array of doubles.
+ * @param left The starting index of the portion to be sorted.
+ * @param right The ending index of the portion to be sorted.
+ */
+void insertion_sort_data(double *data, int left, int right)
+{
+	for (int i = left + 1; i <= right; i++)
+	{
+		double value = data[i];
+		int j = i - 1;
+		while (j >= left && data[j] > value)
+		{
+			data[j + 1] = data[j];
+			j--;
+		}
+		data[j + 1] = value;
+	}
+}
+
+
+/**
+ * select_order_statistics_in_range
+ *
+ * The recursive part of 'select_order_statistics'. Partitions the range around the median of its first, middle, and last values
+ * into the values less than, equal to, and greater than it(the equal values are already in their final positions, so long runs of
+ * ties end the search at once), then continues into each side only if a requested rank falls there. The ranks must be sorted. A range
+ * that has been partitioned more times than the depth limit allows is merge sorted instead, so that adversarial inputs still
+ * finish in O(nLogn).
+ *
+ * @param data Pointer to the array of doubles.
+ * @param left The starting index of the range.
+ * @param right The ending index of the range.
+ * @param ranks The sorted ranks, all within the range, to put in place.
+ * @param rankCount The number of ranks.
+ * @param depthLimit The number of partitions left before falling back to sorting.
+ */
+void select_order_statistics_in_range(double *data, int left, int right, const int *ranks, int rankCount, int depthLimit)
+{
+	while (rankCount > 0 && right - left + 1 > SELECTION_INSERTION_SORT_LENGTH)
+	{
+		if (depthLimit-- == 0)
+		{
+			merge_sort_data(data, left, right);
+			return;
+		}
+		
+		
+		// Median-of-three pivot
+		int middle = left + (right - left) / 2;
+		double a = data[left], b = data[middle], c = data[right];
+		double pivot = (a < b) ? ((b < c) ? b : ((a < c) ? c : a)) : ((a < c) ? a : ((b < c) ? c : b));
+		
+		
+		// Three-way partition: [left, lower) < pivot, [lower, upper] == pivot, (upper, right] > pivot
+		int lower = left, i = left, upper = right;
+		while (i <= upper)
+		{
+			double value = data[i];
+			if (value < pivot)
+			{
+				data[i++] = data[lower];
+				data[lower++] = value;
+			}
+			else if (value > pivot)
+			{
+				data[i] = data[upper];
+				data[upper--] = value;
+			}
+			else
+			{
+				i++;
+			}
+		}
+		
+		
+		// Split the ranks between the two sides, those landing among the pivot values are already in place
+		int leftRankCount = 0;
+		while (leftRankCount < rankCount && ranks[leftRankCount] < lower)
+		{
+			leftRankCount++;
+		}
+		int rightRankStart = leftRankCount;
+		while (rightRankStart < rankCount && ranks[rightRankStart] <= upper)
+		{
+			rightRankStart++;
+		}
+		
+		select_order_statistics_in_range(data, left, lower - 1, ranks, leftRankCount, depthLimit);
+		ranks += rightRankStart;
+		rankCount -= rightRankStart;
+		left = upper + 1;
+	}
+	
+	if (rankCount > 0)
+	{
+		insertion_sort_data(data, left, right);
+	}
+}
+
+
+/**
+ * select_order_statistics, an introselect algorithm, O(n) expected for a fixed number of ranks
+ *
+ * Rearranges an array so that, for each requested rank k, data[k] holds the value that would be at index k if the array were
+ * sorted, without sorting it: every value before a requested rank is no greater, and every value after it no smaller. Several ranks
+ * are found in the same series of partitions, each one only narrowing the range the remaining ranks are searched in, so asking
+ * for the quartiles together with the minimum and maximum costs little more than asking for the median.
+ *
+ * @param data Pointer to the array of doubles, reordered in place.
+ * @param numElements The number of elements in the array.
+ * @param ranks The ranks to put in place, each in [0, numElements), sorted in place.
+ * @param rankCount The number of ranks.
+ */
+void select_order_statistics(double *data, const int numElements, int *ranks, int rankCount)
+{
+	// Check for null pointers to ensure data integrity
+	if (data == NULL || ranks == NULL)
+	{
+		perror("\n\nError: Data or ranks to select were NULL in 'select_order_statistics'.\n");
+		exit(1);
+	}
+	for (int i = 0; i < rankCount; i++)
+	{
+		if (ranks[i] < 0 || ranks[i] >= numElements)
+		{
+			perror("\n\nError: Rank to select was out of range in 'select_order_statistics'.\n");
+			exit(1);
+		}
+	}
+	
+	
+	// The ranks are few, so insertion sort them
+	for (int i = 1; i < rankCount; i++)
+	{
+		int rank = ranks[i];
+		int j = i - 1;
+		while (j >= 0 && ranks[j] > rank)
+		{
+			ranks[j + 1] = ranks[j];
+			j--;
+		}
+		ranks[j + 1] = rank;
+	}
+	
+	int depthLimit = 2 * (64 - __builtin_clzll((unsigned long long)numElements | 1));
+	select_order_statistics_in_range(data, 0, numElements - 1, ranks, rankCount, depthLimit);
+}
+
+
+
+
+/**
+ * count_radix_sort_chunk_digits
+ *
+ * Thread routine of 'radix_sort_keys' that counts, in a single read of the chunk's keys, how many of them have each value of each
+ * of their 8 bytes.
+ *
+ * @param arg Pointer to the RadixSortChunk whose keys are counted into 'byteCounts'.
+ * @return NULL.
+ */
+void *count_radix_sort_chunk_digits(void *arg)
+{
+	RadixSortChunk *chunk = (RadixSortChunk *)arg;
+	memset(chunk->byteCounts, 0, sizeof(chunk->byteCounts));
+	for (int i = chunk->start; i < chunk->end; i++)
+	{
+		uint64_t key = chunk->keys[i];
+		for (int pass = 0; pass < 8; pass++)
 		{
-			intValue = flip_sign_bit(intValue);
+			chunk->byteCounts[pass][(key >> (8 * pass)) & 0xFF]++;
 		}
-		intValues[i] = intValue;
 	}
 	
+	return NULL;
+}
+
+
+/**
+ * count_radix_sort_chunk_digit
+ *
+ * Thread routine of 'radix_sort_keys' that counts how many of the chunk's keys have each value of the byte sorted by the current
+ * pass. A pass moves keys between chunks, so unlike the totals over all chunks, each chunk's counts must be taken again every pass.
+ *
+ * @param arg Pointer to the RadixSortChunk whose keys are counted into 'byteCounts[pass]'.
+ * @return NULL.
+ */
+void *count_radix_sort_chunk_digit(void *arg)
+{
+	RadixSortChunk *chunk = (RadixSortChunk *)arg;
+	size_t *counts = chunk->byteCounts[chunk->pass];
+	memset(counts, 0, 256 * sizeof(size_t));
+	int shift = 8 * chunk->pass;
+	for (int i = chunk->start; i < chunk->end; i++)
+	{
+		counts[(chunk->keys[i] >> shift) & 0xFF]++;
+	}
 	
+	return NULL;
+}
+
+
+/**
+ * scatter_radix_sort_chunk
+ *
+ * Thread routine of 'radix_sort_keys' that moves the chunk's keys, and their row indices if any, to their positions after the
+ * current pass, starting each byte value at the chunk's offset for it. The chunks' offsets don't overlap, so all of the chunks are
+ * scattered at once, and keys with the same byte keep their order, which keeps the sort stable.
+ *
+ * @param arg Pointer to the RadixSortChunk to scatter.
+ * @return NULL.
+ */
+void *scatter_radix_sort_chunk(void *arg)
+{
+	RadixSortChunk *chunk = (RadixSortChunk *)arg;
+	int shift = 8 * chunk->pass;
+	if (chunk->indices == NULL)
+	{
+		for (int i = chunk->start; i < chunk->end; i++)
+		{
+			uint64_t key = chunk->keys[i];
+			chunk->destinationKeys[chunk->offsets[(key >> shift) & 0xFF]++] = key;
+		}
+	}
+	else
+	{
+		for (int i = chunk->start; i < chunk->end; i++)
+		{
+			uint64_t key = chunk->keys[i];
+			size_t destination = chunk->offsets[(key >> shift) & 0xFF]++;
+			chunk->destinationKeys[destination] = key;
+			chunk->destinationIndices[destination] = chunk->indices[i];
+		}
+	}
 	
+	return NULL;
+}
+
+
+/**
+ * run_radix_sort_chunks
+ *
+ * Runs a thread routine of 'radix_sort_keys' on every chunk, each in its own thread, or directly when there is only one chunk,
+ * and waits for all of them to finish.
+ *
+ * @param routine The thread routine.
+ * @param chunks The chunks.
+ * @param chunkCount The number of chunks.
+ */
+void run_radix_sort_chunks(void *(*routine)(void *), RadixSortChunk *chunks, int chunkCount)
+{
+	if (chunkCount == 1)
+	{
+		routine(&chunks[0]);
+		return;
+	}
+	
+	
+	pthread_t threads[chunkCount];
+	for (int i = 0; i < chunkCount; i++)
+	{
+		if (pthread_create(&threads[i], NULL, routine, &chunks[i]) != 0)
+		{
+			perror("\n\nError: Unable to create a thread in 'run_radix_sort_chunks'.\n");
+			exit(1);
+		}
+	}
+	for (int i = 0; i < chunkCount; i++)
+	{
+		pthread_join(threads[i], NULL);
+	}
+}
+
+
+/**
+ * radix_sort_keys
+ *
+ * Sorts 64-bit unsigned keys, and optionally carries a row index along with each, with a stable least-significant-digit radix sort
+ * one byte per pass, divided between several threads:
+ *   - A single pre-pass counts every byte of every key at once. A pass whose byte is the same for all of the keys(the counts of
+ *     that byte hold a single nonzero value) would not move anything, so it is skipped, as are, for example, the exponent
+ *     passes of data of similar magnitude or the high passes of small integers.
+ *   - Each remaining pass is divided into one chunk of the keys per thread. Each thread counts its chunk's bytes, the counts of all
+ *     chunks are turned into one offset per chunk and byte value, ordered by byte value then chunk, and each thread scatters its
+ *     chunk from those offsets.
+ *   - The keys alternate between the input and one scratch buffer from pass to pass instead of being copied back, and are only
+ *     copied once at the end if an odd number of passes left them in the buffer.
+ *
+ * @param keys The keys, sorted in place.
+ * @param indices The row indices carried along with the keys, reordered in place, or NULL.
+ * @param numElements The number of keys.
+ * @param threadCount The number of threads to use, or 0 for one per hardware thread.
+ */
+void radix_sort_keys(uint64_t *keys, int *indices, const int numElements, int threadCount)
+{
+	if (numElements < 2)
+	{
+		return;
+	}
+	if (threadCount <= 0)
+	{
+		threadCount = determine_hardware_thread_count();
+	}
+	if (threadCount > numElements / PARALLEL_RADIX_SORT_MIN_CHUNK_LENGTH)
+	{
+		threadCount = numElements / PARALLEL_RADIX_SORT_MIN_CHUNK_LENGTH;
+	}
+	if (threadCount < 1)
+	{
+		threadCount = 1;
+	}
+	
+	
+	uint64_t *keyScratch = (uint64_t *)malloc(numElements * sizeof(uint64_t));
+	int *indexScratch = (indices != NULL) ? allocate_memory_int_ptr(numElements) : NULL;
+	RadixSortChunk *chunks = (RadixSortChunk *)malloc(threadCount * sizeof(RadixSortChunk));
+	if (keyScratch == NULL || chunks == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'radix_sort_keys'.\n");
+		exit(1);
+	}
+	for (int t = 0; t < threadCount; t++)
+	{
+		chunks[t].start = (int)((int64_t)numElements * t / threadCount);
+		chunks[t].end = (int)((int64_t)numElements * (t + 1) / threadCount);
+		chunks[t].keys = keys;
+		chunks[t].indices = indices;
+	}
 	
-	/// Step 2: Perform Radix Sort on the 64-bit integer representations.
-	for (int shift = 0; shift < 64; shift += 8)
+	
+	/// Step 1: Count every byte of every key in one pre-pass, to find the passes that can be skipped
+	run_radix_sort_chunks(count_radix_sort_chunk_digits, chunks, threadCount);
+	bool passNeeded[8];
+	for (int pass = 0; pass < 8; pass++)
 	{
-		// Sorts the array byte-by-byte (8 bits at a time).
-		size_t counts[256] = {0};
-		size_t offsets[256] = {0};
+		passNeeded[pass] = true;
+		for (int byteValue = 0; byteValue < 256; byteValue++)
+		{
+			size_t total = 0;
+			for (int t = 0; t < threadCount; t++)
+			{
+				total += chunks[t].byteCounts[pass][byteValue];
+			}
+			if (total != 0)
+			{
+				passNeeded[pass] = (total != (size_t)numElements);
+				break;
+			}
+		}
+	}
+	
+	
+	/// Step 2: Sort by each needed byte from least to most significant, alternating between the keys and the scratch buffer
+	uint64_t *sourceKeys = keys, *destinationKeys = keyScratch;
+	int *sourceIndices = indices, *destinationIndices = indexScratch;
+	bool countsCurrent = true; // The pre-pass counts hold for the first pass, and for every pass when there is only one chunk
+	for (int pass = 0; pass < 8; pass++)
+	{
+		if (!passNeeded[pass])
+		{
+			continue;
+		}
 		
 		
-		// Counting occurrences for each byte value
-		for (size_t i = 0; i < numElements; i++)
+		for (int t = 0; t < threadCount; t++)
 		{
-			size_t index = (intValues[i] >> shift) & 0xFF;
-			counts[index]++;
+			chunks[t].keys = sourceKeys;
+			chunks[t].destinationKeys = destinationKeys;
+			chunks[t].indices = sourceIndices;
+			chunks[t].destinationIndices = destinationIndices;
+			chunks[t].pass = pass;
 		}
-		
-		// Calculate offsets for each byte value
-		for (size_t i = 1; i < 256; i++)
+		if (!countsCurrent)
 		{
-			offsets[i] = offsets[i - 1] + counts[i - 1];
+			run_radix_sort_chunks(count_radix_sort_chunk_digit, chunks, threadCount);
 		}
 		
-		// Reorder elements based on the current byte
-		for (size_t i = 0; i < numElements; i++)
+		size_t offset = 0;
+		for (int byteValue = 0; byteValue < 256; byteValue++)
 		{
-			size_t index = (intValues[i] >> shift) & 0xFF;
-			temp[offsets[index]] = intValues[i];
-			offsets[index]++;
+			for (int t = 0; t < threadCount; t++)
+			{
+				chunks[t].offsets[byteValue] = offset;
+				offset += chunks[t].byteCounts[pass][byteValue];
+			}
 		}
+		run_radix_sort_chunks(scatter_radix_sort_chunk, chunks, threadCount);
+		countsCurrent = (threadCount == 1);
 		
-		// Copy the sorted temporary array to the original one
-		memcpy(intValues, temp, numElements * sizeof(uint64_t));
+		
+		uint64_t *swapKeys = sourceKeys;
+		sourceKeys = destinationKeys;
+		destinationKeys = swapKeys;
+		int *swapIndices = sourceIndices;
+		sourceIndices = destinationIndices;
+		destinationIndices = swapIndices;
 	}
 	
-	
-	/// Step 3: Convert uint64_t back to double
-	for (size_t i = 0; i < numElements; i++)
+	if (sourceKeys != keys)
 	{
-		// Re-flip sign bit if necessary to restore the original sign.
-		if (intValues[i] >> 63)
+		memcpy(keys, sourceKeys, numElements * sizeof(uint64_t));
+		if (indices != NULL)
 		{
-			intValues[i] = flip_sign_bit(intValues[i]);
+			memcpy(indices, sourceIndices, numElements * sizeof(int));
 		}
-		unsortedData[i] = uint64_to_double(intValues[i]);
 	}
 	
-	free(temp);
-	free(intValues);
+	free(chunks);
+	free(keyScratch);
+	free(indexScratch);
+}
+
+
+/**
+ * radix_sort_doubles
+ *
+ * Sorts an array of double precision floating-point numbers using Radix Sort algorithm. This implementation
+ * specifically deals with the floating-point nature of the data by converting doubles to their 64-bit integer
+ * representations. The sorting is performed on these integer representations, enabling the Radix Sort algorithm
+ * to be applied to floating-point numbers.
+ *
+ *
+ * Perform a radix sort on an array of double values. This function sorts an array of doubles
+ * using a radix sort algorithm, which is a non-comparative integer sorting algorithm. It achieves this by
+ * interpreting the bit representation of double values as unsigned 64-bit integers (uint64_t), mapped by
+ * 'double_to_radix_key' so that the integers order the same as the doubles, negative numbers included.
+ * The sort itself is done by 'radix_sort_keys' on a single thread, see 'parallel_radix_sort_doubles'.
+ *
+ * This function is particularly useful in scenarios where a fast, stable sorting of a large number of floating-point numbers( > 60) is required.
+ *
+ * @param unsortedData A pointer to the array of double values to be sorted.
+ * @param numElements The number of elements in the array.
+ */
+void radix_sort_doubles(double *unsortedData, const int numElements)
+{
+	parallel_radix_sort_doubles(unsortedData, numElements, 1);
+}
+
+
+/**
+ * parallel_radix_sort_doubles
+ *
+ * Sorts an array of doubles with the radix sort of 'radix_sort_doubles', divided between several threads by 'radix_sort_keys'.
+ *
+ * @param unsortedData A pointer to the array of double values to be sorted.
+ * @param numElements The number of elements in the array.
+ * @param threadCount The number of threads to use, or 0 for one per hardware thread.
+ */
+void parallel_radix_sort_doubles(double *unsortedData, const int numElements, int threadCount)
+{
+	if (unsortedData == NULL)
+	{
+		perror("\n\nError: Data to be sorted was NULL in 'parallel_radix_sort_doubles'.\n");
+		exit(1);
+	}
+	if (numElements < 2)
+	{
+		return;
+	}
+	
+	
+	uint64_t *keys = (uint64_t *)malloc(numElements * sizeof(uint64_t));
+	if (keys == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'parallel_radix_sort_doubles'.\n");
+		exit(1);
+	}
+	for (int i = 0; i < numElements; i++)
+	{
+		keys[i] = double_to_radix_key(unsortedData[i]);
+	}
+	
+	radix_sort_keys(keys, NULL, numElements, threadCount);
+	
+	for (int i = 0; i < numElements; i++)
+	{
+		unsortedData[i] = radix_key_to_double(keys[i]);
+	}
+	free(keys);
+}
+
+
+/**
+ * radix_argsort_doubles
+ *
+ * Computes the permutation that sorts an array of doubles, without moving the doubles: element i of the result is the row index of
+ * the i-th smallest value, and rows with equal values keep their original order. Applying the permutation to other columns of the
+ * same rows reorders them by this column as the sort key. Sorted by 'radix_sort_keys', carrying each row's index with its key.
+ *
+ * @param data The values to sort by, they are not modified.
+ * @param numElements The number of values.
+ * @param threadCount The number of threads to use, or 0 for one per hardware thread.
+ * @return The row indices in sorted order, to be freed by the caller.
+ */
+int *radix_argsort_doubles(const double *data, const int numElements, int threadCount)
+{
+	if (data == NULL)
+	{
+		perror("\n\nError: Data to be sorted was NULL in 'radix_argsort_doubles'.\n");
+		exit(1);
+	}
+	
+	
+	int *indices = allocate_memory_int_ptr(numElements > 0 ? numElements : 1);
+	uint64_t *keys = (uint64_t *)malloc((numElements > 0 ? numElements : 1) * sizeof(uint64_t));
+	if (keys == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'radix_argsort_doubles'.\n");
+		exit(1);
+	}
+	for (int i = 0; i < numElements; i++)
+	{
+		keys[i] = double_to_radix_key(data[i]);
+		indices[i] = i;
+	}
+	
+	radix_sort_keys(keys, indices, numElements, threadCount);
+	
+	free(keys);
+	return indices;
 }
 
 
@@ -22,12 +22,119 @@
 #include <time.h>
 #include <math.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <pthread.h>
 
 
 
 
+// -------------- Memory Arena Structure Definitions --------------
+/**
+ * ArenaBlock Structure: One contiguous block of memory of a MemoryArena, allocations are carved out of it front to back.
+ *
+ * - next: The next block of the arena, or NULL for the last one.
+ * - capacity: The number of bytes of 'data'.
+ * - used: The number of bytes of 'data' already allocated since the arena was created or last reset.
+ * - data: The memory of the block, aligned for any of the types allocated from it.
+ */
+typedef struct ArenaBlock
+{
+	struct ArenaBlock *next;
+	size_t capacity;
+	size_t used;
+	_Alignas(16) unsigned char data[];
+} ArenaBlock;
+
+
+/**
+ * MemoryArena Structure: A region allocator, every allocation is a pointer bump within its current block and nothing is freed
+ * individually. Everything allocated from the arena is released at once by 'reset_memory_arena', which keeps the blocks for the
+ * next batch of allocations, or by 'destroy_memory_arena'.
+ *
+ * - firstBlock: The first block of the arena.
+ * - currentBlock: The block allocations are currently carved out of, blocks after it are unused since the last reset.
+ * - blockSize: The number of bytes of each block allocated, unless a single allocation needs more.
+ */
+typedef struct
+{
+	ArenaBlock *firstBlock;
+	ArenaBlock *currentBlock;
+	size_t blockSize;
+} MemoryArena;
+
+
+
+
+
+// -------------- Parallel Merge Sort Structure Definitions --------------
+/**
+ * MergeSortRun Structure: A run of an array sorted by one thread of 'parallel_merge_sort'.
+ *
+ * - data: The first value of the run.
+ * - scratch: The portion of the scratch buffer matching the run.
+ * - length: The number of values of the run.
+ */
+typedef struct
+{
+	double *data;
+	double *scratch;
+	int length;
+} MergeSortRun;
+
+
+/**
+ * MergeSegment Structure: A segment of the merge of two sorted runs, merged by one thread of 'parallel_merge_sort'.
+ *
+ * - first: The values of the first run merged in the segment.
+ * - firstLength: The number of values of the first run merged in the segment.
+ * - second: The values of the second run merged in the segment.
+ * - secondLength: The number of values of the second run merged in the segment.
+ * - destination: Where the merged values of the segment go.
+ */
+typedef struct
+{
+	const double *first;
+	int firstLength;
+	const double *second;
+	int secondLength;
+	double *destination;
+} MergeSegment;
+
+
+
+
+
+// -------------- Parallel Radix Sort Structure Definition --------------
+/**
+ * RadixSortChunk Structure: The portion of the keys of a radix sort handled by one thread of 'radix_sort_keys'.
+ *
+ * - keys: All of the keys, as arranged before the current pass.
+ * - destinationKeys: Where all of the keys go during the current pass.
+ * - indices: The row indices carried along with the keys, or NULL.
+ * - destinationIndices: Where the row indices go during the current pass, or NULL.
+ * - start: The index of the chunk's first key.
+ * - end: The index one past the chunk's last key.
+ * - pass: The current pass, which sorts by byte 'pass' of the keys, least significant first.
+ * - byteCounts: The number of the chunk's keys with each value of each byte.
+ * - offsets: Where the chunk's next key with each value of the current byte goes.
+ */
+typedef struct
+{
+	uint64_t *keys;
+	uint64_t *destinationKeys;
+	int *indices;
+	int *destinationIndices;
+	int start;
+	int end;
+	int pass;
+	size_t byteCounts[8][256];
+	size_t offsets[256];
+} RadixSortChunk;
+
+
+
+
 // ------------- Helper Functions for Allocating Memory Safely For Basic Types -------------
 /// \{
 int *allocate_memory_int_ptr(size_t sizeI);
@@ -44,7 +151,7 @@ char *allocate_memory_char_ptr(size_t sizeC);
 int **allocate_memory_int_ptr_ptr(size_t sizeI);
 float **allocate_memory_float_ptr_ptr(size_t sizeF);
 double **allocate_memory_double_ptr_ptr(size_t sizeD);
-char **allocate_memory_char_ptr_ptr(size_t strSize, size_t numStrings);
+char **allocate_memory_char_ptr_ptr(size_t strSize, size_t numStrings); // A 'strSize' of 0 leaves every pointer NULL, for strings assigned by the caller.
 
 void deallocate_memory_int_ptr_ptr(int **intPtrPtr, size_t numInts);
 void deallocate_memory_float_ptr_ptr(float **floatPtrPtr, size_t numFloats);
@@ -55,6 +162,20 @@ void deallocate_memory_char_ptr_ptr(char **charPtrPtr, size_t numStrings);
 
 
 
+// ------------- Helper Functions for Allocating Memory From an Arena -------------
+/// \{
+MemoryArena *create_memory_arena(size_t blockSize); // Creates an empty memory arena whose blocks hold 'blockSize' bytes each.
+void *arena_allocate(MemoryArena *arena, size_t size); // Allocates 'size' bytes from an arena, or with malloc if the arena is NULL.
+void reset_memory_arena(MemoryArena *arena); // Releases everything allocated from an arena at once, keeping its blocks for reuse.
+void destroy_memory_arena(MemoryArena *arena); // Frees an arena and all of its blocks.
+
+char *allocate_memory_char_ptr_in_arena(MemoryArena *arena, size_t sizeC); // 'allocate_memory_char_ptr', from an arena.
+char **allocate_memory_char_ptr_ptr_in_arena(MemoryArena *arena, size_t strSize, size_t numStrings); // 'allocate_memory_char_ptr_ptr', with the pointers and the strings from an arena.
+/// \}
+
+
+
+
 
 
 // ------------- Helper Functions for Performing Various Mathematical Operations on Containers -------------
@@ -73,6 +194,7 @@ double max_element(double *data, int n); // Returns the maximum element in an ar
 // ------------- Helper Functions for Operations with Time -------------
 /// \{
 time_t convert_to_unix_time(const char *dateTimeString); // Converts a date/time string into Unix time.
+int64_t days_since_unix_epoch(int64_t year, int month, int day); // Counts the days from January 1, 1970 to a date of the proleptic Gregorian calendar, without 'mktime'.
 struct tm *thread_safe_localtime(const time_t *tim, struct tm *result); // A thread-safe wrapper around localtime.
 /// \}
 
@@ -81,11 +203,37 @@ struct tm *thread_safe_localtime(const time_t *tim, struct tm *result); // A thr
 
 
 
+// ------------- Helper Functions for Validity Bitmaps -------------
+/// \{
+uint64_t *allocate_validity_bitmap(size_t valueCount); // Allocates a packed bitmap with one bit per value, every value initially marked missing.
+uint64_t *grow_validity_bitmap(uint64_t *validity, size_t oldValueCount, size_t newValueCount); // Grows a bitmap, the added values are marked missing.
+void set_validity_bit(uint64_t *validity, size_t index); // Marks a value as present.
+bool validity_bit_is_set(const uint64_t *validity, size_t index); // Checks whether a value is present.
+size_t count_valid_values(const uint64_t *validity, size_t valueCount); // Counts the present values, 64 at a time with a population count.
+/// \}
+
+
+
+
+
+
+// ------------- Helper Functions for Concurrency -------------
+/// \{
+int determine_hardware_thread_count(void); // Determines the number of hardware threads(online logical processors) available.
+/// \}
+
+
+
+
+
+
 // ------------- Helper Functions for Bitwise Operations(on Binary Numerals?) -------------
 /// \{
 uint64_t flip_sign_bit(uint64_t value); // Helper function to flip the sign bit of the double's binary representation.
 uint64_t double_to_uint64(double value); // Helper function to reinterpret a double as an uint64_t.
 double uint64_to_double(uint64_t value); // Helper function to reinterpret a uint64_t as an double.
+uint64_t double_to_radix_key(double value); // Maps a double to a 64-bit unsigned integer that orders the same way, for radix sorting.
+double radix_key_to_double(uint64_t key); // Restores the double a radix key was made from.
 /// \}
 
 
@@ -96,12 +244,30 @@ double uint64_to_double(uint64_t value); // Helper function to reinterpret a uin
 
 // ------------- Helper Functions for Sorting -------------
 /// \{
+void merge_sorted_runs(const double *first, int firstLength, const double *second, int secondLength, double *destination); // Merges two sorted runs into a separate destination, branchlessly.
 void merge_data(double *unsortedData, int left, int middle, int right); // Merges two sorted subarrays into a single sorted array.
-void merge_sort_data(double *unsortedData, int left, int right); // Recursively divides and sorts an array using the merge sort algorithm.
+void merge_sort_with_buffer(double *data, double *scratch, int numElements); // Sorts an array with a bottom-up merge sort, alternating between it and a scratch buffer.
+void merge_sort_data(double *unsortedData, int left, int right); // Sorts a portion of an array using the merge sort algorithm.
 void merge_sort(double *unsortedData, const int numElements); // Sorts an array of doubles using the merge sort algorithm.
 
+void *sort_merge_sort_run(void *arg); // Thread routine sorting one run of a parallel merge sort.
+void *merge_merge_sort_segment(void *arg); // Thread routine merging one segment of a pair of runs of a parallel merge sort.
+int find_merge_path_split(const double *first, int firstLength, const double *second, int secondLength, int diagonal); // Finds how many of the first merged values of two sorted runs come from the first run.
+void parallel_merge_sort(double *unsortedData, const int numElements, int threadCount); // Sorts an array of doubles with a merge sort divided between several threads.
+
+void insertion_sort_data(double *data, int left, int right); // Sorts a short portion of an array of doubles by insertion.
+void select_order_statistics_in_range(double *data, int left, int right, const int *ranks, int rankCount, int depthLimit); // Recursively partitions a range of an array until the requested ranks are in place.
+void select_order_statistics(double *data, const int numElements, int *ranks, int rankCount); // Puts the values of the requested ranks in their sorted positions, in expected linear time, without sorting the array.
+
 
+void *count_radix_sort_chunk_digits(void *arg); // Thread routine counting every byte of a chunk's radix sort keys at once.
+void *count_radix_sort_chunk_digit(void *arg); // Thread routine counting the byte of the current pass of a chunk's radix sort keys.
+void *scatter_radix_sort_chunk(void *arg); // Thread routine moving a chunk's radix sort keys to their positions after the current pass.
+void run_radix_sort_chunks(void *(*routine)(void *), RadixSortChunk *chunks, int chunkCount); // Runs a radix sort thread routine on every chunk concurrently.
+void radix_sort_keys(uint64_t *keys, int *indices, const int numElements, int threadCount); // Stably sorts 64-bit keys, optionally with row indices, by a parallel radix sort that skips constant bytes.
 void radix_sort_doubles(double *unsortedData, const int numElements); // Sorts an array of double precision floating-point numbers by interpreting their bit patterns as unsigned 64-bit integers using Radix Sort.
+void parallel_radix_sort_doubles(double *unsortedData, const int numElements, int threadCount); // Sorts an array of doubles with a radix sort divided between several threads.
+int *radix_argsort_doubles(const double *data, const int numElements, int threadCount); // Computes the row indices that stably sort an array of doubles, for reordering other columns by it.
 /// \}
 
 
@@ -8,6 +8,10 @@
 #include "GeneralUtilities.h"
 #include "StringUtilities.h"
 #include "Integrators.h"
+#include <pthread.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 
 
@@ -42,16 +46,14 @@ double* get_uniform_samples(int *n, double xmin, double xmax, double step)
  * compute_mean
  *
  * This function calculates the mean value of an array of data.
- * The mean is calculated as the sum of all elements divided by the number of elements.
+ * The mean is calculated as the sum of all elements divided by the number of elements, here by 'accumulate_moments'.
+ * NaN values mark missing entries and are skipped.
  */
 double compute_mean(double* data, int n)
 {
-	double sum = 0.0;
-	for (int i = 0; i < n; i++)
-	{
-		sum += data[i];
-	}
-	return sum / n;
+	MomentsAccumulator moments = create_moments_accumulator();
+	accumulate_moments(&moments, data, n);
+	return (moments.count > 0) ? moments.mean : NAN;
 }
 
 
@@ -65,16 +67,20 @@ double compute_mean(double* data, int n)
  *a measure of how dispersed the data is in relation to the mean
  * The formula for the sample standard deviation is:
  *      s = sqrt((1/n) * Σ(xi - mean)^2)
+ * The sum is taken from 'accumulate_moments' as M2 + n * (mean of the data - mean)^2, which equals it exactly for any 'mean'.
+ * NaN values mark missing entries and are skipped.
  */
 double compute_standard_deviation(double* data, int n, double mean)
 {
-	double variance = 0.0;
-	
-	for (int i = 0; i < n; i++)
+	MomentsAccumulator moments = create_moments_accumulator();
+	accumulate_moments(&moments, data, n);
+	if (moments.count == 0)
 	{
-		variance += (data[i] - mean) * (data[i] - mean);
+		return NAN;
 	}
-	variance/=n;
+	
+	double meanOffset = moments.mean - mean;
+	double variance = (moments.M2 + moments.count * meanOffset * meanOffset) / moments.count;
 	return sqrt(variance);
 }
 
@@ -91,595 +97,3309 @@ double compute_standard_deviation(double* data, int n, double mean)
  * random variable about its mean.
  * The formula for the sample skewness is:
  *  s =  (n / (n−1)(n−2)) * Σ(xi - mean / std_dev)^3)
+ * The mean, standard deviation, and sum are all taken from a single pass of 'accumulate_moments'.
  */
 double compute_skewness(double *data, int n)
 {
-	double m = compute_mean(data, n);
-	double sd = compute_standard_deviation(data, n, m);
-	double sum = 0.0;
-	
-	for(int i = 0; i < n; i++)
-	{
-		sum += pow((data[i] - m) / sd, 3);
-	}
-	
-	double skewness = ((double)n / ((n - 1) * (n - 2))) * sum;
-	return skewness;
+	MomentsAccumulator moments = create_moments_accumulator();
+	accumulate_moments(&moments, data, n);
+	return moments_skewness(&moments);
 }
 
 
 
 
 /**
- * compute_normal_cdf
+ * compute_kurtosis
  *
- * This function calculates the cumulative distribution function (CDF)
- * for a normal distribution at a given value 'x', with given mean 'mu'
- * and standard deviation 'sigma'.
+ * Computes the excess kurtosis of an array of data, a measure of the weight of the tails of its distribution: 0 for a normal
+ * distribution, positive for heavier tails, and negative for lighter ones. The formula is:
+ *  k = n * Σ(xi - mean)^4 / (Σ(xi - mean)^2)^2 - 3
+ * computed from a single pass of 'accumulate_moments'. NaN values mark missing entries and are skipped.
  */
-double compute_normal_cdf(double x, double mu, double sigma)
+double compute_kurtosis(double *data, int n)
 {
-	return 0.5 * (1.0 + erf((x - mu) / (sigma * sqrt(2.0))));
+	MomentsAccumulator moments = create_moments_accumulator();
+	accumulate_moments(&moments, data, n);
+	return moments_excess_kurtosis(&moments);
 }
 
 
 
 
-
-
-
-
+/**
+ * create_moments_accumulator
+ *
+ * Creates an accumulator holding no values, to which values are added with 'accumulate_moments' or other accumulators merged with
+ * 'merge_moments_accumulators'.
+ *
+ * @return The empty accumulator.
+ */
+MomentsAccumulator create_moments_accumulator(void)
+{
+	MomentsAccumulator moments = {0, 0, 0.0, 0.0, 0.0, 0.0, INFINITY, -INFINITY};
+	return moments;
+}
 
 
 
 
 /**
- * compute_gaussian
+ * compute_block_moments_scalar
  *
- * Computes the Gaussian function values for given x-values.
- * Gaussian function is given by: f(x) = (2/sqrt(pi)) * exp(-x^2).
- * This function returns an array of Gaussian values for a given array of x-values.
+ * Computes the moments of a block of values in two passes over it: the first finds the count, sum, and range of the values, the
+ * second sums the powers of their deviations from the block's mean. The block is small enough(see MOMENTS_BLOCK_LENGTH) to still
+ * be in cache for the second pass, and summing deviations from the exact mean of the block keeps the sums accurate however far
+ * the values are from zero. NaN values are counted as missing and skipped.
+ *
+ * @param block Pointer to the first value of the block.
+ * @param blockLength The number of values in the block.
+ * @return The moments of the block.
  */
-double* compute_gaussian(int n, double x[])
+MomentsAccumulator compute_block_moments_scalar(const double *block, int blockLength)
 {
-	double *f = allocate_memory_double_ptr(n);
+	MomentsAccumulator moments = create_moments_accumulator();
+	double sum = 0.0;
+	for (int i = 0; i < blockLength; i++)
+	{
+		double value = block[i];
+		if (isnan(value))
+		{
+			continue;
+		}
+		moments.count++;
+		sum += value;
+		moments.min = (value < moments.min) ? value : moments.min;
+		moments.max = (value > moments.max) ? value : moments.max;
+	}
+	moments.nullCount = blockLength - moments.count;
+	if (moments.count == 0)
+	{
+		return moments;
+	}
 	
-	for (int i = 0; i < n; i++)
+	
+	moments.mean = sum / moments.count;
+	for (int i = 0; i < blockLength; i++)
 	{
-		f[i] = (2.0/sqrt(M_PI)) * exp(-(x[i] * x[i]));
+		if (isnan(block[i]))
+		{
+			continue;
+		}
+		double deviation = block[i] - moments.mean;
+		double squaredDeviation = deviation * deviation;
+		moments.M2 += squaredDeviation;
+		moments.M3 += squaredDeviation * deviation;
+		moments.M4 += squaredDeviation * squaredDeviation;
 	}
-	return f;
+	
+	return moments;
 }
 
 
 
 
+#if defined(__x86_64__) || defined(__i386__)
 /**
- * gaussian_riemann_sum_integration
+ * compute_block_moments_sse2
  *
- * Integrates the function f(x) using Riemann approximation.
- * This function takes in arrays of x-values and their corresponding function values f(x) and
- * computes samples of the function F(x), the integral, using a Riemann sum approximation.
+ * Computes the moments of a block of values exactly as 'compute_block_moments_scalar' does, 4 values at a time with SSE2 in two
+ * independent pairs of lanes. A value compared unordered with itself is NaN, so the comparison masks missing values out of every
+ * sum, and 'minpd'/'maxpd' return their second operand when the first is NaN. The values past the last multiple of 4 are added
+ * one at a time.
+ *
+ * @param block Pointer to the first value of the block.
+ * @param blockLength The number of values in the block.
+ * @return The moments of the block.
  */
-double* gaussian_riemann_sum_integration(int n, double x[], double f[])
+MomentsAccumulator compute_block_moments_sse2(const double *block, int blockLength)
 {
-	double *F = allocate_memory_double_ptr(n);
+	MomentsAccumulator moments = create_moments_accumulator();
+	const __m128d ones = _mm_set1_pd(1.0);
+	__m128d sums[2] = { _mm_setzero_pd(), _mm_setzero_pd() };
+	__m128d counts[2] = { _mm_setzero_pd(), _mm_setzero_pd() };
+	__m128d mins[2] = { _mm_set1_pd(INFINITY), _mm_set1_pd(INFINITY) };
+	__m128d maxs[2] = { _mm_set1_pd(-INFINITY), _mm_set1_pd(-INFINITY) };
+	int vectorLength = blockLength & ~3;
+	for (int i = 0; i < vectorLength; i += 4)
+	{
+		for (int lane = 0; lane < 2; lane++)
+		{
+			__m128d values = _mm_loadu_pd(block + i + 2 * lane);
+			__m128d present = _mm_cmpord_pd(values, values);
+			sums[lane] = _mm_add_pd(sums[lane], _mm_and_pd(present, values));
+			counts[lane] = _mm_add_pd(counts[lane], _mm_and_pd(present, ones));
+			mins[lane] = _mm_min_pd(values, mins[lane]);
+			maxs[lane] = _mm_max_pd(values, maxs[lane]);
+		}
+	}
 	
-	F[0] = 0; // Starting value
-	for (int i = 1; i < n; i++)
+	double laneValues[2];
+	_mm_storeu_pd(laneValues, _mm_add_pd(sums[0], sums[1]));
+	double sum = laneValues[0] + laneValues[1];
+	_mm_storeu_pd(laneValues, _mm_add_pd(counts[0], counts[1]));
+	moments.count = (int64_t)(laneValues[0] + laneValues[1]);
+	_mm_storeu_pd(laneValues, _mm_min_pd(mins[0], mins[1]));
+	moments.min = (laneValues[0] < laneValues[1]) ? laneValues[0] : laneValues[1];
+	_mm_storeu_pd(laneValues, _mm_max_pd(maxs[0], maxs[1]));
+	moments.max = (laneValues[0] > laneValues[1]) ? laneValues[0] : laneValues[1];
+	for (int i = vectorLength; i < blockLength; i++)
 	{
-		double dx = x[i] - x[i-1];
-		F[i] = F[i-1] + f[i] * dx; // Rectangle approximation for area
+		double value = block[i];
+		if (isnan(value))
+		{
+			continue;
+		}
+		moments.count++;
+		sum += value;
+		moments.min = (value < moments.min) ? value : moments.min;
+		moments.max = (value > moments.max) ? value : moments.max;
 	}
-	return F;
+	moments.nullCount = blockLength - moments.count;
+	if (moments.count == 0)
+	{
+		return moments;
+	}
+	
+	
+	moments.mean = sum / moments.count;
+	const __m128d mean = _mm_set1_pd(moments.mean);
+	__m128d M2s[2] = { _mm_setzero_pd(), _mm_setzero_pd() };
+	__m128d M3s[2] = { _mm_setzero_pd(), _mm_setzero_pd() };
+	__m128d M4s[2] = { _mm_setzero_pd(), _mm_setzero_pd() };
+	for (int i = 0; i < vectorLength; i += 4)
+	{
+		for (int lane = 0; lane < 2; lane++)
+		{
+			__m128d values = _mm_loadu_pd(block + i + 2 * lane);
+			__m128d deviations = _mm_and_pd(_mm_cmpord_pd(values, values), _mm_sub_pd(values, mean));
+			__m128d squaredDeviations = _mm_mul_pd(deviations, deviations);
+			M2s[lane] = _mm_add_pd(M2s[lane], squaredDeviations);
+			M3s[lane] = _mm_add_pd(M3s[lane], _mm_mul_pd(squaredDeviations, deviations));
+			M4s[lane] = _mm_add_pd(M4s[lane], _mm_mul_pd(squaredDeviations, squaredDeviations));
+		}
+	}
+	
+	_mm_storeu_pd(laneValues, _mm_add_pd(M2s[0], M2s[1]));
+	moments.M2 = laneValues[0] + laneValues[1];
+	_mm_storeu_pd(laneValues, _mm_add_pd(M3s[0], M3s[1]));
+	moments.M3 = laneValues[0] + laneValues[1];
+	_mm_storeu_pd(laneValues, _mm_add_pd(M4s[0], M4s[1]));
+	moments.M4 = laneValues[0] + laneValues[1];
+	for (int i = vectorLength; i < blockLength; i++)
+	{
+		if (isnan(block[i]))
+		{
+			continue;
+		}
+		double deviation = block[i] - moments.mean;
+		double squaredDeviation = deviation * deviation;
+		moments.M2 += squaredDeviation;
+		moments.M3 += squaredDeviation * deviation;
+		moments.M4 += squaredDeviation * squaredDeviation;
+	}
+	
+	return moments;
 }
 
 
 
 
-
-
-
-
-
-
-
-
 /**
- * anderson_darling_normality_test
- *
- * Performs the Anderson-Darling test for normality.
+ * compute_block_moments_avx2
  *
- * The test statistic A-squared is a measure of how well the data follow
- * a particular distribution. For the normal distribution, if the A-squared
- * statistic is large, it indicates that the data does not follow a normal distribution.
- *tfr1e
- * The test rejects the hypothesis of normality when the p-value is less than or equal to 0.05.
- * Failing the normality test allows you to state with 95% confidence the data does not fit the normal distribution.
- * Passing the normality test only allows you to state no significant departure from normality was found.
+ * Computes the moments of a block of values exactly as 'compute_block_moments_sse2' does, 8 values at a time with AVX2 in two
+ * independent sets of 4 lanes. Compiled for AVX2 regardless of the flags the rest of the program is built with, so it must only be
+ * called once 'select_block_moments_kernel' has confirmed that the processor supports AVX2.
  *
- * The Anderson-Darling test, while having excellent theoretical properties, has a serious flaw when applied to real world data.
- * The Anderson-Darling test is severely affected by ties in the data due to poor precision.
- * When a significant number of ties exist, the Anderson-Darling will frequently reject the data as non-normal,
- * regardless of how well the data fits the normal distribution. A tie is when identical values occur more than once.
+ * @param block Pointer to the first value of the block.
+ * @param blockLength The number of values in the block.
+ * @return The moments of the block.
  */
-double anderson_darling_normality_test(double *data, int n)
+__attribute__((target("avx2")))
+MomentsAccumulator compute_block_moments_avx2(const double *block, int blockLength)
 {
-	// The test requires sorted data
-	double *sortedData = allocate_memory_double_ptr(n);
+	MomentsAccumulator moments = create_moments_accumulator();
+	const __m256d ones = _mm256_set1_pd(1.0);
+	__m256d sums[2] = { _mm256_setzero_pd(), _mm256_setzero_pd() };
+	__m256d counts[2] = { _mm256_setzero_pd(), _mm256_setzero_pd() };
+	__m256d mins[2] = { _mm256_set1_pd(INFINITY), _mm256_set1_pd(INFINITY) };
+	__m256d maxs[2] = { _mm256_set1_pd(-INFINITY), _mm256_set1_pd(-INFINITY) };
+	int vectorLength = blockLength & ~7;
+	for (int i = 0; i < vectorLength; i += 8)
+	{
+		for (int lane = 0; lane < 2; lane++)
+		{
+			__m256d values = _mm256_loadu_pd(block + i + 4 * lane);
+			__m256d present = _mm256_cmp_pd(values, values, _CMP_ORD_Q);
+			sums[lane] = _mm256_add_pd(sums[lane], _mm256_and_pd(present, values));
+			counts[lane] = _mm256_add_pd(counts[lane], _mm256_and_pd(present, ones));
+			mins[lane] = _mm256_min_pd(values, mins[lane]);
+			maxs[lane] = _mm256_max_pd(values, maxs[lane]);
+		}
+	}
 	
-	for (int i = 0; i < n; i++)
+	double laneValues[4];
+	_mm256_storeu_pd(laneValues, _mm256_add_pd(sums[0], sums[1]));
+	double sum = (laneValues[0] + laneValues[1]) + (laneValues[2] + laneValues[3]);
+	_mm256_storeu_pd(laneValues, _mm256_add_pd(counts[0], counts[1]));
+	moments.count = (int64_t)((laneValues[0] + laneValues[1]) + (laneValues[2] + laneValues[3]));
+	_mm256_storeu_pd(laneValues, _mm256_min_pd(mins[0], mins[1]));
+	for (int lane = 0; lane < 4; lane++)
 	{
-		sortedData[i] = data[i];
+		moments.min = (laneValues[lane] < moments.min) ? laneValues[lane] : moments.min;
+	}
+	_mm256_storeu_pd(laneValues, _mm256_max_pd(maxs[0], maxs[1]));
+	for (int lane = 0; lane < 4; lane++)
+	{
+		moments.max = (laneValues[lane] > moments.max) ? laneValues[lane] : moments.max;
+	}
+	for (int i = vectorLength; i < blockLength; i++)
+	{
+		double value = block[i];
+		if (isnan(value))
+		{
+			continue;
+		}
+		moments.count++;
+		sum += value;
+		moments.min = (value < moments.min) ? value : moments.min;
+		moments.max = (value > moments.max) ? value : moments.max;
+	}
+	moments.nullCount = blockLength - moments.count;
+	if (moments.count == 0)
+	{
+		return moments;
 	}
-	merge_sort(sortedData, n);
 	
 	
-	double mean = compute_mean(data, n);
-	double std_dev = compute_standard_deviation(data, n, mean);
+	moments.mean = sum / moments.count;
+	const __m256d mean = _mm256_set1_pd(moments.mean);
+	__m256d M2s[2] = { _mm256_setzero_pd(), _mm256_setzero_pd() };
+	__m256d M3s[2] = { _mm256_setzero_pd(), _mm256_setzero_pd() };
+	__m256d M4s[2] = { _mm256_setzero_pd(), _mm256_setzero_pd() };
+	for (int i = 0; i < vectorLength; i += 8)
+	{
+		for (int lane = 0; lane < 2; lane++)
+		{
+			__m256d values = _mm256_loadu_pd(block + i + 4 * lane);
+			__m256d deviations = _mm256_and_pd(_mm256_cmp_pd(values, values, _CMP_ORD_Q), _mm256_sub_pd(values, mean));
+			__m256d squaredDeviations = _mm256_mul_pd(deviations, deviations);
+			M2s[lane] = _mm256_add_pd(M2s[lane], squaredDeviations);
+			M3s[lane] = _mm256_add_pd(M3s[lane], _mm256_mul_pd(squaredDeviations, deviations));
+			M4s[lane] = _mm256_add_pd(M4s[lane], _mm256_mul_pd(squaredDeviations, squaredDeviations));
+		}
+	}
 	
-	double A_squared = 0.0;
-	for (int i = 0; i < n; i++)
+	_mm256_storeu_pd(laneValues, _mm256_add_pd(M2s[0], M2s[1]));
+	moments.M2 = (laneValues[0] + laneValues[1]) + (laneValues[2] + laneValues[3]);
+	_mm256_storeu_pd(laneValues, _mm256_add_pd(M3s[0], M3s[1]));
+	moments.M3 = (laneValues[0] + laneValues[1]) + (laneValues[2] + laneValues[3]);
+	_mm256_storeu_pd(laneValues, _mm256_add_pd(M4s[0], M4s[1]));
+	moments.M4 = (laneValues[0] + laneValues[1]) + (laneValues[2] + laneValues[3]);
+	for (int i = vectorLength; i < blockLength; i++)
 	{
-		double Fi = compute_normal_cdf(sortedData[i], mean, std_dev);
-		A_squared += (2 * (i + 1) - 1) * (log(Fi) + log(1 - Fi));
+		if (isnan(block[i]))
+		{
+			continue;
+		}
+		double deviation = block[i] - moments.mean;
+		double squaredDeviation = deviation * deviation;
+		moments.M2 += squaredDeviation;
+		moments.M3 += squaredDeviation * deviation;
+		moments.M4 += squaredDeviation * squaredDeviation;
 	}
-	A_squared = -n - A_squared * (1.0 / n);
 	
-	free(sortedData);
-	return A_squared;
+	return moments;
 }
+#endif
 
 
 
 
-
-
-
-
+/**
+ * select_block_moments_kernel
+ *
+ * Chooses the fastest block moments kernel the processor supports: AVX2, then SSE2(always present on x86-64), and the scalar
+ * kernel on any other architecture. The choice is made on the first call and remembered.
+ *
+ * @return The selected kernel.
+ */
+BlockMomentsKernel select_block_moments_kernel(void)
+{
+	static _Atomic(BlockMomentsKernel) selectedKernel = NULL; // Threads racing to make the first selection all choose the same kernel
+	BlockMomentsKernel kernel = selectedKernel;
+	if (kernel == NULL)
+	{
+#if defined(__x86_64__) || defined(__i386__)
+		__builtin_cpu_init();
+		kernel = __builtin_cpu_supports("avx2") ? compute_block_moments_avx2 : compute_block_moments_sse2;
+#else
+		kernel = compute_block_moments_scalar;
+#endif
+		selectedKernel = kernel;
+	}
+	
+	return kernel;
+}
 
 
 
 
 /**
- * compute_IQR
+ * merge_moments_accumulators
  *
- * Computes the Interquartile Range (IQR) of a dataset.
- * The IQR is a measure of statistical dispersion and is calculated as the difference
- * between the 75th (Q3) and 25th (Q1) percentiles of the dataset. The function sorts
- * the data internally before computing the quartiles. Handles both even and
- * odd-sized datasets. If the computed IQR is zero (indicating all values are the same),
- * the function issues a warning and recalculates the IQR based on the 25th and 75th indices.
- * Assumes that the dataset is large enough to provide meaningful percentile values.
+ * Merges the accumulator of one set of values into the accumulator of another, disjoint set, producing the accumulator of both, with
+ * the pairwise update formulas of Chan et al. and Pébay for the mean and central moments:
+ *   delta = mean_b - mean_a,  n = n_a + n_b
+ *   M2 = M2_a + M2_b + delta^2 * n_a * n_b / n
+ *   M3 = M3_a + M3_b + delta^3 * n_a * n_b * (n_a - n_b) / n^2 + 3 * delta * (n_a * M2_b - n_b * M2_a) / n
+ *   M4 = M4_a + M4_b + delta^4 * n_a * n_b * (n_a^2 - n_a * n_b + n_b^2) / n^3 + 6 * delta^2 * (n_a^2 * M2_b + n_b^2 * M2_a) / n^2
+ *        + 4 * delta * (n_a * M3_b - n_b * M3_a) / n
+ * Partial accumulators of blocks, chunks, or threads can therefore be combined in any grouping.
+ *
+ * @param moments The accumulator to merge into.
+ * @param otherMoments The accumulator of the other values, it is not modified.
  */
-double compute_IQR(double* data, int n)
+void merge_moments_accumulators(MomentsAccumulator *moments, const MomentsAccumulator *otherMoments)
 {
-	// Allocate memory for a copy of the data to be sorted
-	double *sortedData = allocate_memory_double_ptr(n);
-	
-	
-	// Copy data to the new array for sorting, to preserve the original data order
-	for (int i = 0; i < n; i++)
-	{
-		sortedData[i] = data[i];
-	}
-	//memcpy(sortedData, data, n);
-	
-	// Sort the data to prepare for IQR calculation
-	merge_sort(sortedData, n); // // Note: Sorting is required for IQR calculation. merge sort is a comparison sort algorithm(good for medium size lists and O(nlogn) in the worst case)
-	
-	
-	//merge_sort(data, n);
-	
-	// Calculating the Interquartile Range (IQR).
-	double iqr = 0.0;
-	double q25, q75;
-	
-	// Calculate the 25th and 75th percentiles based on sorted data
-	// If the number of data points is even, calculate the quartiles using the middle two points
-	if (n % 2 == 0)
+	moments->nullCount += otherMoments->nullCount;
+	if (otherMoments->count == 0)
 	{
-		int mid = n / 2;
-		q25 = (sortedData[mid / 2 - 1] + sortedData[mid / 2]) / 2.0;
-		q75 = (sortedData[mid + mid / 2 - 1] + sortedData[mid + mid / 2]) / 2.0;
+		return;
 	}
-	else  // If the number of data points is odd
+	if (moments->count == 0)
 	{
-		int mid = (n - 1) / 2;
-		q25 = sortedData[mid / 2];
-		q75 = sortedData[mid + mid / 2];
+		int64_t nullCount = moments->nullCount;
+		*moments = *otherMoments;
+		moments->nullCount = nullCount;
+		return;
 	}
 	
-	// Compute the IQR as the difference between the 75th and 25th quartiles
-	iqr = q75 - q25;
-	
-	// Handle special case where IQR is zero, which can skew the bin width calculation
-	if (iqr == 0.0)
-	{
-		perror("\n\nError: Interquartile range is zero. Choose a different binning method, in 'compute_bin_width'.");
-		//printf("\nq75: %lf", q75);
-		//printf("\nq25: %lf", q25);
-		//printf("\n iqr: %lf \n\n\n\n", iqr);
-		//free(sortedData);
-		
-		int q25_index = n / 4;
-		int q75_index = 3 * n / 4;
-		double q25 = sortedData[q25_index];
-		double q75 = sortedData[q75_index];
-		return q75 - q25;
-	}
 	
-	// Return the computed IQR
-	return iqr;
+	double countA = (double)moments->count, countB = (double)otherMoments->count;
+	double count = countA + countB;
+	double delta = otherMoments->mean - moments->mean;
+	double deltaOverCount = delta / count;
+	double deltaOverCountSquared = deltaOverCount * deltaOverCount;
+	double crossTerm = delta * deltaOverCount * countA * countB; // delta^2 * n_a * n_b / n
+	
+	double M4 = moments->M4 + otherMoments->M4 + crossTerm * deltaOverCountSquared * (countA * countA - countA * countB + countB * countB)
+	            + 6.0 * deltaOverCountSquared * (countA * countA * otherMoments->M2 + countB * countB * moments->M2)
+	            + 4.0 * deltaOverCount * (countA * otherMoments->M3 - countB * moments->M3);
+	double M3 = moments->M3 + otherMoments->M3 + crossTerm * deltaOverCount * (countA - countB)
+	            + 3.0 * deltaOverCount * (countA * otherMoments->M2 - countB * moments->M2);
+	double M2 = moments->M2 + otherMoments->M2 + crossTerm;
+	
+	moments->count += otherMoments->count;
+	moments->mean += deltaOverCount * countB;
+	moments->M2 = M2;
+	moments->M3 = M3;
+	moments->M4 = M4;
+	moments->min = (otherMoments->min < moments->min) ? otherMoments->min : moments->min;
+	moments->max = (otherMoments->max > moments->max) ? otherMoments->max : moments->max;
 }
 
 
 
 
+/**
+ * accumulate_moments
+ *
+ * Adds an array of values to a moments accumulator in one pass over memory: the values are taken MOMENTS_BLOCK_LENGTH at a time,
+ * the moments of each block are computed by the fastest available kernel(see 'select_block_moments_kernel'), and each block is merged
+ * into the accumulator. NaN values mark missing entries, they are counted in 'nullCount' and otherwise skipped.
+ *
+ * @param moments The accumulator to add the values to.
+ * @param data The values.
+ * @param n The number of values.
+ */
+void accumulate_moments(MomentsAccumulator *moments, const double *data, int n)
+{
+	BlockMomentsKernel kernel = select_block_moments_kernel();
+	for (int blockStart = 0; blockStart < n; blockStart += MOMENTS_BLOCK_LENGTH)
+	{
+		int blockLength = (n - blockStart < MOMENTS_BLOCK_LENGTH) ? n - blockStart : MOMENTS_BLOCK_LENGTH;
+		MomentsAccumulator blockMoments = kernel(data + blockStart, blockLength);
+		merge_moments_accumulators(moments, &blockMoments);
+	}
+}
 
 
 
 
+/**
+ * accumulate_moments_of_valid_values
+ *
+ * Adds only the values marked present in a validity bitmap to a moments accumulator, the missing ones are counted in 'nullCount'.
+ * The present values are packed into a block of MOMENTS_BLOCK_LENGTH values, a word of the bitmap at a time(a full word is copied
+ * in one block, an empty word is skipped, and the set bits of any other word are visited with count-trailing-zeros), and each full
+ * block is passed to the block moments kernel as in 'accumulate_moments'.
+ *
+ * @param moments The accumulator to add the values to.
+ * @param data The values, missing ones are ignored whatever they hold.
+ * @param validity The validity bitmap of the values.
+ * @param n The number of values.
+ */
+void accumulate_moments_of_valid_values(MomentsAccumulator *moments, const double *data, const uint64_t *validity, int n)
+{
+	BlockMomentsKernel kernel = select_block_moments_kernel();
+	double block[MOMENTS_BLOCK_LENGTH + 64]; // A word's values are always added whole, so the block may overrun by up to 63 before it is flushed
+	int blockLength = 0;
+	for (int wordStart = 0; wordStart < n; wordStart += 64)
+	{
+		int wordLength = (n - wordStart < 64) ? n - wordStart : 64;
+		uint64_t word = validity[wordStart / 64];
+		if (wordLength < 64)
+		{
+			word &= ((uint64_t)1 << wordLength) - 1;
+		}
+		
+		
+		if (word == UINT64_MAX)
+		{
+			memcpy(block + blockLength, data + wordStart, 64 * sizeof(double));
+			blockLength += 64;
+		}
+		else
+		{
+			moments->nullCount += wordLength - __builtin_popcountll(word);
+			for (; word != 0; word &= word - 1)
+			{
+				block[blockLength++] = data[wordStart + __builtin_ctzll(word)];
+			}
+		}
+		
+		
+		if (blockLength >= MOMENTS_BLOCK_LENGTH)
+		{
+			MomentsAccumulator blockMoments = kernel(block, blockLength);
+			merge_moments_accumulators(moments, &blockMoments);
+			blockLength = 0;
+		}
+	}
+	
+	MomentsAccumulator blockMoments = kernel(block, blockLength);
+	merge_moments_accumulators(moments, &blockMoments);
+}
 
 
 
 
+/**
+ * moments_standard_deviation
+ *
+ * Computes the standard deviation of the values of an accumulator, with the same formula as 'compute_standard_deviation':
+ *      s = sqrt(M2 / n)
+ *
+ * @param moments The accumulator.
+ * @return The standard deviation, or NAN if the accumulator holds no values.
+ */
+double moments_standard_deviation(const MomentsAccumulator *moments)
+{
+	return (moments->count > 0) ? sqrt(moments->M2 / moments->count) : NAN;
+}
 
 
 
 
+/**
+ * moments_skewness
+ *
+ * Computes the skewness of the values of an accumulator, with the same formula as 'compute_skewness':
+ *      s = (n / (n−1)(n−2)) * M3 / std_dev^3
+ *
+ * @param moments The accumulator.
+ * @return The skewness, or NAN if the accumulator holds fewer than 3 values.
+ */
+double moments_skewness(const MomentsAccumulator *moments)
+{
+	if (moments->count < 3)
+	{
+		return NAN;
+	}
+	
+	double n = (double)moments->count;
+	double standardDeviation = moments_standard_deviation(moments);
+	return (n / ((n - 1) * (n - 2))) * moments->M3 / (standardDeviation * standardDeviation * standardDeviation);
+}
 
 
 
 
+/**
+ * moments_excess_kurtosis
+ *
+ * Computes the excess kurtosis of the values of an accumulator, as 'compute_kurtosis' does:
+ *      k = n * M4 / M2^2 - 3
+ *
+ * @param moments The accumulator.
+ * @return The excess kurtosis, or NAN if the accumulator holds no values.
+ */
+double moments_excess_kurtosis(const MomentsAccumulator *moments)
+{
+	if (moments->count == 0)
+	{
+		return NAN;
+	}
+	
+	return moments->count * moments->M4 / (moments->M2 * moments->M2) - 3.0;
+}
 
 
 
 
+/**
+ * gather_valid_values
+ *
+ * Copies the values marked present in a validity bitmap into a dense array, in order, so that kernels needing the values themselves
+ * (sorting, quantiles, binning) see only real data rather than placeholder zeros. The bitmap is read a word of 64 values at a time:
+ * a full word is copied in one block, an empty word is skipped, and the set bits of any other word are visited with count-trailing-zeros.
+ *
+ * @param data The values, missing ones are ignored whatever they hold.
+ * @param validity The validity bitmap of the values.
+ * @param n The number of values.
+ * @param validValues The array receiving the present values, large enough for all of them(at most 'n').
+ * @return The number of present values copied.
+ */
+int gather_valid_values(const double *data, const uint64_t *validity, int n, double *validValues)
+{
+	int validCount = 0;
+	for (int wordStart = 0; wordStart < n; wordStart += 64)
+	{
+		int wordLength = (n - wordStart < 64) ? n - wordStart : 64;
+		uint64_t word = validity[wordStart / 64];
+		if (wordLength < 64)
+		{
+			word &= ((uint64_t)1 << wordLength) - 1;
+		}
+		
+		
+		if (word == UINT64_MAX)
+		{
+			memcpy(&validValues[validCount], &data[wordStart], 64 * sizeof(double));
+			validCount += 64;
+		}
+		else
+		{
+			for (; word != 0; word &= word - 1)
+			{
+				validValues[validCount++] = data[wordStart + __builtin_ctzll(word)];
+			}
+		}
+	}
+	return validCount;
+}
 
 
 
 
+/**
+ * compute_mean_of_valid_values
+ *
+ * Calculates the mean of only the values marked present in a validity bitmap, so missing values do not pull the mean towards zero.
+ * The present values are accumulated by 'accumulate_moments_of_valid_values'.
+ *
+ * @param data The values.
+ * @param validity The validity bitmap of the values.
+ * @param n The number of values.
+ * @return The mean of the present values, or NAN if none are present.
+ */
+double compute_mean_of_valid_values(const double *data, const uint64_t *validity, int n)
+{
+	MomentsAccumulator moments = create_moments_accumulator();
+	accumulate_moments_of_valid_values(&moments, data, validity, n);
+	return (moments.count > 0) ? moments.mean : NAN;
+}
+
+
+
+
+/**
+ * compute_standard_deviation_of_valid_values
+ *
+ * Calculates the standard deviation of only the values marked present in a validity bitmap, with the same formula as
+ * 'compute_standard_deviation', about a mean computed by 'compute_mean_of_valid_values'.
+ *
+ * @param data The values.
+ * @param validity The validity bitmap of the values.
+ * @param n The number of values.
+ * @param mean The mean of the present values.
+ * @return The standard deviation of the present values, or NAN if none are present.
+ */
+double compute_standard_deviation_of_valid_values(const double *data, const uint64_t *validity, int n, double mean)
+{
+	MomentsAccumulator moments = create_moments_accumulator();
+	accumulate_moments_of_valid_values(&moments, data, validity, n);
+	if (moments.count == 0)
+	{
+		return NAN;
+	}
+	
+	double meanOffset = moments.mean - mean;
+	return sqrt((moments.M2 + moments.count * meanOffset * meanOffset) / moments.count);
+}
+
+
+
+
+/**
+ * compute_IQR_of_valid_values
+ *
+ * Computes the Interquartile Range of only the values marked present in a validity bitmap, by gathering them with 'gather_valid_values'
+ * and selecting its quartiles in place with 'compute_IQR_by_selection'.
+ *
+ * @param data The values.
+ * @param validity The validity bitmap of the values.
+ * @param n The number of values.
+ * @return The IQR of the present values, or NAN if none are present.
+ */
+double compute_IQR_of_valid_values(const double *data, const uint64_t *validity, int n)
+{
+	double *validValues = allocate_memory_double_ptr(n > 0 ? n : 1);
+	int validCount = gather_valid_values(data, validity, n, validValues);
+	double iqr = (validCount > 0) ? compute_IQR_by_selection(validValues, validCount, NULL, NULL) : NAN; // The gathered values are already a scratch copy
+	free(validValues);
+	
+	return iqr;
+}
+
+
+
+
+/**
+ * compute_data_set_binning_of_valid_values
+ *
+ * Bins only the values marked present in a validity bitmap, by gathering them with 'gather_valid_values' and passing them to
+ * 'compute_data_set_binning', so missing values do not appear as a spike of zeros in the histogram.
+ *
+ * @param data The values.
+ * @param validity The validity bitmap of the values.
+ * @param n The number of values.
+ * @return The histogram of the present values.
+ */
+Histogram compute_data_set_binning_of_valid_values(const double *data, const uint64_t *validity, int n)
+{
+	double *validValues = allocate_memory_double_ptr(n > 0 ? n : 1);
+	int validCount = gather_valid_values(data, validity, n, validValues);
+	Histogram histogram = compute_data_set_binning(validValues, validCount);
+	free(validValues);
+	
+	return histogram;
+}
+
+
+
+
+
+/**
+ * create_column_statistics_cache
+ *
+ * Creates the cache of the data derived from a column that the statistical methods share, holding only the column's present values
+ * (and the row each came from) to begin with. Each derived item is computed the first time it is asked for and kept until the cache
+ * is freed, so however many methods are applied to the column, it is sorted at most once and its moments are accumulated at most once.
+ * The cache is of the column as it was when the cache was created, tagged with the column's 'sourceVersion', the owner of the
+ * column replaces the cache when the column's version moves on(see 'data_column_statistics').
+ *
+ * @param data The values of the column.
+ * @param validity The validity bitmap of the values, or NULL if they are all present.
+ * @param n The number of values.
+ * @param sourceVersion The version of the column the values were taken from.
+ * @return The cache, to be freed with 'free_column_statistics_cache'.
+ */
+ColumnStatisticsCache *create_column_statistics_cache(const double *data, const uint64_t *validity, int n, uint64_t sourceVersion)
+{
+	ColumnStatisticsCache *cache = (ColumnStatisticsCache *)calloc(1, sizeof(ColumnStatisticsCache));
+	if (cache == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'create_column_statistics_cache'.\n");
+		exit(1);
+	}
+	cache->sourceVersion = sourceVersion;
+	cache->values = allocate_memory_double_ptr(n > 0 ? n : 1);
+	cache->rows = allocate_memory_int_ptr(n > 0 ? n : 1);
+	
+	
+	for (int i = 0; i < n; i++)
+	{
+		if (validity == NULL || validity_bit_is_set(validity, i))
+		{
+			cache->values[cache->count] = data[i];
+			cache->rows[cache->count] = i;
+			cache->count++;
+		}
+	}
+	
+	return cache;
+}
+
+
+
+
+/**
+ * free_column_statistics_cache
+ *
+ * Releases a column statistics cache and every item derived into it.
+ *
+ * @param cache The cache, or NULL.
+ */
+void free_column_statistics_cache(ColumnStatisticsCache *cache)
+{
+	if (cache == NULL)
+	{
+		return;
+	}
+	
+	free(cache->values);
+	free(cache->rows);
+	free(cache->sortedValues);
+	free(cache->sortPermutation);
+	free(cache);
+}
+
+
+
+
+/**
+ * cached_sorted_values
+ *
+ * Returns the present values of a cached column in ascending order, sorting them the first time. The column is sorted once by
+ * 'radix_argsort_doubles', which yields the sort permutation at the same time, and the sorted values are gathered through it.
+ *
+ * @param cache The cache of the column.
+ * @return The 'count' present values in ascending order, owned by the cache.
+ */
+const double *cached_sorted_values(ColumnStatisticsCache *cache)
+{
+	if (cache->sortedValues == NULL)
+	{
+		int *order = radix_argsort_doubles(cache->values, cache->count, 0);
+		cache->sortedValues = allocate_memory_double_ptr(cache->count > 0 ? cache->count : 1);
+		for (int i = 0; i < cache->count; i++)
+		{
+			cache->sortedValues[i] = cache->values[order[i]];
+			order[i] = cache->rows[order[i]]; // From positions among the present values to rows of the column
+		}
+		cache->sortPermutation = order;
+	}
+	
+	return cache->sortedValues;
+}
+
+
+
+
+/**
+ * cached_sort_permutation
+ *
+ * Returns the rows of a cached column's present values in the order of their values, sorting the column the first time(see
+ * 'cached_sorted_values'). Rows with equal values keep their order, so other columns of the data set can be reordered by this one.
+ *
+ * @param cache The cache of the column.
+ * @return The 'count' row indices in sorted order, owned by the cache.
+ */
+const int *cached_sort_permutation(ColumnStatisticsCache *cache)
+{
+	cached_sorted_values(cache);
+	return cache->sortPermutation;
+}
+
+
+
+
+/**
+ * cached_moments
+ *
+ * Returns the moments, and so the mean, standard deviation, skewness, kurtosis, minimum, and maximum, of a cached column's present
+ * values, accumulating them the first time.
+ *
+ * @param cache The cache of the column.
+ * @return The accumulator of the present values, owned by the cache.
+ */
+const MomentsAccumulator *cached_moments(ColumnStatisticsCache *cache)
+{
+	if (!cache->hasMoments)
+	{
+		cache->moments = create_moments_accumulator();
+		accumulate_moments(&cache->moments, cache->values, cache->count);
+		cache->hasMoments = true;
+	}
+	
+	return &cache->moments;
+}
+
+
+
+
+/**
+ * cached_extremes
+ *
+ * Finds the minimum and maximum of a cached column's present values from whichever derived item already holds them: the ends of the
+ * sorted values, or else the moments, accumulating those the first time.
+ *
+ * @param cache The cache of the column.
+ * @param minValue Set to the smallest present value.
+ * @param maxValue Set to the largest present value.
+ */
+void cached_extremes(ColumnStatisticsCache *cache, double *minValue, double *maxValue)
+{
+	if (cache->sortedValues != NULL && cache->count > 0)
+	{
+		*minValue = cache->sortedValues[0];
+		*maxValue = cache->sortedValues[cache->count - 1];
+		return;
+	}
+	
+	const MomentsAccumulator *moments = cached_moments(cache);
+	*minValue = moments->min;
+	*maxValue = moments->max;
+}
+
+
+
+
+/**
+ * compute_IQR_of_cached_column
+ *
+ * Computes the Interquartile Range of a cached column's present values, as 'compute_IQR' does, reading the quartiles straight from
+ * the column's shared sorted values.
+ *
+ * @param cache The cache of the column, with at least 2 present values.
+ * @return The IQR.
+ */
+double compute_IQR_of_cached_column(ColumnStatisticsCache *cache)
+{
+	const double *sortedData = cached_sorted_values(cache);
+	int n = cache->count;
+	double q25, q75;
+	quartiles_of_order_statistics(sortedData, n, &q25, &q75);
+	
+	double iqr = q75 - q25;
+	if (iqr == 0.0)
+	{
+		perror("\n\nError: Interquartile range is zero. Choose a different binning method, in 'compute_IQR_of_cached_column'.");
+		return sortedData[3 * n / 4] - sortedData[n / 4];
+	}
+	
+	return iqr;
+}
+
+
+
+
+/**
+ * compute_bin_width_of_cached_column
+ *
+ * Calculates the Freedman-Diaconis bin width of a cached column's present values, as 'compute_bin_width' does, from the column's
+ * shared sorted values.
+ *
+ * @param cache The cache of the column.
+ * @return The bin width.
+ */
+double compute_bin_width_of_cached_column(ColumnStatisticsCache *cache)
+{
+	if (cache->count < 2)
+	{
+		perror("\n\nError: Insufficient data to calculate bin width in 'compute_bin_width_of_cached_column'.\n");
+		exit(1);
+	}
+	
+	double q25, q75;
+	quartiles_of_order_statistics(cached_sorted_values(cache), cache->count, &q25, &q75);
+	return compute_bin_width_from_quartiles(q25, q75, cache->count);
+}
+
+
+
+
+/**
+ * compute_data_set_binning_of_cached_column
+ *
+ * Bins a cached column's present values, as 'compute_data_set_binning' does, taking the IQR and range from the column's shared
+ * sorted values.
+ *
+ * @param cache The cache of the column.
+ * @return The histogram of the present values.
+ */
+Histogram compute_data_set_binning_of_cached_column(ColumnStatisticsCache *cache)
+{
+	if (cache->count < 2)
+	{
+		perror("\n\nError: Insufficient data to calculate bin width in 'compute_data_set_binning_of_cached_column'.\n");
+	}
+	
+	double iqr = compute_IQR_of_cached_column(cache);
+	double min_value, max_value;
+	cached_extremes(cache, &min_value, &max_value);
+	return compute_data_set_binning_with_summary(cache->values, cache->count, iqr, min_value, max_value);
+}
+
+
+
+
+/**
+ * anderson_darling_normality_test_of_cached_column
+ *
+ * Performs the Anderson-Darling test for normality on a cached column's present values, as 'anderson_darling_normality_test' does,
+ * with the column's shared sorted values and moments.
+ *
+ * @param cache The cache of the column.
+ * @return The A-squared statistic.
+ */
+double anderson_darling_normality_test_of_cached_column(ColumnStatisticsCache *cache)
+{
+	const MomentsAccumulator *moments = cached_moments(cache);
+	return anderson_darling_normality_test_of_sorted_values(cached_sorted_values(cache), cache->count, moments->mean, moments_standard_deviation(moments));
+}
+
+
+
+
+
+/**
+ * create_quantile_sketch
+ *
+ * Creates an empty KLL quantile sketch, which summarizes any number of values in bounded memory, in a single pass, so that their
+ * quantiles can be estimated without holding or sorting them. The sketch keeps its values in a stack of levels: level h holds values
+ * each standing for 2^h of the values added. Values are added to level 0, and whenever the sketch holds more values than its
+ * capacity, the lowest level that is full is compacted: it is sorted and every other value, starting from a randomly chosen one of
+ * the first two, is promoted to the level above with twice the weight, while the rest are discarded. The capacity of a level
+ * shrinks by 2/3 for each level below the top, down to QUANTILE_SKETCH_MIN_LEVEL_CAPACITY, so the sketch holds about 3 * k values
+ * however many are added, and estimates every quantile to within the rank error of 'quantile_sketch_rank_error'.
+ *
+ * The generator choosing which half of a level is promoted is seeded from 'seed', scrambled with the SplitMix64 finalizer. Sketches
+ * that are merged must be seeded differently(e.g., with the index of their field and chunk), otherwise they promote the same halves
+ * of their levels and their errors add up instead of averaging out.
+ *
+ * @param k The accuracy parameter, the capacity of the top level, or 0 for QUANTILE_SKETCH_DEFAULT_K.
+ * @param seed The seed of the sketch's generator.
+ * @return The sketch, to be freed with 'free_quantile_sketch'.
+ */
+QuantileSketch *create_quantile_sketch(int k, uint64_t seed)
+{
+	QuantileSketch *sketch = (QuantileSketch *)calloc(1, sizeof(QuantileSketch));
+	if (sketch == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'create_quantile_sketch'.\n");
+		exit(1);
+	}
+	sketch->k = (k > 0) ? k : QUANTILE_SKETCH_DEFAULT_K;
+	sketch->min = INFINITY;
+	sketch->max = -INFINITY;
+	uint64_t state = seed + 0x9E3779B97F4A7C15ull;
+	state = (state ^ (state >> 30)) * 0xBF58476D1CE4E5B9ull;
+	state = (state ^ (state >> 27)) * 0x94D049BB133111EBull;
+	state ^= state >> 31;
+	sketch->randomState = (state != 0) ? state : 0x9E3779B97F4A7C15ull; // The xorshift generator never leaves a zero state
+	add_quantile_sketch_level(sketch);
+	
+	return sketch;
+}
+
+
+
+
+/**
+ * free_quantile_sketch
+ *
+ * Releases a quantile sketch and every level of it.
+ *
+ * @param sketch The sketch, or NULL.
+ */
+void free_quantile_sketch(QuantileSketch *sketch)
+{
+	if (sketch == NULL)
+	{
+		return;
+	}
+	
+	for (int h = 0; h < sketch->levelCount; h++)
+	{
+		free(sketch->levels[h]);
+	}
+	free(sketch->levels);
+	free(sketch->levelSizes);
+	free(sketch->levelAllocations);
+	free(sketch);
+}
+
+
+
+
+/**
+ * quantile_sketch_level_capacity
+ *
+ * The number of values a level of a quantile sketch holds before it is compacted: k for the top level, 2/3 of that for each level
+ * further below it, and never fewer than QUANTILE_SKETCH_MIN_LEVEL_CAPACITY.
+ *
+ * @param sketch The sketch.
+ * @param level The level.
+ * @return The capacity of the level.
+ */
+int quantile_sketch_level_capacity(const QuantileSketch *sketch, int level)
+{
+	double capacity = ceil(sketch->k * pow(2.0 / 3.0, sketch->levelCount - 1 - level));
+	return (capacity > QUANTILE_SKETCH_MIN_LEVEL_CAPACITY) ? (int)capacity : QUANTILE_SKETCH_MIN_LEVEL_CAPACITY;
+}
+
+
+
+
+/**
+ * add_quantile_sketch_level
+ *
+ * Adds an empty level to the top of a quantile sketch, which lowers the capacity of every level below it, and updates the total
+ * capacity of the sketch.
+ *
+ * @param sketch The sketch.
+ */
+void add_quantile_sketch_level(QuantileSketch *sketch)
+{
+	int levelCount = sketch->levelCount + 1;
+	sketch->levels = (double **)realloc(sketch->levels, levelCount * sizeof(double *));
+	sketch->levelSizes = (int *)realloc(sketch->levelSizes, levelCount * sizeof(int));
+	sketch->levelAllocations = (int *)realloc(sketch->levelAllocations, levelCount * sizeof(int));
+	if (sketch->levels == NULL || sketch->levelSizes == NULL || sketch->levelAllocations == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'add_quantile_sketch_level'.\n");
+		exit(1);
+	}
+	sketch->levels[levelCount - 1] = NULL;
+	sketch->levelSizes[levelCount - 1] = 0;
+	sketch->levelAllocations[levelCount - 1] = 0;
+	sketch->levelCount = levelCount;
+	
+	
+	sketch->retainedCapacity = 0;
+	for (int h = 0; h < levelCount; h++)
+	{
+		sketch->retainedCapacity += quantile_sketch_level_capacity(sketch, h);
+	}
+}
+
+
+
+
+/**
+ * append_to_quantile_sketch_level
+ *
+ * Appends a value to a level of a quantile sketch, growing the level's buffer as needed and adding the level if it is the one above
+ * the top.
+ *
+ * @param sketch The sketch.
+ * @param level The level, at most one above the top.
+ * @param value The value.
+ */
+void append_to_quantile_sketch_level(QuantileSketch *sketch, int level, double value)
+{
+	if (level == sketch->levelCount)
+	{
+		add_quantile_sketch_level(sketch);
+	}
+	if (sketch->levelSizes[level] == sketch->levelAllocations[level])
+	{
+		int allocation = (sketch->levelAllocations[level] > 0) ? 2 * sketch->levelAllocations[level] : quantile_sketch_level_capacity(sketch, level) + 1;
+		sketch->levels[level] = (double *)realloc(sketch->levels[level], allocation * sizeof(double));
+		if (sketch->levels[level] == NULL)
+		{
+			perror("\n\nError: Unable to allocate memory in 'append_to_quantile_sketch_level'.\n");
+			exit(1);
+		}
+		sketch->levelAllocations[level] = allocation;
+	}
+	
+	sketch->levels[level][sketch->levelSizes[level]++] = value;
+	sketch->retainedCount++;
+}
+
+
+
+
+/**
+ * compact_quantile_sketch_level
+ *
+ * Halves a level of a quantile sketch: sorts it, promotes every other value to the level above, starting from the first or second
+ * value with equal probability so that the estimated ranks are unbiased, and discards the others. An odd value out stays behind.
+ *
+ * @param sketch The sketch.
+ * @param level The level to compact.
+ */
+void compact_quantile_sketch_level(QuantileSketch *sketch, int level)
+{
+	int size = sketch->levelSizes[level];
+	merge_sort(sketch->levels[level], size);
+	
+	// xorshift64, only one bit of it is needed per compaction
+	sketch->randomState ^= sketch->randomState << 13;
+	sketch->randomState ^= sketch->randomState >> 7;
+	sketch->randomState ^= sketch->randomState << 17;
+	int offset = (int)(sketch->randomState & 1);
+	
+	
+	int pairedSize = size & ~1;
+	for (int i = offset; i < pairedSize; i += 2)
+	{
+		append_to_quantile_sketch_level(sketch, level + 1, sketch->levels[level][i]);
+	}
+	double *items = sketch->levels[level];
+	if (size % 2 == 1)
+	{
+		items[0] = items[size - 1];
+	}
+	sketch->levelSizes[level] = size % 2;
+	sketch->retainedCount -= pairedSize;
+}
+
+
+
+
+/**
+ * compress_quantile_sketch
+ *
+ * Compacts the lowest full levels of a quantile sketch, one at a time, until it holds no more values than its capacity.
+ *
+ * @param sketch The sketch.
+ */
+void compress_quantile_sketch(QuantileSketch *sketch)
+{
+	while (sketch->retainedCount >= sketch->retainedCapacity)
+	{
+		for (int h = 0; h < sketch->levelCount; h++)
+		{
+			if (sketch->levelSizes[h] >= quantile_sketch_level_capacity(sketch, h))
+			{
+				compact_quantile_sketch_level(sketch, h);
+				break;
+			}
+		}
+	}
+}
+
+
+
+
+/**
+ * add_values_to_quantile_sketch
+ *
+ * Adds an array of values to a quantile sketch, NaN values mark missing entries and are skipped. The sketch's minimum and maximum
+ * are kept exactly.
+ *
+ * @param sketch The sketch.
+ * @param data The values.
+ * @param n The number of values.
+ */
+void add_values_to_quantile_sketch(QuantileSketch *sketch, const double *data, int n)
+{
+	for (int i = 0; i < n; i++)
+	{
+		double value = data[i];
+		if (isnan(value))
+		{
+			continue;
+		}
+		sketch->count++;
+		sketch->min = (value < sketch->min) ? value : sketch->min;
+		sketch->max = (value > sketch->max) ? value : sketch->max;
+		
+		append_to_quantile_sketch_level(sketch, 0, value);
+		if (sketch->retainedCount >= sketch->retainedCapacity)
+		{
+			compress_quantile_sketch(sketch);
+		}
+	}
+}
+
+
+
+
+/**
+ * merge_quantile_sketches
+ *
+ * Merges the sketch of one set of values into the sketch of another, producing a sketch of both with the same error bound, so that
+ * the sketches of chunks or threads can be combined in any grouping. Each level of the other sketch is appended to the same level of
+ * the sketch, whose values carry the same weight, and the result is compressed back within its capacity.
+ *
+ * @param sketch The sketch to merge into.
+ * @param otherSketch The sketch of the other values, it is not modified.
+ */
+void merge_quantile_sketches(QuantileSketch *sketch, const QuantileSketch *otherSketch)
+{
+	for (int h = 0; h < otherSketch->levelCount; h++)
+	{
+		while (sketch->levelCount <= h)
+		{
+			add_quantile_sketch_level(sketch);
+		}
+		for (int i = 0; i < otherSketch->levelSizes[h]; i++)
+		{
+			append_to_quantile_sketch_level(sketch, h, otherSketch->levels[h][i]);
+		}
+	}
+	sketch->count += otherSketch->count;
+	sketch->min = (otherSketch->min < sketch->min) ? otherSketch->min : sketch->min;
+	sketch->max = (otherSketch->max > sketch->max) ? otherSketch->max : sketch->max;
+	
+	compress_quantile_sketch(sketch);
+}
+
+
+
+
+/**
+ * quantile_sketch_quantiles
+ *
+ * Estimates any number of quantiles of the values summarized by a quantile sketch. The retained values are sorted once, each weighted
+ * by 2^level, and the quantile at probability p is the first value whose cumulative weight reaches p times the number of values
+ * added. The quantiles at probabilities 0 and 1 are the exact minimum and maximum.
+ *
+ * @param sketch The sketch.
+ * @param probabilities The probabilities of the quantiles, each in [0, 1].
+ * @param quantileCount The number of quantiles.
+ * @param quantiles Set to the estimated quantiles, in the order of the probabilities, NAN if the sketch is empty.
+ */
+void quantile_sketch_quantiles(const QuantileSketch *sketch, const double *probabilities, int quantileCount, double *quantiles)
+{
+	if (sketch->count == 0)
+	{
+		for (int i = 0; i < quantileCount; i++)
+		{
+			quantiles[i] = NAN;
+		}
+		return;
+	}
+	
+	
+	/// Gather the retained values with their weights and sort them by value
+	int retainedCount = (int)sketch->retainedCount;
+	double *values = allocate_memory_double_ptr(retainedCount);
+	int64_t *weights = (int64_t *)malloc(retainedCount * sizeof(int64_t));
+	if (weights == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'quantile_sketch_quantiles'.\n");
+		exit(1);
+	}
+	int retained = 0;
+	for (int h = 0; h < sketch->levelCount; h++)
+	{
+		for (int i = 0; i < sketch->levelSizes[h]; i++)
+		{
+			values[retained] = sketch->levels[h][i];
+			weights[retained] = (int64_t)1 << h;
+			retained++;
+		}
+	}
+	int *order = radix_argsort_doubles(values, retainedCount, 1);
+	
+	int64_t *cumulativeWeights = (int64_t *)malloc(retainedCount * sizeof(int64_t));
+	if (cumulativeWeights == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'quantile_sketch_quantiles'.\n");
+		exit(1);
+	}
+	int64_t cumulativeWeight = 0;
+	for (int i = 0; i < retainedCount; i++)
+	{
+		cumulativeWeight += weights[order[i]];
+		cumulativeWeights[i] = cumulativeWeight;
+	}
+	
+	
+	/// Find each quantile by binary search over the cumulative weights
+	for (int q = 0; q < quantileCount; q++)
+	{
+		double p = probabilities[q];
+		if (p <= 0.0)
+		{
+			quantiles[q] = sketch->min;
+			continue;
+		}
+		if (p >= 1.0)
+		{
+			quantiles[q] = sketch->max;
+			continue;
+		}
+		
+		double targetWeight = p * (double)cumulativeWeight;
+		int low = 0, high = retainedCount - 1;
+		while (low < high)
+		{
+			int middle = low + (high - low) / 2;
+			if ((double)cumulativeWeights[middle] < targetWeight)
+			{
+				low = middle + 1;
+			}
+			else
+			{
+				high = middle;
+			}
+		}
+		quantiles[q] = values[order[low]];
+	}
+	
+	free(values);
+	free(weights);
+	free(order);
+	free(cumulativeWeights);
+}
+
+
+
+
+/**
+ * quantile_sketch_quantile
+ *
+ * Estimates a single quantile of the values summarized by a quantile sketch, see 'quantile_sketch_quantiles'.
+ *
+ * @param sketch The sketch.
+ * @param probability The probability of the quantile, in [0, 1].
+ * @return The estimated quantile, NAN if the sketch is empty.
+ */
+double quantile_sketch_quantile(const QuantileSketch *sketch, double probability)
+{
+	double quantile;
+	quantile_sketch_quantiles(sketch, &probability, 1, &quantile);
+	return quantile;
+}
+
+
+
+
+/**
+ * quantile_sketch_rank_error
+ *
+ * The rank error of the quantiles estimated by a quantile sketch: with 99% confidence, the true rank of an estimated quantile is
+ * within this fraction of the number of values of the requested rank. This is the empirical bound of the KLL sketch, 2.296 / k^0.9723,
+ * about 1.33% for the default k of 200, it does not depend on how many values were added.
+ *
+ * @param sketch The sketch.
+ * @return The normalized rank error.
+ */
+double quantile_sketch_rank_error(const QuantileSketch *sketch)
+{
+	return 2.296 / pow((double)sketch->k, 0.9723);
+}
+
+
+
+
+/**
+ * resolve_quantile_mode
+ *
+ * Decides how the quantiles of a number of values are to be found. QUANTILE_MODE_AUTOMATIC finds them exactly when a scratch copy
+ * of the values fits EXACT_QUANTILE_MEMORY_BUDGET, and with a quantile sketch otherwise. The other modes are returned as they are.
+ *
+ * @param mode The requested mode.
+ * @param n The number of values.
+ * @return QUANTILE_MODE_EXACT or QUANTILE_MODE_SKETCH.
+ */
+QuantileMode resolve_quantile_mode(QuantileMode mode, int n)
+{
+	if (mode != QUANTILE_MODE_AUTOMATIC)
+	{
+		return mode;
+	}
+	return ((size_t)n * sizeof(double) <= EXACT_QUANTILE_MEMORY_BUDGET) ? QUANTILE_MODE_EXACT : QUANTILE_MODE_SKETCH;
+}
+
+
+
+
+/**
+ * compute_IQR_of_sketch
+ *
+ * Estimates the Interquartile Range of the values summarized by a quantile sketch, as the difference between its estimated 75th
+ * and 25th percentiles.
+ *
+ * @param sketch The sketch.
+ * @return The estimated IQR.
+ */
+double compute_IQR_of_sketch(const QuantileSketch *sketch)
+{
+	double probabilities[2] = { 0.25, 0.75 };
+	double quartiles[2];
+	quantile_sketch_quantiles(sketch, probabilities, 2, quartiles);
+	return quartiles[1] - quartiles[0];
+}
+
+
+
+
+/**
+ * compute_bin_width_of_sketch
+ *
+ * Calculates the Freedman-Diaconis bin width, as 'compute_bin_width' does, from the quartiles estimated by a quantile sketch, so
+ * a column can be binned without ever being held in memory.
+ *
+ * @param sketch The sketch.
+ * @return The bin width.
+ */
+double compute_bin_width_of_sketch(const QuantileSketch *sketch)
+{
+	if (sketch->count < 2)
+	{
+		perror("\n\nError: Insufficient data to calculate bin width in 'compute_bin_width_of_sketch'.\n");
+		exit(1);
+	}
+	
+	double probabilities[2] = { 0.25, 0.75 };
+	double quartiles[2];
+	quantile_sketch_quantiles(sketch, probabilities, 2, quartiles);
+	return compute_bin_width_from_quartiles(quartiles[0], quartiles[1], (int)sketch->count);
+}
+
+
+
+
+/**
+ * compute_IQR_in_mode
+ *
+ * Computes the Interquartile Range of a dataset exactly with 'compute_IQR', or estimates it with a quantile sketch built in one pass
+ * over the data, depending on the mode(see 'resolve_quantile_mode').
+ *
+ * @param data The data.
+ * @param n The number of data points.
+ * @param mode How the quartiles are found.
+ * @return The IQR.
+ */
+double compute_IQR_in_mode(double *data, int n, QuantileMode mode)
+{
+	if (resolve_quantile_mode(mode, n) == QUANTILE_MODE_EXACT)
+	{
+		return compute_IQR(data, n);
+	}
+	
+	QuantileSketch *sketch = create_quantile_sketch(0, 0);
+	add_values_to_quantile_sketch(sketch, data, n);
+	double iqr = compute_IQR_of_sketch(sketch);
+	free_quantile_sketch(sketch);
+	return iqr;
+}
+
+
+
+
+/**
+ * compute_bin_width_in_mode
+ *
+ * Calculates the Freedman-Diaconis bin width of a dataset exactly with 'compute_bin_width', or from quartiles estimated with a
+ * quantile sketch built in one pass over the data, depending on the mode(see 'resolve_quantile_mode').
+ *
+ * @param data The data.
+ * @param n The number of data points.
+ * @param mode How the quartiles are found.
+ * @return The bin width.
+ */
+double compute_bin_width_in_mode(double *data, int n, QuantileMode mode)
+{
+	if (resolve_quantile_mode(mode, n) == QUANTILE_MODE_EXACT)
+	{
+		return compute_bin_width(data, n);
+	}
+	
+	QuantileSketch *sketch = create_quantile_sketch(0, 0);
+	add_values_to_quantile_sketch(sketch, data, n);
+	double binWidth = compute_bin_width_of_sketch(sketch);
+	free_quantile_sketch(sketch);
+	return binWidth;
+}
+
+
+
+
+/**
+ * compute_data_set_binning_in_mode
+ *
+ * Bins a dataset as 'compute_data_set_binning' does, finding the IQR of the Freedman-Diaconis rule exactly, or estimating it with a
+ * quantile sketch built in one pass over the data(which also holds the exact minimum and maximum), depending on the mode(see
+ * 'resolve_quantile_mode'). Either way the bins are then counted exactly in a second pass.
+ *
+ * @param data The data.
+ * @param n The number of data points.
+ * @param mode How the quartiles are found.
+ * @return The histogram of the data.
+ */
+Histogram compute_data_set_binning_in_mode(double *data, int n, QuantileMode mode)
+{
+	if (resolve_quantile_mode(mode, n) == QUANTILE_MODE_EXACT)
+	{
+		return compute_data_set_binning(data, n);
+	}
+	
+	QuantileSketch *sketch = create_quantile_sketch(0, 0);
+	add_values_to_quantile_sketch(sketch, data, n);
+	Histogram histogram = compute_data_set_binning_with_summary(data, n, compute_IQR_of_sketch(sketch), sketch->min, sketch->max);
+	free_quantile_sketch(sketch);
+	return histogram;
+}
+
+
+
+
+/**
+ * compute_normal_cdf
+ *
+ * This function calculates the cumulative distribution function (CDF)
+ * for a normal distribution at a given value 'x', with given mean 'mu'
+ * and standard deviation 'sigma'.
+ */
+double compute_normal_cdf(double x, double mu, double sigma)
+{
+	return 0.5 * (1.0 + erf((x - mu) / (sigma * sqrt(2.0))));
+}
+
+
+
+
+
+
+
+
+
+
+
+
+/**
+ * compute_gaussian
+ *
+ * Computes the Gaussian function values for given x-values.
+ * Gaussian function is given by: f(x) = (2/sqrt(pi)) * exp(-x^2).
+ * This function returns an array of Gaussian values for a given array of x-values.
+ */
+double* compute_gaussian(int n, double x[])
+{
+	double *f = allocate_memory_double_ptr(n);
+	
+	for (int i = 0; i < n; i++)
+	{
+		f[i] = (2.0/sqrt(M_PI)) * exp(-(x[i] * x[i]));
+	}
+	return f;
+}
+
+
+
+
+/**
+ * gaussian_riemann_sum_integration
+ *
+ * Integrates the function f(x) using Riemann approximation.
+ * This function takes in arrays of x-values and their corresponding function values f(x) and
+ * computes samples of the function F(x), the integral, using a Riemann sum approximation.
+ */
+double* gaussian_riemann_sum_integration(int n, double x[], double f[])
+{
+	double *F = allocate_memory_double_ptr(n);
+	
+	F[0] = 0; // Starting value
+	for (int i = 1; i < n; i++)
+	{
+		double dx = x[i] - x[i-1];
+		F[i] = F[i-1] + f[i] * dx; // Rectangle approximation for area
+	}
+	return F;
+}
+
+
+
+
+
+
+
+
+
+
+
+
+/**
+ * anderson_darling_normality_test
+ *
+ * Performs the Anderson-Darling test for normality.
+ *
+ * The test statistic A-squared is a measure of how well the data follow
+ * a particular distribution. For the normal distribution, if the A-squared
+ * statistic is large, it indicates that the data does not follow a normal distribution.
+ *tfr1e
+ * The test rejects the hypothesis of normality when the p-value is less than or equal to 0.05.
+ * Failing the normality test allows you to state with 95% confidence the data does not fit the normal distribution.
+ * Passing the normality test only allows you to state no significant departure from normality was found.
+ *
+ * The Anderson-Darling test, while having excellent theoretical properties, has a serious flaw when applied to real world data.
+ * The Anderson-Darling test is severely affected by ties in the data due to poor precision.
+ * When a significant number of ties exist, the Anderson-Darling will frequently reject the data as non-normal,
+ * regardless of how well the data fits the normal distribution. A tie is when identical values occur more than once.
+ */
+double anderson_darling_normality_test(double *data, int n)
+{
+	// The test requires sorted data
+	double *sortedData = allocate_memory_double_ptr(n);
+	
+	for (int i = 0; i < n; i++)
+	{
+		sortedData[i] = data[i];
+	}
+	merge_sort(sortedData, n);
+	
+	
+	MomentsAccumulator moments = create_moments_accumulator(); // The mean and standard deviation in a single pass
+	accumulate_moments(&moments, data, n);
+	double A_squared = anderson_darling_normality_test_of_sorted_values(sortedData, n, moments.mean, moments_standard_deviation(&moments));
+	
+	free(sortedData);
+	return A_squared;
+}
+
+
+
+
+/**
+ * anderson_darling_normality_test_of_sorted_values
+ *
+ * Computes the Anderson-Darling statistic A-squared, as 'anderson_darling_normality_test' does, of data that is already sorted and
+ * whose mean and standard deviation are already known.
+ *
+ * @param sortedData The data, sorted in ascending order.
+ * @param n The number of data points.
+ * @param mean The mean of the data.
+ * @param std_dev The standard deviation of the data.
+ * @return The A-squared statistic.
+ */
+double anderson_darling_normality_test_of_sorted_values(const double *sortedData, int n, double mean, double std_dev)
+{
+	double A_squared = 0.0;
+	for (int i = 0; i < n; i++)
+	{
+		double Fi = compute_normal_cdf(sortedData[i], mean, std_dev);
+		A_squared += (2 * (i + 1) - 1) * (log(Fi) + log(1 - Fi));
+	}
+	A_squared = -n - A_squared * (1.0 / n);
+	
+	return A_squared;
+}
+
+
+
+
+
+
+
+
+
+
+
+
+/**
+ * quartiles_of_order_statistics
+ *
+ * Reads the 25th (Q1) and 75th (Q3) percentiles of a dataset from an array holding its values of the quartile ranks in their sorted
+ * positions, either because the whole array is sorted or because those ranks were selected by 'compute_quartiles_by_selection'. If
+ * the number of data points is even, each quartile is the average of the middle two points of its half, otherwise it is the middle point.
+ *
+ * @param orderedData The data, with at least the quartile ranks in their sorted positions.
+ * @param n The number of data points, at least 2.
+ * @param q25 Set to the 25th percentile.
+ * @param q75 Set to the 75th percentile.
+ */
+void quartiles_of_order_statistics(const double *orderedData, int n, double *q25, double *q75)
+{
+	int mid = (n % 2 == 0) ? n / 2 : (n - 1) / 2;
+	int lowerOffset = (mid / 2 > 0) ? 1 : 0; // With 2 data points the lower half is a single point, which is then both of its middle points
+	if (n % 2 == 0)
+	{
+		*q25 = (orderedData[mid / 2 - lowerOffset] + orderedData[mid / 2]) / 2.0;
+		*q75 = (orderedData[mid + mid / 2 - 1] + orderedData[mid + mid / 2]) / 2.0;
+	}
+	else
+	{
+		*q25 = orderedData[mid / 2];
+		*q75 = orderedData[mid + mid / 2];
+	}
+}
+
+
+
+
+/**
+ * compute_quartiles_by_selection
+ *
+ * Finds the 25th (Q1) and 75th (Q3) percentiles of a dataset with 'select_order_statistics' rather than by sorting it, then reads
+ * them with 'quartiles_of_order_statistics'. The minimum and maximum can be found in the same selection by passing pointers for them.
+ *
+ * @param scratch The data, reordered in place.
+ * @param n The number of data points, at least 2.
+ * @param q25 Set to the 25th percentile.
+ * @param q75 Set to the 75th percentile.
+ * @param minValue Set to the minimum if not NULL.
+ * @param maxValue Set to the maximum if not NULL.
+ */
+void compute_quartiles_by_selection(double *scratch, int n, double *q25, double *q75, double *minValue, double *maxValue)
+{
+	int ranks[6];
+	int rankCount = 0;
+	int mid = (n % 2 == 0) ? n / 2 : (n - 1) / 2;
+	int lowerOffset = (mid / 2 > 0) ? 1 : 0; // With 2 data points the lower half is a single point, which is then both of its middle points
+	if (n % 2 == 0)
+	{
+		ranks[rankCount++] = mid / 2 - lowerOffset;
+		ranks[rankCount++] = mid + mid / 2 - 1;
+	}
+	ranks[rankCount++] = mid / 2;
+	ranks[rankCount++] = mid + mid / 2;
+	if (minValue != NULL)
+	{
+		ranks[rankCount++] = 0;
+	}
+	if (maxValue != NULL)
+	{
+		ranks[rankCount++] = n - 1;
+	}
+	select_order_statistics(scratch, n, ranks, rankCount);
+	quartiles_of_order_statistics(scratch, n, q25, q75);
+	if (minValue != NULL)
+	{
+		*minValue = scratch[0];
+	}
+	if (maxValue != NULL)
+	{
+		*maxValue = scratch[n - 1];
+	}
+}
+
+
+
+
+/**
+ * compute_IQR_by_selection
+ *
+ * Computes the Interquartile Range (IQR) of a dataset as 'compute_IQR' does, in a scratch copy of the data that it reorders
+ * rather than sorts, optionally finding the minimum and maximum in the same selection.
+ *
+ * @param scratch The data, reordered in place.
+ * @param n The number of data points, at least 2.
+ * @param minValue Set to the minimum if not NULL.
+ * @param maxValue Set to the maximum if not NULL.
+ * @return The IQR.
+ */
+double compute_IQR_by_selection(double *scratch, int n, double *minValue, double *maxValue)
+{
+	double q25, q75;
+	compute_quartiles_by_selection(scratch, n, &q25, &q75, minValue, maxValue);
+	
+	// Compute the IQR as the difference between the 75th and 25th quartiles
+	double iqr = q75 - q25;
+	
+	// Handle special case where IQR is zero, which can skew the bin width calculation
+	if (iqr == 0.0)
+	{
+		perror("\n\nError: Interquartile range is zero. Choose a different binning method, in 'compute_IQR_by_selection'.");
+		
+		int ranks[2] = { n / 4, 3 * n / 4 };
+		select_order_statistics(scratch, n, ranks, 2);
+		return scratch[3 * n / 4] - scratch[n / 4];
+	}
+	
+	// Return the computed IQR
+	return iqr;
+}
+
+
+
+
+/**
+ * compute_IQR
+ *
+ * Computes the Interquartile Range (IQR) of a dataset.
+ * The IQR is a measure of statistical dispersion and is calculated as the difference
+ * between the 75th (Q3) and 25th (Q1) percentiles of the dataset. The function selects
+ * the quartiles from a copy of the data(see 'compute_quartiles_by_selection') in expected
+ * linear time rather than sorting it. Handles both even and
+ * odd-sized datasets. If the computed IQR is zero (indicating all values are the same),
+ * the function issues a warning and recalculates the IQR based on the 25th and 75th indices.
+ * Assumes that the dataset is large enough to provide meaningful percentile values.
+ */
+double compute_IQR(double* data, int n)
+{
+	// Copy the data to preserve the original data order
+	double *scratch = allocate_memory_double_ptr(n);
+	memcpy(scratch, data, n * sizeof(double));
+	
+	double iqr = compute_IQR_by_selection(scratch, n, NULL, NULL);
+	
+	free(scratch);
+	return iqr;
+}
+
+
+
+
+/**
+ * compute_quantiles
+ *
+ * Computes any number of quantiles of a dataset at once, with linear interpolation between the two closest order statistics:
+ * the quantile at probability p lies at position h = (n - 1) * p of the sorted data, so it is x[floor(h)] + (h - floor(h)) * (x[floor(h) + 1] - x[floor(h)]).
+ * All of the needed order statistics are found by a single call of 'select_order_statistics' on one scratch copy of the data, in
+ * expected linear time.
+ *
+ * @param data The data, it is not modified.
+ * @param n The number of data points.
+ * @param probabilities The probabilities of the quantiles, each in [0, 1].
+ * @param quantileCount The number of quantiles.
+ * @param quantiles Set to the quantiles, in the order of the probabilities.
+ */
+void compute_quantiles(const double *data, int n, const double *probabilities, int quantileCount, double *quantiles)
+{
+	if (n < 1)
+	{
+		perror("\n\nError: Insufficient data to calculate quantiles in 'compute_quantiles'.\n");
+		exit(1);
+	}
+	
+	
+	int ranks[2 * quantileCount];
+	for (int i = 0; i < quantileCount; i++)
+	{
+		if (!(probabilities[i] >= 0.0 && probabilities[i] <= 1.0))
+		{
+			perror("\n\nError: Quantile probability was outside of [0, 1] in 'compute_quantiles'.\n");
+			exit(1);
+		}
+		int lowerRank = (int)floor((n - 1) * probabilities[i]);
+		ranks[2 * i] = lowerRank;
+		ranks[2 * i + 1] = (lowerRank + 1 < n) ? lowerRank + 1 : lowerRank;
+	}
+	
+	double *scratch = allocate_memory_double_ptr(n);
+	memcpy(scratch, data, n * sizeof(double));
+	select_order_statistics(scratch, n, ranks, 2 * quantileCount);
+	
+	
+	for (int i = 0; i < quantileCount; i++)
+	{
+		double position = (n - 1) * probabilities[i];
+		int lowerRank = (int)floor(position);
+		int upperRank = (lowerRank + 1 < n) ? lowerRank + 1 : lowerRank;
+		quantiles[i] = scratch[lowerRank] + (position - lowerRank) * (scratch[upperRank] - scratch[lowerRank]);
+	}
+	
+	free(scratch);
+}
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+
+/**
+ * compute_bin_width
+ *
+ * Calculates optimal bin width for histogram using the Freedman-Diaconis rule.
+ * The Freedman-Diaconis rule provides a robust bin-width calculation based on the
+ * Interquartile Range (IQR) of the data set.
+ *
+ * Formula: binWidth = 2 * (IQR) * n^(-1/3)
+ */
+double compute_bin_width(double* data, int n)
+{
+	// Check if the data set is large enough to calculate IQR
+	if (n < 2)
+	{
+		perror("\n\nError: Insufficient data to calculate bin width in 'compute_bin_width'.\n");
+		exit(1);
+	}
+	
+	
+	double q25, q75;
+	
+	
+	// Select the 25th and 75th percentiles from a copy of the data, preserving the original data order
+	double *scratch = allocate_memory_double_ptr(n);
+	memcpy(scratch, data, n * sizeof(double));
+	compute_quartiles_by_selection(scratch, n, &q25, &q75, NULL, NULL);
+	free(scratch);
+	
+	return compute_bin_width_from_quartiles(q25, q75, n);
+}
+
+
+
+
+/**
+ * compute_bin_width_from_quartiles
+ *
+ * Calculates the bin width of the Freedman-Diaconis rule, as 'compute_bin_width' does, from the quartiles of a dataset however they
+ * were found.
+ *
+ * @param q25 The 25th percentile of the data.
+ * @param q75 The 75th percentile of the data.
+ * @param n The number of data points.
+ * @return The bin width.
+ */
+double compute_bin_width_from_quartiles(double q25, double q75, int n)
+{
+	// Compute the Interquartile Range (IQR)
+	double iqr = q75 - q25;
+	
+	// Handle cases where IQR is zero (all numbers are the same)
+	if (iqr == 0.0)
+	{
+		perror("\n\nError: Interquartile range is zero. Choose a different binning method, in 'compute_bin_width'.");
+		exit(1);
+		//printf("\nq75: %lf", q75);
+		//printf("\nq25: %lf", q25);
+		//printf("\n iqr: %lf \n\n\n\n", iqr);
+		
+		//free(sortedData);
+		//return 0.0;
+	}
+	
+	// Calculate the optimal bin width using the Freedman-Diaconis rule
+	double binWidth = 2.0 * iqr / pow((double)(n), 1.0 / 3.0);
+	
+	
+	
+	
+	//data = allocate_memory_double_ptr_ptr(n);
+	//for (int i = 0; i < n; i++)
+	//{
+	//    (*data)[i] = sortedData[i];
+	//printf("\n\nsorted  data ???: %.17g", (*data)[i]);
+	//}
+	//memcpy(data, sortedData, n);
+	return binWidth;
+}
+
+
+
+
+/**
+ * calculateOptimalNumBins
+ *
+ * Calculates the optimal number of bins using a Bayesian approach.
+ * This function calculates Bayesian Information Criterion (BIC) based on the bin width
+ * to find the optimal number of bins for a histogram.
+ *
+ * BIC Formula: BIC = n * log(binWidth) + 0.5 * log(n) * numBins
+ * The formula is also adjusted for small sample sizes.
+ */
+int compute_optimal_num_bins(double* data, int n)
+{
+	double binWidth = compute_bin_width(data, n);
+	if (binWidth == 0.0)
+	{
+		return n;
+	}
+	
+	//merge_sort(data, n);
+	
+	//for (int i = 1; i < n; i++)
+	//{
+	//    printf("\n\nsorted  data ??? : %.17g", (*data)[i]);
+	//sortedData[i-1] = (*data)[i-1];
+	//}
+	
+	
+	// Calculate the range of the data
+	//double range = data[n - 1] - data[0]; // The data has already been sorted
+	
+	
+	// Estimate the number of bins based on the range and optimal bin width
+	//int numBins = ((int)(range / binWidth));
+	
+	// Estimate the number of bins based on the range and optimal bin width
+	//int numBins = (int)ceil(range / binWidth);
+	
+	// Calculate the range of the data
+	double min_value, max_value;
+	compute_extremes(data, n, &min_value, &max_value);
+	double range = max_value - min_value;
+	
+	// Estimate the number of bins based on the range and optimal bin width
+	int numBins = (int)ceil(range / binWidth);
+	
+	// Bayesian Information Criterion (BIC) to find the optimal number of bins
+	double bic = n * log(binWidth) + 0.5 * log(n) * numBins;
+	
+	
+	// Adjusting for small sample sizes
+	//bic += (numBins - 1) * log((double)(n)) / 2.0;
+	
+	
+	
+	return numBins;
+	//return (int)(bic);
+}
+
+
+
+
+/**
+ * compute_data_set_binning
+ *
+ * Computes the optimal binning for a histogram of a dataset.
+ * This function determines the number of bins and their width for constructing
+ * a histogram, using the Freedman-Diaconis rule which is based on the IQR and
+ * the size of the dataset. The function checks for sufficient data size and
+ * handles cases with small datasets. Utilizes the IQR and range of the data to
+ * calculate bin width and number. Populates the bins based on the calculated binning strategy.
+ *
+ * @note For very small datasets, the Freedman-Diaconis rule may not be optimal.
+ *       The method assumes a reasonably symmetric distribution of data.
+ *       Does not consider the Bayesian Information Criterion (BIC) for bin number optimization.
+ */
+Histogram compute_data_set_binning(double *data, int n)
+{
+	// Calculate the optimal number of bins
+	// Verify that the data set is large enough to calculate IQR
+	if (n < 2)
+	{
+		perror("\n\nError: Insufficient data to calculate bin width in 'compute_bin_width'.\n");
+	}
+	
+	
+	// Calculating the Interquartile Range (IQR), and the minimum and maximum values in the data set in the same selection
+	double min_value, max_value;
+	double *scratch = allocate_memory_double_ptr(n);
+	memcpy(scratch, data, n * sizeof(double));
+	double iqr = compute_IQR_by_selection(scratch, n, &min_value, &max_value);
+	free(scratch);
+	
+	return compute_data_set_binning_with_summary(data, n, iqr, min_value, max_value);
+}
+
+
+
+
+/**
+ * compute_data_set_binning_with_summary
+ *
+ * Bins a dataset as 'compute_data_set_binning' does, given its Interquartile Range(IQR), minimum, and maximum, however they were found,
+ * so that callers already holding them(e.g., from a sorted column cached by 'create_column_statistics_cache') need not find them again.
+ *
+ * @param data The data to bin.
+ * @param n The number of data points.
+ * @param iqr The IQR of the data.
+ * @param min_value The smallest data point.
+ * @param max_value The largest data point.
+ * @return The histogram of the data.
+ */
+Histogram compute_data_set_binning_with_summary(const double *data, int n, double iqr, double min_value, double max_value)
+{
+	// Bin the data into the number of bins given by the Freedman-Diaconis rule, with every available thread
+	Histogram data_histogram = create_histogram(min_value, max_value, freedman_diaconis_num_bins(iqr, n, min_value, max_value));
+	bin_data_columns(&data_histogram, &data, NULL, 1, n, 0);
+	
+	return data_histogram;
+}
+
+
+
+
+/**
+ * freedman_diaconis_num_bins
+ *
+ * Calculates the number of bins of a histogram of a dataset with the Freedman-Diaconis rule, which reduces the effect of outliers by
+ * basing the bin width on the Interquartile Range(IQR): 2 * IQR / n^(1/3). A bin width below 1 is replaced by n, and the number of
+ * bins is at least 1.
+ *
+ * @param iqr The IQR of the data.
+ * @param n The number of data points.
+ * @param min_value The smallest data point.
+ * @param max_value The largest data point.
+ * @return The number of bins.
+ */
+int freedman_diaconis_num_bins(double iqr, int n, double min_value, double max_value)
+{
+	// Calculate bin width using the Freedman-Diaconis rule, which reduces the effect of outliers
+	double binWidth = 2.0 * iqr / pow((double)(n), 1.0 / 3.0);
+	
+	// If binWidth is too small, adjust it to a reasonable minimum value
+	if(binWidth < 1)
+	{
+		binWidth = n;
+	}
+	
+	
+	// Estimate the number of bins based on the range and optimal bin width, ensuring it's a positive integer
+	double range = max_value - min_value;
+	int numBins = ((int)(range / binWidth));
+	return numBins > 0 ? numBins : 1;
+}
+
+
+
+
+/**
+ * find_extremes_scalar
+ *
+ * Finds the minimum and maximum of an array of values in a single pass, one value at a time, available on every platform. NaN
+ * values mark missing entries and are skipped.
+ *
+ * @param data The values.
+ * @param n The number of values.
+ * @param minValue Set to the minimum, INFINITY if there are no values.
+ * @param maxValue Set to the maximum, -INFINITY if there are no values.
+ */
+void find_extremes_scalar(const double *data, int n, double *minValue, double *maxValue)
+{
+	double minimum = INFINITY;
+	double maximum = -INFINITY;
+	for (int i = 0; i < n; i++)
+	{
+		// A comparison with NaN is false, so NaN values leave both extremes as they are
+		minimum = (data[i] < minimum) ? data[i] : minimum;
+		maximum = (data[i] > maximum) ? data[i] : maximum;
+	}
+	
+	*minValue = minimum;
+	*maxValue = maximum;
+}
+
+
+
+
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ * find_extremes_avx2
+ *
+ * Finds the minimum and maximum of an array of values exactly as 'find_extremes_scalar' does, in one fused pass of 16 values at a
+ * time with AVX2 in four independent sets of 4 lanes, so the minimum and maximum chains do not wait on each other. Each new vector is
+ * the first operand of the minimum and maximum, whose result is then the second operand whenever the first is NaN. Only call once
+ * 'select_extremes_kernel' has confirmed that the processor supports AVX2.
+ *
+ * @param data The values.
+ * @param n The number of values.
+ * @param minValue Set to the minimum, INFINITY if there are no values.
+ * @param maxValue Set to the maximum, -INFINITY if there are no values.
+ */
+__attribute__((target("avx2")))
+void find_extremes_avx2(const double *data, int n, double *minValue, double *maxValue)
+{
+	__m256d mins[4] = { _mm256_set1_pd(INFINITY), _mm256_set1_pd(INFINITY), _mm256_set1_pd(INFINITY), _mm256_set1_pd(INFINITY) };
+	__m256d maxs[4] = { _mm256_set1_pd(-INFINITY), _mm256_set1_pd(-INFINITY), _mm256_set1_pd(-INFINITY), _mm256_set1_pd(-INFINITY) };
+	int vectorLength = n & ~15;
+	for (int i = 0; i < vectorLength; i += 16)
+	{
+		for (int lane = 0; lane < 4; lane++)
+		{
+			__m256d values = _mm256_loadu_pd(data + i + 4 * lane);
+			mins[lane] = _mm256_min_pd(values, mins[lane]);
+			maxs[lane] = _mm256_max_pd(values, maxs[lane]);
+		}
+	}
+	
+	double laneValues[4];
+	_mm256_storeu_pd(laneValues, _mm256_min_pd(_mm256_min_pd(mins[0], mins[1]), _mm256_min_pd(mins[2], mins[3])));
+	double minimum = fmin(fmin(laneValues[0], laneValues[1]), fmin(laneValues[2], laneValues[3]));
+	_mm256_storeu_pd(laneValues, _mm256_max_pd(_mm256_max_pd(maxs[0], maxs[1]), _mm256_max_pd(maxs[2], maxs[3])));
+	double maximum = fmax(fmax(laneValues[0], laneValues[1]), fmax(laneValues[2], laneValues[3]));
+	
+	
+	// The remaining values
+	double tailMinimum, tailMaximum;
+	find_extremes_scalar(data + vectorLength, n - vectorLength, &tailMinimum, &tailMaximum);
+	*minValue = fmin(minimum, tailMinimum);
+	*maxValue = fmax(maximum, tailMaximum);
+}
+#endif
+
+
+
+
+/**
+ * select_extremes_kernel
+ *
+ * Chooses the fastest extremes kernel the processor supports: AVX2, and otherwise the scalar kernel, which the compiler vectorizes
+ * for the baseline instruction set. The choice is made on the first call and remembered.
+ *
+ * @return The selected kernel.
+ */
+ExtremesKernel select_extremes_kernel(void)
+{
+	static _Atomic(ExtremesKernel) selectedKernel = NULL; // Threads racing to make the first selection all choose the same kernel
+	ExtremesKernel kernel = selectedKernel;
+	if (kernel == NULL)
+	{
+#if defined(__x86_64__) || defined(__i386__)
+		__builtin_cpu_init();
+		kernel = __builtin_cpu_supports("avx2") ? find_extremes_avx2 : find_extremes_scalar;
+#else
+		kernel = find_extremes_scalar;
+#endif
+		selectedKernel = kernel;
+	}
+	
+	return kernel;
+}
+
+
+
+
+/**
+ * compute_extremes
+ *
+ * Finds the minimum and maximum of an array of values in one fused pass with the fastest available kernel(see
+ * 'select_extremes_kernel'), rather than a separate pass for each. NaN values are skipped.
+ *
+ * @param data The values.
+ * @param n The number of values.
+ * @param minValue Set to the minimum, INFINITY if there are no values.
+ * @param maxValue Set to the maximum, -INFINITY if there are no values.
+ */
+void compute_extremes(const double *data, int n, double *minValue, double *maxValue)
+{
+	select_extremes_kernel()(data, n, minValue, maxValue);
+}
+
+
+
+
+/**
+ * create_histogram
+ *
+ * Creates a histogram of equal-width bins spanning a range, with every count at zero, the bin edges laid out, and the reciprocal of
+ * the bin width precomputed so that binning a value takes a multiplication rather than a division.
+ *
+ * @param min_value The lower edge of the first bin.
+ * @param max_value The upper edge of the last bin.
+ * @param num_bins The number of bins, at least 1.
+ * @return The histogram, to be released with 'free_histogram'.
+ */
+Histogram create_histogram(double min_value, double max_value, int num_bins)
+{
+	Histogram histogram;
+	histogram.num_bins = num_bins;
+	histogram.min_value = min_value;
+	histogram.max_value = max_value;
+	histogram.bin_width = (max_value - min_value) / num_bins;
+	histogram.inverse_bin_width = (histogram.bin_width > 0.0) ? 1.0 / histogram.bin_width : 0.0; // With a zero range every value falls in the first bin
+	histogram.bins = (int64_t *)calloc(num_bins, sizeof(int64_t));
+	histogram.bin_edges = allocate_memory_double_ptr(num_bins + 1);
+	if (histogram.bins == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'create_histogram'.\n");
+		exit(1);
+	}
+	
+	for (int i = 0; i < num_bins; i++)
+	{
+		histogram.bin_edges[i] = min_value + i * histogram.bin_width;
+	}
+	histogram.bin_edges[num_bins] = max_value;
+	
+	return histogram;
+}
+
+
+
+
+/**
+ * free_histogram
+ *
+ * Releases the bins and bin edges of a histogram.
+ *
+ * @param histogram The histogram.
+ */
+void free_histogram(Histogram *histogram)
+{
+	free(histogram->bins);
+	free(histogram->bin_edges);
+	histogram->bins = NULL;
+	histogram->bin_edges = NULL;
+	histogram->num_bins = 0;
+}
+
+
+
+
+/**
+ * bin_histogram_rows
+ *
+ * Thread routine counting the values of a range of rows of one or more columns into the task's own bins, one array per column, so
+ * that no two threads ever write to the same count. A value's bin is found by multiplying its offset from the histogram's minimum by
+ * the reciprocal bin width, values on or beyond the upper edge are counted in the last bin and values below the lower edge in the
+ * first, and NaN values and nulls(values whose bit is clear in the column's validity bitmap) are skipped.
+ *
+ * @param task The HistogramBinningTask to run.
+ * @return NULL.
+ */
+void *bin_histogram_rows(void *task)
+{
+	HistogramBinningTask *binningTask = (HistogramBinningTask *)task;
+	for (int c = 0; c < binningTask->columnCount; c++)
+	{
+		const double *column = binningTask->columns[c];
+		const uint64_t *validity = (binningTask->validity != NULL) ? binningTask->validity[c] : NULL;
+		const Histogram *histogram = &binningTask->histograms[c];
+		int64_t *bins = binningTask->bins[c];
+		double minValue = histogram->min_value;
+		double inverseBinWidth = histogram->inverse_bin_width;
+		double binCount = (double)histogram->num_bins;
+		int lastBin = histogram->num_bins - 1;
+		
+		for (int i = binningTask->start; i < binningTask->end; i++)
+		{
+			double position = (column[i] - minValue) * inverseBinWidth;
+			if (isnan(position) || (validity != NULL && !validity_bit_is_set(validity, (size_t)i)))
+			{
+				continue;
+			}
+			int binIndex = (position <= 0.0) ? 0 : (position < binCount) ? (int)position : lastBin;
+			bins[binIndex]++;
+		}
+	}
+	
+	return NULL;
+}
 
 
 
 
+/**
+ * bin_data_columns
+ *
+ * Counts the values of one or more equally long columns into their histograms, which already hold their ranges and bins(see
+ * 'create_histogram'), in one pass over the rows. The rows are divided between several threads, each of which counts its rows of
+ * every column into private 64-bit bins, and the private bins are then added into the histograms, so the threads never contend for a
+ * count and no count overflows however many values there are. NaN values and nulls are not counted.
+ *
+ * @param histograms The histogram of each column, whose bins are added to.
+ * @param columns The columns.
+ * @param validity The validity bitmap of each column(or NULL for a column whose only missing values are NaN), or NULL for none.
+ * @param columnCount The number of columns.
+ * @param n The number of values in each column.
+ * @param threadCount The number of threads, or 0 or less for every hardware thread(see 'determine_hardware_thread_count').
+ */
+void bin_data_columns(Histogram *histograms, const double *const *columns, const uint64_t *const *validity, int columnCount, int n, int threadCount)
+{
+	if (threadCount <= 0)
+	{
+		threadCount = determine_hardware_thread_count();
+	}
+	if (threadCount > n / PARALLEL_HISTOGRAM_MIN_CHUNK_LENGTH)
+	{
+		threadCount = n / PARALLEL_HISTOGRAM_MIN_CHUNK_LENGTH;
+	}
+	
+	
+	/// A single thread counts straight into the histograms
+	int64_t *histogramBins[columnCount];
+	for (int c = 0; c < columnCount; c++)
+	{
+		histogramBins[c] = histograms[c].bins;
+	}
+	if (threadCount <= 1)
+	{
+		HistogramBinningTask task = { columns, validity, histograms, histogramBins, columnCount, 0, n };
+		bin_histogram_rows(&task);
+		return;
+	}
+	
+	
+	/// Give each thread a range of rows and private bins for every column
+	HistogramBinningTask tasks[threadCount];
+	pthread_t threads[threadCount];
+	for (int t = 0; t < threadCount; t++)
+	{
+		tasks[t].columns = columns;
+		tasks[t].validity = validity;
+		tasks[t].histograms = histograms;
+		tasks[t].columnCount = columnCount;
+		tasks[t].start = (int)((int64_t)n * t / threadCount);
+		tasks[t].end = (int)((int64_t)n * (t + 1) / threadCount);
+		tasks[t].bins = (int64_t **)malloc(columnCount * sizeof(int64_t *));
+		if (tasks[t].bins == NULL)
+		{
+			perror("\n\nError: Unable to allocate memory in 'bin_data_columns'.\n");
+			exit(1);
+		}
+		for (int c = 0; c < columnCount; c++)
+		{
+			tasks[t].bins[c] = (int64_t *)calloc(histograms[c].num_bins, sizeof(int64_t));
+			if (tasks[t].bins[c] == NULL)
+			{
+				perror("\n\nError: Unable to allocate memory in 'bin_data_columns'.\n");
+				exit(1);
+			}
+		}
+		
+		if (pthread_create(&threads[t], NULL, bin_histogram_rows, &tasks[t]) != 0)
+		{
+			perror("\n\nError: Unable to create a thread in 'bin_data_columns'.\n");
+			exit(1);
+		}
+	}
+	
+	
+	/// Merge the private bins of each thread into the histograms
+	for (int t = 0; t < threadCount; t++)
+	{
+		pthread_join(threads[t], NULL);
+		for (int c = 0; c < columnCount; c++)
+		{
+			for (int b = 0; b < histograms[c].num_bins; b++)
+			{
+				histogramBins[c][b] += tasks[t].bins[c][b];
+			}
+			free(tasks[t].bins[c]);
+		}
+		free(tasks[t].bins);
+	}
+}
 
 
 
 
+/**
+ * compute_data_columns_binning
+ *
+ * Bins the present values of several equally long columns of a table at once, as 'compute_data_set_binning' bins one. Each column's
+ * present values are gathered into one shared scratch buffer('gather_valid_values'), where their range is found with a fused minimum
+ * and maximum pass('compute_extremes') and, unless the caller already holds it, their IQR by selection. Every column is then counted
+ * into its histogram in a single parallel pass over the table('bin_data_columns'), with its nulls skipped in place.
+ *
+ * @param columns The columns.
+ * @param validity The validity bitmap of each column(or NULL for a column whose only missing values are NaN), or NULL for none.
+ * @param iqrs The IQR of the present values of each column, however it was found(e.g., from a quantile sketch), or NULL to find
+ *             each by selection.
+ * @param columnCount The number of columns.
+ * @param n The number of values in each column, at least 2 of which must be present.
+ * @param threadCount The number of threads, or 0 or less for every hardware thread.
+ * @return An array of the histogram of each column, each to be released with 'free_histogram' and the array with 'free'.
+ */
+Histogram *compute_data_columns_binning(const double *const *columns, const uint64_t *const *validity, const double *iqrs, int columnCount, int n, int threadCount)
+{
+	Histogram *histograms = (Histogram *)malloc((columnCount > 0 ? columnCount : 1) * sizeof(Histogram));
+	if (histograms == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'compute_data_columns_binning'.\n");
+		exit(1);
+	}
+	
+	
+	/// Lay out the bins of each column from the range and IQR of its present values
+	double *scratch = allocate_memory_double_ptr(n > 0 ? n : 1);
+	for (int c = 0; c < columnCount; c++)
+	{
+		const uint64_t *columnValidity = (validity != NULL) ? validity[c] : NULL;
+		int presentCount = n;
+		if (columnValidity != NULL)
+		{
+			presentCount = gather_valid_values(columns[c], columnValidity, n, scratch);
+		}
+		else
+		{
+			memcpy(scratch, columns[c], n * sizeof(double));
+		}
+		if (presentCount < 2)
+		{
+			perror("\n\nError: Insufficient data to calculate bin width in 'compute_data_columns_binning'.\n");
+			exit(1);
+		}
+		
+		double min_value, max_value;
+		compute_extremes(scratch, presentCount, &min_value, &max_value);
+		double iqr = (iqrs != NULL) ? iqrs[c] : compute_IQR_by_selection(scratch, presentCount, NULL, NULL);
+		histograms[c] = create_histogram(min_value, max_value, freedman_diaconis_num_bins(iqr, presentCount, min_value, max_value));
+	}
+	free(scratch);
+	
+	
+	/// Count every column in one pass over the table
+	bin_data_columns(histograms, columns, validity, columnCount, n, threadCount);
+	
+	return histograms;
+}
 
 
 
 
 
+/**
+ * create_streaming_histogram
+ *
+ * Creates an empty streaming histogram(Ben-Haim and Tom-Tov), which summarizes any number of values in at most maxBins bins, each a
+ * centroid and the number of values it stands for, so that a column can be binned while it is ingested, without holding it or
+ * sorting it to choose a bin width. Values are added one at a time or in batches, each becoming a bin of its own, and whenever there
+ * are more than maxBins bins, the two bins whose centroids are closest are merged into one at their weighted mean. Bins are kept
+ * where the values are dense, and values repeated exactly always share a bin, so a column with at most maxBins distinct values is
+ * summarized exactly.
+ *
+ * @param maxBins The most bins the histogram keeps, or 0 for STREAMING_HISTOGRAM_DEFAULT_BINS.
+ * @return The histogram, to be freed with 'free_streaming_histogram'.
+ */
+StreamingHistogram *create_streaming_histogram(int maxBins)
+{
+	StreamingHistogram *histogram = (StreamingHistogram *)calloc(1, sizeof(StreamingHistogram));
+	if (histogram == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'create_streaming_histogram'.\n");
+		exit(1);
+	}
+	histogram->maxBins = (maxBins > 0) ? maxBins : STREAMING_HISTOGRAM_DEFAULT_BINS;
+	histogram->min = INFINITY;
+	histogram->max = -INFINITY;
+	
+	// Up to maxBins new bins are inserted at a time, so the bins never number more than twice maxBins before they are merged
+	histogram->bins = (StreamingHistogramBin *)malloc(2 * histogram->maxBins * sizeof(StreamingHistogramBin));
+	histogram->mergeBuffer = (StreamingHistogramBin *)malloc(2 * histogram->maxBins * sizeof(StreamingHistogramBin));
+	if (histogram->bins == NULL || histogram->mergeBuffer == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'create_streaming_histogram'.\n");
+		exit(1);
+	}
+	
+	return histogram;
+}
 
 
 
 
+/**
+ * free_streaming_histogram
+ *
+ * Releases a streaming histogram.
+ *
+ * @param histogram The histogram, or NULL.
+ */
+void free_streaming_histogram(StreamingHistogram *histogram)
+{
+	if (histogram == NULL)
+	{
+		return;
+	}
+	
+	free(histogram->bins);
+	free(histogram->mergeBuffer);
+	free(histogram);
+}
 
 
 
 
+/**
+ * insert_streaming_histogram_bins
+ *
+ * Merges up to maxBins new bins, sorted by centroid, into the bins of a streaming histogram, combining bins with equal centroids,
+ * then merges the closest bins until there are at most maxBins of them again.
+ *
+ * @param histogram The histogram.
+ * @param newBins The new bins, sorted by centroid.
+ * @param newBinCount The number of new bins, at most maxBins.
+ */
+void insert_streaming_histogram_bins(StreamingHistogram *histogram, const StreamingHistogramBin *newBins, int newBinCount)
+{
+	/// Merge the two sorted lists of bins into the buffer
+	StreamingHistogramBin *merged = histogram->mergeBuffer;
+	int mergedCount = 0;
+	int i = 0, j = 0;
+	while (i < histogram->binCount || j < newBinCount)
+	{
+		StreamingHistogramBin bin;
+		if (j == newBinCount || (i < histogram->binCount && histogram->bins[i].centroid <= newBins[j].centroid))
+		{
+			bin = histogram->bins[i++];
+		}
+		else
+		{
+			bin = newBins[j++];
+		}
+		
+		if (mergedCount > 0 && merged[mergedCount - 1].centroid == bin.centroid)
+		{
+			merged[mergedCount - 1].count += bin.count;
+		}
+		else
+		{
+			merged[mergedCount++] = bin;
+		}
+	}
+	histogram->mergeBuffer = histogram->bins;
+	histogram->bins = merged;
+	histogram->binCount = mergedCount;
+	
+	
+	/// Merge the closest pair of adjacent bins until there are at most maxBins
+	while (histogram->binCount > histogram->maxBins)
+	{
+		StreamingHistogramBin *bins = histogram->bins;
+		int closest = 0;
+		for (int b = 1; b < histogram->binCount - 1; b++)
+		{
+			if (bins[b + 1].centroid - bins[b].centroid < bins[closest + 1].centroid - bins[closest].centroid)
+			{
+				closest = b;
+			}
+		}
+		
+		int64_t count = bins[closest].count + bins[closest + 1].count;
+		bins[closest].centroid = (bins[closest].centroid * (double)bins[closest].count + bins[closest + 1].centroid * (double)bins[closest + 1].count) / (double)count;
+		bins[closest].count = count;
+		memmove(&bins[closest + 1], &bins[closest + 2], (histogram->binCount - closest - 2) * sizeof(StreamingHistogramBin));
+		histogram->binCount--;
+	}
+}
 
 
 
 
+/**
+ * add_value_to_streaming_histogram
+ *
+ * Adds a single value to a streaming histogram, NaN values mark missing entries and are skipped.
+ *
+ * @param histogram The histogram.
+ * @param value The value.
+ */
+void add_value_to_streaming_histogram(StreamingHistogram *histogram, double value)
+{
+	add_values_to_streaming_histogram(histogram, &value, 1);
+}
 
 
 
 
+/**
+ * add_values_to_streaming_histogram
+ *
+ * Adds a batch of values to a streaming histogram, NaN values mark missing entries and are skipped. The values are taken maxBins at a
+ * time, each group sorted and merged into the bins at once rather than inserted one by one.
+ *
+ * @param histogram The histogram.
+ * @param data The values.
+ * @param n The number of values.
+ */
+void add_values_to_streaming_histogram(StreamingHistogram *histogram, const double *data, int n)
+{
+	int maxBins = histogram->maxBins;
+	double values[maxBins];
+	StreamingHistogramBin newBins[maxBins];
+	int i = 0;
+	while (i < n)
+	{
+		int valueCount = 0;
+		for (; i < n && valueCount < maxBins; i++)
+		{
+			if (!isnan(data[i]))
+			{
+				values[valueCount++] = data[i];
+			}
+		}
+		if (valueCount == 0)
+		{
+			continue;
+		}
+		
+		insertion_sort_data(values, 0, valueCount - 1);
+		for (int v = 0; v < valueCount; v++)
+		{
+			newBins[v].centroid = values[v];
+			newBins[v].count = 1;
+		}
+		histogram->count += valueCount;
+		histogram->min = (values[0] < histogram->min) ? values[0] : histogram->min;
+		histogram->max = (values[valueCount - 1] > histogram->max) ? values[valueCount - 1] : histogram->max;
+		insert_streaming_histogram_bins(histogram, newBins, valueCount);
+	}
+}
 
 
 
 
+/**
+ * merge_streaming_histograms
+ *
+ * Merges the streaming histogram of one set of values into that of another, producing a histogram of both within the first
+ * histogram's maxBins, so that the histograms of chunks, threads, or earlier ingests can be combined.
+ *
+ * @param histogram The histogram to merge into.
+ * @param otherHistogram The histogram of the other values, it is not modified.
+ */
+void merge_streaming_histograms(StreamingHistogram *histogram, const StreamingHistogram *otherHistogram)
+{
+	for (int b = 0; b < otherHistogram->binCount; b += histogram->maxBins)
+	{
+		int remainingBins = otherHistogram->binCount - b;
+		insert_streaming_histogram_bins(histogram, &otherHistogram->bins[b], (remainingBins < histogram->maxBins) ? remainingBins : histogram->maxBins);
+	}
+	histogram->count += otherHistogram->count;
+	histogram->min = (otherHistogram->min < histogram->min) ? otherHistogram->min : histogram->min;
+	histogram->max = (otherHistogram->max > histogram->max) ? otherHistogram->max : histogram->max;
+}
 
 
 
 
+/**
+ * streaming_histogram_count_below
+ *
+ * Estimates the number of values of a streaming histogram no greater than x, with the trapezoid interpolation of Ben-Haim and
+ * Tom-Tov: half of each bin's values are taken to lie on either side of its centroid, and the density between two adjacent centroids
+ * to vary linearly from one bin's count to the next. The minimum and maximum act as bins with no values, so the estimate is 0 at the
+ * minimum and every value at the maximum.
+ *
+ * @param histogram The histogram.
+ * @param x The value.
+ * @return The estimated number of values no greater than x.
+ */
+double streaming_histogram_count_below(const StreamingHistogram *histogram, double x)
+{
+	if (histogram->count == 0 || x < histogram->min)
+	{
+		return 0.0;
+	}
+	if (x >= histogram->max)
+	{
+		return (double)histogram->count;
+	}
+	
+	
+	/// Find the pair of centroids, or of a centroid and an extreme, enclosing x
+	double countBelow = 0.0;
+	double leftCentroid = histogram->min, leftCount = 0.0;
+	for (int b = 0; b <= histogram->binCount; b++)
+	{
+		double rightCentroid = (b < histogram->binCount) ? histogram->bins[b].centroid : histogram->max;
+		double rightCount = (b < histogram->binCount) ? (double)histogram->bins[b].count : 0.0;
+		if (x < rightCentroid)
+		{
+			// The trapezoid between the left centroid and x
+			double fraction = (x - leftCentroid) / (rightCentroid - leftCentroid);
+			double countAtX = leftCount + (rightCount - leftCount) * fraction;
+			return countBelow + leftCount / 2.0 + (leftCount + countAtX) / 2.0 * fraction;
+		}
+		
+		countBelow += leftCount;
+		leftCentroid = rightCentroid;
+		leftCount = rightCount;
+	}
+	
+	return (double)histogram->count;
+}
 
 
 
 
+/**
+ * streaming_histogram_to_histogram
+ *
+ * Converts a streaming histogram to a Histogram of equal-width bins spanning its minimum to its maximum, for 'print_histogram' and
+ * everything else that takes a Histogram. The count of each bin is the difference of the rounded estimates of
+ * 'streaming_histogram_count_below' at its edges, so the counts add up to the number of values exactly.
+ *
+ * A streaming histogram holding no values, e.g., of a field whose every value was missing, has no range to span: it is converted to
+ * an empty histogram, a single bin from 0 to 0 with a count of 0, whatever the number of bins requested.
+ *
+ * @param streamingHistogram The streaming histogram.
+ * @param num_bins The number of bins, or 0 to use as many as the streaming histogram holds.
+ * @return The histogram, to be released with 'free_histogram'.
+ */
+Histogram streaming_histogram_to_histogram(const StreamingHistogram *streamingHistogram, int num_bins)
+{
+	if (streamingHistogram->count == 0)
+	{
+		return create_histogram(0.0, 0.0, 1);
+	}
+	
+	Histogram histogram = create_histogram(streamingHistogram->min, streamingHistogram->max, (num_bins > 0) ? num_bins : streamingHistogram->binCount);
+	double previousCount = 0.0;
+	for (int i = 0; i < histogram.num_bins; i++)
+	{
+		double count = (i == histogram.num_bins - 1) ? (double)streamingHistogram->count : round(streaming_histogram_count_below(streamingHistogram, histogram.bin_edges[i + 1]));
+		histogram.bins[i] = (int64_t)(count - previousCount);
+		previousCount = count;
+	}
+	
+	return histogram;
+}
 
 
 
 
 
 /**
- * compute_bin_width
+ * rank_transform_column
  *
- * Calculates optimal bin width for histogram using the Freedman-Diaconis rule.
- * The Freedman-Diaconis rule provides a robust bin-width calculation based on the
- * Interquartile Range (IQR) of the data set.
+ * Replaces the present values of a column by their ranks among each other, 1 for the smallest, with tied values all given the mean
+ * of the ranks they span, as the Spearman correlation requires. The present values are ordered once with 'radix_argsort_doubles'.
  *
- * Formula: binWidth = 2 * (IQR) * n^(-1/3)
+ * @param data The values.
+ * @param validity The validity bitmap of the values, or NULL if only NaN values are missing.
+ * @param n The number of values.
+ * @param ranks Set to the rank of each present value and NAN for each missing one.
  */
-double compute_bin_width(double* data, int n)
+void rank_transform_column(const double *data, const uint64_t *validity, int n, double *ranks)
 {
-	// Check if the data set is large enough to calculate IQR
-	if (n < 2)
-	{
-		perror("\n\nError: Insufficient data to calculate bin width in 'compute_bin_width'.\n");
-		exit(1);
-	}
-	
-	
-	// Calculating the Interquartile Range (IQR).
-	double iqr = 0.0;
-	double q25, q75;
-	
-	
-	double *sortedData = allocate_memory_double_ptr(n);
-	
-	for (int i = 0; i < n; i++)
+	double *presentValues = allocate_memory_double_ptr(n);
+	int *presentRows = allocate_memory_int_ptr(n);
+	int presentCount = 0;
+	for (int r = 0; r < n; r++)
 	{
-		sortedData[i] = data[i];
+		ranks[r] = NAN;
+		if ((validity == NULL || validity_bit_is_set(validity, (size_t)r)) && !isnan(data[r]))
+		{
+			presentValues[presentCount] = data[r];
+			presentRows[presentCount++] = r;
+		}
 	}
-	memcpy(sortedData, data, n);
-	
-	merge_sort(sortedData, n); // Sorting is required for IQR calculation. merge sort is a comparison sort algorithm(good for medium size lists and O(nlogn) in the worst case)
-	
 	
-	for (int i = 1; i < n; i++)
-	{
-		//printf("\n\nsortedData: %.17g", sortedData[i]);
-		//printf("\n\ndata: %.17g", (*data)[i]);
-		//sortedData[i-1] = (*data)[i-1];
-	}
 	
-	// Calculate the 25th and 75th percentiles based on sorted data
-	// Check if data size is even
-	if (n % 2 == 0)
+	int *order = radix_argsort_doubles(presentValues, presentCount, 1);
+	for (int tieStart = 0; tieStart < presentCount;)
 	{
-		int mid = n / 2;
-		q25 = (sortedData[mid / 2 - 1] + sortedData[mid / 2]) / 2.0;
-		q75 = (sortedData[mid + mid / 2 - 1] + sortedData[mid + mid / 2]) / 2.0;
-	}
-	else  // If data size is odd
-	{
-		int mid = (n - 1) / 2;
-		q25 = sortedData[mid / 2];
-		q75 = sortedData[mid + mid / 2];
+		int tieEnd = tieStart + 1;
+		while (tieEnd < presentCount && presentValues[order[tieEnd]] == presentValues[order[tieStart]])
+		{
+			tieEnd++;
+		}
+		
+		double rank = (tieStart + 1 + tieEnd) / 2.0; // The mean of the ranks tieStart + 1 through tieEnd
+		for (int t = tieStart; t < tieEnd; t++)
+		{
+			ranks[presentRows[order[t]]] = rank;
+		}
+		tieStart = tieEnd;
 	}
 	
-	// Compute the Interquartile Range (IQR)
-	iqr = q75 - q25;
-	
-	// Handle cases where IQR is zero (all numbers are the same)
-	if (iqr == 0.0)
+	free(presentValues);
+	free(presentRows);
+	free(order);
+}
+
+
+
+
+/**
+ * pack_correlation_panel
+ *
+ * Copies a range of rows of up to CORRELATION_TILE_COLUMNS consecutive columns into a row-major panel of CORRELATION_TILE_COLUMNS
+ * values per row, each centered on its column's center, along with a panel holding 1 for each present value and 0 for each missing
+ * one(only filled if the task has missing values). Missing values, and the columns past the last, are packed as 0, so they add
+ * nothing to any sum.
+ *
+ * @param task The task whose columns are packed.
+ * @param firstColumn The first column of the panel.
+ * @param columnCount The number of columns in the panel.
+ * @param rowStart The first row of the range.
+ * @param rowCount The number of rows in the range.
+ * @param values Set to the centered values.
+ * @param presence Set to the presence of each value.
+ */
+void pack_correlation_panel(const CorrelationTileTask *task, int firstColumn, int columnCount, int rowStart, int rowCount, double *values, double *presence)
+{
+	int tileColumns = CORRELATION_TILE_COLUMNS;
+	for (int c = 0; c < tileColumns; c++)
 	{
-		perror("\n\nError: Interquartile range is zero. Choose a different binning method, in 'compute_bin_width'.");
-		exit(1);
-		//printf("\nq75: %lf", q75);
-		//printf("\nq25: %lf", q25);
-		//printf("\n iqr: %lf \n\n\n\n", iqr);
+		if (c >= columnCount)
+		{
+			for (int r = 0; r < rowCount; r++)
+			{
+				values[r * tileColumns + c] = 0.0;
+				presence[r * tileColumns + c] = 0.0;
+			}
+			continue;
+		}
 		
-		//free(sortedData);
-		//return 0.0;
+		const double *column = task->columns[firstColumn + c] + rowStart;
+		const uint64_t *validity = (task->validity != NULL) ? task->validity[firstColumn + c] : NULL;
+		double center = task->centers[firstColumn + c];
+		if (!task->hasMissingValues)
+		{
+			// Every value is present, so only the centered values are needed
+			for (int r = 0; r < rowCount; r++)
+			{
+				values[r * tileColumns + c] = column[r] - center;
+			}
+			continue;
+		}
+		
+		for (int r = 0; r < rowCount; r++)
+		{
+			double value = column[r];
+			bool present = (value == value) && (validity == NULL || ((validity[(size_t)(rowStart + r) / 64] >> ((rowStart + r) % 64)) & 1));
+			values[r * tileColumns + c] = present ? value - center : 0.0;
+			presence[r * tileColumns + c] = present ? 1.0 : 0.0;
+		}
 	}
-	
-	// Calculate the optimal bin width using the Freedman-Diaconis rule
-	double binWidth = 2.0 * iqr / pow((double)(n), 1.0 / 3.0);
-	
-	
-	
-	
-	//data = allocate_memory_double_ptr_ptr(n);
-	//for (int i = 0; i < n; i++)
-	//{
-	//    (*data)[i] = sortedData[i];
-	//printf("\n\nsorted  data ???: %.17g", (*data)[i]);
-	//}
-	//memcpy(data, sortedData, n);
-	free(sortedData);// Clean up allocated memory
-	return binWidth;
 }
 
 
 
 
 /**
- * calculateOptimalNumBins
+ * compute_correlation_tiles
  *
- * Calculates the optimal number of bins using a Bayesian approach.
- * This function calculates Bayesian Information Criterion (BIC) based on the bin width
- * to find the optimal number of bins for a histogram.
+ * Thread routine accumulating the pairwise sums of its share of the tiles of the correlation matrix. The columns are divided into
+ * blocks of CORRELATION_TILE_COLUMNS, and a tile is a pair of blocks, whose sums are a GEMM-like product of the two blocks' centered
+ * values: the rows are packed CORRELATION_TILE_ROWS at a time into two small panels(see 'pack_correlation_panel') and each row's outer
+ * product is added into accumulators that stay in cache for the whole tile. When any value is missing, the counts of rows where both
+ * values are present, and each column's sums and sums of squares over those rows, are accumulated the same way, so nulls are
+ * excluded pair by pair.
  *
- * BIC Formula: BIC = n * log(binWidth) + 0.5 * log(n) * numBins
- * The formula is also adjusted for small sample sizes.
+ * The tiles of the upper triangle are dealt out to the threads in turn, and each tile writes only its own entries of the sums, in
+ * both triangles.
+ *
+ * @param task The CorrelationTileTask to run.
+ * @return NULL.
  */
-int compute_optimal_num_bins(double* data, int n)
+void *compute_correlation_tiles(void *task)
 {
-	double binWidth = compute_bin_width(data, n);
-	if (binWidth == 0.0)
+	CorrelationTileTask *tileTask = (CorrelationTileTask *)task;
+	int tileColumns = CORRELATION_TILE_COLUMNS;
+	int tileRows = CORRELATION_TILE_ROWS;
+	int columnCount = tileTask->columnCount;
+	int blockCount = (columnCount + tileColumns - 1) / tileColumns;
+	
+	double *firstValues = allocate_memory_double_ptr(tileRows * tileColumns);
+	double *firstPresence = allocate_memory_double_ptr(tileRows * tileColumns);
+	double *secondValues = allocate_memory_double_ptr(tileRows * tileColumns);
+	double *secondPresence = allocate_memory_double_ptr(tileRows * tileColumns);
+	double products[tileColumns * tileColumns];
+	double counts[tileColumns * tileColumns];
+	double firstSums[tileColumns * tileColumns];
+	double secondSums[tileColumns * tileColumns];
+	double firstSquares[tileColumns * tileColumns];
+	double secondSquares[tileColumns * tileColumns];
+	
+	
+	int tileIndex = 0;
+	for (int firstBlock = 0; firstBlock < blockCount; firstBlock++)
 	{
-		return n;
+		for (int secondBlock = firstBlock; secondBlock < blockCount; secondBlock++)
+		{
+			if (tileIndex++ % tileTask->threadCount != tileTask->threadIndex)
+			{
+				continue;
+			}
+			
+			int firstColumn = firstBlock * tileColumns;
+			int secondColumn = secondBlock * tileColumns;
+			int firstWidth = (columnCount - firstColumn < tileColumns) ? columnCount - firstColumn : tileColumns;
+			int secondWidth = (columnCount - secondColumn < tileColumns) ? columnCount - secondColumn : tileColumns;
+			memset(products, 0, sizeof(products));
+			memset(counts, 0, sizeof(counts));
+			memset(firstSums, 0, sizeof(firstSums));
+			memset(secondSums, 0, sizeof(secondSums));
+			memset(firstSquares, 0, sizeof(firstSquares));
+			memset(secondSquares, 0, sizeof(secondSquares));
+			
+			
+			/// Add the outer products of the rows of each pair of panels
+			for (int rowStart = 0; rowStart < tileTask->n; rowStart += tileRows)
+			{
+				int rowCount = (tileTask->n - rowStart < tileRows) ? tileTask->n - rowStart : tileRows;
+				pack_correlation_panel(tileTask, firstColumn, firstWidth, rowStart, rowCount, firstValues, firstPresence);
+				const double *otherValues = firstValues, *otherPresence = firstPresence;
+				if (secondBlock != firstBlock)
+				{
+					pack_correlation_panel(tileTask, secondColumn, secondWidth, rowStart, rowCount, secondValues, secondPresence);
+					otherValues = secondValues;
+					otherPresence = secondPresence;
+				}
+				
+				// The products of 4 rows are added at once, so each accumulator is loaded and stored a quarter as often
+				int unrolledRowCount = rowCount & ~3;
+				for (int r = 0; r < unrolledRowCount; r += 4)
+				{
+					const double *firstRows = &firstValues[r * tileColumns];
+					const double *secondRows = &otherValues[r * tileColumns];
+					for (int a = 0; a < firstWidth; a++)
+					{
+						double firstValue0 = firstRows[a], firstValue1 = firstRows[tileColumns + a];
+						double firstValue2 = firstRows[2 * tileColumns + a], firstValue3 = firstRows[3 * tileColumns + a];
+						double *productRow = &products[a * tileColumns];
+						for (int b = 0; b < tileColumns; b++)
+						{
+							productRow[b] += (firstValue0 * secondRows[b] + firstValue1 * secondRows[tileColumns + b])
+							               + (firstValue2 * secondRows[2 * tileColumns + b] + firstValue3 * secondRows[3 * tileColumns + b]);
+						}
+					}
+				}
+				for (int r = unrolledRowCount; r < rowCount; r++)
+				{
+					const double *firstRow = &firstValues[r * tileColumns];
+					const double *secondRow = &otherValues[r * tileColumns];
+					for (int a = 0; a < firstWidth; a++)
+					{
+						double firstValue = firstRow[a];
+						double *productRow = &products[a * tileColumns];
+						for (int b = 0; b < tileColumns; b++)
+						{
+							productRow[b] += firstValue * secondRow[b];
+						}
+					}
+				}
+				
+				
+				/// With missing values, also add up the counts, sums, and squares over the rows where both values are present
+				for (int r = 0; tileTask->hasMissingValues && r < rowCount; r++)
+				{
+					const double *firstRow = &firstValues[r * tileColumns];
+					const double *secondRow = &otherValues[r * tileColumns];
+					const double *firstPresent = &firstPresence[r * tileColumns];
+					const double *secondPresent = &otherPresence[r * tileColumns];
+					for (int a = 0; a < firstWidth; a++)
+					{
+						double firstValue = firstRow[a], firstSquare = firstValue * firstValue, present = firstPresent[a];
+						for (int b = 0; b < tileColumns; b++)
+						{
+							counts[a * tileColumns + b] += present * secondPresent[b];
+							firstSums[a * tileColumns + b] += firstValue * secondPresent[b];
+							secondSums[a * tileColumns + b] += present * secondRow[b];
+							firstSquares[a * tileColumns + b] += firstSquare * secondPresent[b];
+							secondSquares[a * tileColumns + b] += present * secondRow[b] * secondRow[b];
+						}
+					}
+				}
+			}
+			
+			
+			/// Write the tile's sums to both triangles
+			for (int a = 0; a < firstWidth; a++)
+			{
+				for (int b = 0; b < secondWidth; b++)
+				{
+					size_t entry = (size_t)(firstColumn + a) * columnCount + (secondColumn + b);
+					size_t mirroredEntry = (size_t)(secondColumn + b) * columnCount + (firstColumn + a);
+					int t = a * tileColumns + b;
+					tileTask->products[entry] = tileTask->products[mirroredEntry] = products[t];
+					if (tileTask->hasMissingValues)
+					{
+						tileTask->counts[entry] = tileTask->counts[mirroredEntry] = counts[t];
+						tileTask->sums[entry] = firstSums[t];
+						tileTask->sums[mirroredEntry] = secondSums[t];
+						tileTask->squares[entry] = firstSquares[t];
+						tileTask->squares[mirroredEntry] = secondSquares[t];
+					}
+				}
+			}
+		}
 	}
 	
-	//merge_sort(data, n);
-	
-	//for (int i = 1; i < n; i++)
-	//{
-	//    printf("\n\nsorted  data ??? : %.17g", (*data)[i]);
-	//sortedData[i-1] = (*data)[i-1];
-	//}
-	
-	
-	// Calculate the range of the data
-	//double range = data[n - 1] - data[0]; // The data has already been sorted
-	
-	
-	// Estimate the number of bins based on the range and optimal bin width
-	//int numBins = ((int)(range / binWidth));
-	
-	// Estimate the number of bins based on the range and optimal bin width
-	//int numBins = (int)ceil(range / binWidth);
-	
-	// Calculate the range of the data
-	double range = max_element(data, n) - min_element(data, n);
-	
-	// Estimate the number of bins based on the range and optimal bin width
-	int numBins = (int)ceil(range / binWidth);
-	
-	// Bayesian Information Criterion (BIC) to find the optimal number of bins
-	double bic = n * log(binWidth) + 0.5 * log(n) * numBins;
-	
-	
-	// Adjusting for small sample sizes
-	//bic += (numBins - 1) * log((double)(n)) / 2.0;
-	
-	
-	
-	return numBins;
-	//return (int)(bic);
+	free(firstValues);
+	free(firstPresence);
+	free(secondValues);
+	free(secondPresence);
+	return NULL;
 }
 
 
 
 
 /**
- * compute_data_set_binning
+ * compute_correlation_matrix
  *
- * Computes the optimal binning for a histogram of a dataset.
- * This function determines the number of bins and their width for constructing
- * a histogram, using the Freedman-Diaconis rule which is based on the IQR and
- * the size of the dataset. The function checks for sufficient data size and
- * handles cases with small datasets. Utilizes the IQR and range of the data to
- * calculate bin width and number. Populates the bins based on the calculated binning strategy.
+ * Computes the covariance, Pearson correlation, or Spearman correlation of every pair of a set of equally long columns, as a
+ * symmetric matrix. Missing values(NaN, or cleared in a column's validity bitmap) are excluded pair by pair, so each entry uses every
+ * row where both of its columns are present.
  *
- * @note For very small datasets, the Freedman-Diaconis rule may not be optimal.
- *       The method assumes a reasonably symmetric distribution of data.
- *       Does not consider the Bayesian Information Criterion (BIC) for bin number optimization.
+ * Each column is first centered on its mean, so that the sums are of small deviations and the covariance is not lost to cancellation.
+ * The pairwise sums are then accumulated in cache-blocked tiles, divided between several threads(see 'compute_correlation_tiles'):
+ * the cost is one GEMM-like pass per tile over the rows, which keeps the work for hundreds of columns proportional to their pairs
+ * without ever holding more than two small panels per thread. With n_ij rows where both columns i and j are present, S_i the sum of
+ * column i over those rows, Q_i its sum of squares, and P_ij the sum of products:
+ *
+ *     cov_ij = (P_ij - S_i S_j / n_ij) / (n_ij - 1)          r_ij = cov_ij / sqrt(var_i|j var_j|i), var_i|j = (Q_i - S_i^2 / n_ij) / (n_ij - 1)
+ *
+ * The Spearman correlation is the Pearson correlation of the ranks of each column's present values('rank_transform_column'), which
+ * are ranked once over the whole column rather than again for each pair.
+ *
+ * @param columns The columns.
+ * @param validity The validity bitmap of each column(any of which may be NULL), or NULL if only NaN values are missing.
+ * @param columnCount The number of columns.
+ * @param n The number of values in each column.
+ * @param method The measure to compute.
+ * @param threadCount The number of threads, or 0 or less for every hardware thread.
+ * @return The columnCount by columnCount matrix, row by row, with NAN where a pair has fewer than 2 rows in common or, for a
+ *         correlation, a column is constant over them.
  */
-Histogram compute_data_set_binning(double *data, int n)
+double *compute_correlation_matrix(const double *const *columns, const uint64_t *const *validity, int columnCount, int n, CorrelationMethod method, int threadCount)
 {
-	// Calculate the optimal number of bins
-	// Verify that the data set is large enough to calculate IQR
-	if (n < 2)
+	/// Rank each column for the Spearman correlation, whose ranks then stand in for the columns with NaN marking missing values
+	double **rankColumns = NULL;
+	if (method == CORRELATION_METHOD_SPEARMAN)
 	{
-		perror("\n\nError: Insufficient data to calculate bin width in 'compute_bin_width'.\n");
+		rankColumns = (double **)malloc(columnCount * sizeof(double *));
+		if (rankColumns == NULL)
+		{
+			perror("\n\nError: Unable to allocate memory in 'compute_correlation_matrix'.\n");
+			exit(1);
+		}
+		for (int c = 0; c < columnCount; c++)
+		{
+			rankColumns[c] = allocate_memory_double_ptr(n);
+			rank_transform_column(columns[c], (validity != NULL) ? validity[c] : NULL, n, rankColumns[c]);
+		}
+		columns = (const double *const *)rankColumns;
+		validity = NULL;
 	}
 	
 	
-	// Calculating the Interquartile Range (IQR).
-	double iqr = compute_IQR(data, n);
-	
-	// Calculate bin width using the Freedman-Diaconis rule, which reduces the effect of outliers
-	double binWidth = 2.0 * iqr / pow((double)(n), 1.0 / 3.0);
-	
-	// If binWidth is too small, adjust it to a reasonable minimum value
-	if(binWidth < 1)
+	/// Center each column on the mean of its present values, noting whether any value is missing at all
+	double *centers = allocate_memory_double_ptr(columnCount);
+	bool hasMissingValues = false;
+	for (int c = 0; c < columnCount; c++)
 	{
-		binWidth = n;
+		MomentsAccumulator moments = create_moments_accumulator();
+		if (validity != NULL && validity[c] != NULL)
+		{
+			accumulate_moments_of_valid_values(&moments, columns[c], validity[c], n);
+		}
+		else
+		{
+			accumulate_moments(&moments, columns[c], n);
+		}
+		centers[c] = (moments.count > 0) ? moments.mean : 0.0;
+		hasMissingValues = hasMissingValues || moments.count < n;
 	}
 	
 	
-	
-	//merge_sort(data, n);
-	
-	// Calculate the range of the data
-	double range = 0;
-	range = max_element(data, n) - min_element(data, n);
-	
-	
-	
-	// Estimate the number of bins based on the range and optimal bin width
-	int numBins = 0;
-	numBins = ((int)(range / binWidth));
-	
-	
-	// Bayesian Information Criterion (BIC) to find the optimal number of bins
-	//double bic = n * log(binWidth) + 0.5 * log(n) * numBins;
-	
-	
-	// Adjusting for small sample sizes
-	//bic -= (numBins - 1) * log((double)(n)) / 2.0;
-	
-	//print_array(n, *data, "Histogram Data");
-	
-	
-	
-	// Calculate the optimal number of bins, ensuring it's a positive integer
-	int optimalNumBins = numBins > 0 ? numBins : 1;
-	
-	
-	
-	
-	
-	if (optimalNumBins <= 0)
+	/// Accumulate the pairwise sums tile by tile
+	size_t entryCount = (size_t)columnCount * columnCount;
+	double *products = (double *)calloc(entryCount, sizeof(double));
+	double *counts = hasMissingValues ? (double *)calloc(entryCount, sizeof(double)) : NULL;
+	double *sums = hasMissingValues ? (double *)calloc(entryCount, sizeof(double)) : NULL;
+	double *squares = hasMissingValues ? (double *)calloc(entryCount, sizeof(double)) : NULL;
+	if (products == NULL || (hasMissingValues && (counts == NULL || sums == NULL || squares == NULL)))
 	{
-		perror("\n\nError: Unable to calculate the optimal number of bins in 'compute_data_set_binning'.\n");
-		//exit(1);
-		optimalNumBins = n;
+		perror("\n\nError: Unable to allocate memory in 'compute_correlation_matrix'.\n");
+		exit(1);
 	}
 	
-	// Calculate the minimum and maximum values in the data set
-	double min_value = min_element(data, n);
-	double max_value = max_element(data, n);
-	//printf("\n\nminValue: %lf, maxValue: %lf\n",  min_value, max_value);
-	
-	
-	
-	
-	
-	// Calculate the width of each bin
-	double bin_width = (max_value - min_value) / optimalNumBins;
-	
-	
-	// Initialize bins, holds frequency count
-	
-	int* dataSetBins = allocate_memory_int_ptr(optimalNumBins); //A pointer to an array of histogram bins is initialized with a size equal to the optimal number of bins.
-																//Each bin is initialized to have a frequency count of 0.
-	
-	
-	for(int i=0; i<optimalNumBins;i++)
+	int blockCount = (columnCount + CORRELATION_TILE_COLUMNS - 1) / CORRELATION_TILE_COLUMNS;
+	int tileCount = blockCount * (blockCount + 1) / 2;
+	if (threadCount <= 0)
 	{
-		dataSetBins[i] = 0;
+		threadCount = determine_hardware_thread_count();
 	}
+	threadCount = (threadCount < tileCount) ? threadCount : tileCount;
+	threadCount = (threadCount > 0) ? threadCount : 1;
 	
-	
-	
-	
-	// Populate the bins with the frequency count of each bin
-	for (int i = 0; i < n; i++)
+	CorrelationTileTask tasks[threadCount];
+	pthread_t threads[threadCount];
+	for (int t = 0; t < threadCount; t++)
 	{
-		int bin_index = (int)((data[i] - min_value) / bin_width);
-		if (bin_index == optimalNumBins)
+		CorrelationTileTask task = { columns, validity, centers, columnCount, n, hasMissingValues, t, threadCount, products, counts, sums, squares };
+		tasks[t] = task;
+		if (t > 0 && pthread_create(&threads[t], NULL, compute_correlation_tiles, &tasks[t]) != 0)
 		{
-			bin_index--;  // Handle the edge case when data[i] == max_value
+			perror("\n\nError: Unable to create a thread in 'compute_correlation_matrix'.\n");
+			exit(1);
 		}
-		dataSetBins[bin_index]++;
+	}
+	compute_correlation_tiles(&tasks[0]); // The calling thread takes the first share
+	for (int t = 1; t < threadCount; t++)
+	{
+		pthread_join(threads[t], NULL);
 	}
 	
 	
-	// Update the data array to hold histogram values for visualization
-	
-	double *binData = allocate_memory_double_ptr(optimalNumBins);
-	// Output bins
-	for (int i = 0; i < optimalNumBins; i++)
+	/// Turn the sums into the requested measure
+	double *matrix = allocate_memory_double_ptr(entryCount);
+	for (int i = 0; i < columnCount; i++)
 	{
-		double bin_start = min_value + i * bin_width;
-		double bin_end = bin_start + bin_width;
-		//printf("\nBin %d: [%.17gf, %.17g): %d", i, bin_start, bin_end, dataSetBins[i]);
-		
-		binData[i] = (bin_start + bin_end) * 0.5;
-		//(*data)[i] = (bin_start + bin_end) * 0.5;
+		for (int j = 0; j < columnCount; j++)
+		{
+			size_t entry = (size_t)i * columnCount + j, mirroredEntry = (size_t)j * columnCount + i;
+			double pairCount = hasMissingValues ? counts[entry] : (double)n;
+			double firstSum = hasMissingValues ? sums[entry] : 0.0; // Without missing values each centered column sums to 0
+			double secondSum = hasMissingValues ? sums[mirroredEntry] : 0.0;
+			double firstSquares = hasMissingValues ? squares[entry] : products[(size_t)i * columnCount + i];
+			double secondSquares = hasMissingValues ? squares[mirroredEntry] : products[(size_t)j * columnCount + j];
+			if (pairCount < 2.0)
+			{
+				matrix[entry] = NAN;
+				continue;
+			}
+			
+			double covariance = (products[entry] - firstSum * secondSum / pairCount) / (pairCount - 1.0);
+			if (method == CORRELATION_METHOD_COVARIANCE)
+			{
+				matrix[entry] = covariance;
+				continue;
+			}
+			
+			double firstVariance = (firstSquares - firstSum * firstSum / pairCount) / (pairCount - 1.0);
+			double secondVariance = (secondSquares - secondSum * secondSum / pairCount) / (pairCount - 1.0);
+			double correlation = (i == j) ? 1.0 : covariance / sqrt(firstVariance * secondVariance); // Rounding must not leave a column short of matching itself
+			matrix[entry] = (firstVariance > 0.0 && secondVariance > 0.0) ? correlation : NAN;
+		}
 	}
 	
-	//free(*(data));
-	//data = allocate_memory_double_ptr_ptr(optimalNumBins);
-	//memcpy(data, binData, optimalNumBins);
 	
-	
-	// Return the computed histogram structure
-	Histogram data_histogram;
-	data_histogram.bins = dataSetBins;
-	data_histogram.num_bins = optimalNumBins;
-	data_histogram.bin_width = bin_width;
-	data_histogram.min_value = min_value;
-	data_histogram.max_value = max_value;
-	return data_histogram;
+	free(centers);
+	free(products);
+	free(counts);
+	free(sums);
+	free(squares);
+	deallocate_memory_double_ptr_ptr(rankColumns, columnCount);
+	return matrix;
 }
 
 
@@ -713,34 +3433,14 @@ void compute_histogram(double* data, int n)
 	// Calculating the Interquartile Range (IQR).
 	double iqr = 0.0;
 	double q25 = 0, q75 = 0;
-	double* sortedData = (double*)malloc(n * sizeof(double));
-	
-	for (int i = 0; i < n; i++)
-	{
-		sortedData[i] = data[i];
-	}
-	
-	
-	
-	merge_sort(sortedData, n); // Sorting is required for IQR calculation. merge sort is a comparison sort algorithm(good for medium size lists and O(nlogn) in the worst case)
+	double min_value = 0, max_value = 0;
 	
 	
-	
-	
-	// Calculate the 25th and 75th percentiles based on sorted data
-	// Check if data size is even
-	if (n % 2 == 0)
-	{
-		int mid = n / 2;
-		q25 = (sortedData[mid / 2 - 1] + sortedData[mid / 2]) / 2.0;
-		q75 = (sortedData[mid + mid / 2 - 1] + sortedData[mid + mid / 2]) / 2.0;
-	}
-	else  // If data size is odd
-	{
-		int mid = (n - 1) / 2;
-		q25 = sortedData[mid / 2];
-		q75 = sortedData[mid + mid / 2];
-	}
+	// Select the 25th and 75th percentiles, and the minimum and maximum values, from a copy of the data in one selection
+	double* scratch = allocate_memory_double_ptr(n);
+	memcpy(scratch, data, n * sizeof(double));
+	compute_quartiles_by_selection(scratch, n, &q25, &q75, &min_value, &max_value);
+	free(scratch);
 	
 	// Compute the Interquartile Range (IQR)
 	iqr = q75 - q25;
@@ -752,8 +3452,6 @@ void compute_histogram(double* data, int n)
 		printf("\nq75: %lf", q75);
 		printf("\nq25: %lf", q25);
 		printf("\n iqr: %lf \n\n\n\n", iqr);
-		
-		free(sortedData);
 	}
 	
 	// Calculate the optimal bin width using the Freedman-Diaconis rule
@@ -762,15 +3460,10 @@ void compute_histogram(double* data, int n)
 	{
 		binWidth = n;
 	}
-	free(sortedData);// Clean up allocated memory
-	
-	
-	
-	merge_sort(sortedData, n);
 	
 	// Calculate the range of the data
 	double range = 0;
-	range = max_element(data, n) - min_element(data, n);
+	range = max_value - min_value;
 	
 	
 	
@@ -813,9 +3506,6 @@ void compute_histogram(double* data, int n)
 		optimalNumBins = n;
 	}
 	
-	// Determine the range of the data
-	double min_value = min_element(data, n);
-	double max_value = max_element(data, n);
 	//printf("\n\nminValue: %lf, maxValue: %lf\n",  min_value, max_value);
 	
 	
@@ -889,7 +3579,7 @@ void print_histogram(Histogram histogram, char *label)
 	printf("\n\n Histogram Bins: ");
 	for(int i = 0; i < histogram.num_bins; i++)
 	{
-		printf("\n   bin %d: %d", i, histogram.bins[i]);
+		printf("\n   bin %d: [%.17g, %.17g): %lld", i, histogram.bin_edges[i], histogram.bin_edges[i + 1], (long long)histogram.bins[i]);
 	}
 	
 	printf("\n\n\n==============================================================================================");
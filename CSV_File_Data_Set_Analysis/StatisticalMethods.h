@@ -13,6 +13,8 @@
 #include <string.h>
 #include <time.h>
 #include <math.h>
+#include <stdint.h>
+#include <stdbool.h>
 
 
 
@@ -24,24 +26,274 @@
  * This struct contains all the information that defines a Histogram.
  * Each member variable holds a specific characteristic defining a Histogram, including bin details and range values.
  *
- * - bins: Pointer to an array of integers representing the count in each bin.
+ * - bins: Pointer to an array of 64-bit integers representing the count in each bin.
  * - num_bins: The total number of bins in the histogram.
  * - bin_width: The width of each bin in the histogram.
+ * - inverse_bin_width: The reciprocal of the bin width(0 if the width is 0), so that a value is binned with a multiplication.
  * - min_value: The minimum value in the dataset.
  * - max_value: The maximum value in the dataset.
+ * - bin_edges: The num_bins + 1 edges of the bins, bin i counting the values in [bin_edges[i], bin_edges[i + 1]) and the last bin
+ *   also counting the values equal to max_value.
  */
 typedef struct
 {
-	int *bins;
+	int64_t *bins;
 	int num_bins;
 	double bin_width;
+	double inverse_bin_width;
 	double min_value;
 	double max_value;
+	double *bin_edges;
 } Histogram;
 
 void print_histogram(Histogram histogram, char *label);
 
 
+/**
+ * HistogramBinningTask Structure: The work of one thread binning a range of rows of one or more columns(see 'bin_data_columns').
+ *
+ * - columns: The columns being binned.
+ * - validity: The validity bitmap of each column, or NULL if only NaN values are missing(as is a column's own NULL bitmap).
+ * - histograms: The histogram of each column, giving its range and bins.
+ * - bins: The counts of each column the thread adds to, private to the thread.
+ * - columnCount: The number of columns.
+ * - start: The first row of the range.
+ * - end: One past the last row of the range.
+ */
+typedef struct
+{
+	const double *const *columns;
+	const uint64_t *const *validity;
+	const Histogram *histograms;
+	int64_t **bins;
+	int columnCount;
+	int start;
+	int end;
+} HistogramBinningTask;
+
+typedef void (*ExtremesKernel)(const double *data, int n, double *minValue, double *maxValue); // Signature shared by every implementation of the extremes kernel
+
+
+
+/**
+ * StreamingHistogramBin Structure: A bin of a streaming histogram.
+ *
+ * - centroid: The mean of the values in the bin.
+ * - count: The number of values in the bin.
+ */
+typedef struct
+{
+	double centroid;
+	int64_t count;
+} StreamingHistogramBin;
+
+
+/**
+ * StreamingHistogram Structure: A Ben-Haim and Tom-Tov streaming histogram, which summarizes a stream of values in at most maxBins
+ * bins of adaptive position(see 'create_streaming_histogram'). Histograms of disjoint values merge with 'merge_streaming_histograms'
+ * and convert to a Histogram with 'streaming_histogram_to_histogram'.
+ *
+ * - maxBins: The most bins the histogram keeps.
+ * - binCount: The number of bins.
+ * - bins: The bins, sorted by centroid, with room for twice maxBins.
+ * - mergeBuffer: The buffer new bins are merged into, swapped with 'bins' after each merge.
+ * - count: The number of values added.
+ * - min: The smallest value added, exactly.
+ * - max: The largest value added, exactly.
+ */
+typedef struct
+{
+	int maxBins;
+	int binCount;
+	StreamingHistogramBin *bins;
+	StreamingHistogramBin *mergeBuffer;
+	int64_t count;
+	double min;
+	double max;
+} StreamingHistogram;
+
+
+
+
+
+// -------------- Correlation Matrix Structure Definitions --------------
+/**
+ * CorrelationMethod Enumeration: The measure of association computed between each pair of columns by 'compute_correlation_matrix'.
+ *
+ * - CORRELATION_METHOD_COVARIANCE: The sample covariance.
+ * - CORRELATION_METHOD_PEARSON: The Pearson correlation coefficient.
+ * - CORRELATION_METHOD_SPEARMAN: The Spearman rank correlation coefficient.
+ */
+typedef enum
+{
+	CORRELATION_METHOD_COVARIANCE,
+	CORRELATION_METHOD_PEARSON,
+	CORRELATION_METHOD_SPEARMAN
+} CorrelationMethod;
+
+
+/**
+ * CorrelationTileTask Structure: The share of the tiles of a correlation matrix accumulated by one thread(see
+ * 'compute_correlation_tiles'), and the pairwise sums, shared by every thread, that its tiles are written to.
+ *
+ * - columns: The columns.
+ * - validity: The validity bitmap of each column, or NULL.
+ * - centers: The mean of each column's present values, which its values are centered on.
+ * - columnCount: The number of columns.
+ * - n: The number of values in each column.
+ * - hasMissingValues: Whether any value is missing, if not only the products are accumulated.
+ * - threadIndex: The index of the thread, it accumulates every threadCount-th tile from this one.
+ * - threadCount: The number of threads.
+ * - products: The sum of the products of the centered values of each pair of columns, over the rows where both are present.
+ * - counts: The number of rows where both columns of each pair are present.
+ * - sums: Entry (i, j) is the sum of the centered values of column i over the rows where column j is also present.
+ * - squares: Entry (i, j) is the sum of the squared centered values of column i over the rows where column j is also present.
+ */
+typedef struct
+{
+	const double *const *columns;
+	const uint64_t *const *validity;
+	const double *centers;
+	int columnCount;
+	int n;
+	bool hasMissingValues;
+	
+	
+	int threadIndex;
+	int threadCount;
+	
+	
+	double *products;
+	double *counts;
+	double *sums;
+	double *squares;
+} CorrelationTileTask;
+
+
+
+
+
+
+
+// -------------- Moments Accumulator Structure Definition --------------
+/**
+ * MomentsAccumulator Structure: The running count, mean, central moments, and range of a set of values, from which the mean,
+ * standard deviation, skewness, and kurtosis all follow, accumulated in a single numerically stable pass.
+ *
+ * 'M2', 'M3', and 'M4' are the sums of the second, third, and fourth powers of the deviations from the mean, updated as values are
+ * added without ever subtracting large, nearly equal sums. Two accumulators of disjoint values(e.g., the partial results of two
+ * threads or chunks) merge into the accumulator of all of their values with 'merge_moments_accumulators'.
+ *
+ * - count: The number of values accumulated.
+ * - nullCount: The number of missing values skipped(NaN, or marked missing in a validity bitmap).
+ * - mean: The mean of the values.
+ * - M2: The sum of the squared deviations from the mean.
+ * - M3: The sum of the cubed deviations from the mean.
+ * - M4: The sum of the fourth powers of the deviations from the mean.
+ * - min: The smallest value, INFINITY if there are none.
+ * - max: The largest value, -INFINITY if there are none.
+ */
+typedef struct
+{
+	int64_t count;
+	int64_t nullCount;
+	double mean;
+	double M2;
+	double M3;
+	double M4;
+	double min;
+	double max;
+} MomentsAccumulator;
+
+typedef MomentsAccumulator (*BlockMomentsKernel)(const double *block, int blockLength); // Signature shared by every implementation of the block moments kernel
+
+
+
+
+
+// -------------- Column Statistics Cache Structure Definition --------------
+/**
+ * ColumnStatisticsCache Structure: The data derived from one column that the statistical methods share, each item computed lazily, at
+ * most once, and kept for as long as the column is unchanged.
+ *
+ * - sourceVersion: The version of the column the cache was created from, the cache is stale once the column's version differs.
+ * - count: The number of present values of the column.
+ * - values: The present values, in row order.
+ * - rows: The row of the column each present value came from.
+ * - sortedValues: The present values in ascending order, NULL until first needed.
+ * - sortPermutation: The rows of the present values in the order of their values, NULL until first needed.
+ * - hasMoments: Whether 'moments' has been accumulated.
+ * - moments: The moments, minimum, and maximum of the present values.
+ */
+typedef struct
+{
+	uint64_t sourceVersion;
+	int count;
+	double *values;
+	int *rows;
+	
+	
+	double *sortedValues;
+	int *sortPermutation;
+	bool hasMoments;
+	MomentsAccumulator moments;
+} ColumnStatisticsCache;
+
+
+
+
+
+// -------------- Quantile Sketch Structure Definitions --------------
+/**
+ * QuantileSketch Structure: A KLL sketch, which summarizes a stream of values in bounded memory so that any of their quantiles can be
+ * estimated to within a known rank error(see 'create_quantile_sketch' and 'quantile_sketch_rank_error'). Sketches of disjoint
+ * values, e.g., of different chunks or threads, merge into the sketch of all of them with 'merge_quantile_sketches'.
+ *
+ * - k: The accuracy parameter, the capacity of the top level.
+ * - levelCount: The number of levels.
+ * - levels: The values retained at each level, a value at level h stands for 2^h of the values added.
+ * - levelSizes: The number of values retained at each level.
+ * - levelAllocations: The number of values each level's buffer can hold before it must grow.
+ * - retainedCount: The number of values retained over all levels.
+ * - retainedCapacity: The sum of the capacities of the levels, the sketch is compressed once it retains this many values.
+ * - count: The number of values added.
+ * - min: The smallest value added, exactly.
+ * - max: The largest value added, exactly.
+ * - randomState: The state of the generator choosing which half of a level is promoted.
+ */
+typedef struct
+{
+	int k;
+	int levelCount;
+	double **levels;
+	int *levelSizes;
+	int *levelAllocations;
+	int64_t retainedCount;
+	int64_t retainedCapacity;
+	
+	
+	int64_t count;
+	double min;
+	double max;
+	uint64_t randomState;
+} QuantileSketch;
+
+
+/**
+ * QuantileMode Enumeration: How the quantiles used by the binning methods are found.
+ *
+ * - QUANTILE_MODE_AUTOMATIC: Exactly if a copy of the data fits EXACT_QUANTILE_MEMORY_BUDGET, with a quantile sketch otherwise.
+ * - QUANTILE_MODE_EXACT: Exactly, by selection or sorting.
+ * - QUANTILE_MODE_SKETCH: Approximately, with a quantile sketch built in a single pass.
+ */
+typedef enum
+{
+	QUANTILE_MODE_AUTOMATIC,
+	QUANTILE_MODE_EXACT,
+	QUANTILE_MODE_SKETCH
+} QuantileMode;
+
+
 // ------------- Helper Functions for Generating and Sampling Data Sets  -------------
 /// \{
 double* get_uniform_samples(int *n, double min, double max, double step);
@@ -54,10 +306,70 @@ double* get_uniform_samples(int *n, double min, double max, double step);
 
 // ------------- Helper Functions For Computing and Handling Data Binning -------------
 /// \{
+void quartiles_of_order_statistics(const double *orderedData, int n, double *q25, double *q75); // Reads the quartiles from data whose quartile ranks are in their sorted positions.
+void compute_quartiles_by_selection(double *scratch, int n, double *q25, double *q75, double *minValue, double *maxValue); // Selects the quartiles, and optionally the extremes, of a dataset in place without sorting it.
+double compute_IQR_by_selection(double *scratch, int n, double *minValue, double *maxValue); // Computes the IQR, and optionally the extremes, of a dataset in place without sorting it.
 double compute_IQR(double* data, int n);
+void compute_quantiles(const double *data, int n, const double *probabilities, int quantileCount, double *quantiles); // Computes any set of quantiles of a dataset in expected linear time with one scratch buffer.
 double compute_bin_width(double *data, int n);
+double compute_bin_width_from_quartiles(double q25, double q75, int n); // Calculates the Freedman-Diaconis bin width from the quartiles of a dataset.
 int compute_optimal_num_bins(double *data, int n);
 Histogram compute_data_set_binning(double *data, int n);
+Histogram compute_data_set_binning_with_summary(const double *data, int n, double iqr, double min_value, double max_value); // Bins a dataset given its IQR and range.
+/// \}
+
+
+
+
+
+
+
+// ------------- Helper Functions for Binning Columns in Parallel -------------
+/// \{
+int freedman_diaconis_num_bins(double iqr, int n, double min_value, double max_value); // Calculates the number of bins given by the Freedman-Diaconis rule.
+void find_extremes_scalar(const double *data, int n, double *minValue, double *maxValue); // Finds the minimum and maximum one value at a time, available on every platform.
+#if defined(__x86_64__) || defined(__i386__)
+void find_extremes_avx2(const double *data, int n, double *minValue, double *maxValue); // Finds the minimum and maximum 16 values at a time with AVX2, only call if the processor supports it.
+#endif
+ExtremesKernel select_extremes_kernel(void); // Returns the fastest extremes kernel supported by the processor, chosen once at runtime.
+void compute_extremes(const double *data, int n, double *minValue, double *maxValue); // Finds the minimum and maximum in one fused pass, skipping NaN values.
+Histogram create_histogram(double min_value, double max_value, int num_bins); // Creates a histogram of empty equal-width bins spanning a range.
+void free_histogram(Histogram *histogram); // Releases the bins and bin edges of a histogram.
+void *bin_histogram_rows(void *task); // Thread routine counting a range of rows into private bins.
+void bin_data_columns(Histogram *histograms, const double *const *columns, const uint64_t *const *validity, int columnCount, int n, int threadCount); // Counts several columns into their histograms in one parallel pass, skipping nulls.
+Histogram *compute_data_columns_binning(const double *const *columns, const uint64_t *const *validity, const double *iqrs, int columnCount, int n, int threadCount); // Bins the present values of several columns of a table at once.
+/// \}
+
+
+
+
+
+
+
+// ------------- Helper Functions for Binning Streams in Fixed Memory -------------
+/// \{
+StreamingHistogram *create_streaming_histogram(int maxBins); // Creates an empty streaming histogram of at most maxBins bins.
+void free_streaming_histogram(StreamingHistogram *histogram); // Releases a streaming histogram.
+void insert_streaming_histogram_bins(StreamingHistogram *histogram, const StreamingHistogramBin *newBins, int newBinCount); // Merges sorted new bins in, then merges the closest bins down to maxBins.
+void add_value_to_streaming_histogram(StreamingHistogram *histogram, double value); // Adds a single value, skipping NaN.
+void add_values_to_streaming_histogram(StreamingHistogram *histogram, const double *data, int n); // Adds a batch of values, skipping NaN values.
+void merge_streaming_histograms(StreamingHistogram *histogram, const StreamingHistogram *otherHistogram); // Merges the histogram of other values into a histogram.
+double streaming_histogram_count_below(const StreamingHistogram *histogram, double x); // Estimates the number of values no greater than x.
+Histogram streaming_histogram_to_histogram(const StreamingHistogram *streamingHistogram, int num_bins); // Converts to a Histogram of equal-width bins.
+/// \}
+
+
+
+
+
+
+
+// ------------- Helper Functions for Relating Columns to Each Other -------------
+/// \{
+void rank_transform_column(const double *data, const uint64_t *validity, int n, double *ranks); // Replaces the present values by their ranks, averaging ties.
+void pack_correlation_panel(const CorrelationTileTask *task, int firstColumn, int columnCount, int rowStart, int rowCount, double *values, double *presence); // Packs a range of rows of a block of columns, centered, into a panel.
+void *compute_correlation_tiles(void *task); // Thread routine accumulating the pairwise sums of its share of the tiles.
+double *compute_correlation_matrix(const double *const *columns, const uint64_t *const *validity, int columnCount, int n, CorrelationMethod method, int threadCount); // Computes the covariance or correlation of every pair of columns, excluding missing values pairwise.
 /// \}
 
 
@@ -67,9 +379,10 @@ Histogram compute_data_set_binning(double *data, int n);
 
 // ------------- Helper Functions to Determine Various Statistical Properties of Data Sets -------------
 /// \{
-double compute_average(double* data, int n);
+double compute_mean(double* data, int n);
 double compute_standard_deviation(double* data, int n, double mean);
 double compute_skewness(double *data, int n);
+double compute_kurtosis(double *data, int n); // Computes the excess kurtosis, a measure of the weight of the tails of a distribution relative to the normal distribution.
 double compute_normal_cdf(double x, double mu, double sigma);
 /// \}
 
@@ -78,6 +391,90 @@ double compute_normal_cdf(double x, double mu, double sigma);
 
 
 
+// ------------- Helper Functions for Accumulating Moments in a Single Pass -------------
+/// \{
+MomentsAccumulator create_moments_accumulator(void); // Creates an accumulator holding no values.
+MomentsAccumulator compute_block_moments_scalar(const double *block, int blockLength); // Computes the moments of a block one value at a time, available on every platform.
+#if defined(__x86_64__) || defined(__i386__)
+MomentsAccumulator compute_block_moments_sse2(const double *block, int blockLength); // Computes the moments of a block 4 values at a time with SSE2.
+MomentsAccumulator compute_block_moments_avx2(const double *block, int blockLength); // Computes the moments of a block 8 values at a time with AVX2, only call if the processor supports it.
+#endif
+BlockMomentsKernel select_block_moments_kernel(void); // Returns the fastest block moments kernel supported by the processor, chosen once at runtime.
+void merge_moments_accumulators(MomentsAccumulator *moments, const MomentsAccumulator *otherMoments); // Merges the accumulator of other values into an accumulator.
+void accumulate_moments(MomentsAccumulator *moments, const double *data, int n); // Adds values to an accumulator, a block at a time, skipping NaN values.
+void accumulate_moments_of_valid_values(MomentsAccumulator *moments, const double *data, const uint64_t *validity, int n); // Adds the values present in a validity bitmap to an accumulator.
+double moments_standard_deviation(const MomentsAccumulator *moments); // The standard deviation of the accumulated values.
+double moments_skewness(const MomentsAccumulator *moments); // The skewness of the accumulated values, as computed by 'compute_skewness'.
+double moments_excess_kurtosis(const MomentsAccumulator *moments); // The excess kurtosis of the accumulated values.
+/// \}
+
+
+
+
+
+
+// ------------- Helper Functions for Skipping Missing Values Marked in Validity Bitmaps -------------
+/// \{
+int gather_valid_values(const double *data, const uint64_t *validity, int n, double *validValues); // Copies the present values into a dense array, a word of 64 values at a time.
+double compute_mean_of_valid_values(const double *data, const uint64_t *validity, int n); // Computes the mean of the present values only.
+double compute_standard_deviation_of_valid_values(const double *data, const uint64_t *validity, int n, double mean); // Computes the standard deviation of the present values only.
+double compute_IQR_of_valid_values(const double *data, const uint64_t *validity, int n); // Computes the IQR of the present values only.
+Histogram compute_data_set_binning_of_valid_values(const double *data, const uint64_t *validity, int n); // Bins the present values only.
+/// \}
+
+
+
+
+
+
+
+// ------------- Helper Functions for Sharing Derived Data of a Column Between Statistical Methods -------------
+/// \{
+ColumnStatisticsCache *create_column_statistics_cache(const double *data, const uint64_t *validity, int n, uint64_t sourceVersion); // Creates the cache of a column's present values, deriving nothing yet.
+void free_column_statistics_cache(ColumnStatisticsCache *cache); // Releases a column statistics cache and everything derived into it.
+const double *cached_sorted_values(ColumnStatisticsCache *cache); // The present values in ascending order, sorted once.
+const int *cached_sort_permutation(ColumnStatisticsCache *cache); // The rows of the present values in sorted order, from the same sort.
+const MomentsAccumulator *cached_moments(ColumnStatisticsCache *cache); // The moments of the present values, accumulated once.
+void cached_extremes(ColumnStatisticsCache *cache, double *minValue, double *maxValue); // The minimum and maximum, from whichever derived item already holds them.
+double compute_IQR_of_cached_column(ColumnStatisticsCache *cache); // Computes the IQR from the shared sorted values.
+double compute_bin_width_of_cached_column(ColumnStatisticsCache *cache); // Calculates the bin width from the shared sorted values.
+Histogram compute_data_set_binning_of_cached_column(ColumnStatisticsCache *cache); // Bins the present values with the IQR and range from the shared sorted values.
+double anderson_darling_normality_test_of_cached_column(ColumnStatisticsCache *cache); // Performs the Anderson-Darling test with the shared sorted values and moments.
+/// \}
+
+
+
+
+
+
+
+// ------------- Helper Functions for Estimating Quantiles in a Single Pass with Bounded Memory -------------
+/// \{
+QuantileSketch *create_quantile_sketch(int k, uint64_t seed); // Creates an empty KLL quantile sketch with accuracy parameter k, its generator seeded from seed.
+void free_quantile_sketch(QuantileSketch *sketch); // Releases a quantile sketch.
+int quantile_sketch_level_capacity(const QuantileSketch *sketch, int level); // The number of values a level holds before it is compacted.
+void add_quantile_sketch_level(QuantileSketch *sketch); // Adds an empty level to the top of a sketch.
+void append_to_quantile_sketch_level(QuantileSketch *sketch, int level, double value); // Appends a value to a level of a sketch.
+void compact_quantile_sketch_level(QuantileSketch *sketch, int level); // Promotes every other value of a sorted level to the level above.
+void compress_quantile_sketch(QuantileSketch *sketch); // Compacts levels until the sketch is within its capacity.
+void add_values_to_quantile_sketch(QuantileSketch *sketch, const double *data, int n); // Adds values to a sketch, skipping NaN values.
+void merge_quantile_sketches(QuantileSketch *sketch, const QuantileSketch *otherSketch); // Merges the sketch of other values into a sketch.
+void quantile_sketch_quantiles(const QuantileSketch *sketch, const double *probabilities, int quantileCount, double *quantiles); // Estimates any number of quantiles from one sort of the retained values.
+double quantile_sketch_quantile(const QuantileSketch *sketch, double probability); // Estimates a single quantile.
+double quantile_sketch_rank_error(const QuantileSketch *sketch); // The normalized rank error of the estimated quantiles, with 99% confidence.
+QuantileMode resolve_quantile_mode(QuantileMode mode, int n); // Decides between exact and sketched quantiles for a number of values.
+double compute_IQR_of_sketch(const QuantileSketch *sketch); // Estimates the IQR from a sketch.
+double compute_bin_width_of_sketch(const QuantileSketch *sketch); // Calculates the Freedman-Diaconis bin width from a sketch.
+double compute_IQR_in_mode(double *data, int n, QuantileMode mode); // Computes the IQR exactly or with a sketch.
+double compute_bin_width_in_mode(double *data, int n, QuantileMode mode); // Calculates the bin width exactly or with a sketch.
+Histogram compute_data_set_binning_in_mode(double *data, int n, QuantileMode mode); // Bins a dataset with its IQR found exactly or with a sketch.
+/// \}
+
+
+
+
+
+
 // ------------- Helper Functions for Computing and Integrating Various Statistical Distributions -------------
 /// \{
 double* compute_gaussian(int n, double x[]);
@@ -92,6 +489,7 @@ double* gaussian_riemann_sum_integration(int n, double x[], double f[]);
 // ------------- Helper Functions for Performing Statistical Tests to Assess the Normality of Data Sets -------------
 /// \{
 double anderson_darling_normality_test(double* data, int n);
+double anderson_darling_normality_test_of_sorted_values(const double *sortedData, int n, double mean, double std_dev); // The Anderson-Darling statistic of sorted data with a known mean and standard deviation.
 //one of three general normality tests designed to detect all departures from normality
 /// \}
 
@@ -8,6 +8,9 @@
 #include "GeneralUtilities.h"
 #include "DebuggingUtilities.h"
 #include <ctype.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
 
 
 
@@ -122,6 +125,253 @@ bool char_is_delimiter(char c)
 
 
 
+
+/**
+ * scan_structural_characters_scalar
+ *
+ * Builds the delimiter, quote, and newline masks of a block of up to 64 bytes by examining it one byte at a time.
+ * This is the portable implementation, used on processors without a vectorized scan and as the reference the vectorized
+ * scans must agree with. Each comparison is turned into a bit without branching, so compilers are free to vectorize it.
+ *
+ * @param block Pointer to the first byte of the block, only the first 'blockLength' bytes are read.
+ * @param blockLength The number of bytes in the block, at most 64(any more are ignored).
+ * @param delimiter The delimiter character to mark.
+ * @return The masks of the block, bits beyond 'blockLength' are 0.
+ */
+StructuralCharacterMasks scan_structural_characters_scalar(const char *block, size_t blockLength, char delimiter)
+{
+	StructuralCharacterMasks masks = { 0, 0, 0 };
+	if (blockLength > 64)
+	{
+		blockLength = 64;
+	}
+	
+	
+	for (size_t i = 0; i < blockLength; i++)
+	{
+		masks.delimiterMask |= (uint64_t)(block[i] == delimiter) << i;
+		masks.quoteMask |= (uint64_t)(block[i] == '"') << i;
+		masks.newlineMask |= (uint64_t)(block[i] == '\n') << i;
+	}
+	
+	return masks;
+}
+
+
+
+
+#if defined(__x86_64__) || defined(__i386__)
+/**
+ * scan_structural_characters_sse2
+ *
+ * Builds the delimiter, quote, and newline masks of a block of up to 64 bytes, comparing 16 bytes at a time with SSE2.
+ * Each comparison yields a vector of 0x00/0xFF bytes whose high bits 'movemask' packs into 16 bits of the mask.
+ * A partial block is copied into a zero-filled 64-byte buffer first so that no byte past the end of the block is ever read.
+ *
+ * @param block Pointer to the first byte of the block, only the first 'blockLength' bytes are read.
+ * @param blockLength The number of bytes in the block, at most 64(any more are ignored).
+ * @param delimiter The delimiter character to mark.
+ * @return The masks of the block, bits beyond 'blockLength' are 0.
+ */
+StructuralCharacterMasks scan_structural_characters_sse2(const char *block, size_t blockLength, char delimiter)
+{
+	char paddedBlock[64];
+	uint64_t validMask = ~(uint64_t)0;
+	if (blockLength < 64)
+	{
+		set_memory_block(paddedBlock, 0, sizeof(paddedBlock));
+		memcpy(paddedBlock, block, blockLength);
+		block = paddedBlock;
+		validMask = ((uint64_t)1 << blockLength) - 1;
+	}
+	
+	
+	const __m128i delimiters = _mm_set1_epi8(delimiter);
+	const __m128i quotes = _mm_set1_epi8('"');
+	const __m128i newlines = _mm_set1_epi8('\n');
+	StructuralCharacterMasks masks = { 0, 0, 0 };
+	for (int i = 0; i < 64; i += 16)
+	{
+		__m128i bytes = _mm_loadu_si128((const __m128i *)(block + i));
+		masks.delimiterMask |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, delimiters)) << i;
+		masks.quoteMask |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, quotes)) << i;
+		masks.newlineMask |= (uint64_t)(uint16_t)_mm_movemask_epi8(_mm_cmpeq_epi8(bytes, newlines)) << i;
+	}
+	
+	
+	masks.delimiterMask &= validMask; // A '\0' delimiter would otherwise match the padding
+	masks.quoteMask &= validMask;
+	masks.newlineMask &= validMask;
+	return masks;
+}
+
+
+
+
+/**
+ * scan_structural_characters_avx2
+ *
+ * Builds the delimiter, quote, and newline masks of a block of up to 64 bytes, comparing 32 bytes at a time with AVX2.
+ * Compiled for AVX2 regardless of the flags the rest of the program is built with, so it must only be called once
+ * 'select_structural_character_scanner' has confirmed that the processor supports AVX2.
+ *
+ * @param block Pointer to the first byte of the block, only the first 'blockLength' bytes are read.
+ * @param blockLength The number of bytes in the block, at most 64(any more are ignored).
+ * @param delimiter The delimiter character to mark.
+ * @return The masks of the block, bits beyond 'blockLength' are 0.
+ */
+__attribute__((target("avx2")))
+StructuralCharacterMasks scan_structural_characters_avx2(const char *block, size_t blockLength, char delimiter)
+{
+	char paddedBlock[64];
+	uint64_t validMask = ~(uint64_t)0;
+	if (blockLength < 64)
+	{
+		set_memory_block(paddedBlock, 0, sizeof(paddedBlock));
+		memcpy(paddedBlock, block, blockLength);
+		block = paddedBlock;
+		validMask = ((uint64_t)1 << blockLength) - 1;
+	}
+	
+	
+	const __m256i delimiters = _mm256_set1_epi8(delimiter);
+	const __m256i quotes = _mm256_set1_epi8('"');
+	const __m256i newlines = _mm256_set1_epi8('\n');
+	__m256i lowBytes = _mm256_loadu_si256((const __m256i *)block);
+	__m256i highBytes = _mm256_loadu_si256((const __m256i *)(block + 32));
+	
+	StructuralCharacterMasks masks;
+	masks.delimiterMask = (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lowBytes, delimiters)) | (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(highBytes, delimiters)) << 32;
+	masks.quoteMask = (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lowBytes, quotes)) | (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(highBytes, quotes)) << 32;
+	masks.newlineMask = (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(lowBytes, newlines)) | (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(highBytes, newlines)) << 32;
+	
+	
+	masks.delimiterMask &= validMask; // A '\0' delimiter would otherwise match the padding
+	masks.quoteMask &= validMask;
+	masks.newlineMask &= validMask;
+	return masks;
+}
+#endif
+
+
+
+
+/**
+ * select_structural_character_scanner
+ *
+ * Chooses the fastest structural character scan the processor supports: AVX2, then SSE2(always present on x86-64), and the
+ * scalar scan on any other architecture. The choice is made on the first call and remembered, so hot loops can call this once
+ * and then call the returned function directly for every block.
+ *
+ * @return The selected scan implementation.
+ */
+StructuralCharacterScanner select_structural_character_scanner(void)
+{
+	static _Atomic(StructuralCharacterScanner) selectedScanner = NULL; // Threads racing to make the first selection all choose the same scan
+	StructuralCharacterScanner scanner = selectedScanner;
+	if (scanner == NULL)
+	{
+#if defined(__x86_64__) || defined(__i386__)
+		__builtin_cpu_init();
+		scanner = __builtin_cpu_supports("avx2") ? scan_structural_characters_avx2 : scan_structural_characters_sse2;
+#else
+		scanner = scan_structural_characters_scalar;
+#endif
+		selectedScanner = scanner;
+	}
+	
+	return scanner;
+}
+
+
+
+
+/**
+ * structural_character_scanner_name
+ *
+ * Returns the name of a structural character scan implementation, for reporting which one was selected.
+ *
+ * @param scanner The scan implementation.
+ * @return "avx2", "sse2", "scalar", or "unknown".
+ */
+const char *structural_character_scanner_name(StructuralCharacterScanner scanner)
+{
+#if defined(__x86_64__) || defined(__i386__)
+	if (scanner == scan_structural_characters_avx2)
+	{
+		return "avx2";
+	}
+	if (scanner == scan_structural_characters_sse2)
+	{
+		return "sse2";
+	}
+#endif
+	if (scanner == scan_structural_characters_scalar)
+	{
+		return "scalar";
+	}
+	
+	return "unknown";
+}
+
+
+
+
+/**
+ * scan_structural_characters
+ *
+ * Builds the delimiter, quote, and newline masks of a block of up to 64 bytes with the fastest implementation the processor supports.
+ *
+ * @param block Pointer to the first byte of the block, only the first 'blockLength' bytes are read.
+ * @param blockLength The number of bytes in the block, at most 64(any more are ignored).
+ * @param delimiter The delimiter character to mark.
+ * @return The masks of the block, bits beyond 'blockLength' are 0.
+ */
+StructuralCharacterMasks scan_structural_characters(const char *block, size_t blockLength, char delimiter)
+{
+	return select_structural_character_scanner()(block, blockLength, delimiter);
+}
+
+
+
+
+/**
+ * compute_quoted_region_mask
+ *
+ * Converts the quote mask of a block into the mask of the bytes that lie inside quoted fields, without visiting the quotes one by one.
+ * Bit 'i' of the result is the parity of the quotes at or before byte 'i'(a prefix XOR, computed in six shift-and-XOR steps),
+ * flipped if the block begins inside a quoted field. An opening quote and everything up to its closing quote are marked, the
+ * closing quote is not. An escaped quote("") toggles the state twice and so has no effect, exactly as in a byte-by-byte scan.
+ *
+ * @param quoteMask The quote mask of the block.
+ * @param insideQuotes Pointer to the quote state at the start of the block(nonzero if inside a quoted field), updated to the state at its end.
+ * @return The mask of the bytes of the block lying inside quoted fields.
+ */
+uint64_t compute_quoted_region_mask(uint64_t quoteMask, int *insideQuotes)
+{
+	uint64_t quotedRegionMask = quoteMask;
+	quotedRegionMask ^= quotedRegionMask << 1;
+	quotedRegionMask ^= quotedRegionMask << 2;
+	quotedRegionMask ^= quotedRegionMask << 4;
+	quotedRegionMask ^= quotedRegionMask << 8;
+	quotedRegionMask ^= quotedRegionMask << 16;
+	quotedRegionMask ^= quotedRegionMask << 32;
+	if (*insideQuotes)
+	{
+		quotedRegionMask = ~quotedRegionMask;
+	}
+	
+	*insideQuotes = (int)(quotedRegionMask >> 63);
+	return quotedRegionMask;
+}
+
+
+
+
+
+
+
+
 size_t string_length(const char *characterString)
 {
 	register const char *s; // The 'register' keyword is a hint to the compiler to store the variable in a CPU register for faster access(though 'register' is mostly deprecated in modern C).
@@ -200,7 +450,7 @@ int count_character_occurrences(const char *characterString, char c)
 /**
  * string_is_numeric
  *
- * Determines if a string represents a valid double value.
+ * Determines if a string represents a valid double value, with the semantics of strtod, by way of 'parse_numeric_string'.
  * Used to handle cases where the use of some character is in question during string parsing for
  * determining whether the character is being used as a numeric sign, punctuation, or is some unknown
  * use like a place holder for blank values in a data set like a space or hyphen.
@@ -213,15 +463,306 @@ bool string_is_numeric(const char *characterString)
 	// Check for NULL input and handle error.
 	if (characterString == NULL){ perror("\n\nError: characterString was NULL in 'string_is_numeric'.\n");      return NULL; }
 	
-	char* end;
-	strtod(characterString, &end);  // Parses the string as a floating-point number
-	if (end != characterString && *end == '\0')
+	double value;
+	return parse_numeric_string(characterString, string_length(characterString), &value); // Parses the string as a floating-point number
+}
+
+
+
+
+/**
+ * compute_double_from_decimal
+ *
+ * Converts a decimal number, given as its significand and power of ten(significand * 10^exponent), to the nearest double.
+ * When both the significand and the power of ten are exactly representable as doubles(Clinger's fast path), a single
+ * floating-point multiplication or division is correctly rounded. Otherwise the Eisel-Lemire algorithm multiplies the normalized
+ * significand by the 128-bit truncated power of five from 'powersOfFiveTable', which determines the correctly rounded result
+ * unless the product lies too close to a halfway point between two doubles, the only case in which it reports failure.
+ *
+ * @param significand The decimal significand, at most 19 digits.
+ * @param exponent The power of ten by which the significand is multiplied.
+ * @param negative True if the number is negative.
+ * @param success Pointer to a variable set to false if the number could not be converted exactly and must be converted by other means.
+ * @return The correctly rounded double, or 0.0 if 'success' was set to false.
+ */
+double compute_double_from_decimal(uint64_t significand, int64_t exponent, bool negative, bool *success)
+{
+	static const double exactPowersOfTen[23] =
+	{
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+	*success = true;
+	if (significand == 0)
+	{
+		return negative ? -0.0 : 0.0;
+	}
+	
+	
+	/// Clinger's fast path, both operands are exact so the one rounding of the operation is the correct rounding
+	if (exponent >= -22 && exponent <= 22 && significand <= ((uint64_t)1 << 53))
 	{
-		return true; // numeric
+		double value = (double)significand;
+		value = (exponent < 0) ? value / exactPowersOfTen[-exponent] : value * exactPowersOfTen[exponent];
+		return negative ? -value : value;
 	}
-	else
+	if (exponent < POWERS_OF_FIVE_SMALLEST_EXPONENT || exponent > POWERS_OF_FIVE_LARGEST_EXPONENT)
+	{
+		*success = false;
+		return 0.0;
+	}
+	
+	
+	/// Eisel-Lemire, multiply the normalized significand by the high 64 bits of 5^exponent
+	const uint64_t *powerOfFive = powersOfFiveTable[exponent - POWERS_OF_FIVE_SMALLEST_EXPONENT];
+	int64_t binaryExponent = (((152170 + 65536) * exponent) >> 16) + 1024 + 63; // floor(exponent * log2(10)) + bias + 63
+	int leadingZeros = __builtin_clzll(significand);
+	significand <<= leadingZeros;
+	
+	unsigned __int128 product = (unsigned __int128)significand * powerOfFive[0];
+	uint64_t lower = (uint64_t)product;
+	uint64_t upper = (uint64_t)(product >> 64);
+	if ((upper & 0x1FF) == 0x1FF && lower + significand < lower) // The truncated bits of the power could change the result, include the next 64 of them
+	{
+		unsigned __int128 lowProduct = (unsigned __int128)significand * powerOfFive[1];
+		uint64_t productLow = (uint64_t)lowProduct;
+		uint64_t productMiddle = lower + (uint64_t)(lowProduct >> 64);
+		if (productMiddle < lower)
+		{
+			upper++;
+		}
+		if (productMiddle + 1 == 0 && (upper & 0x1FF) == 0x1FF && productLow + significand < productLow)
+		{
+			*success = false;
+			return 0.0;
+		}
+		lower = productMiddle;
+	}
+	
+	
+	/// Round the top 54 bits of the product to 53, ties to even
+	uint64_t upperBit = upper >> 63;
+	uint64_t mantissa = upper >> (upperBit + 9);
+	leadingZeros += (int)(1 ^ upperBit);
+	if (lower == 0 && (upper & 0x1FF) == 0 && (mantissa & 3) == 1) // Exactly halfway, the truncated power can not tell which way to round
+	{
+		*success = false;
+		return 0.0;
+	}
+	mantissa += mantissa & 1;
+	mantissa >>= 1;
+	if (mantissa >= ((uint64_t)1 << 53)) // Rounding carried into a new bit
+	{
+		mantissa = (uint64_t)1 << 52;
+		leadingZeros--;
+	}
+	mantissa &= ~((uint64_t)1 << 52);
+	
+	
+	int64_t biasedExponent = binaryExponent - leadingZeros;
+	if (biasedExponent < 1 || biasedExponent > 2046) // Subnormal or infinite, left to the fallback
+	{
+		*success = false;
+		return 0.0;
+	}
+	uint64_t bits = mantissa | ((uint64_t)biasedExponent << 52) | ((uint64_t)negative << 63);
+	double value;
+	copy_memory_block(&value, &bits, sizeof(value));
+	return value;
+}
+
+
+
+
+/**
+ * parse_integer_string
+ *
+ * Determines whether the whole of a string is a decimal integer([sign]digits) that fits in 64 bits and converts it in the same pass.
+ * Such values(counters, identifiers, Unix times) are stored exactly as integers, every other number is left to 'parse_numeric_string'.
+ *
+ * @param characterString Pointer to the characters to be interpreted, they need not be null-terminated.
+ * @param length The number of characters to interpret.
+ * @param value Pointer to a variable in which to store the integer, it is only modified if the string is an integer.
+ * @return true if the whole string is an integer within the range of int64_t, false otherwise.
+ */
+bool parse_integer_string(const char *characterString, size_t length, int64_t *value)
+{
+	size_t position = 0;
+	bool negative = false;
+	if (length > 0 && (characterString[0] == '-' || characterString[0] == '+'))
+	{
+		negative = (characterString[0] == '-');
+		position++;
+	}
+	if (position == length)
+	{
+		return false;
+	}
+	
+	
+	uint64_t magnitude = 0;
+	uint64_t limit = negative ? (uint64_t)INT64_MAX + 1 : (uint64_t)INT64_MAX;
+	for (; position < length; position++)
+	{
+		if (!char_is_digit(characterString[position]))
+		{
+			return false;
+		}
+		uint64_t digit = (uint64_t)(characterString[position] - '0');
+		if (magnitude > (limit - digit) / 10)
+		{
+			return false; // Out of range
+		}
+		magnitude = magnitude * 10 + digit;
+	}
+	
+	*value = negative ? (int64_t)(0 - magnitude) : (int64_t)magnitude;
+	return true;
+}
+
+
+
+
+/**
+ * parse_numeric_string
+ *
+ * Determines whether a string is numeric and converts it to a double in the same call, so that a field never has to be parsed twice.
+ * The result is the same as that of strtod: 'value' receives the value of the longest prefix of the string that is a number(0.0 if
+ * there is none, as with atof), and the string is numeric if that prefix is the whole string.
+ *
+ * Plain decimal numbers([sign]digits[.digits][e[sign]digits], with at most 19 significant digits) are parsed by hand and converted with
+ * 'compute_double_from_decimal'. Anything else strtod accepts(leading whitespace, hexadecimal, infinity and NaN, longer significands,
+ * and the rare number the fast conversion cannot round) falls back to strtod on a null-terminated copy. Strings that can not begin a
+ * number at all are rejected without calling strtod.
+ *
+ * @param characterString Pointer to the characters to be interpreted, they need not be null-terminated.
+ * @param length The number of characters to interpret.
+ * @param value Pointer to a variable in which to store the value of the number.
+ * @return true if the whole string is a number, false otherwise.
+ */
+bool parse_numeric_string(const char *characterString, size_t length, double *value)
+{
+	const char *position = characterString;
+	const char *end = characterString + length;
+	*value = 0.0;
+	if (length == 0)
+	{
+		return false;
+	}
+	if (char_is_whitespace(*position))
+	{
+		goto fallback; // strtod skips leading whitespace
+	}
+	
+	
+	bool negative = false;
+	if (*position == '-' || *position == '+')
+	{
+		negative = (*position == '-');
+		position++;
+	}
+	if (position + 1 < end && position[0] == '0' && (position[1] == 'x' || position[1] == 'X'))
+	{
+		goto fallback; // Hexadecimal
+	}
+	
+	
+	/// Accumulate the significant digits of the integer and fractional parts, leading zeros are not significant
+	uint64_t significand = 0;
+	int64_t exponent = 0;
+	int significantDigitCount = 0;
+	bool foundDigit = false;
+	for (; position < end && char_is_digit(*position); position++)
+	{
+		foundDigit = true;
+		if (significand == 0 && *position == '0')
+		{
+			continue;
+		}
+		significand = significand * 10 + (uint64_t)(*position - '0');
+		significantDigitCount++;
+	}
+	if (position < end && *position == '.')
+	{
+		position++;
+		for (; position < end && char_is_digit(*position); position++)
+		{
+			foundDigit = true;
+			exponent--;
+			if (significand == 0 && *position == '0')
+			{
+				continue;
+			}
+			significand = significand * 10 + (uint64_t)(*position - '0');
+			significantDigitCount++;
+		}
+	}
+	if (!foundDigit)
+	{
+		const char *first = characterString + (negative || *characterString == '+');
+		if (first < end && (*first == 'i' || *first == 'I' || *first == 'n' || *first == 'N'))
+		{
+			goto fallback; // Infinity or NaN
+		}
+		return false; // Nothing strtod could parse
+	}
+	if (significantDigitCount > 19)
+	{
+		goto fallback; // The significand may not fit in 64 bits
+	}
+	
+	
+	/// The exponent is only part of the number if at least one digit follows the 'e' and its sign
+	if (position < end && (*position == 'e' || *position == 'E'))
 	{
-		return false; // nonnumeric
+		const char *exponentPosition = position + 1;
+		bool negativeExponent = false;
+		if (exponentPosition < end && (*exponentPosition == '-' || *exponentPosition == '+'))
+		{
+			negativeExponent = (*exponentPosition == '-');
+			exponentPosition++;
+		}
+		if (exponentPosition < end && char_is_digit(*exponentPosition))
+		{
+			int64_t explicitExponent = 0;
+			for (; exponentPosition < end && char_is_digit(*exponentPosition); exponentPosition++)
+			{
+				if (explicitExponent < 100000) // Far beyond the range of a double either way
+				{
+					explicitExponent = explicitExponent * 10 + (*exponentPosition - '0');
+				}
+			}
+			exponent += negativeExponent ? -explicitExponent : explicitExponent;
+			position = exponentPosition;
+		}
+	}
+	
+	
+	bool success;
+	double convertedValue = compute_double_from_decimal(significand, exponent, negative, &success);
+	if (success)
+	{
+		*value = convertedValue;
+		return position == end;
+	}
+	
+	
+fallback:
+	{
+		char buffer[64];
+		char *numberString = (length < sizeof(buffer)) ? buffer : (char *)malloc(length + 1);
+		copy_memory_block(numberString, characterString, length);
+		numberString[length] = '\0';
+		
+		char *numberEnd;
+		*value = strtod(numberString, &numberEnd);
+		bool isNumeric = (numberEnd != numberString && *numberEnd == '\0');
+		
+		if (numberString != buffer)
+		{
+			free(numberString);
+		}
+		return isNumeric;
 	}
 }
 
@@ -270,9 +811,8 @@ bool string_is_hyphen_else_is_minus_sign(char *characterString)
 	if (characterString == NULL){ perror("\n\nError: characterString was NULL in 'string_is_hyphen_else_is_minus_sign'.\n");      return NULL; }
 	
 	
-	char* end;
-	strtod(characterString, &end);
-	return end != characterString && *end == '\0';
+	double value;
+	return parse_numeric_string(characterString, string_length(characterString), &value);
 }
 
 
@@ -308,7 +848,8 @@ int* string_is_date_time(const char *characterString, const char *delimiter, con
 	char *copyOfString = duplicate_string(characterString);     // Create a duplicate of the input string because 'duplicate_string' modifies the string it processes.
 	
 	// Tokenize the duplicated string using the provided delimiter.
-	char *token = tokenize_string(copyOfString, delimiter);
+	StringTokenizer tokenizer = create_string_tokenizer(copyOfString, delimiter);
+	char *token = next_string_token(&tokenizer);
 	int index = 0; // Index for tracking current field.
 	
 	
@@ -319,8 +860,8 @@ int* string_is_date_time(const char *characterString, const char *delimiter, con
 		bool foundDateTime = false; // Flag to indicate if a date/time format is found.
 		
 		
-		// Iterate over the common date/time formats.
-		for (int i = 0; i < ARRAY_SIZE(commonDateTimeFormats); i++)
+		// Iterate over the common date/time formats, all of which contain a ':', so a field without one can be skipped.
+		for (int i = 0; i < ARRAY_SIZE(commonDateTimeFormats) && strchr(token, ':') != NULL; i++)
 		{
 			// Reset the tm struct for each format.
 			set_memory_block(&tm, 0, sizeof(struct tm));
@@ -347,7 +888,7 @@ int* string_is_date_time(const char *characterString, const char *delimiter, con
 		
 		// Increment the index and move to the next field(token) in the string.
 		index++;
-		token = tokenize_string(NULL, delimiter);
+		token = next_string_token(&tokenizer);
 	}
 	// Cleanup
 	free(copyOfString);
@@ -358,6 +899,293 @@ int* string_is_date_time(const char *characterString, const char *delimiter, con
 
 
 
+
+/**
+ * string_to_unix_time
+ *
+ * Checks if a whole string matches one of the 'commonDateTimeFormats' and, if it does, converts it to Unix time, parsing the string
+ * only as many times as it takes to find the matching format. The result is the same as 'string_is_date_time' followed by
+ * 'convert_to_unix_time', which parses the string again from the first format: the formats preceding the match fail again, and
+ * any later format is only tried if the matched time can not be represented(mktime fails).
+ *
+ * @param characterString The string to be checked and converted.
+ * @param unixTime Pointer to a variable in which to store the Unix time, or -1 if the date/time can not be represented.
+ * @return true if the string matches a date/time format, false otherwise(in which case 'unixTime' is not modified).
+ */
+bool string_to_unix_time(const char *characterString, time_t *unixTime)
+{
+	return match_date_time_format(characterString, unixTime) >= 0;
+}
+
+
+
+
+/**
+ * match_date_time_format
+ *
+ * Finds the first of the 'commonDateTimeFormats' that 'strptime' matches against the whole of a string and converts the string to
+ * Unix time with 'mktime', moving on to the later formats only if the time can not be represented. Every one of the formats has a
+ * ':' between its hours and minutes, so a string without one is rejected before any format is tried.
+ *
+ * @param characterString The string to be checked and converted.
+ * @param unixTime Pointer to a variable in which to store the Unix time, or -1 if the date/time can not be represented.
+ * @return The index of the format the Unix time was converted with, or -1 if no format matches(in which case 'unixTime' is not modified).
+ */
+int match_date_time_format(const char *characterString, time_t *unixTime)
+{
+	if (strchr(characterString, ':') == NULL)
+	{
+		return -1;
+	}
+	
+	
+	int matchedFormat = -1;
+	for (int i = 0; i < (int)ARRAY_SIZE(commonDateTimeFormats); i++)
+	{
+		struct tm tm; // Holds the parsed date/time values.
+		set_memory_block(&tm, 0, sizeof(struct tm));
+		
+		char *parsed = strptime(characterString, commonDateTimeFormats[i], &tm);
+		if (parsed != NULL && *parsed == '\0')
+		{
+			matchedFormat = i;
+			*unixTime = mktime(&tm);
+			if (*unixTime != -1)
+			{
+				break;
+			}
+		}
+	}
+	
+	return matchedFormat;
+}
+
+
+
+
+/**
+ * compile_date_time_format
+ *
+ * Compiles one of the 'commonDateTimeFormats' into the sequence of components it is made of: each conversion becomes the component
+ * reading its number(or AM/PM), each whitespace character a component skipping any amount of whitespace, and every other character
+ * a literal that must match exactly. No offset from UTC is cached yet.
+ *
+ * @param formatIndex The index of the format in 'commonDateTimeFormats', or -1 for a column whose format has not been detected yet.
+ * @return The compiled format, whose 'formatIndex' is -1 if the index is out of range or the format uses an unsupported conversion.
+ */
+DateTimeFormat compile_date_time_format(int formatIndex)
+{
+	DateTimeFormat format;
+	set_memory_block(&format, 0, sizeof(DateTimeFormat));
+	format.formatIndex = -1;
+	format.cachedDay = INT64_MIN;
+	if (formatIndex < 0 || formatIndex >= (int)ARRAY_SIZE(commonDateTimeFormats))
+	{
+		return format;
+	}
+	
+	
+	for (const char *formatPtr = commonDateTimeFormats[formatIndex]; *formatPtr != '\0'; formatPtr++)
+	{
+		if (format.componentCount == DATE_TIME_FORMAT_MAX_COMPONENTS)
+		{
+			format.componentCount = 0;
+			return format;
+		}
+		
+		DateTimeComponent component = DATE_TIME_LITERAL;
+		if (char_is_whitespace(*formatPtr))
+		{
+			component = DATE_TIME_WHITESPACE;
+		}
+		else if (*formatPtr == '%')
+		{
+			switch (*++formatPtr)
+			{
+				case 'Y': component = DATE_TIME_YEAR;      break;
+				case 'm': component = DATE_TIME_MONTH;     break;
+				case 'd': component = DATE_TIME_DAY;       break;
+				case 'H': component = DATE_TIME_HOUR_24;   break;
+				case 'I': component = DATE_TIME_HOUR_12;   break;
+				case 'M': component = DATE_TIME_MINUTE;    break;
+				case 'S': component = DATE_TIME_SECOND;    break;
+				case 'p': component = DATE_TIME_MERIDIEM;  break;
+				default:
+					format.componentCount = 0;
+					return format;
+			}
+		}
+		format.literals[format.componentCount] = (component == DATE_TIME_LITERAL) ? *formatPtr : '\0';
+		format.components[format.componentCount++] = component;
+	}
+	format.formatIndex = formatIndex;
+	
+	return format;
+}
+
+
+
+
+/**
+ * parse_date_time_with_format
+ *
+ * Reads a whole string in a compiled date/time format and converts it to Unix time, the same as 'strptime' followed by 'mktime'.
+ * Each number is read as 'strptime' reads it: leading whitespace is skipped, then digits are taken while there are digits left in
+ * the field's width and another digit could still give a value within its range, e.g., "35" is read as a day of 3 followed by a 5.
+ * AM/PM is matched regardless of case, and a 12 o'clock hour counts as 0 before adding 12 hours for PM.
+ *
+ * The date is converted to days since the epoch with 'days_since_unix_epoch', and the time is added with plain arithmetic. Only the
+ * local offset from UTC needs 'mktime', which is called once for noon of each day that differs from the previous one converted with
+ * the format(with tm_isdst set to 0, as 'strptime' leaves it) and cached in the format. A date/time that 'mktime' can not represent
+ * is rejected so that the caller can fall back to 'match_date_time_format'.
+ *
+ * @param characterString The string to be converted.
+ * @param format Pointer to the compiled format, whose cached offset is updated.
+ * @param unixTime Pointer to a variable in which to store the Unix time.
+ * @return true if the whole string is in the format and has been converted, false otherwise(in which case 'unixTime' is not modified).
+ */
+bool parse_date_time_with_format(const char *characterString, DateTimeFormat *format, time_t *unixTime)
+{
+	if (format->formatIndex < 0)
+	{
+		return false;
+	}
+	
+	
+	/// Each numeric component is indexed by its DateTimeComponent value, with the values a zeroed 'struct tm' would hold as defaults
+	const int minimumValues[] = { 0, 1, 1, 0, 1, 0, 0 };
+	const int maximumValues[] = { 9999, 12, 31, 23, 12, 59, 61 };
+	const int fieldWidths[] = { 4, 2, 2, 2, 2, 2, 2 };
+	int values[] = { 1900, 1, 0, 0, 0, 0, 0 };
+	bool hasTwelveHourClock = false, isAfternoon = false;
+	
+	const char *readPtr = characterString;
+	for (int i = 0; i < format->componentCount; i++)
+	{
+		DateTimeComponent component = format->components[i];
+		if (component == DATE_TIME_WHITESPACE)
+		{
+			while (char_is_whitespace(*readPtr))
+			{
+				readPtr++;
+			}
+		}
+		else if (component == DATE_TIME_LITERAL)
+		{
+			if (*readPtr != format->literals[i])
+			{
+				return false;
+			}
+			readPtr++;
+		}
+		else if (component == DATE_TIME_MERIDIEM)
+		{
+			char first = readPtr[0] & ~0x20, second = readPtr[0] ? (readPtr[1] & ~0x20) : '\0'; // Upper case
+			if ((first != 'A' && first != 'P') || second != 'M')
+			{
+				return false;
+			}
+			isAfternoon = (first == 'P');
+			readPtr += 2;
+		}
+		else
+		{
+			while (char_is_whitespace(*readPtr))
+			{
+				readPtr++;
+			}
+			if (!char_is_digit(*readPtr))
+			{
+				return false;
+			}
+			
+			int value = 0, digitsLeft = fieldWidths[component];
+			do
+			{
+				value = value * 10 + (*readPtr++ - '0');
+			} while (--digitsLeft > 0 && value * 10 <= maximumValues[component] && char_is_digit(*readPtr));
+			
+			if (value < minimumValues[component] || value > maximumValues[component])
+			{
+				return false;
+			}
+			values[component] = value;
+			hasTwelveHourClock |= (component == DATE_TIME_HOUR_12);
+		}
+	}
+	if (*readPtr != '\0')
+	{
+		return false;
+	}
+	
+	
+	/// Convert to days since the epoch, then look up(or compute and cache) the day's offset from UTC
+	int hour = hasTwelveHourClock ? values[DATE_TIME_HOUR_12] % 12 + (isAfternoon ? 12 : 0) : values[DATE_TIME_HOUR_24];
+	int64_t day = days_since_unix_epoch(values[DATE_TIME_YEAR], values[DATE_TIME_MONTH], values[DATE_TIME_DAY]);
+	if (day != format->cachedDay)
+	{
+		struct tm noon;
+		set_memory_block(&noon, 0, sizeof(struct tm));
+		noon.tm_year = values[DATE_TIME_YEAR] - 1900;
+		noon.tm_mon = values[DATE_TIME_MONTH] - 1;
+		noon.tm_mday = values[DATE_TIME_DAY];
+		noon.tm_hour = 12;
+		
+		time_t noonTime = mktime(&noon);
+		if (noonTime == -1)
+		{
+			return false;
+		}
+		format->cachedOffset = (int64_t)noonTime - (day * 86400 + 12 * 3600);
+		format->cachedDay = day;
+	}
+	
+	*unixTime = (time_t)(day * 86400 + hour * 3600 + values[DATE_TIME_MINUTE] * 60 + values[DATE_TIME_SECOND] + format->cachedOffset);
+	return true;
+}
+
+
+
+
+/**
+ * column_value_to_unix_time
+ *
+ * Converts a value of a column to Unix time if it is a date/time, parsing it directly with the column's compiled format when it has
+ * one. The first date/time of a column, and any value not in the column's format, is matched against all of the 'commonDateTimeFormats'
+ * with 'match_date_time_format', and the column then adopts the format that matched, so 'strptime' runs once per column(and per
+ * change of format) instead of once per value. Values without a ':' can not be in any of the formats and are rejected immediately.
+ *
+ * @param characterString The value to be checked and converted.
+ * @param columnFormat Pointer to the column's format, compiled with 'compile_date_time_format'(-1 before the column's first date/time).
+ * @param unixTime Pointer to a variable in which to store the Unix time.
+ * @return true if the value is a date/time, false otherwise(in which case 'unixTime' is not modified).
+ */
+bool column_value_to_unix_time(const char *characterString, DateTimeFormat *columnFormat, time_t *unixTime)
+{
+	if (strchr(characterString, ':') == NULL)
+	{
+		return false;
+	}
+	if (parse_date_time_with_format(characterString, columnFormat, unixTime))
+	{
+		return true;
+	}
+	
+	
+	int formatIndex = match_date_time_format(characterString, unixTime);
+	if (formatIndex < 0)
+	{
+		return false;
+	}
+	if (formatIndex != columnFormat->formatIndex)
+	{
+		*columnFormat = compile_date_time_format(formatIndex);
+	}
+	return true;
+}
+
+
+
 /**
  * string_is_unit
  *
@@ -387,7 +1215,8 @@ int* string_is_unit(const char *characterString, const char *delimiter, const in
 	char *copyOfString = strdup(characterString); // Duplicate the input string to avoid modifying the original.
 	
 	// Tokenize the duplicated string using the provided delimiter.
-	char *token = strtok(copyOfString, delimiter);
+	StringTokenizer tokenizer = create_string_tokenizer(copyOfString, delimiter);
+	char *token = next_string_token(&tokenizer);
 	int index = 0; // Index for tracking current field.
 	
 	// Iterate over each token(field) in the string.
@@ -422,7 +1251,7 @@ int* string_is_unit(const char *characterString, const char *delimiter, const in
 		
 		// Increment the index and move to the next field(token) in the string.
 		index++;
-		token = strtok(NULL, delimiter);
+		token = next_string_token(&tokenizer);
 	}
 	
 	// Cleanup
@@ -713,8 +1542,8 @@ bool string_array_contains_date_time(char **stringArray, int stringCount, const
  * find_potential_delimiters
  *
  * This function is designed to identify potential delimiters in a given string.
- * It does this by iterating over each character in the string and checking if it is a delimiter.
- * If it is, it increments a count for that character in an ASCII array.
+ * It does this by counting every character of the string in an ASCII array, and only afterwards discarding the counts
+ * of the characters that are not delimiters, so that each of the 256 characters is classified once rather than each character of the string.
  * The function then collects all characters that have the maximum count (i.e., the most common potential delimiters)
  * and stores them in a dynamically allocated string, which it returns.
  * The count of potential delimiters is also returned via a pointer argument.
@@ -734,24 +1563,28 @@ char *find_potential_delimiters(const char *characterString, int *delimiterCount
 	
 	
 	
-	int ascii[256] = {0}; // Initialize an ASCII array to zero
-	int maxCount = 0;
-	char *delimiters = malloc(256); // Allocate memory to store potential delimiters.
+	size_t ascii[256] = {0}; // Initialize an ASCII array to zero
+	size_t maxCount = 0;
+	char *delimiters = malloc(256); // Allocate memory to store potential delimiters.
+	
+	
+	/// Tally every character of the string without branching on its class, so the loop never examines the delimiter set per character.
+	for (const unsigned char *position = (const unsigned char *)characterString; *position != '\0'; position++)
+	{
+		ascii[*position]++;
+	}
 	
 	
-	/// Iterate over each character of the string.
-	for (int i = 0; characterString[i] != '\0'; i++)
+	/// Classify each of the 256 possible characters once, discarding the counts of non-delimiters and finding the highest count.
+	for (int i = 0; i < 256; i++)
 	{
-		/// If the character is a delimiter, increment its count in the ASCII array.
-		if (char_is_delimiter(characterString[i]))
+		if (!char_is_delimiter((char)i))
 		{
-			ascii[(unsigned char)characterString[i]]++;
-			
-			/// If this character now has the highest count, update maxCount.
-			if (ascii[(unsigned char)characterString[i]] > maxCount)
-			{
-				maxCount = ascii[(unsigned char)characterString[i]];
-			}
+			ascii[i] = 0;
+		}
+		else if (ascii[i] > maxCount)
+		{
+			maxCount = ascii[i];
 		}
 	}
 	
@@ -1047,6 +1880,23 @@ int compare_strings(const char *characterString1, const char *characterString2)
  * @return A pointer to the duplicated string, or NULL if memory allocation fails.
  */
 char *duplicate_string(const char *characterString)
+{
+	return duplicate_string_in_arena(NULL, characterString);
+}
+
+
+
+
+/**
+ * duplicate_string_in_arena
+ *
+ * Duplicates a string exactly as 'duplicate_string' does, with the copy allocated from an arena instead of with malloc.
+ *
+ * @param arena The arena to allocate the copy from, or NULL to allocate it with malloc.
+ * @param characterString The string to be duplicated.
+ * @return A pointer to the duplicated string, or NULL if memory allocation fails.
+ */
+char *duplicate_string_in_arena(MemoryArena *arena, const char *characterString)
 {
 	if (characterString == NULL)
 	{
@@ -1054,7 +1904,7 @@ char *duplicate_string(const char *characterString)
 	}
 	
 	size_t length = string_length(characterString) + 1; // Calculate the length of the string including the null terminator
-	char *dup = (char *)malloc(length); // Allocate memory for the duplicated string
+	char *dup = (char *)arena_allocate(arena, length); // Allocate memory for the duplicated string
 	
 	if (dup == NULL)
 	{
@@ -1215,6 +2065,24 @@ char *concatenate_n_string(char *destination, const char *source, size_t n)
  * @return A pointer to the combined new string.
  */
 char *combine_strings(const char* characterString1, const char* characterString2)
+{
+	return combine_strings_in_arena(NULL, characterString1, characterString2);
+}
+
+
+
+
+/**
+ * combine_strings_in_arena
+ *
+ * Combines two strings exactly as 'combine_strings' does, with the combined string allocated from an arena instead of with malloc.
+ *
+ * @param arena The arena to allocate the combined string from, or NULL to allocate it with malloc.
+ * @param characterString1 The first character string.
+ * @param characterString2 The second character string.
+ * @return A pointer to the combined new string.
+ */
+char *combine_strings_in_arena(MemoryArena *arena, const char* characterString1, const char* characterString2)
 {
 	// Check for NULL input and handle error.
 	if (characterString1 == NULL) characterString1 = " ";
@@ -1223,7 +2091,7 @@ char *combine_strings(const char* characterString1, const char* characterString2
 	
 	/* Determine Count of Characters of Both Strings and Allocate Memory Appropriately */
 	int characterCount = string_length(characterString1) + 1 + string_length(characterString2) + 1;
-	char *combinedString = (char*)malloc(characterCount * sizeof(char));   //Allocate memory based on character count.
+	char *combinedString = (char*)arena_allocate(arena, characterCount * sizeof(char));   //Allocate memory based on character count.
 	
 	
 	/* Populate the CombinedString with the contents of the two strings */
@@ -1442,14 +2310,201 @@ char* concatenate_string_array(const char** stringArray, int stringCount, const
 
 
 
+/**
+ * create_string_tokenizer
+ *
+ * This function creates a tokenizer over a string, preparing the delimiter once so that 'next_string_token' never has to scan the
+ * delimiter string again. A single delimiter character is located with the structural character scan, for which the end of the
+ * string is found up front. Multiple delimiter characters are converted into the tokenizer's lookup table instead. The tokenizer
+ * holds all of the state of the tokenization, so it is reentrant: any number of tokenizers can be in use at once, on any number of threads.
+ *
+ * @param characterString The string to be tokenized, it is modified in place as tokens are taken from it. May be NULL, in which case no tokens are returned.
+ * @param delimiter The delimiter character(s) used to tokenize the string.
+ * @return A tokenizer positioned at the beginning of the string.
+ */
+StringTokenizer create_string_tokenizer(char *characterString, const char *delimiter)
+{
+	StringTokenizer tokenizer;
+	tokenizer.cursor = characterString;
+	tokenizer.end = NULL;
+	tokenizer.blockStart = NULL;
+	tokenizer.blockDelimiterMask = 0;
+	tokenizer.delimiterCharacter = '\0';
+	set_memory_block(tokenizer.delimiterTable, 0, sizeof(tokenizer.delimiterTable));
+	tokenizer.delimiterTable[0] = 1; // The null character always ends a token
+	
+	for (const unsigned char *delimiterCharacter = (const unsigned char *)delimiter; *delimiterCharacter != '\0'; delimiterCharacter++)
+	{
+		tokenizer.delimiterTable[*delimiterCharacter] = 1;
+	}
+	
+	
+	if (delimiter[0] != '\0' && delimiter[1] == '\0' && characterString != NULL)
+	{
+		tokenizer.delimiterCharacter = delimiter[0];
+		tokenizer.end = characterString + strlen(characterString);
+	}
+	
+	return tokenizer;
+}
+
+
+
+
+/**
+ * tokenizer_block_mask
+ *
+ * Returns the bits of the tokenizer's current block mask from 'position' onward, shifted so that bit 0 corresponds to 'position',
+ * scanning a new 64-byte block beginning at 'position' if 'position' lies outside the current block. 'validBits' receives the number
+ * of bytes from 'position' to the end of the block(or of the string, whichever is first).
+ *
+ * @param tokenizer The single delimiter tokenizer.
+ * @param position A position within the string, before its end.
+ * @param validBits Pointer to a variable in which to store the number of meaningful bits in the returned mask.
+ * @return The delimiter mask of the bytes from 'position' to the end of the block.
+ */
+uint64_t tokenizer_block_mask(StringTokenizer *tokenizer, char *position, size_t *validBits)
+{
+	if (tokenizer->blockStart == NULL || position < tokenizer->blockStart || position >= tokenizer->blockStart + 64)
+	{
+		size_t remaining = (size_t)(tokenizer->end - position);
+		tokenizer->blockStart = position;
+		tokenizer->blockDelimiterMask = scan_structural_characters(position, (remaining < 64) ? remaining : 64, tokenizer->delimiterCharacter).delimiterMask;
+	}
+	
+	
+	size_t blockOffset = (size_t)(position - tokenizer->blockStart);
+	size_t blockLength = (size_t)(tokenizer->end - tokenizer->blockStart);
+	*validBits = ((blockLength < 64) ? blockLength : 64) - blockOffset;
+	return tokenizer->blockDelimiterMask >> blockOffset;
+}
+
+
+
+
+/**
+ * next_string_token
+ *
+ * This function returns the next token of the tokenizer's string, with the same semantics as strtok_r: leading delimiters are skipped,
+ * so empty fields are never returned, and the delimiter ending the token is replaced with a null character('\0') to terminate it.
+ * With a single delimiter character, the delimiters are found by taking the lowest set bit of each block's delimiter mask, otherwise
+ * each character is classified with a single lookup in the tokenizer's delimiter table.
+ *
+ * @param tokenizer The tokenizer created by 'create_string_tokenizer', its cursor is advanced past the returned token.
+ * @return A pointer to the next token in the string, or NULL if no more tokens are found.
+ */
+char *next_string_token(StringTokenizer *tokenizer)
+{
+	if (tokenizer->cursor == NULL)
+	{
+		return NULL;
+	}
+	
+	
+	if (tokenizer->delimiterCharacter != '\0')
+	{
+		char *position = tokenizer->cursor;
+		size_t validBits;
+		
+		
+		// Skip leading delimiters, i.e., find the lowest clear bit of the delimiter mask
+		while (position < tokenizer->end)
+		{
+			uint64_t nonDelimiterMask = ~tokenizer_block_mask(tokenizer, position, &validBits);
+			if (validBits < 64)
+			{
+				nonDelimiterMask &= ((uint64_t)1 << validBits) - 1;
+			}
+			if (nonDelimiterMask != 0)
+			{
+				position += __builtin_ctzll(nonDelimiterMask);
+				break;
+			}
+			position += validBits;
+		}
+		if (position >= tokenizer->end)
+		{
+			tokenizer->cursor = NULL;
+			return NULL;
+		}
+		char *token = position;
+		
+		
+		// Find the delimiter ending the token, i.e., the lowest set bit of the delimiter mask
+		position++;
+		while (position < tokenizer->end)
+		{
+			uint64_t delimiterMask = tokenizer_block_mask(tokenizer, position, &validBits);
+			if (delimiterMask != 0)
+			{
+				position += __builtin_ctzll(delimiterMask);
+				break;
+			}
+			position += validBits;
+		}
+		
+		
+		if (position >= tokenizer->end)
+		{
+			tokenizer->cursor = NULL; // No more characters to process
+		}
+		else
+		{
+			*position = '\0'; // Null-terminate the token, the block mask of the bytes beyond it is unaffected
+			tokenizer->cursor = position + 1;
+		}
+		return token;
+	}
+	
+	
+	unsigned char *position = (unsigned char *)tokenizer->cursor;
+	const unsigned char *delimiterTable = tokenizer->delimiterTable;
+	
+	
+	// Skip leading delimiters
+	while (delimiterTable[*position] && *position != '\0')
+	{
+		position++;
+	}
+	if (*position == '\0')
+	{
+		tokenizer->cursor = NULL;
+		return NULL;
+	}
+	char *token = (char *)position;
+	
+	
+	// Scan to the delimiter(or null character) ending the token
+	do
+	{
+		position++;
+	} while (delimiterTable[*position] == 0);
+	
+	
+	if (*position == '\0')
+	{
+		tokenizer->cursor = NULL; // No more characters to process
+	}
+	else
+	{
+		*position = '\0'; // Null-terminate the token
+		tokenizer->cursor = (char *)(position + 1);
+	}
+	return token;
+}
+
+
+
+
 /**
  * tokenize_string
  *
  * This function tokenizes a string based on a delimiter character and returns the next token.
- * It is similar to the standard strtok function but is reentrant and thread-safe.
+ * It is similar to the standard strtok function, and like strtok it is NOT reentrant: only one string can be tokenized at a time
+ * on each thread. Prefer 'create_string_tokenizer'/'next_string_token', which keep their state in a caller-owned tokenizer.
  * The input string is modified in place by replacing each delimiter with a null character ('\0')
  * to terminate the token. The function maintains the state of the string being tokenized using
- * a static variable.
+ * a thread-local static variable, so each thread tokenizes independently of any other thread.
  *
  * @param characterString The string to be tokenized, if NULL, the function will continue tokenizing from the last saved position.
  * @param delimiter The delimiter character used to tokenize the string.
@@ -1461,7 +2516,7 @@ char *tokenize_string(char *characterString, const char *delimiter)
 	register char *spanp; // Span pointer to iterate over delimiter characters
 	register int c, sc; // Characters for comparison
 	char *token; // Pointer to the next token
-	static char *last; // Static variable to maintain the state of the string being tokenized
+	static _Thread_local char *last; // Thread-local static variable to maintain the state of the string being tokenized(one per thread)
 	
 	// If characterString is NULL, attempt to use the saved pointer 'last'
 	if (characterString == NULL)
@@ -1534,7 +2589,8 @@ cont:
  * split_tokenized_string
  *
  * Splits a string into an array of strings based on a given delimiter.
- *
+ * The fields are located as spans into the original string, which is therefore neither duplicated nor modified, and only
+ * the fields themselves are copied into the returned array.
  *
  * @param characterString The string to be split.
  * @param delimiter The delimiter used to split the string.
@@ -1544,41 +2600,309 @@ cont:
 char** split_tokenized_string(const char* characterString, const char* delimiter, int divisions)
 {
 	char** parts = (char**)malloc(sizeof(char*) * (divisions + 1));
-	if (parts == NULL)
+	FieldSpan *spans = (FieldSpan *)malloc(sizeof(FieldSpan) * (divisions > 0 ? divisions : 1));
+	if (parts == NULL || spans == NULL)
 	{
 		fprintf(stderr, "Memory allocation failed in split_tokenized_string\n");
 		exit(EXIT_FAILURE);
 	}
 	
-	char* strCopy = duplicate_string(characterString); // Duplicate the string to avoid modifying the original
-	if (strCopy == NULL)
+	
+	int partCount = split_string_into_field_spans(characterString, delimiter, spans, divisions);
+	for (int i = 0; i < partCount; i++)
 	{
-		fprintf(stderr, "Memory allocation failed in split_tokenized_string\n");
-		exit(EXIT_FAILURE);
+		parts[i] = materialize_field_span(spans[i]);
+	}
+	
+	parts[partCount] = NULL; // Null-terminate the array
+	free(spans);
+	return parts;
+}
+
+
+
+
+/**
+ * split_string_into_field_spans
+ *
+ * Records the position and length of each field of a string, up to 'maxSpans' of them, with the same semantics as 'next_string_token'
+ * (empty fields are skipped), but without modifying the string or copying any of it. A single delimiter character is located with the
+ * structural character scan, each set bit of a block's delimiter mask ending the current field. Multiple delimiter characters are
+ * classified with a 256-entry lookup table.
+ *
+ * @param characterString The string to be split, it is not modified. May be NULL, in which case no fields are found.
+ * @param delimiter The delimiter character(s) separating the fields.
+ * @param spans The storage to record the spans in, it must have room for 'maxSpans' spans.
+ * @param maxSpans The maximum number of fields to record, the string is not examined past the last of them.
+ * @return The number of fields recorded.
+ */
+int split_string_into_field_spans(const char *characterString, const char *delimiter, FieldSpan *spans, int maxSpans)
+{
+	if (characterString == NULL || maxSpans <= 0)
+	{
+		return 0;
 	}
+	int spanCount = 0;
 	
 	
-	//printf("\n\n\n\n characterString: %s \ndivisions: %d \ndelimiter: %s", characterString, divisions, delimiter);
-	char* token = tokenize_string(strCopy, delimiter);
-	int i = 0;
-	while (token != NULL && i < divisions)
+	if (delimiter[0] != '\0' && delimiter[1] == '\0')
 	{
-		parts[i] = duplicate_string(token);
+		size_t length = strlen(characterString);
+		size_t fieldStart = 0;
+		StructuralCharacterScanner scanner = select_structural_character_scanner();
+		for (size_t blockStart = 0; blockStart < length; blockStart += 64)
+		{
+			size_t blockLength = (length - blockStart < 64) ? length - blockStart : 64;
+			uint64_t delimiterMask = scanner(characterString + blockStart, blockLength, delimiter[0]).delimiterMask;
+			
+			
+			// Each delimiter ends the field begun after the previous one, unless that field is empty
+			for (; delimiterMask != 0; delimiterMask &= delimiterMask - 1)
+			{
+				size_t delimiterOffset = blockStart + __builtin_ctzll(delimiterMask);
+				if (delimiterOffset > fieldStart)
+				{
+					spans[spanCount].start = characterString + fieldStart;
+					spans[spanCount].length = delimiterOffset - fieldStart;
+					if (++spanCount == maxSpans)
+					{
+						return spanCount;
+					}
+				}
+				fieldStart = delimiterOffset + 1;
+			}
+		}
+		
 		
-		if (parts[i] == NULL)
+		if (length > fieldStart) // The last field is ended by the end of the string rather than a delimiter
+		{
+			spans[spanCount].start = characterString + fieldStart;
+			spans[spanCount].length = length - fieldStart;
+			spanCount++;
+		}
+		return spanCount;
+	}
+	
+	
+	unsigned char delimiterTable[256] = {0};
+	delimiterTable[0] = 1; // The null character always ends a field
+	for (const unsigned char *delimiterCharacter = (const unsigned char *)delimiter; *delimiterCharacter != '\0'; delimiterCharacter++)
+	{
+		delimiterTable[*delimiterCharacter] = 1;
+	}
+	
+	const unsigned char *position = (const unsigned char *)characterString;
+	while (spanCount < maxSpans)
+	{
+		while (delimiterTable[*position] && *position != '\0') // Skip leading delimiters
+		{
+			position++;
+		}
+		if (*position == '\0')
 		{
-			fprintf(stderr, "Memory allocation failed in split_tokenized_string\n");
-			exit(EXIT_FAILURE);
+			break;
 		}
 		
-		token = tokenize_string(NULL, delimiter);
-		i++;
+		const unsigned char *fieldStart = position;
+		do
+		{
+			position++;
+		} while (delimiterTable[*position] == 0);
+		
+		spans[spanCount].start = (const char *)fieldStart;
+		spans[spanCount].length = (size_t)(position - fieldStart);
+		spanCount++;
+	}
+	return spanCount;
+}
+
+
+
+
+/**
+ * split_line_into_delimited_field_spans
+ *
+ * Records the position and length of each field of a line, up to 'maxSpans' of them, where every delimiter character ends a field:
+ * unlike 'split_string_into_field_spans', empty fields are kept, so a value left blank between two delimiters stays in its own field
+ * rather than shifting the following values one field to the left. The line is given by its length, it need not be null-terminated,
+ * so a line of a mapped file can be split without being copied. A single delimiter character is located with the structural character
+ * scan, multiple delimiter characters are classified with a 256-entry lookup table.
+ *
+ * @param line The line to be split, it is not modified.
+ * @param length The number of characters in the line.
+ * @param delimiter The delimiter character(s) separating the fields.
+ * @param spans The storage to record the spans in, it must have room for 'maxSpans' spans.
+ * @param maxSpans The maximum number of fields to record, the line is not examined past the last of them.
+ * @return The number of fields recorded, one more than the number of delimiters(if that many fit).
+ */
+int split_line_into_delimited_field_spans(const char *line, size_t length, const char *delimiter, FieldSpan *spans, int maxSpans)
+{
+	if (line == NULL || maxSpans <= 0)
+	{
+		return 0;
 	}
-	//print_string_array(parts, i, "split_tokenized_string parts");
+	int spanCount = 0;
+	size_t fieldStart = 0;
 	
-	parts[i] = NULL; // Null-terminate the array
-	free(strCopy);
-	return parts;
+	
+	if (delimiter[0] != '\0' && delimiter[1] == '\0')
+	{
+		StructuralCharacterScanner scanner = select_structural_character_scanner();
+		for (size_t blockStart = 0; blockStart < length; blockStart += 64)
+		{
+			size_t blockLength = (length - blockStart < 64) ? length - blockStart : 64;
+			uint64_t delimiterMask = scanner(line + blockStart, blockLength, delimiter[0]).delimiterMask;
+			for (; delimiterMask != 0; delimiterMask &= delimiterMask - 1)
+			{
+				size_t delimiterOffset = blockStart + __builtin_ctzll(delimiterMask);
+				spans[spanCount].start = line + fieldStart;
+				spans[spanCount].length = delimiterOffset - fieldStart;
+				if (++spanCount == maxSpans)
+				{
+					return spanCount;
+				}
+				fieldStart = delimiterOffset + 1;
+			}
+		}
+	}
+	else
+	{
+		unsigned char delimiterTable[256] = {0};
+		for (const unsigned char *delimiterCharacter = (const unsigned char *)delimiter; *delimiterCharacter != '\0'; delimiterCharacter++)
+		{
+			delimiterTable[*delimiterCharacter] = 1;
+		}
+		for (size_t position = 0; position < length; position++)
+		{
+			if (delimiterTable[(unsigned char)line[position]])
+			{
+				spans[spanCount].start = line + fieldStart;
+				spans[spanCount].length = position - fieldStart;
+				if (++spanCount == maxSpans)
+				{
+					return spanCount;
+				}
+				fieldStart = position + 1;
+			}
+		}
+	}
+	
+	
+	spans[spanCount].start = line + fieldStart; // The last field is ended by the end of the line rather than a delimiter
+	spans[spanCount].length = length - fieldStart;
+	return spanCount + 1;
+}
+
+
+
+
+/**
+ * create_row_view
+ *
+ * Views the fields of a line as spans into the line, recorded in storage provided by the caller. Reusing the same storage for every
+ * line of a data set means the rows can be examined field by field without a single allocation.
+ *
+ * @param line The line to be viewed, it is not modified and must outlive the view.
+ * @param delimiter The delimiter character(s) separating the fields.
+ * @param fieldStorage The storage to record the field spans in, it must have room for 'maxFields' spans.
+ * @param maxFields The maximum number of fields to view.
+ * @return A view of the first 'maxFields'(or fewer) fields of the line.
+ */
+RowView create_row_view(const char *line, const char *delimiter, FieldSpan *fieldStorage, int maxFields)
+{
+	RowView rowView;
+	rowView.line = line;
+	rowView.fields = fieldStorage;
+	rowView.fieldCount = split_string_into_field_spans(line, delimiter, fieldStorage, maxFields);
+	return rowView;
+}
+
+
+
+
+/**
+ * create_delimited_row_view
+ *
+ * Views the fields of a null-terminated line exactly as 'create_row_view' does, except that the fields are split with
+ * 'split_line_into_delimited_field_spans', so an empty field keeps its place in the row rather than being skipped. A missing value
+ * left blank is therefore seen, in its own field, by whatever examines the row against its schema.
+ *
+ * @param line The line to be viewed, it is not modified and must outlive the view. May be NULL, in which case no fields are found.
+ * @param delimiter The delimiter character(s) separating the fields.
+ * @param fieldStorage The storage to record the field spans in, it must have room for 'maxFields' spans.
+ * @param maxFields The maximum number of fields to view.
+ * @return A view of the first 'maxFields'(or fewer) fields of the line, empty fields included.
+ */
+RowView create_delimited_row_view(const char *line, const char *delimiter, FieldSpan *fieldStorage, int maxFields)
+{
+	RowView rowView;
+	rowView.line = line;
+	rowView.fields = fieldStorage;
+	rowView.fieldCount = (line != NULL) ? split_line_into_delimited_field_spans(line, string_length(line), delimiter, fieldStorage, maxFields) : 0;
+	return rowView;
+}
+
+
+
+
+/**
+ * materialize_field_span
+ *
+ * Makes an owned, null-terminated copy of a field. This is the only point at which the characters of a field are copied, so it
+ * should be called only where a caller genuinely needs a string that outlives the line the field was viewed in.
+ *
+ * @param span The field to be copied.
+ * @return A newly allocated string holding the characters of the field, to be freed by the caller.
+ */
+char *materialize_field_span(FieldSpan span)
+{
+	char *fieldString = (char *)malloc(span.length + 1);
+	if (fieldString == NULL)
+	{
+		fprintf(stderr, "Memory allocation failed in materialize_field_span\n");
+		exit(EXIT_FAILURE);
+	}
+	
+	copy_memory_block(fieldString, span.start, span.length);
+	fieldString[span.length] = '\0';
+	return fieldString;
+}
+
+
+
+
+/**
+ * field_span_is_numeric
+ *
+ * Checks if a field, in its entirety, represents a number, with the same semantics as 'string_is_numeric'. The field is parsed in
+ * place by 'parse_numeric_string', which does not need it to be null-terminated.
+ *
+ * @param span The field to be checked.
+ * @return true if the whole field parses as a number, false otherwise.
+ */
+bool field_span_is_numeric(FieldSpan span)
+{
+	double value;
+	return parse_numeric_string(span.start, span.length, &value);
+}
+
+
+
+
+/**
+ * field_span_to_double
+ *
+ * Converts the leading number of a field to a double, with the same semantics as atof(0.0 if the field does not begin with a number).
+ * Use 'parse_numeric_string' directly where the field must also be classified, so that it is parsed only once.
+ *
+ * @param span The field to be converted.
+ * @return The numeric value of the field.
+ */
+double field_span_to_double(FieldSpan span)
+{
+	double value;
+	parse_numeric_string(span.start, span.length, &value);
+	return value;
 }
 
 
@@ -1601,6 +2925,24 @@ char** split_tokenized_string(const char* characterString, const char* delimiter
  * @return A pointer to the newly allocated trimmed string, or NULL if the input string is NULL or empty.
  */
 char *trim_string_whitespaces(char* untrimmedString)
+{
+	return trim_string_whitespaces_in_arena(NULL, untrimmedString);
+}
+
+
+
+
+/**
+ * trim_string_whitespaces_in_arena
+ *
+ * Trims leading and trailing whitespace from a string exactly as 'trim_string_whitespaces' does, with the trimmed string allocated
+ * from an arena instead of with malloc.
+ *
+ * @param arena The arena to allocate the trimmed string from, or NULL to allocate it with malloc.
+ * @param untrimmedString A pointer to the string to be trimmed.
+ * @return A pointer to the newly allocated trimmed string, or NULL if the input string is NULL or empty.
+ */
+char *trim_string_whitespaces_in_arena(MemoryArena *arena, char* untrimmedString)
 {
 	// Check for NULL or empty string
 	if (!untrimmedString || !*untrimmedString)
@@ -1618,7 +2960,7 @@ char *trim_string_whitespaces(char* untrimmedString)
 	// Handle the case where the entire string is whitespace
 	if (!*startPtr)
 	{
-		char *emptyStr = (char *)malloc(1);
+		char *emptyStr = (char *)arena_allocate(arena, 1);
 		if (emptyStr)
 		{
 			*emptyStr = '\0';
@@ -1638,7 +2980,7 @@ char *trim_string_whitespaces(char* untrimmedString)
 	
 	
 	// Allocate memory for the new string
-	char *trimmedString = (char *)malloc(trimmedLength + 1); // +1 for the null terminator
+	char *trimmedString = (char *)arena_allocate(arena, trimmedLength + 1); // +1 for the null terminator
 	if (!trimmedString)
 	{
 		return NULL; // Allocation failed
@@ -1665,6 +3007,24 @@ char *trim_string_whitespaces(char* untrimmedString)
  * @return A pointer to the newly allocated pruned string, or NULL if the input string is NULL or empty.
  */
 char *prune_string_whitespaces(char *unprunedString)
+{
+	return prune_string_whitespaces_in_arena(NULL, unprunedString);
+}
+
+
+
+
+/**
+ * prune_string_whitespaces_in_arena
+ *
+ * Removes all whitespace characters from a string exactly as 'prune_string_whitespaces' does, with the pruned string allocated from
+ * an arena instead of with malloc. Memory from an arena is not shrunk to fit, since it is released with the rest of the batch.
+ *
+ * @param arena The arena to allocate the pruned string from, or NULL to allocate it with malloc.
+ * @param unprunedString A pointer to the string from which whitespaces are to be removed.
+ * @return A pointer to the newly allocated pruned string, or NULL if the input string is NULL or empty.
+ */
+char *prune_string_whitespaces_in_arena(MemoryArena *arena, char *unprunedString)
 {
 	// Check for NULL or empty string
 	if (!unprunedString || !*unprunedString)
@@ -1673,7 +3033,7 @@ char *prune_string_whitespaces(char *unprunedString)
 	}
 	
 	// Allocate memory for the new string
-	char *prunedString = (char *)malloc(string_length(unprunedString) + 1);
+	char *prunedString = (char *)arena_allocate(arena, string_length(unprunedString) + 1);
 	if (!prunedString)
 	{
 		return NULL; // Allocation failed
@@ -1696,11 +3056,14 @@ char *prune_string_whitespaces(char *unprunedString)
 	*writePtr = '\0';
 	
 	
-	// Reallocate prunedString to fit the actual pruned length
-	char *fitString = realloc(prunedString, string_length(prunedString) + 1);
-	if (fitString)
+	// Reallocate prunedString to fit the actual pruned length, unless it belongs to an arena
+	if (arena == NULL)
 	{
-		prunedString = fitString;
+		char *fitString = realloc(prunedString, string_length(prunedString) + 1);
+		if (fitString)
+		{
+			prunedString = fitString;
+		}
 	}
 	
 	return prunedString;
@@ -1710,111 +3073,74 @@ char *prune_string_whitespaces(char *unprunedString)
 
 
 /**
- * prune_repeated_delimiters_from_string
+ * prune_and_trim_problematic_characters_from_string
  *
- * Inserts a '0' character between consecutive delimiters in a string and returns a new string.
- * This function is particularly useful for processing CSV data. It ensures that empty fields
- * (indicated by consecutive delimiters) are explicitly represented with a '0' value, aiding in
- * correct data alignment during parsing.
+ * Processes a string by trimming whitespace, pruning whitespace, and replacing date/time fields with Unix time.
+ * All three steps are fused into a single forward scan that writes into one output buffer: each non-whitespace character is copied
+ * (which both trims and prunes, as trimming is subsumed by removing every whitespace character), and each field is checked for a
+ * date/time format and converted as soon as its last character has been copied. The output is identical to applying the steps one
+ * after the other, as 'trim_string_whitespaces', 'prune_string_whitespaces' and 'replace_date_time_with_unix' do. Empty fields are
+ * missing values and keep their place: the fields are counted by position, so each date/time field is checked against the format of
+ * its own column, and when a row contains a date/time field it is rebuilt from all of its fields, empty ones included, joined by the
+ * delimiter up to the 'fieldCount'th field.
  *
+ * The pruned characters are written 'fieldCount * (20 + delimiter length)' bytes into the buffer, leaving enough headroom for the
+ * rebuilt row(whose Unix times and delimiters may be longer than what they replace) to be written over it from the front.
  *
- * @param unprunedString A pointer to the string to be processed.
- * @param delimiter The delimiter character used to identify consecutive occurrences.
- *        If the string is NULL or empty, the function returns NULL.
- * @return A pointer to the newly allocated processed string, or NULL if the input string is NULL or empty.
+ * Each field is checked against every date/time format with 'string_to_unix_time'. To process many rows of the same data set, use
+ * 'prune_and_trim_problematic_characters_with_date_formats', which detects the format of each column once.
+ *
+ * @param originalString Pointer to the original string to be processed.
+ * @param delimiter Pointer to the delimiter character used in the string.
+ * @param fieldCount Number of fields expected in the string.
+ * @return Pointer to the newly created string after processing, or NULL in case of an error or if the original string is NULL or empty.
  */
-char *prune_repeated_delimiters_from_string(char *unprunedString, const char *delimiter)
+char *prune_and_trim_problematic_characters_from_string(char *originalString, const char *delimiter, const int fieldCount)
 {
-	// Check for NULL or empty string
-	if (!unprunedString || !*unprunedString)
-	{
-		return NULL;
-	}
-	
-	
-	/// Allocate Memory for the New Pruned String
-	size_t originalLength = string_length(unprunedString) + 1;
-	size_t newLength = originalLength; // Initial estimate of new length
-	
-	
-	// First pass: count consecutive delimiters to estimate the new length, i.e., the number of additional '0' characters required
-	for (size_t i = 0; i < originalLength; i++)
-	{
-		if (unprunedString[i] == *delimiter && unprunedString[i + 1] == *delimiter)
-		{
-			newLength++;
-		}
-	}
-	
-	
-	
-	// Allocate memory for the new string
-	char *prunedString = (char *)malloc((newLength) * sizeof(char));
-	const char *readPtr = unprunedString; // Pointer for reading the input string
-	char *writePtr = prunedString; // Pointer for writing to the new string
-	bool previousCharWasDelimiter = false; // Track if the previous character was a delimiter
-	
-	
-	// Iterate over the input string and process delimiters
-	while (*readPtr)
-	{
-		if (readPtr == delimiter)
-		{
-			if (!previousCharWasDelimiter) //Will occur when
-			{
-				*writePtr++ = *readPtr; // Copy the first occurrence of the delimiter
-			}
-			else // if we reach here it means that the delimiter was true on the last iteration and it is also true this iteration
-			{
-				// Here is where the consecutive delimiters occur
-				// Need to insert '0' between consecutive delimiters, memory was already allocated, so no concerns
-				*writePtr++ = '0';
-				*writePtr++ = *readPtr;
-			}
-			
-			
-			previousCharWasDelimiter = true;
-		}
-		else
-		{
-			*writePtr++ = *readPtr; // Copy non-delimiter character
-			previousCharWasDelimiter = false;
-		}
-		readPtr++;
-	}
-	
-	
-	// Null-terminate the new string
-	*writePtr = '\0';
-	
-	
-	
-	// Reallocate the pruned string to fit the actual length
-	char *fitString = realloc(prunedString, string_length(prunedString) + 1);
-	if (fitString)
-	{
-		prunedString = fitString;
-	}
-	
-	return prunedString;
+	return prune_and_trim_problematic_characters_with_date_formats(originalString, delimiter, fieldCount, NULL);
 }
 
 
 
 
 /**
- * prune_and_trim_problematic_characters_from_string
+ * prune_and_trim_problematic_characters_with_date_formats
  *
- * Processes a string by trimming whitespace, pruning whitespace, handling repeated delimiters, and replacing date/time fields with Unix time.
- * The function first trims leading and trailing whitespaces, then removes all internal whitespaces,
- * handles repeated delimiters by inserting '0' characters, and finally replaces any date/time fields with their Unix time equivalents.
+ * Processes a string the same way as 'prune_and_trim_problematic_characters_from_string', except that the date/time fields are
+ * converted with 'column_value_to_unix_time' using the caller's per-column formats, which persist from one row to the next: once
+ * a column's format has been detected, its values are parsed directly, without 'strptime' and with 'mktime' only once per day.
+ * The formats are updated as columns are detected, so each thread processing rows needs its own.
  *
  * @param originalString Pointer to the original string to be processed.
  * @param delimiter Pointer to the delimiter character used in the string.
  * @param fieldCount Number of fields expected in the string.
+ * @param columnFormats Array of 'fieldCount' formats, initialized with 'compile_date_time_format(-1)' before the first row, or NULL
+ *                      to check each field against every format.
  * @return Pointer to the newly created string after processing, or NULL in case of an error or if the original string is NULL or empty.
  */
-char *prune_and_trim_problematic_characters_from_string(char *originalString, const char *delimiter, const int fieldCount)
+char *prune_and_trim_problematic_characters_with_date_formats(char *originalString, const char *delimiter, const int fieldCount, DateTimeFormat *columnFormats)
+{
+	return prune_and_trim_problematic_characters_in_arena(NULL, originalString, delimiter, fieldCount, columnFormats);
+}
+
+
+
+
+/**
+ * prune_and_trim_problematic_characters_in_arena
+ *
+ * Processes a string exactly as 'prune_and_trim_problematic_characters_with_date_formats' does, with the processed string allocated
+ * from an arena instead of with malloc. Memory from an arena is not shrunk to fit, since it is released with the rest of the batch.
+ *
+ * @param arena The arena to allocate the processed string from, or NULL to allocate it with malloc.
+ * @param originalString Pointer to the original string to be processed.
+ * @param delimiter Pointer to the delimiter character used in the string.
+ * @param fieldCount Number of fields expected in the string.
+ * @param columnFormats Array of 'fieldCount' formats, initialized with 'compile_date_time_format(-1)' before the first row, or NULL
+ *                      to check each field against every format.
+ * @return Pointer to the newly created string after processing, or NULL in case of an error or if the original string is NULL or empty.
+ */
+char *prune_and_trim_problematic_characters_in_arena(MemoryArena *arena, char *originalString, const char *delimiter, const int fieldCount, DateTimeFormat *columnFormats)
 {
 	// Check for NULL or empty string
 	if (!originalString || !*originalString)
@@ -1823,73 +3149,127 @@ char *prune_and_trim_problematic_characters_from_string(char *originalString, co
 	}
 	
 	
-	
-	// Step 1: Trim whitespace from the beginning and end of the string.
-	char *trimmedString = trim_string_whitespaces(originalString);
-	if (!trimmedString)
+	/// Classify each character once: 1 for whitespace(always removed, even if it is also a delimiter), 2 for a delimiter
+	unsigned char characterClasses[256] = {0};
+	size_t delimiterLength = string_length(delimiter);
+	for (size_t i = 0; i < delimiterLength; i++)
 	{
-		perror("\n\nError: Step 1: Trim whitespace from string failure in 'prune_and_trim_problematic_characters_from_string'.\n");
-		return originalString; // If the whitespace trimming fails then the original string is returned
+		characterClasses[(unsigned char)delimiter[i]] = 2;
 	}
-	
-	
-	
-	// Step 2: Prune all internal whitespace characters from the string.
-	char *prunedWhitespaceString = prune_string_whitespaces(trimmedString);
-	if (!prunedWhitespaceString)
+	const char whitespaces[] = { ' ', '\t', '\n', '\v', '\f', '\r' };
+	for (size_t i = 0; i < ARRAY_SIZE(whitespaces); i++)
 	{
-		perror("\n\nError: Step 2: Prune whitespace from string failure in 'prune_and_trim_problematic_characters_from_string'.\n");
-		return trimmedString; // If the whitespace pruning fails then the last successful string format is returned
+		characterClasses[(unsigned char)whitespaces[i]] = 1;
 	}
-	else
+	
+	
+	size_t checkedFieldCount = (fieldCount > 0) ? (size_t)fieldCount : 0; // Only the first 'fieldCount' fields can be date/time fields
+	size_t headroom = checkedFieldCount * (20 + delimiterLength);
+	char *outputString = (char *)arena_allocate(arena, headroom + string_length(originalString) + 1);
+	if (!outputString)
 	{
-		free(trimmedString); // Free the memory allocated by trim_string_whitespaces and proceed to the next step
+		perror("\n\nError: Unable to allocate memory in 'prune_and_trim_problematic_characters_in_arena'.\n");
+		return originalString;
 	}
+	time_t dateTimeValues[checkedFieldCount > 0 ? checkedFieldCount : 1];
+	bool dateTimeIndicators[checkedFieldCount > 0 ? checkedFieldCount : 1];
 	
 	
 	
-	// Step 3: Process repeated delimiters by inserting '0' characters.
-	char *prunedDelimiterString = prune_repeated_delimiters_from_string(prunedWhitespaceString, delimiter);
-	if (!prunedDelimiterString)
+	/// Single forward scan: copy every non-whitespace character, and check each non-empty field for a date/time format as it ends, empty fields keep their index
+	char *prunedString = outputString + headroom;
+	size_t prunedLength = 0, fieldStart = 0, fieldIndex = 0, dateTimeCount = 0;
+	for (const unsigned char *readPtr = (const unsigned char *)originalString; ; readPtr++)
 	{
-		perror("\n\nError: Step 3: Prune repeated delimiters from string failure in 'prune_and_trim_problematic_characters_from_string'.\n");
-		return prunedWhitespaceString; // If the delimiter replacement fails then the last successful string format is returned
-	}
-	else
-	{
-		free(prunedWhitespaceString); // Proceed only if step 3 was successful and the previous string was replaced
+		unsigned char characterClass = characterClasses[*readPtr];
+		if (characterClass == 1)
+		{
+			continue;
+		}
+		if (characterClass == 2 || *readPtr == '\0')
+		{
+			if (fieldIndex < checkedFieldCount)
+			{
+				dateTimeIndicators[fieldIndex] = false; // An empty field is a missing value, never a date/time
+				if (prunedLength > fieldStart)
+				{
+					prunedString[prunedLength] = '\0'; // Overwritten by the delimiter once the field has been checked
+					dateTimeIndicators[fieldIndex] = (columnFormats != NULL) ? column_value_to_unix_time(prunedString + fieldStart, &columnFormats[fieldIndex], &dateTimeValues[fieldIndex])
+					                                                         : string_to_unix_time(prunedString + fieldStart, &dateTimeValues[fieldIndex]);
+					dateTimeCount += dateTimeIndicators[fieldIndex];
+				}
+			}
+			fieldIndex++;
+			if (*readPtr == '\0')
+			{
+				break;
+			}
+			fieldStart = prunedLength + 1;
+		}
+		prunedString[prunedLength++] = (char)*readPtr;
 	}
+	prunedString[prunedLength] = '\0';
 	
 	
-	// Step 4: Detect Date/Time Fields in string and Replace them with Unix Time
-	char *unixTimeString = replace_date_time_with_unix(prunedDelimiterString, delimiter, fieldCount);
-	if (!unixTimeString)
+	if (dateTimeCount == 0) // Without date/time fields the pruned string is the result
 	{
-		//perror("\n\nError: Step 4: Replace date/time fields with Unix time failure in 'prune_and_trim_problematic_characters_from_string'.\n");
-		return prunedDelimiterString; // If the date/time replacement fails then the last successful string format is returned
+		memmove(outputString, prunedString, prunedLength + 1);
 	}
 	else
 	{
-		free(prunedDelimiterString); // Only proceed if step 4 was successful and the previous string was replaced
+		/// Rebuild the row from its fields, empty ones included, over the front of the buffer, which never overtakes the fields still to be read
+		char *writePtr = outputString;
+		const char *readPtr = prunedString;
+		for (fieldIndex = 0; ; fieldIndex++)
+		{
+			const char *fieldStartPtr = readPtr;
+			while (*readPtr != '\0' && characterClasses[(unsigned char)*readPtr] != 2)
+			{
+				readPtr++;
+			}
+			
+			
+			if (fieldIndex > 0 && fieldIndex < checkedFieldCount) // Delimiters only join the first 'fieldCount' fields
+			{
+				memmove(writePtr, delimiter, delimiterLength);
+				writePtr += delimiterLength;
+			}
+			if (fieldIndex < checkedFieldCount && dateTimeIndicators[fieldIndex])
+			{
+				char unixTimeString[20];
+				snprintf(unixTimeString, sizeof(unixTimeString), "%ld", (long)dateTimeValues[fieldIndex]);
+				size_t unixTimeLength = string_length(unixTimeString);
+				memmove(writePtr, unixTimeString, unixTimeLength);
+				writePtr += unixTimeLength;
+			}
+			else
+			{
+				memmove(writePtr, fieldStartPtr, (size_t)(readPtr - fieldStartPtr));
+				writePtr += readPtr - fieldStartPtr;
+			}
+			
+			
+			if (*readPtr == '\0')
+			{
+				break;
+			}
+			readPtr++; // Each delimiter character ends exactly one field
+		}
+		*writePtr = '\0';
 	}
 	
 	
-	//
-	/*
-	 // Step 5: Detect numeric entries with units and Separate Units from Values
-	 char *numericUnitString = extract_units_from_fields(unixTimeString, delimiter, fieldCount);
-	 if (!numericUnitString)
-	 {
-	 //perror("\n\nError: Step 5: Seperate Units from Values failure in 'prune_and_trim_problematic_characters_from_string'.\n");
-	 return unixTimeString; // If the unit replacement fails then the last successful string format is returned
-	 }
-	 else
-	 {
-	 free(unixTimeString); // Only proceed if step 5 was successful and the previous string was replaced
-	 }
-	 //*/
+	// Reallocate the output string to fit the actual length, unless it belongs to an arena
+	if (arena == NULL)
+	{
+		char *fitString = realloc(outputString, string_length(outputString) + 1);
+		if (fitString)
+		{
+			outputString = fitString;
+		}
+	}
 	
-	return unixTimeString; //numericUnitString; // Return the final processed string if all 4 steps were successful
+	return outputString;
 }
 
 
@@ -2102,7 +3482,8 @@ char** extract_units_from_fields(const char* characterString, const char* delimi
 	char* copyOfString = strdup(characterString);
 	
 	// Tokenize the duplicated string using the provided delimiter.
-	char* token = strtok(copyOfString, delimiter);
+	StringTokenizer tokenizer = create_string_tokenizer(copyOfString, delimiter);
+	char* token = next_string_token(&tokenizer);
 	int index = 0;
 	
 	// Iterate over each token(field) in the string.
@@ -2125,7 +3506,7 @@ char** extract_units_from_fields(const char* characterString, const char* delimi
 		
 		results[index] = value; // Store the modified value (with unit removed).
 		index++;
-		token = strtok(NULL, delimiter);
+		token = next_string_token(&tokenizer);
 	}
 	
 	
@@ -2183,7 +3564,7 @@ char** extract_units_from_fields(const char* characterString, const char* delimi
  * It then counts the number of fields that are identified as date/time fields.
  * The function then estimates the size of the output string based on the number of date/time fields and the length of the input string.
  * It allocates memory for the output string based on the estimated size.
- * The function then duplicates the input string to avoid modifying it directly, as strtok modifies the string it processes.
+ * The function then duplicates the input string to avoid modifying it directly, as tokenizing modifies the string it processes.
  * It then initializes the output string to an empty string and tokenizes the copied string using the delimiter character.
  * The function then iterates over each token(field) in the string, checking if the current field is a date/time field.
  * If it is, it converts the date/time field to Unix time, prepares a string to hold the Unix time, and appends the Unix time string to the output.
@@ -2200,6 +3581,27 @@ char** extract_units_from_fields(const char* characterString, const char* delimi
  * @return A pointer to the newly allocated string with the date/time fields replaced with Unix time representations.
  */
 char* replace_date_time_with_unix(char* characterString, const char *delimiter, const int fieldCount)
+{
+	return replace_date_time_with_unix_in_arena(NULL, characterString, delimiter, fieldCount);
+}
+
+
+
+
+/**
+ * replace_date_time_with_unix_in_arena
+ *
+ * Replaces the date/time fields of a string with their Unix time exactly as 'replace_date_time_with_unix' does, with the output string
+ * and the working copy of the input allocated from an arena instead of with malloc. Memory from an arena is not shrunk to fit, since
+ * it is released with the rest of the batch.
+ *
+ * @param arena The arena to allocate from, or NULL to allocate with malloc.
+ * @param characterString Pointer to the string to be interpreted.
+ * @param delimiter The delimiter character used to identify consecutive occurrences.
+ * @param fieldCount The number of fields found in the string.
+ * @return A pointer to the newly allocated string with the date/time fields replaced with Unix time representations.
+ */
+char* replace_date_time_with_unix_in_arena(MemoryArena *arena, char* characterString, const char *delimiter, const int fieldCount)
 {
 	// Call the string_is_date_time function to get an array indicating which fields are date/time fields.
 	int *dateTimeIndicators = string_is_date_time(characterString, delimiter, fieldCount);
@@ -2227,16 +3629,17 @@ char* replace_date_time_with_unix(char* characterString, const char *delimiter,
 	
 	
 	// Allocate memory for the output string based on the estimated size.
-	char *output = (char *)malloc(estimatedOutputSize);
+	char *output = (char *)arena_allocate(arena, estimatedOutputSize);
 	
-	// Duplicate the input string to avoid modifying it directly, as strtok modifies the string it processes.
-	char* copyOfString = duplicate_string(characterString);
+	// Duplicate the input string to avoid modifying it directly, as tokenizing modifies the string it processes.
+	char* copyOfString = duplicate_string_in_arena(arena, characterString);
 	
 	
 	
 	
 	output[0] = '\0'; // Initialize the output string to an empty string
-	char* token = tokenize_string(copyOfString, delimiter);  // Tokenize the copied string using the delimiter character.
+	StringTokenizer tokenizer = create_string_tokenizer(copyOfString, delimiter);
+	char* token = next_string_token(&tokenizer);  // Tokenize the copied string using the delimiter character.
 	int index = 0; // Initialize an index to track the current field
 	
 	// Iterate over each token(field) in the string.
@@ -2263,7 +3666,7 @@ char* replace_date_time_with_unix(char* characterString, const char *delimiter,
 		
 		
 		// Append delimiter for next field.
-		token = tokenize_string(NULL, delimiter);
+		token = next_string_token(&tokenizer);
 		if (token != NULL && string_length(token) > 0 && index < fieldCount - 1)
 		{
 			concatenate_string(output, delimiter);
@@ -2274,7 +3677,10 @@ char* replace_date_time_with_unix(char* characterString, const char *delimiter,
 	}
 	
 	// Free the memory allocated for the copy of the input string and the dateTimeIndicators array.
-	free(copyOfString);
+	if (arena == NULL)
+	{
+		free(copyOfString);
+	}
 	free(dateTimeIndicators);
 	
 	
@@ -2287,10 +3693,13 @@ char* replace_date_time_with_unix(char* characterString, const char *delimiter,
 	// Included here because the estimated size has to be able to account for the maximum possible size of the
 	// outputted string, and since the outputted string usually changes minimnally in length from the inputtted string, it means that the estimate
 	// often greatly exceeds the actual needed size, hence it's good practice to reallocate here.
-	char *fitoutput = realloc(output, string_length(output) + 1);
-	if (fitoutput)
+	if (arena == NULL)
 	{
-		output = fitoutput;
+		char *fitoutput = realloc(output, string_length(output) + 1);
+		if (fitoutput)
+		{
+			output = fitoutput;
+		}
 	}
 	
 	
@@ -2343,6 +3752,197 @@ char **preprocess_string_array(char **stringArray, int stringCount, const char *
 
 
 
+/**
+ * create_string_intern_table
+ *
+ * Creates an empty string intern table, which stores each distinct string once and identifies it by a small integer, so that
+ * strings repeated across many rows(e.g., the categories of a column) are compared and hashed as integers from then on. The strings
+ * are kept back to back in a single heap and found with an open-addressing hash table of linearly probed slots, which is doubled
+ * whenever it becomes more than half full.
+ *
+ * @param initialCapacity The number of distinct strings to make room for.
+ * @return The table, to be released with 'free_string_intern_table'.
+ */
+StringInternTable create_string_intern_table(int initialCapacity)
+{
+	StringInternTable table;
+	table.count = 0;
+	table.capacity = (initialCapacity > 16) ? initialCapacity : 16;
+	table.slotCount = 32;
+	while (table.slotCount < 2 * table.capacity)
+	{
+		table.slotCount *= 2;
+	}
+	table.bytesLength = 0;
+	table.bytesCapacity = 16 * (size_t)table.capacity;
+	
+	table.bytes = (char *)malloc(table.bytesCapacity);
+	table.offsets = (size_t *)malloc((table.capacity + 1) * sizeof(size_t));
+	table.hashes = (uint64_t *)malloc(table.capacity * sizeof(uint64_t));
+	table.slots = (int *)malloc(table.slotCount * sizeof(int));
+	if (table.bytes == NULL || table.offsets == NULL || table.hashes == NULL || table.slots == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'create_string_intern_table'.\n");
+		exit(1);
+	}
+	table.offsets[0] = 0;
+	memset(table.slots, 0xFF, table.slotCount * sizeof(int)); // Every slot starts empty(-1)
+	
+	return table;
+}
+
+
+
+
+/**
+ * free_string_intern_table
+ *
+ * Releases the memory held by a string intern table.
+ *
+ * @param table The table.
+ */
+void free_string_intern_table(StringInternTable *table)
+{
+	free(table->bytes);
+	free(table->offsets);
+	free(table->hashes);
+	free(table->slots);
+	table->bytes = NULL;
+	table->offsets = NULL;
+	table->hashes = NULL;
+	table->slots = NULL;
+	table->count = 0;
+}
+
+
+
+
+/**
+ * hash_string_bytes
+ *
+ * Hashes a run of bytes with 64-bit FNV-1a, whose low bits are well enough mixed to index a power-of-two table directly.
+ *
+ * @param start The first byte.
+ * @param length The number of bytes.
+ * @return The hash.
+ */
+uint64_t hash_string_bytes(const char *start, size_t length)
+{
+	uint64_t hash = 0xcbf29ce484222325ull;
+	for (size_t i = 0; i < length; i++)
+	{
+		hash ^= (unsigned char)start[i];
+		hash *= 0x100000001b3ull;
+	}
+	return hash;
+}
+
+
+
+
+/**
+ * intern_string
+ *
+ * Finds the identifier of a string in an intern table, adding the string if it is not there yet. Identifiers are given out in the
+ * order strings are first added, from 0.
+ *
+ * @param table The table.
+ * @param span The string, which need not be null-terminated.
+ * @return The identifier of the string.
+ */
+int intern_string(StringInternTable *table, FieldSpan span)
+{
+	uint64_t hash = hash_string_bytes(span.start, span.length);
+	size_t mask = (size_t)table->slotCount - 1;
+	size_t slot = hash & mask;
+	for (; table->slots[slot] >= 0; slot = (slot + 1) & mask)
+	{
+		int id = table->slots[slot];
+		size_t length = table->offsets[id + 1] - table->offsets[id];
+		if (table->hashes[id] == hash && length == span.length && memcmp(table->bytes + table->offsets[id], span.start, length) == 0)
+		{
+			return id;
+		}
+	}
+	
+	
+	/// Store the new string, growing the heap and the arrays as needed
+	if (table->bytesLength + span.length > table->bytesCapacity)
+	{
+		while (table->bytesLength + span.length > table->bytesCapacity)
+		{
+			table->bytesCapacity *= 2;
+		}
+		table->bytes = (char *)realloc(table->bytes, table->bytesCapacity);
+	}
+	if (table->count == table->capacity)
+	{
+		table->capacity *= 2;
+		table->offsets = (size_t *)realloc(table->offsets, (table->capacity + 1) * sizeof(size_t));
+		table->hashes = (uint64_t *)realloc(table->hashes, table->capacity * sizeof(uint64_t));
+	}
+	if (table->bytes == NULL || table->offsets == NULL || table->hashes == NULL)
+	{
+		perror("\n\nError: Unable to allocate memory in 'intern_string'.\n");
+		exit(1);
+	}
+	
+	int id = table->count++;
+	memcpy(table->bytes + table->bytesLength, span.start, span.length);
+	table->bytesLength += span.length;
+	table->offsets[id + 1] = table->bytesLength;
+	table->hashes[id] = hash;
+	table->slots[slot] = id;
+	
+	
+	/// Keep the slots at most half full, rehashing every string from its stored hash into twice as many
+	if (2 * table->count > table->slotCount)
+	{
+		table->slotCount *= 2;
+		table->slots = (int *)realloc(table->slots, table->slotCount * sizeof(int));
+		if (table->slots == NULL)
+		{
+			perror("\n\nError: Unable to allocate memory in 'intern_string'.\n");
+			exit(1);
+		}
+		memset(table->slots, 0xFF, table->slotCount * sizeof(int));
+		mask = (size_t)table->slotCount - 1;
+		for (int i = 0; i < table->count; i++)
+		{
+			size_t newSlot = table->hashes[i] & mask;
+			while (table->slots[newSlot] >= 0)
+			{
+				newSlot = (newSlot + 1) & mask;
+			}
+			table->slots[newSlot] = i;
+		}
+	}
+	
+	return id;
+}
+
+
+
+
+/**
+ * interned_string
+ *
+ * Views a string stored in an intern table by its identifier.
+ *
+ * @param table The table.
+ * @param id The identifier of the string.
+ * @return A span of the string within the table, valid until the next string is added.
+ */
+FieldSpan interned_string(const StringInternTable *table, int id)
+{
+	FieldSpan span = { table->bytes + table->offsets[id], table->offsets[id + 1] - table->offsets[id] };
+	return span;
+}
+
+
+
+
+
 
 
 
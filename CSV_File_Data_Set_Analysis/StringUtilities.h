@@ -19,6 +19,8 @@
 #include <time.h>
 #include <math.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include "GeneralUtilities.h"
 
 
 
@@ -40,15 +42,62 @@ bool char_is_delimiter(char c); // Checks if a character is a delimiter (non-alp
 
 
 
+
+// -------------- Structural Character Masks Structure Definition --------------
+/**
+ * StructuralCharacterMasks Structure: Marks where the characters that give a delimited file its structure occur within a block of up to 64 bytes.
+ *
+ * Bit 'i' of each mask corresponds to byte 'i' of the block, so the positions of the structural characters of a whole block can be
+ * visited with count-trailing-zeros and counted with a population count instead of examining the block one byte at a time.
+ * Bits beyond the length of a partial block are always 0.
+ *
+ * - delimiterMask: Bit 'i' is set if byte 'i' is the delimiter character.
+ * - quoteMask: Bit 'i' is set if byte 'i' is a double quote.
+ * - newlineMask: Bit 'i' is set if byte 'i' is a newline.
+ */
+typedef struct
+{
+	uint64_t delimiterMask;
+	uint64_t quoteMask;
+	uint64_t newlineMask;
+} StructuralCharacterMasks;
+
+typedef StructuralCharacterMasks (*StructuralCharacterScanner)(const char *block, size_t blockLength, char delimiter); // Signature shared by every implementation of the structural character scan
+
+
+
+
+// ------------- Helper Functions for Scanning Structural Characters -------------
+/// \{
+StructuralCharacterMasks scan_structural_characters_scalar(const char *block, size_t blockLength, char delimiter); // Scans a block one byte at a time, available on every platform.
+#if defined(__x86_64__) || defined(__i386__)
+StructuralCharacterMasks scan_structural_characters_sse2(const char *block, size_t blockLength, char delimiter); // Scans a block 16 bytes at a time with SSE2.
+StructuralCharacterMasks scan_structural_characters_avx2(const char *block, size_t blockLength, char delimiter); // Scans a block 32 bytes at a time with AVX2, only call if the processor supports it.
+#endif
+StructuralCharacterScanner select_structural_character_scanner(void); // Returns the fastest scan supported by the processor, chosen once at runtime.
+const char *structural_character_scanner_name(StructuralCharacterScanner scanner); // Returns the name of a scan implementation, for reporting.
+StructuralCharacterMasks scan_structural_characters(const char *block, size_t blockLength, char delimiter); // Scans a block of up to 64 bytes with the fastest available implementation.
+uint64_t compute_quoted_region_mask(uint64_t quoteMask, int *insideQuotes); // Converts a block's quote mask into the mask of bytes lying inside quoted fields.
+/// \}
+
+
+
+
+
+
 // ------------- Helper Functions for Counting and Classifying Strings -------------
 /// \{
 size_t string_length(const char *characterString); // Returns the length of a character string.
 int count_array_strings(char **stringArray); // Counts the number of strings in an array of strings.
 int count_character_occurrences(const char *characterString, char c); // Counts occurrences of a specified character in a string
 bool string_is_numeric(const char *characterString); // Checks if a string represents a numeric value.
+bool parse_numeric_string(const char *characterString, size_t length, double *value); // Checks if a string is numeric and converts it to a double in one pass. (~= strtod)
+bool parse_integer_string(const char *characterString, size_t length, int64_t *value); // Checks if a string is a decimal integer within the range of int64_t and converts it in one pass.
+double compute_double_from_decimal(uint64_t significand, int64_t exponent, bool negative, bool *success); // Converts significand * 10^exponent to the correctly rounded double(Clinger/Eisel-Lemire).
 bool string_is_nonnumeric(const char *characterString); // Checks if the given string contains any numeric characters.
 bool string_is_hyphen_else_is_minus_sign(char *characterString); // Differentiates between hyphens and minus signs.
 int *string_is_date_time(const char *characterString, const char *delimiter, const int fieldCount); // Analyzes a string for date/time formats.
+bool string_to_unix_time(const char *characterString, time_t *unixTime); // Checks if a string is a date/time and converts it to Unix time in the same pass.
 int* string_is_unit(const char *characterString, const char *delimiter, const int fieldCount); // Analyzes a string for units/unitformats.
 bool is_numeric_with_units(const char* characterStringToken, char* testUnit); // Checks a string for specified units.
 const char *determine_string_representation_type(const char* token); // Determines if a string is numeric or non-numeric.
@@ -88,6 +137,7 @@ char *identify_delimiter_recursive(char** stringArray, int stringCount, char **p
 /// \{
 int compare_strings(const char *characterString1, const char *characterString2); // Compares two character strings for equality.
 char *duplicate_string(const char *characterString); // Duplicates a character string. (~= strdup)
+char *duplicate_string_in_arena(MemoryArena *arena, const char *characterString); // Duplicates a character string into an arena.
 char *copy_string(char *destination, const char *source); // Copies a character string. (~= strcpy)
 char *copy_n_string(char *destination, const char *source, size_t n); // Copies up to n characters from the string pointed to by 'source' and to 'destination', where any n greater than the length of 'source' is padded with null characters. (~= strncpy)
 /// \}
@@ -102,6 +152,7 @@ char *copy_n_string(char *destination, const char *source, size_t n); // Copies
 char *concatenate_string(char *destination, const char *source); // Concatenates two character strings. (~= strcat)
 char *concatenate_n_string(char *destination, const char *source, size_t n); // Concatenates up to n characters from the string pointed to by 'source' to the end of the string pointed to by 'destination'. (~= strncat)
 char *combine_strings(const char *characterString1, const char *characterString2);  // Returns a new string with contents of the second string appended to the first.
+char *combine_strings_in_arena(MemoryArena *arena, const char *characterString1, const char *characterString2); // Combines two strings into a new string allocated from an arena.
 char **combine_string_arrays(const char **stringArray1, int stringCountArray1, const char **stringArray2, int stringCountArray2); // Combines two arrays of strings.
 char *append_string_array_to_string(const char *characterString1, const char *characterStringArray[], int numArrayStrings, const char *delimiter); // Combines each string in the array with the original string to return a single string having the contents of the original string with each string from the array appended to it seperated by the specified delimiter.
 char *concatenate_string_array(const char** stringArray, int stringCount, const char *delimiter); // Concatenates an array of strings into a single string with elements/fields seperated by the specified delimiter
@@ -112,8 +163,41 @@ char *concatenate_string_array(const char** stringArray, int stringCount, const
 
 
 
+// -------------- String Tokenizer Structure Definition --------------
+/**
+ * StringTokenizer Structure: The complete state of an in-progress tokenization of a single string.
+ *
+ * Unlike 'tokenize_string'(and strtok), which remember their position in hidden static state, all of the state lives in this
+ * structure, so any number of strings can be tokenized at once, on any number of threads, as long as each has its own tokenizer.
+ * A single delimiter character(the common case) is located with the structural character scan, 64 bytes at a time, and each
+ * block's delimiter mask is kept so that every byte is examined once no matter how many tokens the block holds. Multiple delimiter
+ * characters are converted once into a 256-entry lookup table, so that classifying each character is a single table lookup.
+ *
+ * - cursor: The position in the string at which the search for the next token begins, NULL once the string is exhausted.
+ * - end: The null character terminating the string(single delimiter only).
+ * - blockStart: The first byte of the most recently scanned block, NULL before the first scan(single delimiter only).
+ * - blockDelimiterMask: The delimiter mask of the block beginning at 'blockStart'(single delimiter only).
+ * - delimiterCharacter: The delimiter character, or '\0' if the delimiter has more than one character and the lookup table is used.
+ * - delimiterTable: Entry 'c' is 1 if the character 'c' ends a token, i.e., it is one of the delimiter characters or the null character.
+ */
+typedef struct
+{
+	char *cursor;
+	char *end;
+	char *blockStart;
+	uint64_t blockDelimiterMask;
+	char delimiterCharacter;
+	unsigned char delimiterTable[256];
+} StringTokenizer;
+
+
+
+
 // ------------- Helper Functions for Tokenizing and Segmenting Strings -------------
 /// \{
+StringTokenizer create_string_tokenizer(char *characterString, const char *delimiter); // Creates a tokenizer over a character string, the string is modified in place as tokens are taken from it.
+uint64_t tokenizer_block_mask(StringTokenizer *tokenizer, char *position, size_t *validBits); // Returns the delimiter mask of a single delimiter tokenizer from a position to the end of its block, scanning a new block if needed.
+char *next_string_token(StringTokenizer *tokenizer); // Returns the next token of the tokenizer's string, or NULL when there are none left. (reentrant ~= strtok_r)
 char *tokenize_string(char *characterString, const char *delimiter); // Tokenizes a character string based on a delimiter. (~= strtok)
 char **split_tokenized_string(const char* characterString, const char* delimiter, int divisions); // Splits a tokenized string into an array of strings based on a given delimiter, i.e., assigns each tokenized field to an element in an array.
 /// \}
@@ -121,14 +205,130 @@ char **split_tokenized_string(const char* characterString, const char* delimiter
 
 
 
+// -------------- Field Span and Row View Structure Definitions --------------
+/**
+ * FieldSpan Structure: A view of a single field of a delimited string, pointing directly into the string it was split from.
+ *
+ * Nothing is copied or allocated to create a span, and the span is NOT null-terminated, so it remains valid only as long as the
+ * string it points into. A null-terminated copy is made only when one is explicitly requested with 'materialize_field_span'.
+ *
+ * - start: The first character of the field.
+ * - length: The number of characters in the field.
+ */
+typedef struct
+{
+	const char *start;
+	size_t length;
+} FieldSpan;
+
+
+/**
+ * RowView Structure: The fields of a single delimited line, as spans into the line.
+ *
+ * The span storage is owned by the caller and reused from one line to the next, so viewing each row of a data set requires no
+ * allocation at all. As with 'next_string_token', empty fields are skipped.
+ *
+ * - line: The line the fields point into.
+ * - fields: The caller's span storage, holding the spans of the first 'fieldCount' fields of the line.
+ * - fieldCount: The number of fields found, at most the capacity of 'fields'.
+ */
+typedef struct
+{
+	const char *line;
+	FieldSpan *fields;
+	int fieldCount;
+} RowView;
+
+
+
+
+// ------------- Helper Functions for Field Spans and Row Views -------------
+/// \{
+int split_string_into_field_spans(const char *characterString, const char *delimiter, FieldSpan *spans, int maxSpans); // Records the spans of up to 'maxSpans' fields of a string without modifying or copying it.
+int split_line_into_delimited_field_spans(const char *line, size_t length, const char *delimiter, FieldSpan *spans, int maxSpans); // Records the spans of up to 'maxSpans' fields of a line, keeping empty fields, without copying it.
+RowView create_row_view(const char *line, const char *delimiter, FieldSpan *fieldStorage, int maxFields); // Views the fields of a line as spans held in the caller's storage.
+RowView create_delimited_row_view(const char *line, const char *delimiter, FieldSpan *fieldStorage, int maxFields); // Views the fields of a line as spans, keeping empty fields in place.
+char *materialize_field_span(FieldSpan span); // Returns a newly allocated, null-terminated copy of a field.
+bool field_span_is_numeric(FieldSpan span); // Checks if the whole of a field is a number. (~= string_is_numeric)
+double field_span_to_double(FieldSpan span); // Converts the leading number of a field to a double. (~= atof)
+/// \}
+
+
+
+
+
+// -------------- Date/Time Format Structure Definition --------------
+#define DATE_TIME_FORMAT_MAX_COMPONENTS 16 // The most components of any of the 'commonDateTimeFormats'(which have at most 12)
+
+/**
+ * DateTimeComponent Enumeration: A single element of a date/time format: a conversion reading a number(or AM/PM), a character
+ * that must match exactly, or whitespace, which matches any amount of whitespace(including none).
+ */
+typedef enum
+{
+	DATE_TIME_YEAR,
+	DATE_TIME_MONTH,
+	DATE_TIME_DAY,
+	DATE_TIME_HOUR_24,
+	DATE_TIME_HOUR_12,
+	DATE_TIME_MINUTE,
+	DATE_TIME_SECOND,
+	DATE_TIME_MERIDIEM,
+	DATE_TIME_LITERAL,
+	DATE_TIME_WHITESPACE
+} DateTimeComponent;
+
+
+/**
+ * DateTimeFormat Structure: One of the 'commonDateTimeFormats' compiled into the sequence of components it is made of, so that the
+ * date/time fields of a column can be converted to Unix time without calling 'strptime' and 'mktime' for every value.
+ *
+ * A column's format is detected with 'strptime' from the first date/time found in it, and every later value is read component by
+ * component following the same digit rules. The offset from UTC of the most recently converted day is cached, so 'mktime'(and the
+ * timezone lock it takes) is needed only once per distinct day rather than once per value.
+ *
+ * - formatIndex: The index of the format in 'commonDateTimeFormats', or -1 while no date/time has been found in the column.
+ * - componentCount: The number of entries of 'components' in use.
+ * - components: The conversions, literal characters, and whitespace of the format, in order.
+ * - literals: The character to match at each DATE_TIME_LITERAL component.
+ * - cachedDay: The day(counted from the epoch) whose offset from UTC is 'cachedOffset', or INT64_MIN if no offset is cached.
+ * - cachedOffset: The number of seconds to add to a time on 'cachedDay', counted as if it were UTC, to obtain its Unix time.
+ */
+typedef struct
+{
+	int formatIndex;
+	int componentCount;
+	DateTimeComponent components[DATE_TIME_FORMAT_MAX_COMPONENTS];
+	char literals[DATE_TIME_FORMAT_MAX_COMPONENTS];
+	int64_t cachedDay;
+	int64_t cachedOffset;
+} DateTimeFormat;
+
+
+
+
+// ------------- Helper Functions for Date/Time Formats -------------
+/// \{
+int match_date_time_format(const char *characterString, time_t *unixTime); // Finds the first of the 'commonDateTimeFormats' matching a whole string and converts it to Unix time with 'strptime' and 'mktime'.
+DateTimeFormat compile_date_time_format(int formatIndex); // Compiles one of the 'commonDateTimeFormats' into its components, or an undetected format for -1.
+bool parse_date_time_with_format(const char *characterString, DateTimeFormat *format, time_t *unixTime); // Converts a string in a compiled format to Unix time with calendar arithmetic. (~= strptime + mktime)
+bool column_value_to_unix_time(const char *characterString, DateTimeFormat *columnFormat, time_t *unixTime); // Converts a value of a column to Unix time, detecting the column's format the first time and parsing it directly after.
+/// \}
+
+
+
+
 
 
 // ------------- Helper Functions for Pruning and Trimming Strings -------------
 /// \{
 char *trim_string_whitespaces(char* untrimmedString); // Trims whitespace from a string.
 char *prune_string_whitespaces(char *unprunedString); // Removes all whitespaces from a string.
-char *prune_repeated_delimiters_from_string(char *unprunedString, const char *delimiter);  // Handles repeated delimiters.
+char *trim_string_whitespaces_in_arena(MemoryArena *arena, char* untrimmedString); // Trims whitespace from a string into an arena.
+char *prune_string_whitespaces_in_arena(MemoryArena *arena, char *unprunedString); // Removes all whitespaces from a string into an arena.
 char *prune_and_trim_problematic_characters_from_string(char *originalString, const char *delimiter, const int fieldCount);  // Prunes and trims problematic characters.
+char *prune_and_trim_problematic_characters_with_date_formats(char *originalString, const char *delimiter, const int fieldCount, DateTimeFormat *columnFormats); // Prunes and trims problematic characters, converting date/time fields with formats detected per column.
+char *prune_and_trim_problematic_characters_in_arena(MemoryArena *arena, char *originalString, const char *delimiter, const int fieldCount, DateTimeFormat *columnFormats); // Prunes and trims problematic characters with per-column date/time formats, into an arena.
 /// \}
 
 
@@ -142,6 +342,7 @@ char** extract_units_from_fields(const char* characterString, const char* delimi
 
 
 char *replace_date_time_with_unix(char* characterString, const char *delimiter, const int fieldCount); // Replaces date/time with Unix time.
+char *replace_date_time_with_unix_in_arena(MemoryArena *arena, char* characterString, const char *delimiter, const int fieldCount); // Replaces date/time with Unix time, into an arena.
 char **preprocess_string_array(char **stringArray, int stringCount, const char *delimiter); // Preprocesses an array of strings, trimming and pruning whitespaces, repeated delimiters, and standardizing some variable parameters like date/time strings which have no standard formatting and are standardized by replacing them with unix representation.
 /// \}
 
@@ -151,6 +352,54 @@ char **preprocess_string_array(char **stringArray, int stringCount, const char *
 
 
 
+// -------------- String Intern Table Structure Definition --------------
+/**
+ * StringInternTable Structure: Stores each distinct string once and identifies it by the order it was first added(see
+ * 'create_string_intern_table').
+ *
+ * - bytes: The heap holding the bytes of every string back to back, without null characters.
+ * - bytesLength: The number of bytes used in the heap.
+ * - bytesCapacity: The number of bytes the heap can hold before it must grow.
+ * - offsets: String 'i' occupies the bytes from 'offsets[i]' up to 'offsets[i + 1]'.
+ * - hashes: The hash of each string, kept so the slots can be rebuilt without hashing the strings again.
+ * - slots: The open-addressing hash table, each slot holding the identifier of a string or -1 if empty.
+ * - slotCount: The number of slots, a power of two at least twice the number of strings.
+ * - count: The number of strings.
+ * - capacity: The number of strings 'offsets' and 'hashes' can hold before they must grow.
+ */
+typedef struct
+{
+	char *bytes;
+	size_t bytesLength;
+	size_t bytesCapacity;
+	size_t *offsets;
+	uint64_t *hashes;
+	
+	
+	int *slots;
+	int slotCount;
+	int count;
+	int capacity;
+} StringInternTable;
+
+
+
+
+// ------------- Helper Functions for Interning Strings -------------
+/// \{
+StringInternTable create_string_intern_table(int initialCapacity); // Creates an empty table with room for 'initialCapacity' distinct strings.
+void free_string_intern_table(StringInternTable *table); // Releases the memory held by a string intern table.
+uint64_t hash_string_bytes(const char *start, size_t length); // Hashes a run of bytes with 64-bit FNV-1a.
+int intern_string(StringInternTable *table, FieldSpan span); // Returns the identifier of a string, adding it if it is new.
+FieldSpan interned_string(const StringInternTable *table, int id); // Views a string by its identifier.
+/// \}
+
+
+
+
+
+
+
 
 #endif /* StringUtilities_h */
 
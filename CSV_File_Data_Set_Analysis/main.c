@@ -19,8 +19,14 @@
 #include "DebuggingUtilities.h"
 
 
-// This function encapsulates the entire workflow from reading the file contents, preprocessing and formatting the data, to writing the parsed data into structured files.
-void run_data_set(const char* dataSetFilePathName, char **fileContents, int lineCount, const char *delimiter); 
+// This function encapsulates the entire workflow from ingesting the file contents into a typed columnar table, to writing the plottable fields and computing their statistics.
+void run_data_set(const char* dataSetFilePathName, const MappedFile *dataSetFile, const char *delimiter, DataSetRunOptions options);
+
+// This function runs the legacy workflow, preprocessing and formatting every data entry into a string before writing the parsed data into structured files.
+void run_data_set_string_pipeline(const char* dataSetFilePathName, const MappedFile *dataSetFile, const char *delimiter);
+
+// This function runs the same workflow in bounded memory, streaming the data set window by window instead of reading it into memory as a whole.
+void run_data_set_streaming(const char* dataSetFilePathName, StreamingOptions options);
 
 
 
@@ -35,15 +41,59 @@ int main(int argc, const char * argv[])
 	
 	
 	
-	/*-----------   Capture File Contents in an Array of Strings   -----------*/
-	int lineCount = count_file_lines(particleDataSetFilePathName, MAX_NUM_FILE_LINES);
-	char **fileContents = read_file_contents(particleDataSetFilePathName, lineCount);
-	const char *delimiter = identify_delimiter(fileContents, lineCount);
+	/*-----------   Map the File Contents Into Memory   -----------*/
+	MappedFile particleDataSetFile = map_file_bytes(particleDataSetFilePathName); // The records are located while preprocessing, no line index is needed
+	const char *delimiter = identify_mapped_file_delimiter(&particleDataSetFile, 64);
 	
 	
 	
 	/*-----------   Run Data Set   -----------*/
-	run_data_set(particleDataSetFilePathName, fileContents, lineCount, delimiter);
+	DataSetRunOptions runOptions = default_data_set_run_options(); // Set 'runOptions.legacyStringPipeline' to run the original string pipeline instead
+	run_data_set(particleDataSetFilePathName, &particleDataSetFile, delimiter, runOptions);
+	unmap_file_contents(&particleDataSetFile);
+	
+	
+	
+	
+	
+	
+	
+	
+	/// TESTING STREAMING MODE(bounded memory, for data sets too large to be read into memory as a whole)
+	/*
+	 StreamingOptions streamingOptions = default_streaming_options();
+	 streamingOptions.memoryBudgetBytes = 16 * 1024 * 1024; // The window is shrunk to fit if needed
+	 run_data_set_streaming(weatherDataSetFilePathName, streamingOptions);
+	 //*/
+	
+	
+	
+	
+	
+	
+	
+	
+	/// TESTING TOKENIZER PERFORMANCE('tokenize_string' vs. strtok_r vs. the reentrant 'StringTokenizer')
+	/*
+	 MappedFile tokenizerBenchmarkFile = map_file_contents(particleDataSetFilePathName);
+	 int benchmarkLineCount = (int)tokenizerBenchmarkFile.lineIndex.count;
+	 LineStore benchmarkLines = read_mapped_file_contents(&tokenizerBenchmarkFile, benchmarkLineCount);
+	 benchmark_string_tokenizers(line_store_pointers(&benchmarkLines), benchmarkLineCount, delimiter, 20);
+	 free_line_store(&benchmarkLines);
+	 unmap_file_contents(&tokenizerBenchmarkFile);
+	 //*/
+	
+	
+	
+	
+	
+	
+	
+	
+	/// TESTING SORTING PERFORMANCE('merge_sort' vs. 'parallel_merge_sort' vs. 'radix_sort_doubles' vs. 'parallel_radix_sort_doubles')
+	/*
+	 benchmark_sorts(10000000, 5);
+	 //*/
 	
 	
 	
@@ -108,38 +158,81 @@ int main(int argc, const char * argv[])
 
 /**
  * The function performs the following major steps:
- * 1. Preprocesses the file contents to standardize the format.
- * 2. Formats each data entry for plotting.
- * 3. Writes the formatted data set to a new directory.
- * 4. Parses the entire file to categorize data and writes categorized data into separate files.
+ * 1. Ingests the data set once into a typed columnar table, with missing values recorded as nulls rather than rewritten as zeros.
+ * 2. Writes the numeric columns to the plottable fields directory, straight from their contiguous values.
+ * 3. Computes and prints the statistics of each numeric column from its contiguous values, finding its quartiles in 'options.quantileMode'.
+ * 4. Writes the 'options.correlationMethod' matrix of every pair of numeric columns next to the plottable fields directory.
+ * 5. Aggregates the numeric columns over the groups keyed by 'options.groupByFieldIndices', or by each string column in turn.
+ *
+ * The mapped file and its delimiter are only read by the legacy string pipeline, run instead if 'options.legacyStringPipeline' is set.
  */
-void run_data_set(const char* dataSetFilePathName, char **fileContents, int lineCount, const char *delimiter)
+void run_data_set(const char* dataSetFilePathName, const MappedFile *dataSetFile, const char *delimiter, DataSetRunOptions options)
 {
-	/*-----------   Begin Preprocessing File Contents to Standardize the Format and Achieve/Maintain Compatibility of the Contents   -----------*/
-	int fieldCount = count_data_fields(fileContents[0]);
-	char **formattedFileContents = fileContents;
+	if (options.legacyStringPipeline)
+	{
+		run_data_set_string_pipeline(dataSetFilePathName, dataSetFile, delimiter);
+		return;
+	}
 	
 	
-	char *headerLine = prune_and_trim_problematic_characters_from_string(fileContents[1], delimiter, fieldCount);
-	for(int i = 1; i < lineCount; i++)
+	/*-----------   Ingest the Data Set Into a Typed Columnar Table in a Single Pass Over the File   -----------*/
+	DataSetProperties dataSetProperties = analyze_data_set_properties(dataSetFilePathName);
+	if (dataSetProperties.entryCount == 0)
 	{
-		formattedFileContents[i] = prune_and_trim_problematic_characters_from_string(fileContents[i], delimiter, fieldCount);
+		free_data_set_properties(&dataSetProperties);
+		return;
 	}
 	
 	
-	/// Individually preprocess, format, and capture each line of the data set in order to achieve a fully preprocessed/formatted data set
-	for(int i = 1; i < lineCount; i++)
+	/*-----------   Write the Plottable Fields Straight From the Numeric Columns   -----------*/
+	char *plottableFieldsDirectory = write_data_set_properties_plottable_fields(&dataSetProperties);
+	
+	
+	/*-----------   Compute the Statistics of Each Field From its Column   -----------*/
+	print_data_set_properties_statistics(&dataSetProperties, options.quantileMode);
+	printf("\nPlottable fields written to: %s\n", plottableFieldsDirectory);
+	
+	
+	/*-----------   Write the Correlation Matrix of the Numeric Columns   -----------*/
+	char *correlationMatrixFilePathName = write_data_set_properties_correlation_matrix(&dataSetProperties, options.correlationMethod);
+	printf("\nCorrelation matrix written to: %s\n", correlationMatrixFilePathName);
+	
+	
+	
+	
+	/*-----------   Aggregate the Numeric Columns Over the Groups Keyed by the String Columns   -----------*/
+	print_data_set_properties_groups(&dataSetProperties, options.groupByFieldIndices, options.groupByFieldCount);
+	
+	
+	free(correlationMatrixFilePathName);
+	free(plottableFieldsDirectory);
+	free_data_set_properties(&dataSetProperties);
+}
+
+
+
+
+
+
+/**
+ * The function performs the following major steps:
+ * 1. Preprocesses the file contents to standardize the format, dividing the mapped file between the available hardware threads.
+ * 2. Formats each data entry for plotting(on the same threads).
+ * 3. Writes the formatted data set to a new directory.
+ * 4. Parses the entire file to categorize data and writes categorized data into separate files.
+ */
+void run_data_set_string_pipeline(const char* dataSetFilePathName, const MappedFile *dataSetFile, const char *delimiter)
+{
+	/*-----------   Preprocess and Format the File Contents to Standardize the Format and Achieve/Maintain Compatibility of the Contents   -----------*/
+	/// Each thread examines the data entries of its own range of the mapped file, filtering out problematic characters, omitting or replacing disruptive
+	/// aspects(such as repeated delimiters, whitespaces, unexpected date/time formats, etc.), and formatting each field to ensure it is of the correct data type
+	LineStore formattedFileStore = preprocess_data_set_in_parallel(dataSetFile, delimiter, determine_hardware_thread_count());
+	if (formattedFileStore.lineCount == 0)
 	{
-		/// Examine each data entry and filter out problematic characters, omit or replace disruptive aspects(such as repeated delimiters, whitespaces,
-		/// unexpected date/time formats, etc.), and standardize the arrangement of characters representing information for each data entry
-		char *dataEntry =  prune_and_trim_problematic_characters_from_string(fileContents[i], delimiter, fieldCount);
-		
-		
-		/// Pass the now preprocessed 'dataEntry' to the utility function, 'format_data_entry_for_plotting', where it will be formatted to ensure each one of it's
-		/// field's is of the correct data type, and correctly handling the case(s) when it they are not(i.e., if the field missing, mismatched data type, etc.), in order to
-		/// ensure compatibility with the rest of the program before being captured as an element of the 'formattedFileContents'
-		formattedFileContents[i] = format_data_entry_for_plotting(headerLine, dataEntry, fieldCount, delimiter);
+		return;
 	}
+	int lineCount = (int)formattedFileStore.lineCount;
+	char **formattedFileContents = line_store_pointers(&formattedFileStore);
 	print_file_contents(formattedFileContents, lineCount);
 	
 	/*-----------   Capture Plottable Data from 'fileContents' and write to directory at the same level as the original file. (too long to explain here)   -----------*/
@@ -212,6 +305,50 @@ void run_data_set(const char* dataSetFilePathName, char **fileContents, int line
 	
 	
 	print_string_array_array(separatedData, parameterCount, lineCount, "separatedData print_string_array_array");
-	deallocate_memory_char_ptr_ptr(fileContents, lineCount);
+	free_line_store(&formattedFileStore);
 }
 
+
+
+
+
+
+/**
+ * The function performs the following major steps:
+ * 1. Streams the data set window by window, preprocessing and formatting each data entry as it is read.
+ * 2. Writes the plottable fields to a new directory as each window is completed.
+ * 3. Prints the per-field summary accumulated while streaming, with each field's quartiles found in 'options.quantileMode'.
+ */
+void run_data_set_streaming(const char* dataSetFilePathName, StreamingOptions options)
+{
+	StreamingDataSetSummary summary = stream_data_set(dataSetFilePathName, options);
+	
+	
+	printf("\n\n\n\nStreamed Data Set: %s", dataSetFilePathName);
+	printf("\nentryCount: %zu        fieldCount: %d        plottableFieldCount: %d", summary.entryCount, summary.fieldCount, summary.plottableFieldCount);
+	for (int i = 0; i < summary.fieldCount; i++)
+	{
+		ColumnAccumulator accumulator = summary.columnAccumulators[i];
+		if (summary.plottabilityStatus[i] == 1 && accumulator.count > 0)
+		{
+			printf("\n    Field %d: %-20s missing: %-8zu mean: %-14g min: %-14g max: %-14g median: %-14g IQR: %-14g bin width: %-14g bins: %-6d (%s)", i, summary.fieldNames[i], accumulator.missingCount,
+			       accumulator.sum / (double)accumulator.count, accumulator.min, accumulator.max, accumulator.median, accumulator.iqr, accumulator.binWidth, accumulator.binCount,
+			       (accumulator.quantileMode == QUANTILE_MODE_EXACT) ? "exact" : "sketched");
+		}
+		else
+		{
+			printf("\n    Field %d: %-20s missing: %zu", i, summary.fieldNames[i], accumulator.missingCount);
+		}
+	}
+	for (int i = 0; i < summary.fieldCount; i++)
+	{
+		if (summary.plottabilityStatus[i] == 1 && summary.columnAccumulators[i].count > 0)
+		{
+			print_histogram(summary.columnAccumulators[i].binning, summary.fieldNames[i]);
+		}
+	}
+	printf("\n\nPlottable fields written to: %s\n", summary.plottableFieldsDirectory);
+	
+	
+	free_streaming_data_set_summary(&summary);
+}